@@ -28,6 +28,11 @@ set(FRONTEND_SOURCES
 )
 source_group("frontend" FILES ${FRONTEND_HEADERS} ${FRONTEND_SOURCES})
 
+set(FUZZER_SOURCES
+	"${PROJECT_INCLUDE_DIR}/frontend/FuzzDriver.cpp" # main, replaces CubeChip.cpp
+)
+source_group("frontend" FILES ${FUZZER_SOURCES})
+
 # ==================================================================================== #
 
 set(COMPONENTS_HEADERS
@@ -38,14 +43,19 @@ set(COMPONENTS_HEADERS
 	"${PROJECT_INCLUDE_DIR}/components/DisplayDevice.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/FileImage.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/FrameLimiter.hpp"
+	"${PROJECT_INCLUDE_DIR}/components/FrameRecorder.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/FramePacket.hpp"
+	"${PROJECT_INCLUDE_DIR}/components/LatencyHistogram.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/LazyFilePrefetcher.hpp"
+	"${PROJECT_INCLUDE_DIR}/components/MemoryWriteTracker.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/SlidingRingBuffer.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/SimpleMRU.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/SimpleTimer.hpp"
+	"${PROJECT_INCLUDE_DIR}/components/StepDebugger.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/TripleBuffer.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/Voice.hpp"
 	"${PROJECT_INCLUDE_DIR}/components/Well512.hpp"
+	"${PROJECT_INCLUDE_DIR}/components/ZipArchive.hpp"
 )
 set(COMPONENTS_SOURCES
 	"${PROJECT_INCLUDE_DIR}/components/AudioDevice.cpp"
@@ -54,7 +64,10 @@ set(COMPONENTS_SOURCES
 	"${PROJECT_INCLUDE_DIR}/components/DisplayDevice.cpp"
 	"${PROJECT_INCLUDE_DIR}/components/FileImage.cpp"
 	"${PROJECT_INCLUDE_DIR}/components/FrameLimiter.cpp"
+	"${PROJECT_INCLUDE_DIR}/components/FrameRecorder.cpp"
 	"${PROJECT_INCLUDE_DIR}/components/SimpleTimer.cpp"
+	"${PROJECT_INCLUDE_DIR}/components/StepDebugger.cpp"
+	"${PROJECT_INCLUDE_DIR}/components/ZipArchive.cpp"
 )
 source_group("components" FILES ${COMPONENTS_HEADERS} ${COMPONENTS_SOURCES})
 
@@ -67,8 +80,10 @@ set(UTILITIES_HEADERS
 	"${PROJECT_INCLUDE_DIR}/utilities/ColorOps.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/Concepts.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/DefaultConfig.hpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/Deflate.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/EzMaths.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/FileItem.hpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/FileWatcher.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/FriendlyUnique.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/ImLabel.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/LifetimeWrapperSDL.hpp"
@@ -77,22 +92,31 @@ set(UTILITIES_HEADERS
 	"${PROJECT_INCLUDE_DIR}/utilities/Millis.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/Parameter.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/PathGetters.hpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/PixelScaler.hpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/SeqLockBox.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/SettingWrapper.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/SHA1.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/SHA1_Helpers.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/SimpleFileIO.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/StringJoin.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/ThreadAffinity.hpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/VirtualMemory.hpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/Waveforms.hpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/ZoneProfiler.hpp"
 )
 set(UTILITIES_SOURCES
 	"${PROJECT_INCLUDE_DIR}/utilities/AttachConsole.cpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/DefaultConfig.cpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/Deflate.cpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/FileWatcher.cpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/Millis.cpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/LifetimeWrapperSDL.cpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/PathGetters.cpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/PixelScaler.cpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/SHA1.cpp"
 	"${PROJECT_INCLUDE_DIR}/utilities/ThreadAffinity.cpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/VirtualMemory.cpp"
+	"${PROJECT_INCLUDE_DIR}/utilities/ZoneProfiler.cpp"
 )
 source_group("utilities" FILES ${UTILITIES_HEADERS} ${UTILITIES_SOURCES})
 
@@ -115,16 +139,26 @@ source_group("services" FILES ${SERVICES_HEADERS} ${SERVICES_SOURCES})
 # ==================================================================================== #
 
 set(SYSTEMS_HEADERS
+	"${PROJECT_INCLUDE_DIR}/systems/BulkValidator.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/CoreFuzzer.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/CoreRegistry.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/CoreRegistry.inl"
+	"${PROJECT_INCLUDE_DIR}/systems/DiffRunner.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/InstanceScheduler.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/ISystemEmu.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/ISystemEmu_GUI.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/ProgramLibrary.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/SystemDescriptor.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/SystemStaging.hpp"
 )
 set(SYSTEMS_SOURCES
+	"${PROJECT_INCLUDE_DIR}/systems/BulkValidator.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/CoreFuzzer.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/CoreRegistry.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/DiffRunner.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/InstanceScheduler.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/ISystemEmu.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/ProgramLibrary.cpp"
 )
 source_group("systems" FILES ${SYSTEMS_HEADERS} ${SYSTEMS_SOURCES})
 
@@ -132,23 +166,32 @@ source_group("systems" FILES ${SYSTEMS_HEADERS} ${SYSTEMS_SOURCES})
 
 set(SYSTEM_CHIP8_HEADERS
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/IFamily_CHIP8.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/XOCHIP_Tables.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8_MODERN.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8_VIP.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/SCHIP_MODERN.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/SCHIP_LEGACY.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/XOCHIP.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/HWCHIP64.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/MEGACHIP.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/GIGACHIP.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8X.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8X_MPD.hpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8E.hpp"
 )
 set(SYSTEM_CHIP8_SOURCES
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/IFamily_CHIP8.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/IFamily_CHIP8_GUI.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8_MODERN.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8_VIP.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/SCHIP_MODERN.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/SCHIP_LEGACY.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/XOCHIP.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/HWCHIP64.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/MEGACHIP.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/GIGACHIP.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8X.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8X_MPD.cpp"
 	"${PROJECT_INCLUDE_DIR}/systems/chip8/cores/CHIP8E.cpp"
 )
 source_group("systems\\chip8" FILES ${SYSTEM_CHIP8_HEADERS} ${SYSTEM_CHIP8_SOURCES})
@@ -178,3 +221,16 @@ set(SYSTEM_GAMEBOY_SOURCES
 	"${PROJECT_INCLUDE_DIR}/systems/gameboy/cores/GAMEBOY_CLASSIC.cpp"
 )
 source_group("systems\\gameboy" FILES ${SYSTEM_GAMEBOY_HEADERS} ${SYSTEM_GAMEBOY_SOURCES})
+
+# ==================================================================================== #
+
+set(SYSTEM_COSMAC_HEADERS
+	"${PROJECT_INCLUDE_DIR}/systems/cosmac/IFamily_COSMAC.hpp"
+	"${PROJECT_INCLUDE_DIR}/systems/cosmac/cores/COSMAC_VIP.hpp"
+)
+set(SYSTEM_COSMAC_SOURCES
+	"${PROJECT_INCLUDE_DIR}/systems/cosmac/IFamily_COSMAC.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/cosmac/IFamily_COSMAC_GUI.cpp"
+	"${PROJECT_INCLUDE_DIR}/systems/cosmac/cores/COSMAC_VIP.cpp"
+)
+source_group("systems\\cosmac" FILES ${SYSTEM_COSMAC_HEADERS} ${SYSTEM_COSMAC_SOURCES})
@@ -15,6 +15,7 @@
 
 #include "HDIS_HCIS.hpp"
 #include "ExecPolicy.hpp"
+#include "VirtualMemory.hpp"
 
 /*==================================================================*/
 
@@ -27,6 +28,27 @@
 template<typename T>
 concept Allocatable = std::is_object_v<T> && !std::is_abstract_v<T>;
 
+/**
+ * @brief Where the pages of an array allocation come from.
+ * - DEFAULT     :: Aligned operator new, touched by whichever thread constructs the elements.
+ * - FIRST_TOUCH :: Page-mapped and left untouched by the allocating thread, so each page lands
+ *                  on the NUMA node of the thread that first writes it, normally its owner.
+ * - HUGE_PAGES  :: As FIRST_TOUCH, but aligned for and hinted towards transparent huge pages,
+ *                  cutting TLB misses on large buffers. Only Linux honors the hint.
+ *
+ * Page-mapped memory reads back as zeroes, so value-construction of trivially copyable
+ * types is skipped for it, on the assumption that a value-initialized T is all zero bits.
+ * Platforms without page mapping fall back to DEFAULT.
+ */
+enum class AllocPolicy {
+	DEFAULT,
+	FIRST_TOUCH,
+	HUGE_PAGES,
+};
+
+template <AllocPolicy P>
+inline constexpr bool is_page_mapped_v = P != AllocPolicy::DEFAULT && virtual_memory::is_supported;
+
 /**
  * @brief Free-standing heap Deleter for non-trivially destructible aligned memory.
  * @tparam T :: The type of data to destroy and deallocate.
@@ -82,31 +104,60 @@ public:
 	friend constexpr void swap(AlignedLiteArrayDeleter&, AlignedLiteArrayDeleter&) noexcept {}
 };
 
+/**
+ * @brief Free-standing Deleter for page-mapped memory, see AllocPolicy.
+ * @tparam T :: The type of data to destroy and deallocate.
+ * @param[in] size :: The amount of elements this Deleter is managing.
+ */
+template <Allocatable T>
+class AlignedPageArrayDeleter {
+	std::size_t m_size{};
+
+public:
+	constexpr AlignedPageArrayDeleter() noexcept = default;
+	constexpr AlignedPageArrayDeleter(std::size_t size) noexcept : m_size(size) {}
+
+	void operator()(T* ptr) const noexcept(std::is_nothrow_destructible_v<T>)
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>)
+			{ if (ptr) { std::destroy_n(EXEC_POLICY(unseq) ptr, m_size); } }
+		virtual_memory::release(ptr, m_size * sizeof(T));
+	}
+
+	friend constexpr void swap(AlignedPageArrayDeleter& lhs, AlignedPageArrayDeleter& rhs) noexcept
+		{ std::swap(lhs.m_size, rhs.m_size); }
+};
+
 /*==================================================================*/
 
 /**
  * @brief Free-standing unique_ptr type for aligned memory.
  * @tparam T :: The type of data to manage.
  * @tparam A :: The alignment offset (optional). Must be a power of two.
+ * @tparam P :: The allocation policy (optional), see AllocPolicy.
  */
-template <Allocatable T, std::size_t A = HDIS>
+template <Allocatable T, std::size_t A = HDIS, AllocPolicy P = AllocPolicy::DEFAULT>
 using AlignedUniqueArray = std::unique_ptr<T[], std::conditional_t<
-	std::is_trivially_destructible_v<T>,
-	AlignedLiteArrayDeleter<T, A>,
-	AlignedTypeArrayDeleter<T, A>
+	is_page_mapped_v<P>,
+	AlignedPageArrayDeleter<T>,
+	std::conditional_t<
+		std::is_trivially_destructible_v<T>,
+		AlignedLiteArrayDeleter<T, A>,
+		AlignedTypeArrayDeleter<T, A>
+	>
 >>;
 
-template <Allocatable T, std::size_t A>
+template <Allocatable T, std::size_t A, AllocPolicy P = AllocPolicy::DEFAULT>
 class AlignedMemoryBlock;
 
-template <Allocatable T, std::size_t A>
-AlignedMemoryBlock<T, A> allocate_n(std::size_t) noexcept;
+template <Allocatable T, std::size_t A, AllocPolicy P>
+AlignedMemoryBlock<T, A, P> allocate_n(std::size_t) noexcept;
 
 /*==================================================================*/
 
-template <Allocatable T, std::size_t A>
+template <Allocatable T, std::size_t A, AllocPolicy P = AllocPolicy::DEFAULT>
 class AlignedContainer {
-	using memory_type = AlignedUniqueArray<T, A>;
+	using memory_type = AlignedUniqueArray<T, A, P>;
 	using self = AlignedContainer;
 
 public:
@@ -197,18 +248,22 @@ public:
 
 /*==================================================================*/
 
-template <Allocatable T, std::size_t A>
+template <Allocatable T, std::size_t A, AllocPolicy P>
 class AlignedMemoryBlock {
-	using memory_type = AlignedUniqueArray<T, A>;
+	using memory_type = AlignedUniqueArray<T, A, P>;
 	using self = AlignedMemoryBlock;
 	using size_type = std::size_t;
 
+	// fresh mapped pages already hold the zeroes value-construction would write
+	static constexpr bool c_pre_zeroed = is_page_mapped_v<P>
+		&& std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+
 	memory_type m_allocated;
 	size_type m_size{};
 	size_type m_offset{};
 
 private:
-	friend self allocate_n<T, A>(std::size_t) noexcept;
+	friend self allocate_n<T, A, P>(std::size_t) noexcept;
 
 	AlignedMemoryBlock(T* ptr, size_type size) noexcept
 		: m_allocated(ptr, size), m_size(size)
@@ -241,14 +296,14 @@ public:
 		{ return is_constructed() ? std::move(m_allocated) : memory_type{}; }
 
 	[[nodiscard]]
-	AlignedContainer<T, A> release_as_container() noexcept {
-		return AlignedContainer<T, A>(has_valid_ptr() \
+	AlignedContainer<T, A, P> release_as_container() noexcept {
+		return AlignedContainer<T, A, P>(has_valid_ptr() \
 			? std::move(m_allocated) : memory_type{}, element_count());
 	}
 
 	[[nodiscard]]
-	AlignedContainer<T, A> release_as_container_if_constructed() noexcept {
-		return AlignedContainer<T, A>(is_constructed() \
+	AlignedContainer<T, A, P> release_as_container_if_constructed() noexcept {
+		return AlignedContainer<T, A, P>(is_constructed() \
 			? std::move(m_allocated) : memory_type{}, element_count());
 	}
 
@@ -261,8 +316,10 @@ public:
 	{
 		if (has_valid_ptr() && !is_constructed()) {
 			const auto safe_count = clamp_element_construction_count(count);
-			std::uninitialized_value_construct_n(EXEC_POLICY(unseq)
-				m_allocated.get() + construct_count(), safe_count);
+			if constexpr (!c_pre_zeroed) {
+				std::uninitialized_value_construct_n(EXEC_POLICY(unseq)
+					m_allocated.get() + construct_count(), safe_count);
+			}
 			m_offset += safe_count;
 		}
 		return *this;
@@ -374,15 +431,22 @@ public:
 
 /*==================================================================*/
 
-template<Allocatable T, std::size_t A = HDIS>
-inline AlignedMemoryBlock<T, A> allocate_n(std::size_t size) noexcept {
+template<Allocatable T, std::size_t A = HDIS, AllocPolicy P = AllocPolicy::DEFAULT>
+inline AlignedMemoryBlock<T, A, P> allocate_n(std::size_t size) noexcept {
 	static_assert(std::has_single_bit(A),
 		"A must be a power of two.");
 	static_assert(A <= MAX_ALIGN,
 		"Exceeded maximum allowed alignment.");
 
-	void* ptr = !size ? nullptr : ::operator new[](
-		size * sizeof(T), std::align_val_t(A), std::nothrow);
+	void* ptr = nullptr;
+	if (size) {
+		if constexpr (is_page_mapped_v<P>) {
+			// pages are aligned far beyond A, and stay untouched until first written
+			ptr = virtual_memory::reserve(size * sizeof(T), P == AllocPolicy::HUGE_PAGES);
+		} else {
+			ptr = ::operator new[](size * sizeof(T), std::align_val_t(A), std::nothrow);
+		}
+	}
 	return { static_cast<T*>(ptr), { ptr != nullptr ? size : 0 } };
 }
 
@@ -7,8 +7,15 @@
 #include "DisplayDevice.hpp"
 #include "LifetimeWrapperSDL.hpp"
 #include "BasicVideoSpec.hpp"
+#include "ZoneProfiler.hpp"
+#include "AtomSharedPtr.hpp"
+#include "SimpleFileIO.hpp"
+#include "Millis.hpp"
+#include "BasicLogger.hpp"
+#include "Deflate.hpp"
 
 #include <imgui.h>
+#include <fmt/format.h>
 
 /*==================================================================*/
 
@@ -16,9 +23,20 @@ struct DisplayDevice::DisplayContext {
 	using Callable = DisplayDevice::Callable;
 	using Metadata = FramePacket::Metadata;
 
-	AtomicBox<Metadata>      m_staging_data;
+	SeqLockBox<Metadata>     m_staging_data;
 	AtomSharedPtr<Callable>  m_osd_callable;
 
+	AtomSharedPtr<FrameRecorder> m_recorder;
+	std::atomic<bool>            m_is_recording{};
+	std::string                  m_capture_directory;
+	std::string                  m_capture_name_hint;
+
+	std::atomic<bool>                        m_is_checksumming{};
+	SeqLockBox<DisplayDevice::FrameChecksum> m_frame_checksum{};
+
+	static inline std::atomic<FrameRecorder::Format>
+		s_autostart_capture{ FrameRecorder::Format::NONE };
+
 	SDL_Renderer* const&     m_renderer_hook;
 	SDL_Renderer*            m_live_renderer;
 	DisplayDevice::Swapchain m_swapchain;
@@ -30,11 +48,39 @@ struct DisplayDevice::DisplayContext {
 
 	BoundedParam<0, 0, 3> m_screen_rotation;
 
+	BoundedParam<0, 0, int(pixel_scaler::Filter::COUNT) - 1>
+	                        m_screen_filter;
+	BoundedParam<0, 0, 100> m_scanlines_strength;
+	BoundedParam<0, 0, 100> m_grid_strength;
+	BoundedParam<1, 1, 8>   m_capture_scale;
+
+	pixel_scaler::Options   m_scaler_options{};
+
 	bool m_integer_scaling = false;
 	bool m_borderless_view = false;
 	bool m_shaders_enabled = false;
 	bool m_debugger_enabled = false;
 
+	// the software renderer gets frames scaled straight into the target on the CPU,
+	// as does any renderer once a filter or effect the GPU path lacks is selected
+	bool m_software_path = false;
+	bool m_target_stale  = false;
+	bool m_target_stream = false;
+
+	bool uses_cpu_scaler() const noexcept {
+		return m_software_path || *m_screen_filter
+			|| *m_scanlines_strength || *m_grid_strength;
+	}
+
+	auto make_scaler_options(RGBA tint) const noexcept {
+		pixel_scaler::Options options;
+		options.filter    = pixel_scaler::Filter(*m_screen_filter);
+		options.tint      = tint;
+		options.scanlines = u8(*m_scanlines_strength * 255 / 100);
+		options.grid      = u8(*m_grid_strength * 255 / 100);
+		return options;
+	}
+
 	auto init_stream_texture(int W, int H) const noexcept {
 		return BasicVideoSpec::create_stream_texture(m_live_renderer, W, H);
 	}
@@ -44,12 +90,14 @@ public:
 		: m_renderer_hook(sdl_renderer_ptr)
 		, m_live_renderer(nullptr)
 		, m_swapchain(int(W), int(H))
-		, m_staging_data(std::make_shared<Metadata>(int(W), int(H)))
+		, m_staging_data(std::in_place, int(W), int(H))
 	{
-		assert((m_staging_data.view()->get_base_frame().area() == (W * H))
+		assert((m_staging_data.copy().get_base_frame().area() == (W * H))
 			&& "Display W/H sizes are beyond expected bounds, clamping!");
 	}
 
+	~DisplayContext() noexcept { stop_recording(); }
+
 private:
 	class DisplayLayout {
 		const Metadata& m_metadata_ref;
@@ -103,36 +151,57 @@ private:
 	void sync_renderer_change() noexcept {
 		if (m_renderer_hook == m_live_renderer) { return; }
 
-		if (m_renderer_hook != nullptr) {
-			const auto frame = m_staging_data.view()->get_base_frame();
+		m_live_renderer = m_renderer_hook;
+		m_software_path = BasicVideoSpec::is_software_renderer(m_live_renderer);
+
+		if (m_live_renderer != nullptr && !m_software_path) {
+			const auto frame = m_staging_data.copy().get_base_frame();
 			m_stream_texture.reset(BasicVideoSpec::create_stream_texture(
-				m_live_renderer = m_renderer_hook, frame.w, frame.h));
+				m_live_renderer, frame.w, frame.h));
 		} else {
 			m_stream_texture.reset();
-			m_live_renderer = nullptr;
 		}
 		m_target_texture.reset();
 	}
 
 private:
-	void render_texture_region(const DisplayLayout& layout_data) noexcept {
+	void render_texture_region(const DisplayLayout& layout_data, const FramePacket& frame) noexcept {
 		if (layout_data->enabled) {
+			const auto cpu_scaled = uses_cpu_scaler();
+			const auto options = make_scaler_options(layout_data->texture_tint);
+
 			const auto target_AR = std::max(std::floor(layout_data.base_ratio),
 				f32(layout_data->minimum_zoom));
 
-			const auto new_target_size = ez::Frame(
-				s32(std::ceil(layout_data.dar_viewport.w * target_AR)),
-				s32(std::ceil(layout_data.dar_viewport.h * target_AR))
-			);
-
-			if (!m_target_texture || new_target_size != m_old_target_size) {
-				m_target_texture.reset(BasicVideoSpec::create_target_texture(
-					m_live_renderer, new_target_size.w, new_target_size.h, true));
+			// sharp bilinear resolves fractional sizes itself, the rest prescale by integers
+			const auto new_target_size = (cpu_scaled && options.filter == pixel_scaler::Filter::SHARP_BILINEAR)
+				? ez::Frame(
+					std::max(s32(layout_data.texture_region.x), 1),
+					std::max(s32(layout_data.texture_region.y), 1))
+				: ez::Frame(
+					s32(std::ceil(layout_data.dar_viewport.w * target_AR)),
+					s32(std::ceil(layout_data.dar_viewport.h * target_AR)));
+
+			if (!m_target_texture || new_target_size != m_old_target_size || cpu_scaled != m_target_stream) {
+				m_target_texture.reset(cpu_scaled
+					? BasicVideoSpec::create_stream_texture(m_live_renderer,
+						new_target_size.w, new_target_size.h, true)
+					: BasicVideoSpec::create_target_texture(m_live_renderer,
+						new_target_size.w, new_target_size.h, true));
 				m_old_target_size = new_target_size;
+				m_target_stream = cpu_scaled;
+				m_target_stale = true;
 			}
 
-			BasicVideoSpec::write_stream_texture(m_live_renderer,
-				m_target_texture, m_stream_texture);
+			if (!cpu_scaled) {
+				BasicVideoSpec::write_stream_texture(m_live_renderer,
+					m_target_texture, m_stream_texture);
+			} else if (std::exchange(m_target_stale, false) || options != m_scaler_options) {
+				m_scaler_options = options;
+				const auto base_frame = frame.metadata.get_base_frame();
+				BasicVideoSpec::write_scaled_texture(m_target_texture,
+					frame.data(), base_frame.w, base_frame.h, options);
+			}
 
 			ImGui::SetCursorPos(layout_data.origin_point + ImGui::floor(
 				(layout_data.avail_region - layout_data.margins_region) * 0.5f));
@@ -153,8 +222,11 @@ private:
 			ImGui::SetCursorPos(layout_data.origin_point + ImGui::floor(
 				(layout_data.avail_region - layout_data.texture_region) * 0.5f));
 
+			// the CPU scaler already blended the tint into the pixels
+			const auto image_A = cpu_scaled ? RGBA::Opaque_A : layout_data->texture_tint.A;
+
 			ImGui::DrawRotatedImage(m_target_texture, layout_data.texture_region, *m_screen_rotation,
-				uv0, uv1, RGBA(0xFF, 0xFF, 0xFF, layout_data->texture_tint.A).ABGR());
+				uv0, uv1, RGBA(0xFF, 0xFF, 0xFF, image_A).ABGR());
 		}
 	}
 	void render_borders_region(const DisplayLayout& layout_data) const noexcept {
@@ -226,20 +298,24 @@ public:
 
 		sync_renderer_change();
 
+		PROFILE_ZONE("swapchain_present");
 		m_swapchain.present([&](auto frame) noexcept {
 			if constexpr (frame.dirty) {
-				BasicVideoSpec::write_stream_texture(m_live_renderer,
-					m_stream_texture, frame.buffer.data());
+				if (!m_software_path) {
+					BasicVideoSpec::write_stream_texture(m_live_renderer,
+						m_stream_texture, frame.buffer.data());
+				}
+				m_target_stale = true;
 			}
 
 			m_borderless_view = m_borderless_view_input
 				? *m_borderless_view_input : m_borderless_view;
 
-			const auto metadata_view = m_staging_data.view();
-			const auto layout_data = DisplayLayout(metadata_view->debug_mode
-				? *metadata_view : frame.buffer.metadata, this);
+			const auto metadata_copy = m_staging_data.copy();
+			const auto layout_data = DisplayLayout(metadata_copy.debug_mode
+				? metadata_copy : frame.buffer.metadata, this);
 
-			render_texture_region(layout_data);
+			render_texture_region(layout_data, frame.buffer);
 			render_borders_region(layout_data);
 
 			render_osd_callable(layout_data);
@@ -252,8 +328,85 @@ public:
 		EndChild();
 		PopID();
 	}
+	void capture_frame(const FramePacket& frame) noexcept {
+		if (m_is_checksumming.load(mo::relaxed)) { checksum_frame(frame); }
+
+		if (!m_is_recording.load(mo::relaxed)) { return; }
+		if (const auto recorder = m_recorder.load(mo::acquire)) { recorder->submit(frame); }
+	}
+
+	void checksum_frame(const FramePacket& frame) noexcept {
+		const auto base_w   = frame.metadata.get_base_frame().w;
+		const auto viewport = frame.metadata.get_viewport();
+
+		// only the visible rows are hashed, padding outside the viewport is not part of the image
+		const auto* src = reinterpret_cast<const u8*>(frame.data());
+		u32 crc = 0;
+		for (s32 y = 0; y < viewport.h; ++y) {
+			crc = deflate_codec::crc32({ src + (std::size_t(viewport.y + y) * base_w
+				+ viewport.x) * sizeof(u32), std::size_t(viewport.w) * sizeof(u32) }, crc);
+		}
+
+		m_frame_checksum.edit([&](auto& checksum) noexcept {
+			checksum = { viewport.w, viewport.h, crc, checksum.count + 1 };
+		});
+	}
+
+	bool start_recording(FrameRecorder::Format format) noexcept {
+		if (m_capture_directory.empty() || m_is_recording.load(mo::relaxed)) { return false; }
+
+		const auto output_path = fs::Path(m_capture_directory) / fmt::format("{}__{}", m_capture_name_hint,
+			NanoTime(Millis::initial_wall() + Millis::raw_wall()).format_as_datetime("{:%Y-%m-%d__%H-%M-%S}"));
+
+		// captures share the screen's filter and effects, but never its tint
+		auto options = make_scaler_options(RGBA::White);
+		options.filter = options.filter == pixel_scaler::Filter::SHARP_BILINEAR
+			? pixel_scaler::Filter::NEAREST : options.filter;
+
+		const auto frame = m_staging_data.copy().get_base_frame();
+		auto recorder = std::make_shared<FrameRecorder>(output_path.string(), format,
+			frame.w, frame.h, u32(*m_capture_scale), options);
+		if (!recorder->valid()) { return false; }
+
+		m_recorder.store(std::move(recorder), mo::release);
+		m_is_recording.store(true, mo::relaxed);
+		return true;
+	}
+
+	void stop_recording() noexcept {
+		m_is_recording.store(false, mo::relaxed);
+		if (const auto recorder = m_recorder.exchange(nullptr, mo::acq_rel)) {
+			// drain here, so the producer never ends up joining the encoder
+			recorder->finish();
+			blog.info("Recording stopped: {} frames written, {} dropped",
+				recorder->get_written_count(), recorder->get_dropped_count());
+		}
+	}
+
+	void render_recording_menu() noexcept {
+		using Format = FrameRecorder::Format;
+
+		if (const auto recorder = m_recorder.load(mo::acquire)) {
+			if (ImGui::MenuItem("Stop Recording")) { stop_recording(); }
+			ImGui::TextDisabled("Written: %llu | Dropped: %llu",
+				static_cast<unsigned long long>(recorder->get_written_count()),
+				static_cast<unsigned long long>(recorder->get_dropped_count()));
+		} else {
+			const bool can_record = !m_capture_directory.empty();
+			ImGui::SliderInt("Capture Scale", &*m_capture_scale,
+				m_capture_scale.min,
+				m_capture_scale.max,
+				"%dx", ImGuiSliderFlags_AlwaysClamp
+			);
+			if (ImGui::MenuItem("Record PNG Sequence", nullptr, false, can_record)) { start_recording(Format::PNG); }
+			if (ImGui::MenuItem("Record Y4M Video",    nullptr, false, can_record)) { start_recording(Format::Y4M); }
+		}
+		ImGui::Separator();
+	}
+
 	void render_settings_menu() noexcept {
 		if (!ImGui::BeginMenu("Display Settings")) { return; }
+		render_recording_menu();
 		m_staging_data.edit([&](auto& meta) noexcept {
 			ImGui::SliderInt("Border Width", &*meta.border_width,
 				meta.border_width.min,
@@ -312,6 +465,21 @@ public:
 			static const char* rotation_labels[] = { "0 degrees", "90 degrees", "180 degrees", "270 degrees" };
 			ImGui::Combo("Screen Rotation", &*m_screen_rotation, rotation_labels, 4);
 
+			static const char* filter_labels[] = { "Nearest", "Sharp Bilinear", "Edge Smooth" };
+			ImGui::Combo("Screen Filter", &*m_screen_filter, filter_labels, 3);
+
+			ImGui::SliderInt("Scanlines", &*m_scanlines_strength,
+				m_scanlines_strength.min,
+				m_scanlines_strength.max,
+				"%d%%", ImGuiSliderFlags_AlwaysClamp
+			);
+
+			ImGui::SliderInt("Pixel Grid", &*m_grid_strength,
+				m_grid_strength.min,
+				m_grid_strength.max,
+				"%d%%", ImGuiSliderFlags_AlwaysClamp
+			);
+
 			int enable_screen = meta.enabled ? 1 : 0;
 			if (ImGui::SliderInt("Screen Enabled?", &enable_screen,
 				0, 1, "", ImGuiSliderFlags_NoInput
@@ -370,8 +538,8 @@ DisplayDevice& DisplayDevice::operator=(DisplayDevice&&) noexcept = default;
 auto DisplayDevice::swapchain() /***/ noexcept -> /***/ Swapchain& { return m_context->m_swapchain; }
 auto DisplayDevice::swapchain() const noexcept -> const Swapchain& { return m_context->m_swapchain; }
 
-auto DisplayDevice::metadata() /***/ noexcept -> /***/ AtomicBox<Metadata>& { return m_context->m_staging_data; }
-auto DisplayDevice::metadata() const noexcept -> const AtomicBox<Metadata>& { return m_context->m_staging_data; }
+auto DisplayDevice::metadata() /***/ noexcept -> /***/ SeqLockBox<Metadata>& { return m_context->m_staging_data; }
+auto DisplayDevice::metadata() const noexcept -> const SeqLockBox<Metadata>& { return m_context->m_staging_data; }
 
 /*==================================================================*/
 
@@ -416,6 +584,48 @@ void DisplayDevice::set_osd_callable(Callable callable) noexcept {
 		std::move(callable)), std::memory_order::relaxed);
 }
 
+/*==================================================================*/
+
+void DisplayDevice::capture_frame(const FramePacket& frame) noexcept {
+	m_context->capture_frame(frame);
+}
+
+void DisplayDevice::set_capture_directory(std::string_view directory, std::string_view name_hint) noexcept {
+	m_context->m_capture_directory = directory;
+	m_context->m_capture_name_hint = name_hint;
+
+	const auto format = DisplayContext::s_autostart_capture.load(mo::relaxed);
+	if (format != FrameRecorder::Format::NONE) { m_context->start_recording(format); }
+}
+
+void DisplayDevice::set_autostart_capture(FrameRecorder::Format format) noexcept {
+	DisplayContext::s_autostart_capture.store(format, mo::relaxed);
+}
+
+bool DisplayDevice::start_recording(FrameRecorder::Format format) noexcept {
+	return m_context->start_recording(format);
+}
+
+void DisplayDevice::stop_recording() noexcept {
+	m_context->stop_recording();
+}
+
+bool DisplayDevice::is_recording() const noexcept {
+	return m_context->m_is_recording.load(mo::relaxed);
+}
+
+/*==================================================================*/
+
+void DisplayDevice::set_frame_checksums(bool enable) noexcept {
+	m_context->m_is_checksumming.store(enable, mo::relaxed);
+}
+
+auto DisplayDevice::get_frame_checksum() const noexcept -> FrameChecksum {
+	return m_context->m_frame_checksum.copy();
+}
+
+/*==================================================================*/
+
 void DisplayDevice::render_display() noexcept {
 	m_context->render_display();
 }
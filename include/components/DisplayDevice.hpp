@@ -8,9 +8,10 @@
 
 #include <functional>
 
-#include "AtomicBox.hpp"
+#include "SeqLockBox.hpp"
 #include "FramePacket.hpp"
 #include "TripleBuffer.hpp"
+#include "FrameRecorder.hpp"
 
 /*==================================================================*/
 
@@ -34,14 +35,30 @@ public:
 	auto swapchain() /***/ noexcept -> /***/ Swapchain&;
 	auto swapchain() const noexcept -> const Swapchain&;
 
+	/**
+	 * @brief Fills the swapchain's writer buffer via callable, then hands the
+	 *        finished frame to the active recorder (if any) before it is published.
+	 *        Cores should prefer this over 'swapchain().acquire()'.
+	 */
+	template <typename Fn> requires (std::is_invocable_v<Fn, FramePacket&>)
+	void present(Fn&& callable) noexcept(std::is_nothrow_invocable_v<Fn, FramePacket&>) {
+		swapchain().acquire([&](FramePacket& frame) noexcept(std::is_nothrow_invocable_v<Fn, FramePacket&>) {
+			callable(frame);
+			capture_frame(frame);
+		});
+	}
+
+private:
+	void capture_frame(const FramePacket& frame) noexcept;
+
 public:
 	/**
 	 * @brief Staging area for metadata, serving both as persistent storage,
 	 *        as well as for writing to the swapchain's internal metadata
 	 *        instance to propagate state changes per acquire() call.
 	**/
-	auto metadata() /***/ noexcept -> /***/ AtomicBox<Metadata>&;
-	auto metadata() const noexcept -> const AtomicBox<Metadata>&;
+	auto metadata() /***/ noexcept -> /***/ SeqLockBox<Metadata>&;
+	auto metadata() const noexcept -> const SeqLockBox<Metadata>&;
 
 public:
 	DisplayDevice(std::size_t W, std::size_t H,
@@ -68,6 +85,36 @@ public:
 
 	void set_osd_callable(Callable callable) noexcept;
 
+	/**
+	 * @brief Sets where recordings are written, named '<name_hint>__<date>'.
+	 *        Starts recording right away if an autostart format was set.
+	 */
+	void set_capture_directory(std::string_view directory, std::string_view name_hint) noexcept;
+
+	// Format to start recording in as soon as a capture directory is set, NONE to disable.
+	static void set_autostart_capture(FrameRecorder::Format format) noexcept;
+
+	bool start_recording(FrameRecorder::Format format) noexcept;
+	void stop_recording() noexcept;
+	bool is_recording() const noexcept;
+
+public:
+	struct FrameChecksum {
+		s32 w{}, h{}; // visible area the checksum covers
+		u32 crc{};    // CRC-32 of the visible pixels, row by row
+		u32 count{};  // frames checksummed so far
+
+		// frames are only comparable at equal size, 'count' is not part of the comparison
+		bool matches(const FrameChecksum& other) const noexcept {
+			return w == other.w && h == other.h && crc == other.crc;
+		}
+	};
+
+	// Checksums the visible area of every frame presented from now on, for headless comparisons.
+	void set_frame_checksums(bool enable) noexcept;
+	FrameChecksum get_frame_checksum() const noexcept;
+
+public:
 	void render_display() noexcept;
 	void render_settings_menu() noexcept;
 };
@@ -6,10 +6,16 @@
 
 #include "FileImage.hpp"
 
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
-#include <thread>
+
+#include "Thread.hpp"
 
 #include "mio/mmap.hpp"
+#include <atomic_queue/atomic_queue.h>
 
 /*==================================================================*/
 
@@ -17,21 +23,155 @@ struct FileImage::Context {
 	std::string      file_path{};
 	mio::mmap_source file_mmap{};
 
+	// owned contents of images that were decoded rather than mapped
+	std::vector<std::uint8_t>
+		file_data{};
+	bool in_memory{};
+
+	std::filesystem::file_time_type
+		write_time{};
+
 	Context() noexcept = default;
 	Context(std::string file) noexcept
 		: file_path(std::move(file))
 	{
 		std::error_code error;
-		file_mmap.map(file_path, error);
+		write_time = std::filesystem::last_write_time(file_path, error);
+		if (!error) { file_mmap.map(file_path, error); }
 		if (error) { file_path.clear(); }
 	}
+
+	Context(std::string name, std::vector<std::uint8_t> data) noexcept
+		: file_path(std::move(name))
+		, file_data(std::move(data))
+		, in_memory(true)
+	{}
+
+	auto data() const noexcept -> const char* {
+		return in_memory ? reinterpret_cast<const char*>(file_data.data()) : file_mmap.data();
+	}
+	auto size() const noexcept -> std::size_t {
+		return in_memory ? file_data.size() : file_mmap.size();
+	}
+	bool is_loaded() const noexcept {
+		return in_memory || file_mmap.is_mapped();
+	}
+
+	// true if the file on disk still looks like what was mapped
+	bool is_current() const noexcept {
+		std::error_code error;
+		const auto time = std::filesystem::last_write_time(file_path, error);
+		if (error || time != write_time) { return false; }
+		const auto size = std::filesystem::file_size(file_path, error);
+		return !error && size == file_mmap.size();
+	}
 };
 
-void FileImage::replace_context(std::unique_ptr<Context> new_ctx) noexcept {
-	if (m_context && m_context->file_mmap.size() >= async_threshold) {
-		// sacrificial thread to unmap the source so we don't block
-		std::thread([ctx = std::move(m_context)]() mutable {}).detach();
+/*==================================================================*/
+
+// set once the reclaimer is torn down, late releases unmap in place instead
+static constinit std::atomic_bool s_reclaimer_closed{ false };
+
+/**
+ * Single long-lived thread that unmaps large mappings handed to it through a
+ * lock-free queue, so dropping an image never blocks on the unmap itself.
+ * Started on first use, drained and joined during static destruction.
+ */
+struct FileImage::Reclaimer {
+	atomic_queue::AtomicQueue<const Context*, 64>
+		m_queue{};
+
+	// bumped on every push, the thread sleeps on it while the queue is empty
+	std::atomic<std::uint32_t>
+		m_pushes{};
+
+	Thread m_thread;
+
+	Reclaimer() noexcept
+		: m_thread([this](StopToken token) noexcept { reclaim_loop(token); })
+	{}
+
+	~Reclaimer() noexcept {
+		s_reclaimer_closed.store(true, std::memory_order::release);
+		m_thread.request_stop();
+		m_pushes.fetch_add(1, std::memory_order::release);
+		m_pushes.notify_one();
+		if (m_thread.joinable()) { m_thread.join(); }
+		drain_queue();
+	}
+
+	void drain_queue() noexcept {
+		const Context* ctx{};
+		while (m_queue.try_pop(ctx)) { delete ctx; }
 	}
+
+	void reclaim_loop(StopToken token) noexcept {
+		while (!token.stop_requested()) {
+			// sample before draining, a push that lands after the drain
+			// changes the counter and the wait falls through at once
+			const auto pushes = m_pushes.load(std::memory_order::acquire);
+			drain_queue();
+			m_pushes.wait(pushes, std::memory_order::acquire);
+		}
+	}
+
+	bool push(const Context* ctx) noexcept {
+		if (!m_queue.try_push(ctx)) { return false; }
+		m_pushes.fetch_add(1, std::memory_order::release);
+		m_pushes.notify_one();
+		return true;
+	}
+
+	static Reclaimer& get() noexcept {
+		static Reclaimer s_reclaimer;
+		return s_reclaimer;
+	}
+};
+
+/*==================================================================*/
+
+void FileImage::release_context(const Context* ctx) noexcept {
+	if (ctx->size() >= async_threshold
+		&& !s_reclaimer_closed.load(std::memory_order::acquire)
+		&& Reclaimer::get().push(ctx)
+	) { return; }
+
+	// small mapping, or the queue is full: unmap right here
+	delete ctx;
+}
+
+auto FileImage::acquire_context(std::string file) noexcept
+	-> std::shared_ptr<const Context>
+{
+	struct SharedMappings {
+		std::mutex lock;
+		std::unordered_map<std::string,
+			std::weak_ptr<const Context>> entries;
+	};
+
+	static SharedMappings s_mappings;
+
+	try {
+		std::scoped_lock lock(s_mappings.lock);
+		std::erase_if(s_mappings.entries, [](const auto& entry) noexcept
+			{ return entry.second.expired(); });
+
+		auto& entry = s_mappings.entries[file];
+		if (auto shared = entry.lock(); shared && shared->is_current()) {
+			return shared;
+		}
+
+		std::shared_ptr<const Context> new_ctx(
+			new Context(std::move(file)), release_context);
+
+		if (new_ctx->file_mmap.is_mapped()) { entry = new_ctx; }
+		return new_ctx;
+	}
+	catch (...) { return std::make_shared<const Context>(); }
+}
+
+void FileImage::replace_context(std::shared_ptr<const Context> new_ctx) noexcept {
+	// the last reference going away hands the mapping to release_context()
 	m_context = std::move(new_ctx);
 }
 
@@ -43,16 +183,24 @@ FileImage::FileImage() noexcept
 {}
 
 FileImage::FileImage(std::string file) noexcept
-	: m_context(std::make_unique<Context>(std::move(file)))
+	: m_context(acquire_context(std::move(file)))
 {}
 
+FileImage::FileImage(std::string name, std::vector<std::uint8_t> data) noexcept {
+	try {
+		m_context = std::shared_ptr<const Context>(
+			new Context(std::move(name), std::move(data)), release_context);
+	}
+	catch (...) { m_context = nullptr; }
+}
+
 FileImage::FileImage(const FileImage& other) noexcept
-	: m_context(std::make_unique<Context>(other.m_context->file_path))
+	: m_context(other.m_context)
 {}
 
 FileImage& FileImage::operator=(const FileImage& other) noexcept {
 	if (this != &other) {
-		load(other.path());
+		replace_context(other.m_context);
 	}
 	return *this;
 }
@@ -79,11 +227,11 @@ auto FileImage::span() const noexcept -> std::span<const char> {
 }
 
 auto FileImage::data() const noexcept -> const char* {
-	return m_context ? m_context->file_mmap.data() : nullptr;
+	return m_context ? m_context->data() : nullptr;
 }
 
 auto FileImage::size() const noexcept -> std::size_t {
-	return m_context ? m_context->file_mmap.size() : std::size_t();
+	return m_context ? m_context->size() : std::size_t();
 }
 
 auto FileImage::path() const noexcept -> std::string {
@@ -92,9 +240,9 @@ auto FileImage::path() const noexcept -> std::string {
 
 bool FileImage::load(std::string file) noexcept {
 	if (!m_context || m_context->file_path != file) {
-		replace_context(std::make_unique<Context>(std::move(file)));
+		replace_context(acquire_context(std::move(file)));
 	}
-	return m_context->file_mmap.is_mapped();
+	return m_context->is_loaded();
 }
 
 void FileImage::clear() noexcept {
@@ -102,5 +250,5 @@ void FileImage::clear() noexcept {
 }
 
 bool FileImage::valid() const noexcept {
-	return m_context && m_context->file_mmap.is_mapped();
+	return m_context && m_context->is_loaded();
 }
@@ -8,23 +8,39 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <span>
 
 /*==================================================================*/
 
+/**
+ * @brief Read-only memory mapping of a file. Mappings are shared: copies, and
+ *        any other image loaded from the same unchanged file, refer to the one
+ *        mapping, which is unmapped once the last image lets go of it.
+ *
+ * An image may also own a buffer instead, for data that was decoded rather than
+ * mapped (such as an archive entry). Its path is then only a name for it.
+ */
 class FileImage {
 	struct Context;
+	struct Reclaimer;
 
-	std::unique_ptr<Context>
+	std::shared_ptr<const Context>
 		m_context{};
 
-	void replace_context(std::unique_ptr<Context> new_ctx) noexcept;
+	static auto acquire_context(std::string file) noexcept
+		-> std::shared_ptr<const Context>;
+	static void release_context(const Context* ctx) noexcept;
+
+	void replace_context(std::shared_ptr<const Context> new_ctx) noexcept;
 
 public:
 	~FileImage() noexcept;
 	FileImage() noexcept;
 
 	FileImage(std::string file) noexcept;
+	FileImage(std::string name, std::vector<std::uint8_t> data) noexcept;
 
 	FileImage(const FileImage&) noexcept;
 	FileImage& operator=(const FileImage&) noexcept;
@@ -33,7 +49,7 @@ public:
 	FileImage& operator=(FileImage&& other) noexcept;
 
 public:
-	// Threshold at which we spawn a detached thread to unmap
+	// Mappings at least this large are unmapped on the reclaimer thread
 	static constexpr auto async_threshold = 32ull * 1024 * 1024;
 
 	static auto page_size() noexcept -> std::size_t;
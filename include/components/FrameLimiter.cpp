@@ -10,16 +10,48 @@
 
 #include "FrameLimiter.hpp"
 #include "RelaxCPU.hpp"
+#include "ZoneProfiler.hpp"
 
 /*==================================================================*/
 
 static constexpr auto c_millis = std::chrono::milliseconds(1);
 
-// 99.5% of 1ms sleeps measure below this value
-static constexpr auto c_spin_threshold = 2.3f;
+// bounds for the calibrated spin threshold, in millis
+static constexpr auto c_spin_threshold_min = 1.0f;
+static constexpr auto c_spin_threshold_max = 8.0f;
+
+// amount of new sleep samples between spin threshold recalibrations
+static constexpr auto c_calibration_pace = 64;
 
 static auto current_time() noexcept { return std::chrono::steady_clock::now(); }
 
+static float elapsed_millis(std::chrono::steady_clock::time_point since) noexcept {
+	return std::chrono::duration<float, std::milli>(::current_time() - since).count();
+}
+
+template <typename Histogram>
+static float spin_threshold_from(const Histogram& histogram) noexcept {
+	return std::clamp(histogram.percentile(0.99f),
+		c_spin_threshold_min, c_spin_threshold_max);
+}
+
+// Samples the host's 1ms sleep once per process, as a starting point
+// for every limiter until it has gathered enough samples of its own.
+static float get_initial_spin_threshold() noexcept {
+	static const auto s_initial_threshold = []() noexcept {
+		LatencyHistogram<320, 25> histogram;
+
+		for (auto i = 0; i < 32; ++i) {
+			const auto sleep_begin = ::current_time();
+			std::this_thread::sleep_for(c_millis);
+			histogram.add(::elapsed_millis(sleep_begin));
+		}
+
+		return ::spin_threshold_from(histogram);
+	}();
+	return s_initial_threshold;
+}
+
 /*==================================================================*/
 
 void FrameLimiter::set_limiter_props(float framerate) noexcept {
@@ -31,6 +63,8 @@ void FrameLimiter::set_limiter_props(float framerate, bool force_initial_pass, b
 	m_force_initial_pass = force_initial_pass;
 	m_force_skip_periods = force_skip_periods;
 	m_missed_last_period = false;
+	m_missed_period_count = 0;
+	m_jitter_histogram.clear();
 }
 
 /*==================================================================*/
@@ -38,12 +72,17 @@ void FrameLimiter::set_limiter_props(float framerate, bool force_initial_pass, b
 bool FrameLimiter::is_frame_ready(bool lazy) noexcept {
 	if (has_target_period_elapsed()) { return true; }
 
-	if ((lazy && m_target_time_period >= c_spin_threshold) \
-		|| (get_period_remaining() >= c_spin_threshold))
+	if (m_spin_threshold <= 0.0f) [[unlikely]]
+		{ m_spin_threshold = ::get_initial_spin_threshold(); }
+
+	if ((lazy && m_target_time_period >= m_spin_threshold) \
+		|| (get_period_remaining() >= m_spin_threshold))
 	{
-		std::this_thread::sleep_for(c_millis);
+		PROFILE_ZONE("limiter_sleep");
+		sleep_and_calibrate();
 		return false;
 	} else {
+		PROFILE_ZONE("limiter_spin");
 		for (auto i = 0; ++i <= 128;) { ::cpu_relax(); }
 		std::this_thread::yield();
 		return false;
@@ -54,6 +93,19 @@ bool FrameLimiter::is_frame_ready_no_block() noexcept {
 	return has_target_period_elapsed();
 }
 
+float FrameLimiter::get_host_spin_threshold() noexcept {
+	return ::get_initial_spin_threshold();
+}
+
+void FrameLimiter::sleep_and_calibrate() noexcept {
+	const auto sleep_begin = ::current_time();
+	std::this_thread::sleep_for(c_millis);
+	m_sleep_histogram.add(::elapsed_millis(sleep_begin));
+
+	if (++m_sleep_sample_count % c_calibration_pace == 0)
+		{ m_spin_threshold = ::spin_threshold_from(m_sleep_histogram); }
+}
+
 /*==================================================================*/
 
 bool FrameLimiter::has_target_period_elapsed() noexcept {
@@ -76,6 +128,10 @@ bool FrameLimiter::has_target_period_elapsed() noexcept {
 	if (m_time_elapsed_since < m_target_time_period)
 		[[likely]] { return false; }
 
+	const auto period_lateness = m_time_elapsed_since - m_target_time_period;
+	m_jitter_histogram.add(period_lateness);
+	m_missed_period_count += period_lateness >= m_target_time_period * 0.5f;
+
 	if (m_force_skip_periods) {
 		m_missed_last_period = m_time_elapsed_since >= m_target_time_period + 0.050f;
 		m_time_yield_accrued = std::fmod(m_time_elapsed_since, m_target_time_period);
@@ -91,6 +147,13 @@ bool FrameLimiter::has_target_period_elapsed() noexcept {
 
 /*==================================================================*/
 
+auto FrameLimiter::get_next_deadline() const noexcept -> chrono {
+	if (!m_new_init_completed || m_force_initial_pass) { return {}; }
+
+	return m_last_period_origin + std::chrono::duration_cast<std::chrono::steady_clock::duration>
+		(std::chrono::duration<float, std::milli>(m_target_time_period - m_time_yield_accrued));
+}
+
 float FrameLimiter::get_elapsed_millis_since() const noexcept {
 	return std::chrono::duration_cast<std::chrono::microseconds>
 		(::current_time() - m_last_period_origin).count() / 1e3f
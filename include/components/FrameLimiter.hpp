@@ -8,6 +8,8 @@
 
 #include <chrono>
 
+#include "LatencyHistogram.hpp"
+
 /*==================================================================*/
 
 class FrameLimiter final {
@@ -25,9 +27,17 @@ class FrameLimiter final {
 
 	chrono m_last_period_origin{}; // Stores the actual timestamp of the last valid limiter check.
 	sint64 m_valid_period_count{}; // Counts the total amount of valid limiter checks. Does not include skipped frames, if any.
+	sint64 m_missed_period_count{}; // Counts the valid limiter checks that started over half a period past their deadline.
+
+	float  m_spin_threshold{}; // Remaining period time (millis) below which we spin instead of sleep. Calibrated from the p99 of observed 1ms sleeps.
+	sint64 m_sleep_sample_count{}; // Counts the sleeps measured so far, used to pace spin threshold recalibration.
+
+	LatencyHistogram<320, 25> m_sleep_histogram{};  // Actual durations of the 1ms sleeps this limiter performed, 0..8ms.
+	LatencyHistogram<256, 50> m_jitter_histogram{}; // Lateness of each valid limiter check relative to its ideal deadline, 0..12.8ms.
 
 private:
 	bool has_target_period_elapsed() noexcept;
+	void sleep_and_calibrate() noexcept;
 
 /*==================================================================*/
 
@@ -56,6 +66,9 @@ public:
 	// Check if a new frame is ready, without blocking the thread.
 	bool is_frame_ready_no_block() noexcept;
 
+	// Returns the spin threshold measured from the host's 1ms sleeps, shared by the process.
+	static float get_host_spin_threshold() noexcept;
+
 /*==================================================================*/
 
 	// These getters are snapshot-based off the last valid limiter check!
@@ -66,6 +79,12 @@ public:
 	auto get_target_time_period() const noexcept { return m_target_time_period; }
 	auto get_time_yield_accrued() const noexcept { return m_time_yield_accrued; }
 
+	auto get_missed_period_count() const noexcept { return m_missed_period_count; }
+	auto get_spin_threshold()      const noexcept { return m_spin_threshold; }
+
+	const auto& get_sleep_histogram()  const noexcept { return m_sleep_histogram; }
+	const auto& get_jitter_histogram() const noexcept { return m_jitter_histogram; }
+
 	// These getters calculate live values based on current time!
 public:
 	// Get elapsed time in millis since the last period boundary
@@ -73,6 +92,9 @@ public:
 	// Get elapsed time in micros since the last period boundary
 	float get_elapsed_micros_since() const noexcept;
 
+	// Get the timestamp of the next period boundary
+	chrono get_next_deadline() const noexcept;
+
 	// Get remaining time in millis until the next period boundary
 	float get_period_remaining() const noexcept { return m_target_time_period - get_elapsed_millis_since(); }
 	// Get the fraction of the current period that has elapsed, in range of [0..1]
@@ -153,8 +153,9 @@ struct FramePacket {
 private:
 	static constexpr auto MAX_ALIGN = ::HDIS;
 
+	// first written by the producing thread, which then also owns the pages
 	AlignedUniqueArray
-		<value_type, MAX_ALIGN> m_buffer;
+		<value_type, MAX_ALIGN, AllocPolicy::FIRST_TOUCH> m_buffer;
 
 public:
 	Metadata metadata;
@@ -171,7 +172,7 @@ private:
 
 public:
 	FramePacket(std::size_t W, std::size_t H, std::size_t bpp = sizeof(RGBA)) noexcept
-		: m_buffer(::allocate_n<value_type, MAX_ALIGN>(W * H * bpp).as_value().release())
+		: m_buffer(::allocate_n<value_type, MAX_ALIGN, AllocPolicy::FIRST_TOUCH>(W * H * bpp).as_value().release())
 		, metadata(static_cast<int>(W), static_cast<int>(H))
 	{}
 
@@ -0,0 +1,360 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "FrameRecorder.hpp"
+#include "FramePacket.hpp"
+#include "SimpleFileIO.hpp"
+#include "ZoneProfiler.hpp"
+#include "BasicLogger.hpp"
+#include "Deflate.hpp"
+#include "Thread.hpp"
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <semaphore>
+
+#include <fmt/format.h>
+
+/*==================================================================*/
+
+struct FrameRecorder::RecorderContext {
+	struct Slot {
+		AlignedUniqueArray<u32> pixels;
+		std::atomic<bool> busy{};
+
+		s32 w{}, h{};
+		f32 framerate{};
+		u64 frame_number{};
+	};
+
+	struct Image {
+		const u32* pixels;
+		s32 w, h;
+	};
+
+	const Format      m_format;
+	const fs::Path    m_output_path;
+	const std::size_t m_slot_capacity;
+
+	const u32                   m_scale;
+	const pixel_scaler::Options m_scaler_options;
+
+	std::unique_ptr<Slot[]> m_slots;
+	std::size_t             m_slot_count{};
+	std::size_t             m_produce_index{}; // producer thread only
+	std::size_t             m_consume_index{}; // encoder thread only
+	u64                     m_frame_number{};  // producer thread only
+
+	std::counting_semaphore<> m_ready{ 0 };
+	std::atomic<bool>         m_accepting{};
+	std::atomic<u64>          m_written{};
+	std::atomic<u64>          m_dropped{};
+
+	bool m_valid{};
+	bool m_failed{};   // encoder thread only, set once on the first I/O error
+
+	// encoder thread scratch, reused across frames
+	std::ofstream   m_y4m_stream;
+	s32             m_y4m_w{}, m_y4m_h{};
+	std::vector<u8> m_raw_data;
+	std::vector<u8> m_out_data;
+	std::vector<u8> m_row_data; // current row, previous row, then one per filter type
+	std::vector<u32> m_scaled_data;
+
+	Thread m_encoder;
+
+public:
+	RecorderContext(std::string_view output_path, Format format,
+		std::size_t max_w, std::size_t max_h, u32 scale,
+		const pixel_scaler::Options& options, std::size_t pool_size) noexcept
+		: m_format(format)
+		, m_output_path(output_path)
+		, m_slot_capacity(max_w * max_h)
+		, m_scale(std::max(scale, 1u))
+		, m_scaler_options(options)
+	{
+		if (format == Format::NONE || !m_slot_capacity || !pool_size) { return; }
+
+		try {
+			m_slots = std::make_unique<Slot[]>(pool_size);
+			for (std::size_t i = 0; i < pool_size; ++i) {
+				m_slots[i].pixels = ::allocate_n<u32, HDIS>(m_slot_capacity).as_value().release();
+				if (!m_slots[i].pixels) { return; }
+			}
+			m_slot_count = pool_size;
+		}
+		catch (...) { return; }
+
+		if (format == Format::PNG) {
+			if (const auto created = fs::create_directories(m_output_path); !created) {
+				blog.error("Unable to create capture directory '{}': {}",
+					m_output_path.string(), created.error().message());
+				return;
+			}
+		}
+
+		m_valid = true;
+		m_accepting.store(true, mo::release);
+
+		m_encoder = Thread([this](StopToken token) noexcept {
+			zone_profiler::set_thread_name("frame_recorder");
+			encoder_loop(token);
+		});
+
+		blog.info("Recording {} capture to '{}'", format == Format::PNG
+			? "PNG" : "Y4M", m_output_path.string());
+	}
+
+private:
+	void encoder_loop(StopToken token) noexcept {
+		using namespace std::chrono_literals;
+
+		for (;;) {
+			if (!m_ready.try_acquire_for(50ms)) {
+				if (token.stop_requested()) { return; } else { continue; }
+			}
+
+			auto& slot = m_slots[m_consume_index];
+			m_consume_index = (m_consume_index + 1) % m_slot_count;
+
+			if (!m_failed) {
+				PROFILE_ZONE("encode_frame");
+				m_failed = !(m_format == Format::PNG ? write_png(slot) : write_y4m(slot));
+				if (m_failed) {
+					blog.error("Frame capture to '{}' failed, further frames are dropped",
+						m_output_path.string());
+				}
+			}
+
+			(m_failed ? m_dropped : m_written).fetch_add(1, mo::relaxed);
+			slot.busy.store(false, mo::release);
+		}
+	}
+
+	/*==================================================================*/
+
+	static void append_be32(std::vector<u8>& out, u32 value) {
+		for (auto shift = 24; shift >= 0; shift -= 8) { out.push_back(u8(value >> shift)); }
+	}
+
+	static void append_chunk(std::vector<u8>& out, const char* type, std::span<const u8> data) {
+		append_be32(out, u32(data.size()));
+		const auto type_offset = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data.begin(), data.end());
+		append_be32(out, deflate_codec::crc32({ out.data() + type_offset, data.size() + 4 }));
+	}
+
+	// Scales the slot's viewport up by the capture factor, or views it as-is at 1x.
+	Image scale_image(const Slot& slot) {
+		if (m_scale == 1) { return { slot.pixels.get(), slot.w, slot.h }; }
+
+		const auto w = slot.w * s32(m_scale);
+		const auto h = slot.h * s32(m_scale);
+		m_scaled_data.resize(std::size_t(w) * h);
+
+		pixel_scaler::scale(slot.pixels.get(), slot.w, slot.w, slot.h,
+			m_scaled_data.data(), w, w, h, m_scaler_options);
+		return { m_scaled_data.data(), w, h };
+	}
+
+	// Filters each RGB row with whichever of None/Sub/Up yields the smallest absolute sum.
+	void filter_rows(const Image& image) {
+		const auto row_bytes = std::size_t(image.w) * 3;
+		m_raw_data.resize((row_bytes + 1) * image.h);
+
+		m_row_data.assign(row_bytes * 5, 0);
+		auto* this_row   = m_row_data.data();
+		auto* prev_row   = this_row + row_bytes;
+		auto* candidates = prev_row + row_bytes;
+
+		for (s32 y = 0; y < image.h; ++y) {
+			const auto* src = image.pixels + std::size_t(y) * image.w;
+			for (s32 x = 0; x < image.w; ++x) {
+				this_row[x * 3 + 0] = u8(src[x] >> 24);
+				this_row[x * 3 + 1] = u8(src[x] >> 16);
+				this_row[x * 3 + 2] = u8(src[x] >>  8);
+			}
+
+			u32 best_sum = ~0u, best_type = 0;
+			for (u32 type = 0; type < 3; ++type) {
+				u32 sum = 0;
+				for (std::size_t i = 0; i < row_bytes; ++i) {
+					const auto left = i >= 3 ? this_row[i - 3] : u8(0);
+					const auto pred = type == 0 ? u8(0) : type == 1 ? left : prev_row[i];
+					const auto diff = u8(this_row[i] - pred);
+					candidates[type * row_bytes + i] = diff;
+					sum += diff < 128 ? diff : 256 - diff;
+				}
+				if (sum < best_sum) { best_sum = sum; best_type = type; }
+			}
+
+			auto* dst = m_raw_data.data() + (row_bytes + 1) * y;
+			dst[0] = u8(best_type);
+			std::copy_n(candidates + best_type * row_bytes, row_bytes, dst + 1);
+			std::swap(prev_row, this_row);
+		}
+	}
+
+	bool write_png(const Slot& slot) noexcept {
+		try {
+			const auto image = scale_image(slot);
+			filter_rows(image);
+
+			m_out_data.clear();
+			static constexpr u8 c_signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			m_out_data.insert(m_out_data.end(), std::begin(c_signature), std::end(c_signature));
+
+			std::vector<u8> header;
+			append_be32(header, u32(image.w));
+			append_be32(header, u32(image.h));
+			header.insert(header.end(), { 8, 2, 0, 0, 0 }); // 8-bit RGB, no interlace
+			append_chunk(m_out_data, "IHDR", header);
+
+			std::vector<u8> compressed;
+			if (!deflate_codec::compress_zlib(m_raw_data, compressed)) { return false; }
+			append_chunk(m_out_data, "IDAT", compressed);
+			append_chunk(m_out_data, "IEND", {});
+
+			const auto file_path = m_output_path / fmt::format("frame_{:06}.png", slot.frame_number);
+			return bool(::write_file_data(file_path, m_out_data));
+		}
+		catch (...) { return false; }
+	}
+
+	/*==================================================================*/
+
+	// BT.601 limited-range RGB to YCbCr, the colorspace Y4M readers assume by default.
+	static constexpr u8 to_Y (s32 R, s32 G, s32 B) noexcept { return u8((( 66 * R + 129 * G +  25 * B + 128) >> 8) +  16); }
+	static constexpr u8 to_Cb(s32 R, s32 G, s32 B) noexcept { return u8(((-38 * R -  74 * G + 112 * B + 128) >> 8) + 128); }
+	static constexpr u8 to_Cr(s32 R, s32 G, s32 B) noexcept { return u8(((112 * R -  94 * G -  18 * B + 128) >> 8) + 128); }
+
+	bool write_y4m(const Slot& slot) noexcept {
+		try {
+			const auto image = scale_image(slot);
+
+			if (!m_y4m_stream.is_open()) {
+				auto file_path = m_output_path;
+				file_path += ".y4m";
+
+				m_y4m_stream.open(file_path, std::ios::binary | std::ios::out | std::ios::trunc);
+				if (!m_y4m_stream) { return false; }
+
+				m_y4m_w = image.w; m_y4m_h = image.h;
+				m_y4m_stream << fmt::format("YUV4MPEG2 W{} H{} F{}:1000 Ip A1:1 C444\n",
+					m_y4m_w, m_y4m_h, u32(std::lround(slot.framerate * 1000.0f)));
+			}
+
+			// the stream's size is fixed, later viewports are cropped or padded in black
+			const auto plane_size = std::size_t(m_y4m_w) * m_y4m_h;
+			m_out_data.assign(plane_size * 3, 0);
+			std::fill_n(m_out_data.begin(), plane_size, u8(16));
+			std::fill_n(m_out_data.begin() + plane_size, plane_size * 2, u8(128));
+
+			const auto copy_w = std::min(image.w, m_y4m_w);
+			const auto copy_h = std::min(image.h, m_y4m_h);
+
+			for (s32 y = 0; y < copy_h; ++y) {
+				const auto* src = image.pixels + std::size_t(y) * image.w;
+				auto* dst_Y  = m_out_data.data() + std::size_t(y) * m_y4m_w;
+				auto* dst_Cb = dst_Y + plane_size;
+				auto* dst_Cr = dst_Cb + plane_size;
+
+				for (s32 x = 0; x < copy_w; ++x) {
+					const s32 R = u8(src[x] >> 24), G = u8(src[x] >> 16), B = u8(src[x] >> 8);
+					dst_Y [x] = to_Y (R, G, B);
+					dst_Cb[x] = to_Cb(R, G, B);
+					dst_Cr[x] = to_Cr(R, G, B);
+				}
+			}
+
+			m_y4m_stream.write("FRAME\n", 6);
+			m_y4m_stream.write(reinterpret_cast<const char*>(m_out_data.data()), std::streamsize(m_out_data.size()));
+			return bool(m_y4m_stream);
+		}
+		catch (...) { return false; }
+	}
+
+	/*==================================================================*/
+
+public:
+	void submit(const FramePacket& frame) noexcept {
+		if (!m_accepting.load(mo::acquire)) { return; }
+
+		const auto frame_number = m_frame_number++;
+		auto& slot = m_slots[m_produce_index];
+
+		if (slot.busy.load(mo::acquire)) {
+			m_dropped.fetch_add(1, mo::relaxed);
+			return;
+		}
+
+		const auto base_w   = frame.metadata.get_base_frame().w;
+		const auto viewport = frame.metadata.get_viewport();
+
+		slot.w = viewport.w;
+		slot.h = std::min<s32>(viewport.h, s32(m_slot_capacity / viewport.w));
+		slot.framerate    = frame.metadata.refresh_rate;
+		slot.frame_number = frame_number;
+
+		const auto* src = reinterpret_cast<const u32*>(frame.data());
+		for (s32 y = 0; y < slot.h; ++y) {
+			std::memcpy(slot.pixels.get() + std::size_t(y) * slot.w,
+				src + std::size_t(viewport.y + y) * base_w + viewport.x,
+				std::size_t(slot.w) * sizeof(u32));
+		}
+
+		slot.busy.store(true, mo::release);
+		m_produce_index = (m_produce_index + 1) % m_slot_count;
+		m_ready.release();
+	}
+
+	void finish() noexcept {
+		m_accepting.store(false, mo::release);
+		if (m_encoder.joinable()) {
+			m_encoder.request_stop();
+			m_encoder.join();
+		}
+		if (m_y4m_stream.is_open()) { m_y4m_stream.close(); }
+	}
+};
+
+/*==================================================================*/
+
+FrameRecorder::FrameRecorder(std::string_view output_path, Format format,
+	std::size_t max_w, std::size_t max_h, std::uint32_t scale,
+	const pixel_scaler::Options& options, std::size_t pool_size) noexcept
+	: m_context(std::make_unique<RecorderContext>(output_path, format,
+		max_w, max_h, scale, options, pool_size))
+{}
+
+FrameRecorder::~FrameRecorder() noexcept {
+	finish();
+}
+
+bool FrameRecorder::valid() const noexcept {
+	return m_context->m_valid;
+}
+
+void FrameRecorder::submit(const FramePacket& frame) noexcept {
+	PROFILE_ZONE("recorder_submit");
+	m_context->submit(frame);
+}
+
+void FrameRecorder::finish() noexcept {
+	m_context->finish();
+}
+
+u64 FrameRecorder::get_written_count() const noexcept {
+	return m_context->m_written.load(mo::relaxed);
+}
+
+u64 FrameRecorder::get_dropped_count() const noexcept {
+	return m_context->m_dropped.load(mo::relaxed);
+}
@@ -0,0 +1,75 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <string_view>
+
+#include "PixelScaler.hpp"
+
+/*==================================================================*/
+
+struct FramePacket;
+
+/**
+ * @brief Asynchronous capture of finished frames to disk.
+ *
+ * 'submit()' copies the viewport of a frame into one of a fixed pool of
+ * buffers and returns immediately; an encoder thread drains the pool in
+ * order and writes either a numbered PNG sequence or a single Y4M stream.
+ * If every buffer is still queued for encoding, the frame is dropped and
+ * counted instead -- the submitting thread never waits on the encoder.
+ */
+class FrameRecorder {
+	struct RecorderContext;
+	std::unique_ptr<RecorderContext> m_context;
+
+public:
+	enum class Format : std::uint8_t {
+		NONE, // not a valid recording format, used as "disabled" by callers
+		PNG,  // <output_path>/frame_000000.png, one file per frame
+		Y4M,  // <output_path>.y4m, uncompressed 4:4:4, fixed to the first frame's viewport
+	};
+
+	/**
+	 * @brief Prepares the buffer pool and starts the encoder thread.
+	 * @param[in] output_path :: Directory (PNG) or file path without extension (Y4M).
+	 * @param[in] format      :: Output format, see Format.
+	 * @param[in] max_w/max_h :: Largest frame that will be submitted, sizes the pool.
+	 * @param[in] scale       :: Integer factor frames are scaled by before encoding.
+	 * @param[in] options     :: Filter and effects to scale with, see pixel_scaler.
+	 * @param[in] pool_size   :: Number of frames that may be queued before dropping.
+	 */
+	FrameRecorder(std::string_view output_path, Format format,
+		std::size_t max_w, std::size_t max_h, std::uint32_t scale = 1,
+		const pixel_scaler::Options& options = {}, std::size_t pool_size = 16) noexcept;
+
+	~FrameRecorder() noexcept;
+
+	FrameRecorder(const FrameRecorder&) = delete;
+	FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+public:
+	// False if the output could not be opened or the pool could not be allocated.
+	bool valid() const noexcept;
+
+	/**
+	 * @brief Queues a copy of the frame's viewport for encoding, or drops it.
+	 * @warning Must only be called from a single producer thread.
+	 */
+	void submit(const FramePacket& frame) noexcept;
+
+	/**
+	 * @brief Stops accepting frames, encodes whatever is queued and joins the
+	 *        encoder thread. Called by the destructor if not called before.
+	 */
+	void finish() noexcept;
+
+	std::uint64_t get_written_count() const noexcept;
+	std::uint64_t get_dropped_count() const noexcept;
+};
@@ -0,0 +1,80 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+/*==================================================================*/
+
+/**
+ * @brief A fixed-bin, single-owner histogram of durations in milliseconds.
+ * @tparam N        :: Amount of bins. The last bin also collects all overflow samples.
+ * @tparam BinMicro :: Width of each bin in microseconds.
+ * @tparam DecayAt  :: Once this many samples are held, all bins are halved, so
+ *                     older samples fade out and percentiles track recent behavior.
+ * @warning Not thread-safe, intended to be owned and written by a single thread.
+ * @code{.cpp}
+ *   LatencyHistogram<256, 50> jitter; // 0..12.8ms in 50us steps
+ *   jitter.add(0.42f);
+ *   auto p99 = jitter.percentile(0.99f);
+ * @endcode
+ */
+template <std::size_t N, std::size_t BinMicro, std::uint32_t DecayAt = 4096>
+	requires (N >= 2 && BinMicro > 0 && DecayAt >= 2)
+class LatencyHistogram {
+	std::array<std::uint32_t, N> m_bins{};
+
+	std::uint32_t m_total_count{};
+	float         m_max_millis{};
+
+public:
+	static constexpr float bin_millis = BinMicro / 1000.0f;
+	static constexpr float max_millis = bin_millis * N;
+
+	void clear() noexcept {
+		m_bins.fill(0);
+		m_total_count = 0;
+		m_max_millis  = 0.0f;
+	}
+
+	void add(float millis) noexcept {
+		const auto index = millis <= 0.0f ? std::size_t(0)
+			: std::min(std::size_t(millis / bin_millis), N - 1);
+
+		++m_bins[index];
+		m_max_millis = std::max(m_max_millis, millis);
+
+		if (++m_total_count >= DecayAt) {
+			m_total_count = 0;
+			for (auto& bin : m_bins) { m_total_count += (bin >>= 1); }
+			m_max_millis = std::min(m_max_millis, percentile(1.0f));
+		}
+	}
+
+	auto size()  const noexcept { return m_total_count; }
+	bool empty() const noexcept { return m_total_count == 0; }
+	auto max()   const noexcept { return m_max_millis; }
+
+	// Returns the upper edge of the bin containing the given fraction [0..1] of samples.
+	float percentile(float fraction) const noexcept {
+		if (empty()) { return 0.0f; }
+
+		const auto target = std::uint32_t(std::clamp(fraction, 0.0f, 1.0f)
+			* float(m_total_count - 1)) + 1;
+
+		std::uint32_t accumulated = 0;
+		for (std::size_t i = 0; i < N; ++i) {
+			accumulated += m_bins[i];
+			if (accumulated >= target) { return bin_millis * float(i + 1); }
+		}
+		return max_millis;
+	}
+
+	const auto& bins() const noexcept { return m_bins; }
+};
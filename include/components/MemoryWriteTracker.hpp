@@ -0,0 +1,94 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <bit>
+#include <algorithm>
+
+#include "EzMaths.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief Per-block write generation counters over a system's memory, bumped by
+ *        the emulation thread's write paths and polled by viewers to find out
+ *        which parts of memory need to be read and reformatted again.
+ *
+ * Each 64-byte block owns a counter that only ever grows, so the sum over the
+ * blocks of a range changes whenever anything inside the range was written.
+ * A single thread is expected to write; readers may poll from any thread.
+ */
+class MemoryWriteTracker {
+	using counter_type = std::atomic<u32>;
+
+	std::unique_ptr<counter_type[]>
+		m_blocks{};
+
+	std::size_t m_block_count{};
+	std::size_t m_address_mask{};
+
+public:
+	static constexpr u32 c_block_shift = 6;
+	static constexpr u32 c_block_size  = 1u << c_block_shift;
+
+	MemoryWriteTracker() noexcept = default;
+
+	MemoryWriteTracker(const MemoryWriteTracker&)            = delete;
+	MemoryWriteTracker& operator=(const MemoryWriteTracker&) = delete;
+
+	// (Re)sizes the counters to cover 'memory_size' bytes. Addresses are mirrored.
+	void resize(std::size_t memory_size) noexcept {
+		const auto mirror_size = std::bit_ceil(std::max<std::size_t>(memory_size, c_block_size));
+
+		m_block_count  = mirror_size >> c_block_shift;
+		m_address_mask = mirror_size - 1;
+		m_blocks = std::make_unique<counter_type[]>(m_block_count);
+	}
+
+	bool valid() const noexcept { return m_block_count != 0; }
+
+/*==================================================================*/
+
+	// Notes a write to a single byte. Writer thread only.
+	void mark(std::size_t addr) noexcept {
+		if (!m_block_count) { return; }
+		auto& block = m_blocks[(addr & m_address_mask) >> c_block_shift];
+		block.store(block.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+	}
+
+	// Notes a write to 'size' consecutive bytes. Writer thread only.
+	void mark(std::size_t addr, std::size_t size) noexcept {
+		if (!m_block_count || !size) { return; }
+		const auto last = (addr + size - 1) >> c_block_shift;
+		for (auto block = addr >> c_block_shift; block <= last; ++block) {
+			mark(block << c_block_shift);
+		}
+	}
+
+	// Notes a write to the entire memory, e.g. after a reset or load.
+	void mark_all() noexcept {
+		for (std::size_t i = 0; i < m_block_count; ++i) {
+			m_blocks[i].store(m_blocks[i].load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+		}
+	}
+
+/*==================================================================*/
+
+	// Returns a value that changes whenever a byte in the given range is written.
+	u64 get_range_generation(std::size_t addr, std::size_t size) const noexcept {
+		if (!m_block_count || !size) { return 0; }
+
+		u64 generation = 0;
+		const auto last = (addr + size - 1) >> c_block_shift;
+		for (auto block = addr >> c_block_shift; block <= last; ++block) {
+			generation += m_blocks[block & (m_block_count - 1)].load(std::memory_order::relaxed);
+		}
+		return generation;
+	}
+};
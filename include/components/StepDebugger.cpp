@@ -0,0 +1,221 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "StepDebugger.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/*==================================================================*/
+
+void StepDebugger::set_memory_range(const void* data, std::size_t size) noexcept {
+	std::scoped_lock lock(m_control_lock);
+
+	m_memory_data = static_cast<const u8*>(data);
+	m_memory_size = size;
+
+	m_breakpoint_bits = std::make_unique<std::atomic<u64>[]>((size + 63) / 64);
+	for (const auto addr : m_breakpoint_list) {
+		if (addr < size) { m_breakpoint_bits[addr >> 6] |= 1ull << (addr & 63); }
+	}
+	m_watch_generation.fetch_add(1, std::memory_order::release);
+}
+
+void StepDebugger::update_arm_flag(u32 flag, bool state) noexcept {
+	if (state) { m_arm_flags.fetch_or(flag, std::memory_order::relaxed); }
+	else       { m_arm_flags.fetch_and(~flag, std::memory_order::relaxed); }
+}
+
+/*==================================================================*/
+
+void StepDebugger::add_breakpoint(u32 addr) noexcept {
+	std::scoped_lock lock(m_control_lock);
+	if (addr >= m_memory_size || has_breakpoint(addr)) { return; }
+
+	try { m_breakpoint_list.push_back(addr); }
+	catch (...) { return; }
+
+	m_breakpoint_bits[addr >> 6].fetch_or(1ull << (addr & 63), std::memory_order::relaxed);
+	update_arm_flag(ARM_BREAKPOINTS, true);
+}
+
+void StepDebugger::remove_breakpoint(u32 addr) noexcept {
+	std::scoped_lock lock(m_control_lock);
+	if (!has_breakpoint(addr)) { return; }
+
+	std::erase(m_breakpoint_list, addr);
+	m_breakpoint_bits[addr >> 6].fetch_and(~(1ull << (addr & 63)), std::memory_order::relaxed);
+	update_arm_flag(ARM_BREAKPOINTS, !m_breakpoint_list.empty());
+}
+
+void StepDebugger::clear_breakpoints() noexcept {
+	std::scoped_lock lock(m_control_lock);
+
+	for (const auto addr : m_breakpoint_list) {
+		m_breakpoint_bits[addr >> 6].store(0, std::memory_order::relaxed);
+	}
+	m_breakpoint_list.clear();
+	update_arm_flag(ARM_BREAKPOINTS, false);
+}
+
+bool StepDebugger::has_breakpoint(u32 addr) const noexcept {
+	return addr < m_memory_size && (m_breakpoint_bits[addr >> 6]
+		.load(std::memory_order::relaxed) >> (addr & 63) & 1);
+}
+
+auto StepDebugger::get_breakpoints() const noexcept -> std::vector<u32> {
+	std::scoped_lock lock(m_control_lock);
+	try { return m_breakpoint_list; }
+	catch (...) { return {}; }
+}
+
+/*==================================================================*/
+
+void StepDebugger::add_watchpoint(Watchpoint watch) noexcept {
+	std::scoped_lock lock(m_control_lock);
+	if (watch.addr >= m_memory_size || !watch.flags) { return; }
+
+	watch.size = std::clamp<u32>(watch.size, 1, c_max_watch_size);
+	watch.size = u32(std::min<std::size_t>(watch.size, m_memory_size - watch.addr));
+
+	try { m_watchpoint_list.push_back(watch); }
+	catch (...) { return; }
+
+	m_watch_generation.fetch_add(1, std::memory_order::release);
+	update_arm_flag(ARM_WATCHPOINTS, true);
+}
+
+void StepDebugger::remove_watchpoint(std::size_t index) noexcept {
+	std::scoped_lock lock(m_control_lock);
+	if (index >= m_watchpoint_list.size()) { return; }
+
+	m_watchpoint_list.erase(m_watchpoint_list.begin() + index);
+	m_watch_generation.fetch_add(1, std::memory_order::release);
+	update_arm_flag(ARM_WATCHPOINTS, !m_watchpoint_list.empty());
+}
+
+void StepDebugger::clear_watchpoints() noexcept {
+	std::scoped_lock lock(m_control_lock);
+
+	m_watchpoint_list.clear();
+	m_watch_generation.fetch_add(1, std::memory_order::release);
+	update_arm_flag(ARM_WATCHPOINTS, false);
+}
+
+auto StepDebugger::get_watchpoints() const noexcept -> std::vector<Watchpoint> {
+	std::scoped_lock lock(m_control_lock);
+	try { return m_watchpoint_list; }
+	catch (...) { return {}; }
+}
+
+/*==================================================================*/
+
+void StepDebugger::request_steps(u32 count) noexcept {
+	m_pending_steps.store(count, std::memory_order::relaxed);
+	update_arm_flag(ARM_STEPS, count != 0);
+}
+
+void StepDebugger::request_run_to(u32 addr) noexcept {
+	m_run_to_pc.store(addr, std::memory_order::relaxed);
+	update_arm_flag(ARM_RUN_TO, true);
+}
+
+void StepDebugger::request_step_frame() noexcept {
+	m_step_frame.store(true, std::memory_order::release);
+}
+
+/*==================================================================*/
+
+void StepDebugger::refresh_watch_cache() noexcept {
+	std::scoped_lock lock(m_control_lock);
+
+	try {
+		m_watch_cache = m_watchpoint_list;
+		m_watch_values.clear();
+		for (const auto& watch : m_watch_cache) {
+			m_watch_values.insert(m_watch_values.end(),
+				m_memory_data + watch.addr, m_memory_data + watch.addr + watch.size);
+		}
+	} catch (...) {
+		m_watch_cache.clear();
+		m_watch_values.clear();
+	}
+}
+
+u32 StepDebugger::begin_slice() noexcept {
+	const auto generation = m_watch_generation.load(std::memory_order::acquire);
+	if (m_cached_generation != generation) {
+		m_cached_generation = generation;
+		refresh_watch_cache();
+	}
+
+	m_is_mid_frame = false;
+	return std::exchange(m_resume_cycle, 0);
+}
+
+void StepDebugger::stop(Reason reason, u32 pc, u32 addr, u32 cycle) noexcept {
+	// a stop ahead of an instruction must not re-trigger when resuming on it
+	m_skip_next_check = reason == Reason::BREAKPOINT || reason == Reason::RUN_TO;
+	m_resume_cycle = cycle;
+	m_is_mid_frame = true;
+	m_has_stopped  = true;
+
+	m_pending_steps.store(0, std::memory_order::relaxed);
+	update_arm_flag(ARM_STEPS, false);
+
+	m_last_break.edit([&](auto& info) noexcept {
+		info = { reason, pc, addr };
+	});
+}
+
+bool StepDebugger::break_after(u32 pc, u32 cycle) noexcept {
+	const auto read_addr = std::exchange(m_read_addr, 0);
+	const auto read_size = std::exchange(m_read_size, 0);
+
+	auto* values = m_watch_values.data();
+	for (const auto& watch : m_watch_cache) {
+		auto* current = m_memory_data + watch.addr;
+
+		if (watch.flags & WATCH_WRITE) {
+			if (std::memcmp(values, current, watch.size)) {
+				std::memcpy(values, current, watch.size);
+				stop(Reason::WATCH_WRITE, pc, watch.addr, cycle);
+				return true;
+			}
+		}
+		if (watch.flags & WATCH_READ && read_size) {
+			if (read_addr < watch.addr + watch.size && watch.addr < read_addr + read_size) {
+				stop(Reason::WATCH_READ, pc, watch.addr, cycle);
+				return true;
+			}
+		}
+		values += watch.size;
+	}
+
+	if (m_arm_flags.load(std::memory_order::relaxed) & ARM_STEPS) {
+		if (m_pending_steps.fetch_sub(1, std::memory_order::relaxed) <= 1) {
+			stop(Reason::STEP, pc, pc, cycle);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool StepDebugger::consume_break() noexcept {
+	if (!std::exchange(m_has_stopped, false)) { return false; }
+	m_step_frame.store(false, std::memory_order::relaxed);
+	return true;
+}
+
+void StepDebugger::reset_frame_state() noexcept {
+	m_resume_cycle    = 0;
+	m_read_addr       = 0;
+	m_read_size       = 0;
+	m_is_mid_frame    = false;
+	m_has_stopped     = false;
+	m_skip_next_check = false;
+	m_cached_generation = ~m_watch_generation.load(std::memory_order::acquire);
+}
@@ -0,0 +1,196 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "EzMaths.hpp"
+#include "SeqLockBox.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief Execution control shared between the UI and a system's emulation thread:
+ *        instruction/frame stepping, run-to, PC breakpoints and memory watchpoints.
+ *
+ * Cores keep two instantiations of their instruction loop. The plain one never
+ * touches this class; the debug one calls 'break_before()' ahead of each fetch and
+ * 'break_after()' behind each instruction, and is only selected for frames where
+ * 'is_armed()' holds or a previous break left the frame half-finished.
+ *
+ * Breakpoints live in a per-address bitmap so the hot check is a single load.
+ * Watchpoints are edited under a lock by the UI and mirrored into a private copy
+ * by the emulation thread whenever their generation changes.
+ */
+class StepDebugger final {
+public:
+	enum class Reason : u8 {
+		NONE,       // not stopped since the last reset
+		STEP,       // requested instruction step count was reached
+		BREAKPOINT, // PC breakpoint hit, instruction not yet executed
+		RUN_TO,     // run-to address reached, instruction not yet executed
+		WATCH_READ, // instruction read from a watched range
+		WATCH_WRITE,// instruction changed a value in a watched range
+	};
+
+	enum WatchFlags : u8 {
+		WATCH_READ  = 0x1,
+		WATCH_WRITE = 0x2,
+	};
+
+	struct Watchpoint {
+		u32 addr;
+		u32 size;
+		u8  flags;
+	};
+
+	struct BreakInfo {
+		Reason reason{};
+		u32    pc{};   // program counter of the next instruction to execute
+		u32    addr{}; // breakpoint or watched address that caused the stop
+	};
+
+	static constexpr u32 c_max_watch_size = 256;
+
+private:
+	enum ArmFlags : u32 {
+		ARM_BREAKPOINTS = 0x1,
+		ARM_WATCHPOINTS = 0x2,
+		ARM_STEPS       = 0x4,
+		ARM_RUN_TO      = 0x8,
+	};
+
+	const u8*   m_memory_data{};
+	std::size_t m_memory_size{};
+
+	std::unique_ptr<std::atomic<u64>[]>
+		m_breakpoint_bits{};
+
+	std::atomic<u32> m_arm_flags{};
+	std::atomic<u32> m_pending_steps{};
+	std::atomic<u32> m_run_to_pc{};
+	std::atomic<u32> m_watch_generation{};
+	std::atomic<bool> m_step_frame{};
+
+	mutable std::mutex m_control_lock;
+	std::vector<u32>        m_breakpoint_list{};
+	std::vector<Watchpoint> m_watchpoint_list{};
+
+	SeqLockBox<BreakInfo> m_last_break{};
+
+	// emulation thread only
+	std::vector<Watchpoint> m_watch_cache{};
+	std::vector<u8>         m_watch_values{};
+	u32  m_cached_generation{};
+	u32  m_read_addr{};
+	u32  m_read_size{};
+	u32  m_resume_cycle{};
+	bool m_is_mid_frame{};
+	bool m_has_stopped{};
+	bool m_skip_next_check{};
+
+private:
+	void refresh_watch_cache() noexcept;
+	void stop(Reason reason, u32 pc, u32 addr, u32 cycle) noexcept;
+	void update_arm_flag(u32 flag, bool state) noexcept;
+
+public:
+	StepDebugger() noexcept = default;
+
+	StepDebugger(const StepDebugger&)            = delete;
+	StepDebugger& operator=(const StepDebugger&) = delete;
+
+	/**
+	 * @brief Sizes the breakpoint bitmap and binds the memory watched for writes.
+	 * @warning Call before the emulation thread starts, e.g. in 'initialize_system()'.
+	 */
+	void set_memory_range(const void* data, std::size_t size) noexcept;
+
+	// Whether any breakpoint, watchpoint, step or run-to request is pending.
+	bool is_armed() const noexcept { return m_arm_flags.load(std::memory_order::relaxed); }
+
+/*==================================================================*/
+
+public:
+	void add_breakpoint(u32 addr) noexcept;
+	void remove_breakpoint(u32 addr) noexcept;
+	void clear_breakpoints() noexcept;
+	bool has_breakpoint(u32 addr) const noexcept;
+	auto get_breakpoints() const noexcept -> std::vector<u32>;
+
+	void add_watchpoint(Watchpoint watch) noexcept;
+	void remove_watchpoint(std::size_t index) noexcept;
+	void clear_watchpoints() noexcept;
+	auto get_watchpoints() const noexcept -> std::vector<Watchpoint>;
+
+	// Stops again after the given amount of instructions has executed.
+	void request_steps(u32 count) noexcept;
+	// Stops before the instruction at the given address executes.
+	void request_run_to(u32 addr) noexcept;
+	// Stops again once the current (or next) frame has completed.
+	void request_step_frame() noexcept;
+
+	BreakInfo get_last_break() const noexcept { return m_last_break.copy(); }
+
+/*==================================================================*/
+
+public:
+	/**
+	 * @brief Refreshes the watchpoint copy and returns the cycle at which a frame
+	 *        interrupted by a previous stop should resume, or 0 for a fresh loop.
+	 */
+	u32  begin_slice() noexcept;
+
+	// Checks breakpoints and run-to ahead of fetching the instruction at 'pc'.
+	bool break_before(u32 pc, u32 cycle) noexcept {
+		if (m_skip_next_check) [[unlikely]] {
+			m_skip_next_check = false;
+			return false;
+		}
+		if (pc < m_memory_size && (m_breakpoint_bits[pc >> 6]
+			.load(std::memory_order::relaxed) >> (pc & 63) & 1)) [[unlikely]]
+		{
+			stop(Reason::BREAKPOINT, pc, pc, cycle);
+			return true;
+		}
+		if ((m_arm_flags.load(std::memory_order::relaxed) & ARM_RUN_TO)
+			&& m_run_to_pc.load(std::memory_order::relaxed) == pc) [[unlikely]]
+		{
+			update_arm_flag(ARM_RUN_TO, false);
+			stop(Reason::RUN_TO, pc, pc, cycle);
+			return true;
+		}
+		return false;
+	}
+
+	// Records the data range read by the instruction about to execute.
+	void note_read(u32 addr, u32 size) noexcept {
+		m_read_addr = addr;
+		m_read_size = size;
+	}
+
+	/**
+	 * @brief Checks watchpoints and the step count after an instruction executed.
+	 * @param[in] pc    :: Program counter of the next instruction.
+	 * @param[in] cycle :: Cycle index to resume from if this returns true.
+	 */
+	bool break_after(u32 pc, u32 cycle) noexcept;
+
+	// Whether the last stop interrupted a frame that has not completed yet.
+	bool is_mid_frame() const noexcept { return m_is_mid_frame; }
+
+	// Returns whether a stop occurred since the last call.
+	bool consume_break() noexcept;
+	// Returns whether a frame step was requested, clearing the request.
+	bool consume_step_frame() noexcept { return m_step_frame.exchange(false, std::memory_order::acq_rel); }
+
+	// Forgets any half-finished frame, used on system reset.
+	void reset_frame_state() noexcept;
+};
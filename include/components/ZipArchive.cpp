@@ -0,0 +1,257 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ZipArchive.hpp"
+#include "Deflate.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+/*==================================================================*/
+
+namespace {
+	using u8  = std::uint8_t;
+	using u16 = std::uint16_t;
+	using u32 = std::uint32_t;
+	using u64 = std::uint64_t;
+
+	constexpr u32 c_local_header_sig   = 0x04034B50;
+	constexpr u32 c_central_header_sig = 0x02014B50;
+	constexpr u32 c_end_record_sig     = 0x06054B50;
+	constexpr u32 c_zip64_locator_sig  = 0x07064B50;
+	constexpr u32 c_zip64_record_sig   = 0x06064B50;
+
+	constexpr std::size_t c_local_header_size   = 30;
+	constexpr std::size_t c_central_header_size = 46;
+	constexpr std::size_t c_end_record_size     = 22;
+	constexpr std::size_t c_zip64_locator_size  = 20;
+	constexpr std::size_t c_zip64_record_size   = 56;
+
+	constexpr std::size_t c_max_comment_size = 0xFFFF;
+
+	// Bounds-checked little-endian reads, any read past the end yields zero.
+	class ByteView {
+		std::span<const u8> m_data;
+
+	public:
+		explicit ByteView(std::span<const u8> data) noexcept : m_data(data) {}
+
+		bool has(u64 offset, u64 size) const noexcept {
+			return offset <= m_data.size() && size <= m_data.size() - offset;
+		}
+
+		template <typename T>
+		T read(u64 offset) const noexcept {
+			if (!has(offset, sizeof(T))) { return T{}; }
+			T value{};
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+				{ value |= T(T(m_data[offset + i]) << (8 * i)); }
+			return value;
+		}
+
+		auto bytes(u64 offset, u64 size) const noexcept -> std::span<const u8> {
+			return has(offset, size) ? m_data.subspan(offset, size) : std::span<const u8>{};
+		}
+	};
+
+	char to_lower_ascii(char c) noexcept {
+		return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+	}
+
+	bool ends_with_zip(std::string_view str) noexcept {
+		static constexpr std::string_view c_extension = ".zip";
+		return str.size() > c_extension.size()
+			&& std::equal(c_extension.begin(), c_extension.end(),
+				str.end() - c_extension.size(), [](char lhs, char rhs) noexcept
+					{ return lhs == to_lower_ascii(rhs); });
+	}
+
+	bool is_file(std::string_view path) noexcept {
+		std::error_code error;
+		try { return std::filesystem::is_regular_file(std::filesystem::path(path), error); }
+		catch (...) { return false; }
+	}
+}
+
+/*==================================================================*/
+
+bool ZipArchive::open(std::string file) noexcept {
+	m_entries.clear();
+	if (!m_file_image.load(std::move(file))) { return false; }
+	if (parse_central_directory()) { return true; }
+
+	m_entries.clear();
+	m_file_image.clear();
+	return false;
+}
+
+bool ZipArchive::parse_central_directory() noexcept {
+	const auto span = m_file_image.span();
+	const ByteView view({ reinterpret_cast<const u8*>(span.data()), span.size() });
+
+	if (span.size() < c_end_record_size) { return false; }
+
+	// the end record sits behind a comment of up to 64 KiB, scan back for it
+	u64 end_offset = span.size() - c_end_record_size;
+	const u64 scan_limit = end_offset > c_max_comment_size ? end_offset - c_max_comment_size : 0;
+	while (view.read<u32>(end_offset) != c_end_record_sig) {
+		if (end_offset == scan_limit) { return false; }
+		--end_offset;
+	}
+
+	u64 entry_count  = view.read<u16>(end_offset + 10);
+	u64 directory_size   = view.read<u32>(end_offset + 12);
+	u64 directory_offset = view.read<u32>(end_offset + 16);
+
+	if (entry_count == 0xFFFF || directory_size == 0xFFFFFFFF || directory_offset == 0xFFFFFFFF) {
+		if (end_offset < c_zip64_locator_size) { return false; }
+		const auto locator = end_offset - c_zip64_locator_size;
+		if (view.read<u32>(locator) != c_zip64_locator_sig) { return false; }
+
+		const auto record = view.read<u64>(locator + 8);
+		if (!view.has(record, c_zip64_record_size)) { return false; }
+		if (view.read<u32>(record) != c_zip64_record_sig) { return false; }
+
+		entry_count      = view.read<u64>(record + 32);
+		directory_size   = view.read<u64>(record + 40);
+		directory_offset = view.read<u64>(record + 48);
+	}
+
+	if (!view.has(directory_offset, directory_size)) { return false; }
+	// each entry takes at least a header, don't trust the count any further
+	if (entry_count > directory_size / c_central_header_size) { return false; }
+
+	try {
+		m_entries.reserve(std::size_t(entry_count));
+
+		for (u64 offset = directory_offset, i = 0; i < entry_count; ++i) {
+			if (!view.has(offset, c_central_header_size)) { return false; }
+			if (view.read<u32>(offset) != c_central_header_sig) { return false; }
+
+			const u16 name_size    = view.read<u16>(offset + 28);
+			const u16 extra_size   = view.read<u16>(offset + 30);
+			const u16 comment_size = view.read<u16>(offset + 32);
+
+			const auto name_offset  = offset + c_central_header_size;
+			const auto extra_offset = name_offset + name_size;
+			if (!view.has(name_offset, name_size + extra_size + comment_size)) { return false; }
+
+			Entry entry;
+			entry.flags             = view.read<u16>(offset + 8);
+			entry.method            = view.read<u16>(offset + 10);
+			entry.crc32             = view.read<u32>(offset + 16);
+			entry.compressed_size   = view.read<u32>(offset + 20);
+			entry.uncompressed_size = view.read<u32>(offset + 24);
+			entry.header_offset     = view.read<u32>(offset + 42);
+
+			// the ZIP64 extra field holds only those sizes that overflowed, in order
+			for (u64 field = extra_offset; field + 4 <= extra_offset + extra_size;) {
+				const u16 field_id   = view.read<u16>(field);
+				const u16 field_size = view.read<u16>(field + 2);
+				auto data = field + 4;
+				field = data + field_size;
+
+				if (field_id != 0x0001) { continue; }
+				if (entry.uncompressed_size == 0xFFFFFFFF && data + 8 <= field)
+					{ entry.uncompressed_size = view.read<u64>(data); data += 8; }
+				if (entry.compressed_size == 0xFFFFFFFF && data + 8 <= field)
+					{ entry.compressed_size = view.read<u64>(data); data += 8; }
+				if (entry.header_offset == 0xFFFFFFFF && data + 8 <= field)
+					{ entry.header_offset = view.read<u64>(data); }
+			}
+
+			const auto name = view.bytes(name_offset, name_size);
+			entry.name.assign(reinterpret_cast<const char*>(name.data()), name.size());
+			offset = extra_offset + extra_size + comment_size;
+
+			if (entry.name.empty() || entry.name.back() == '/') { continue; }
+			m_entries.push_back(std::move(entry));
+		}
+	}
+	catch (...) { return false; }
+
+	return true;
+}
+
+/*==================================================================*/
+
+auto ZipArchive::find(std::string_view name) const noexcept -> std::size_t {
+	return std::size_t(std::find_if(m_entries.begin(), m_entries.end(),
+		[&](const Entry& entry) noexcept { return entry.name == name; })
+			- m_entries.begin());
+}
+
+bool ZipArchive::extract(const Entry& entry, std::vector<u8>& output) const noexcept {
+	output.clear();
+	if (!entry.is_supported()) { return false; }
+
+	const auto span = m_file_image.span();
+	const ByteView view({ reinterpret_cast<const u8*>(span.data()), span.size() });
+
+	// the local header repeats the name and may carry a different extra field
+	const auto header = entry.header_offset;
+	if (!view.has(header, c_local_header_size)) { return false; }
+	if (view.read<u32>(header) != c_local_header_sig) { return false; }
+
+	const auto data_offset = header + c_local_header_size
+		+ view.read<u16>(header + 26) + view.read<u16>(header + 28);
+	const auto data = view.bytes(data_offset, entry.compressed_size);
+	if (data.size() != entry.compressed_size) { return false; }
+	if (entry.uncompressed_size > deflate_codec::max_inflated_size(data.size())) { return false; }
+
+	try {
+		if (entry.method == 0) {
+			if (entry.compressed_size != entry.uncompressed_size) { return false; }
+			output.assign(data.begin(), data.end());
+		}
+		else if (!deflate_codec::decompress_raw(data, output, std::size_t(entry.uncompressed_size))
+			|| output.size() != entry.uncompressed_size
+		) {
+			output.clear();
+			return false;
+		}
+	}
+	catch (...) { output.clear(); return false; }
+
+	if (deflate_codec::crc32(output) != entry.crc32) {
+		output.clear();
+		return false;
+	}
+	return true;
+}
+
+auto ZipArchive::load_entry(std::size_t index) const noexcept -> FileImage {
+	if (index >= m_entries.size()) { return {}; }
+	const auto& entry = m_entries[index];
+
+	std::vector<u8> contents;
+	if (!extract(entry, contents)) { return {}; }
+
+	try { return FileImage(path() + '/' + entry.name, std::move(contents)); }
+	catch (...) { return {}; }
+}
+
+/*==================================================================*/
+
+bool ZipArchive::is_archive(std::string_view file_path) noexcept {
+	return ::ends_with_zip(file_path);
+}
+
+auto ZipArchive::split_entry_path(std::string_view file_path) noexcept
+	-> std::pair<std::string_view, std::string_view>
+{
+	for (std::size_t pos = 0; pos < file_path.size(); ++pos) {
+		if (file_path[pos] != '/' && file_path[pos] != '\\') { continue; }
+
+		// a directory merely named like an archive is just part of the path
+		const auto archive = file_path.substr(0, pos);
+		if (::ends_with_zip(archive) && pos + 1 < file_path.size() && ::is_file(archive)) {
+			return { archive, file_path.substr(pos + 1) };
+		}
+	}
+	return {};
+}
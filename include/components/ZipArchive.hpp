@@ -0,0 +1,95 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <string_view>
+
+#include "FileImage.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief Read-only view of a ZIP archive, mapped through FileImage. Opening it
+ *        only parses the central directory, entries are decoded on request
+ *        (stored or deflated, ZIP64 included) and handed out as in-memory
+ *        FileImages named '<archive path>/<entry name>', so that the entry's
+ *        own name drives extension matching.
+ *
+ * @note Thread-safe for concurrent extraction once opened.
+ */
+class ZipArchive {
+public:
+	struct Entry {
+		std::string   name{};
+		std::uint64_t compressed_size{};
+		std::uint64_t uncompressed_size{};
+		std::uint64_t header_offset{};
+		std::uint32_t crc32{};
+		std::uint16_t method{};
+		std::uint16_t flags{};
+
+		// no program comes close, so anything larger is a crafted or corrupt entry
+		static constexpr std::uint64_t c_max_size = 64ull << 20;
+
+		// stored or deflated, not encrypted, and within the size cap
+		bool is_supported() const noexcept {
+			return (method == 0 || method == 8) && !(flags & 0x1)
+				&& uncompressed_size <= c_max_size;
+		}
+	};
+
+private:
+	FileImage          m_file_image{};
+	std::vector<Entry> m_entries{};
+
+	bool parse_central_directory() noexcept;
+
+public:
+	ZipArchive() noexcept = default;
+	ZipArchive(std::string file) noexcept { open(std::move(file)); }
+
+	/**
+	 * @brief Maps the archive and reads its central directory. Directories are
+	 *        left out of the entry list.
+	 * @return False if the file can't be mapped or isn't a well-formed archive.
+	 */
+	bool open(std::string file) noexcept;
+
+	auto path()    const noexcept -> std::string { return m_file_image.path(); }
+	auto entries() const noexcept -> std::span<const Entry> { return m_entries; }
+	bool valid()   const noexcept { return m_file_image.valid(); }
+
+	// Index of the entry by exact name, or the entry count if not present.
+	auto find(std::string_view name) const noexcept -> std::size_t;
+
+	/**
+	 * @brief Decodes an entry and verifies its CRC-32.
+	 * @param[out] output :: Receives the entry contents, emptied on failure.
+	 * @return False if unsupported, corrupt or out of memory.
+	 */
+	bool extract(const Entry& entry, std::vector<std::uint8_t>& output) const noexcept;
+
+	// As 'extract()', returning an invalid image on failure.
+	auto load_entry(std::size_t index) const noexcept -> FileImage;
+
+	// True for paths with a '.zip' extension, in any case.
+	static bool is_archive(std::string_view file_path) noexcept;
+
+	/**
+	 * @brief Splits a '<archive>.zip/<entry>' path, as named by 'load_entry()',
+	 *        into the archive path and the entry name. Only prefixes that exist
+	 *        as regular files on disk are taken for archives.
+	 * @return Both empty if the path does not point into an archive.
+	 */
+	static auto split_entry_path(std::string_view file_path) noexcept
+		-> std::pair<std::string_view, std::string_view>;
+};
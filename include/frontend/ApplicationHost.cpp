@@ -11,19 +11,25 @@
 #include "BasicLogger.hpp"
 #include "BasicInput.hpp"
 #include "SHA1.hpp"
+#include "PixelScaler.hpp"
 
 #include "UserInterface.hpp"
 #include "BasicVideoSpec.hpp"
 #include "GlobalAudioBase.hpp"
 #include "HDIS_HCIS.hpp"
 #include "ThreadAffinity.hpp"
+#include "ZoneProfiler.hpp"
+#include "SimpleFileIO.hpp"
+#include "Millis.hpp"
 #include "AtomSharedPtr.hpp"
 #include "SystemDescriptor.hpp"
 #include "SystemStaging.hpp"
+#include "ZipArchive.hpp"
 
 #include "ApplicationHost.hpp"
 #include "ISystemEmu.hpp"
 #include "CoreRegistry.hpp"
+#include "InstanceScheduler.hpp"
 
 /*==================================================================*/
 
@@ -56,14 +62,22 @@ ApplicationHost::ApplicationHost() noexcept {
 	BVS->set_window_title(c_app_name);
 	CoreRegistry::load_game_database();
 
+	HDM->start_file_watcher({
+		{ CoreRegistry::get_game_database_path(), []() noexcept
+			{ CoreRegistry::stage_game_database(); } },
+	});
+
+	if (!s_program_library.start((fs::Path(HDM->get_home_path()) / "library.idx").string())) {
+		blog.warn("Program Library is not available!");
+	}
+
 	setup_gui_callables();
 }
 
 void ApplicationHost::SystemInstance::StopSystemThread::operator()(ISystemEmu* ptr) noexcept {
 	if (ptr) {
 		ptr->stop_worker();
-		ptr->~ISystemEmu();
-		::operator delete(ptr, std::align_val_t(HDIS));
+		CoreRegistry::destroy_core_instance(ptr);
 	}
 }
 
@@ -72,7 +86,11 @@ SettingsMap ApplicationHost::Settings::map() noexcept {
 		::make_setting_link("Frontend.Interface.Scale.Zoom", &ui_zoom_scale),
 		::make_setting_link("Frontend.Interface.Scale.Text", &ui_text_scale),
 		::make_setting_link("Frontend.Display.BorderlessView", &borderless_view_mode),
+		::make_setting_link("Frontend.Emulation.PooledScheduler", &pooled_scheduler),
+		::make_setting_link("Frontend.Emulation.Background.Policy", &background_policy),
+		::make_setting_link("Frontend.Emulation.Background.Framerate", &background_framerate),
 		::make_setting_link("Frontend.Interface.FileMRU", file_mru_cache, s_mru_limit),
+		::make_setting_link("Frontend.Library.Paths", library_paths, s_library_path_limit),
 	};
 }
 
@@ -82,11 +100,45 @@ auto ApplicationHost::export_settings() const noexcept -> Settings {
 	out.ui_zoom_scale = UserInterface::get_ui_zoom_scaling();
 	out.ui_text_scale = UserInterface::get_ui_text_scaling();
 	out.borderless_view_mode = UserInterface::get_borderless_view_mode();
+	out.pooled_scheduler = InstanceScheduler::is_pooled_mode();
+	out.background_policy = int(ISystemEmu::s_default_background_policy.load(mo::relaxed));
+	out.background_framerate = ISystemEmu::s_default_background_framerate.load(mo::relaxed);
 	ApplicationHost::export_mru(out.file_mru_cache);
+	ApplicationHost::export_library_paths(out.library_paths);
 
 	return out;
 }
 
+void ApplicationHost::apply_external_changes() noexcept {
+	if (CoreRegistry::commit_staged_game_database()) {
+		s_program_library.request_rescan(); // titles may have changed
+	}
+
+	if (!HDM->has_staged_config()) { return; }
+
+	auto GAB_settings = GAB->export_settings();
+	auto AUI_settings = export_settings();
+
+	// window geometry/backend and the MRU are owned by the running session, not the file
+	auto AUI_map = AUI_settings.map();
+	AUI_map.erase("Frontend.Interface.FileMRU");
+
+	if (!HDM->apply_config_changes(GAB_settings.map(), AUI_map)) { return; }
+
+	GAB->set_master_volume(GAB_settings.master_volume);
+	GAB->set_background_volume(GAB_settings.background_volume);
+	GAB->is_muted(GAB_settings.all_audio_muted);
+
+	UserInterface::set_ui_zoom_scaling(AUI_settings.ui_zoom_scale);
+	UserInterface::set_ui_text_scaling(AUI_settings.ui_text_scale);
+	UserInterface::set_borderless_view_mode(AUI_settings.borderless_view_mode);
+	InstanceScheduler::set_pooled_mode(AUI_settings.pooled_scheduler);
+	ISystemEmu::s_default_background_policy.store(BackgroundPolicy(std::clamp(
+		AUI_settings.background_policy, 0, int(BackgroundPolicy::COUNT) - 1)), mo::relaxed);
+	ISystemEmu::s_default_background_framerate.store(AUI_settings.background_framerate, mo::relaxed);
+	ApplicationHost::import_library_paths(AUI_settings.library_paths);
+}
+
 /*==================================================================*/
 
 void ApplicationHost::prune_terminated_systems() noexcept {
@@ -140,6 +192,14 @@ void ApplicationHost::insert_system_instance(ISystemEmu* ptr) noexcept {
 /*==================================================================*/
 
 void ApplicationHost::load_file_from_disk(std::string_view file_path) noexcept {
+	auto [archive_path, entry_name] = ZipArchive::split_entry_path(file_path);
+	if (archive_path.empty() && ZipArchive::is_archive(file_path)) { archive_path = file_path; }
+
+	if (!archive_path.empty()) {
+		load_file_from_archive(archive_path, entry_name);
+		return;
+	}
+
 	if (SystemStaging::file_image.load(std::string(file_path))) {
 		if (SystemStaging::file_image.size() == 0) {
 			SystemStaging::file_image.clear();
@@ -153,12 +213,79 @@ void ApplicationHost::load_file_from_disk(std::string_view file_path) noexcept {
 	return;
 }
 
+static auto find_claimed_entry(const ZipArchive& archive) noexcept -> std::size_t {
+	const auto entries = archive.entries();
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		if (!entries[i].is_supported()) { continue; }
+
+		const auto extension = fs::Path(entries[i].name).extension().string();
+		if (!CoreRegistry::get_extension_core_span(extension).empty()) { return i; }
+	}
+	return entries.size();
+}
+
+void ApplicationHost::load_file_from_archive(std::string_view archive_path, std::string_view entry_name) noexcept {
+	SystemStaging::file_image.clear();
+
+	const ZipArchive archive(std::string(archive_path));
+	if (!archive.valid()) {
+		blog.info("Archive rejected: '{}'", archive_path);
+		return;
+	}
+
+	const auto index = entry_name.empty()
+		? ::find_claimed_entry(archive) : archive.find(entry_name);
+
+	if (index >= archive.entries().size()) {
+		if (entry_name.empty()) {
+			blog.info("Archive holds no file claimed by any core: '{}'", archive_path);
+		} else {
+			blog.info("Archive holds no entry '{}': '{}'", entry_name, archive_path);
+		}
+		return;
+	}
+
+	auto file_image = archive.load_entry(index);
+	if (!file_image.valid()) {
+		blog.info("Archive entry rejected: '{}/{}'", archive_path, archive.entries()[index].name);
+		return;
+	}
+	if (file_image.size() == 0) {
+		blog.info("File is empty: '{}'", file_image.path());
+		return;
+	}
+
+	SystemStaging::file_image = std::move(file_image);
+	blog.info("File received: '{}'", SystemStaging::file_image.path());
+}
+
+void ApplicationHost::load_file_from_library(const ProgramLibrary::Record& record) noexcept {
+	if (!ProgramLibrary::is_current(record)) {
+		blog.info("Library entry is outdated, rescanning: '{}'", record.file_path);
+		s_program_library.request_rescan();
+	}
+
+	load_file_from_disk(record.file_path);
+
+	if (SystemStaging::file_image.valid() && ProgramLibrary::is_current(record)
+		&& SystemStaging::file_image.size() == record.file_size
+	) {
+		SystemStaging::sha1_hash = record.file_sha1;
+	}
+}
+
 ApplicationHost* ApplicationHost::init_application(
-	std::string_view game_file_path, bool headless
+	std::string_view game_file_path, bool headless, double trace_window_secs
 ) noexcept {
 	static ApplicationHost* self = nullptr;
 	if (self) { return self; }
 
+	if (trace_window_secs > 0.0) {
+		s_trace_window_secs = trace_window_secs;
+		zone_profiler::set_enabled(true);
+	}
+	zone_profiler::set_thread_name("main");
+
 	HDM = HomeDirManager::get_instance();
 
 	blog.create_log(std::to_string(thread_affinity::get_process_id()),
@@ -166,6 +293,8 @@ ApplicationHost* ApplicationHost::init_application(
 
 	blog.info("SHA1 hardware accelerated path: {}",
 		SHA1::has_hardware_support() ? "ON" : "OFF");
+	blog.info("Pixel scaler kernels: {}",
+		pixel_scaler::get_kernel_name());
 
 	UserInterface::init_context(HDM->get_home_path().c_str());
 
@@ -191,8 +320,13 @@ ApplicationHost* ApplicationHost::init_application(
 	UserInterface::set_ui_zoom_scaling(AUI_settings.ui_zoom_scale);
 	UserInterface::set_ui_text_scaling(AUI_settings.ui_text_scale);
 	UserInterface::set_borderless_view_mode(AUI_settings.borderless_view_mode);
+	InstanceScheduler::set_pooled_mode(AUI_settings.pooled_scheduler);
+	ISystemEmu::s_default_background_policy.store(BackgroundPolicy(std::clamp(
+		AUI_settings.background_policy, 0, int(BackgroundPolicy::COUNT) - 1)), mo::relaxed);
+	ISystemEmu::s_default_background_framerate.store(AUI_settings.background_framerate, mo::relaxed);
 
 	ApplicationHost::import_mru(AUI_settings.file_mru_cache);
+	ApplicationHost::import_library_paths(AUI_settings.library_paths);
 
 	::append_pending_file_drops(game_file_path);
 	thread_affinity::set_affinity(0b11ull);
@@ -202,11 +336,15 @@ ApplicationHost* ApplicationHost::init_application(
 }
 
 void ApplicationHost::quit_application() noexcept {
+	if (zone_profiler::is_enabled()) { dump_trace_to_disk(); }
+
 	UserInterface::quit_video();
 	UserInterface::quit_context();
 
 	m_systems.clear(); // terminate all systems before quitting
 
+	s_program_library.stop();
+	HDM->stop_file_watcher();
 	HDM->write_app_config_file(
 		GAB->export_settings().map(),
 		BVS->export_settings().map(),
@@ -214,6 +352,32 @@ void ApplicationHost::quit_application() noexcept {
 	);
 }
 
+void ApplicationHost::dump_trace_to_disk() noexcept {
+	const auto trace_data = zone_profiler::export_chrome_trace(s_trace_window_secs);
+	if (trace_data.empty()) {
+		blog.warn("Zone profiler has no recorded zones to dump!");
+		return;
+	}
+
+	const auto trace_dir = fs::Path(HDM->get_home_path()) / "traces";
+	if (const auto dir_created = fs::create_directories(trace_dir); !dir_created) {
+		blog.error("Unable to create directory '{}': {}",
+			trace_dir.string(), dir_created.error().message());
+		return;
+	}
+
+	const auto trace_path = trace_dir / NanoTime(Millis::initial_wall() + Millis::raw_wall())
+		.format_as_datetime("trace__{:%Y-%m-%d__%H-%M-%S}.json");
+
+	if (const auto file_written = ::write_file_data(trace_path, trace_data)) {
+		blog.info("Zone profiler trace ({:.1f}s) written to '{}'",
+			s_trace_window_secs, trace_path.string());
+	} else {
+		blog.error("Unable to write trace file '{}': {}",
+			trace_path.string(), file_written.error().message());
+	}
+}
+
 /*==================================================================*/
 
 int ApplicationHost::handle_client_events(void* event) noexcept {
@@ -263,18 +427,13 @@ int ApplicationHost::handle_client_events(void* event) noexcept {
 /*==================================================================*/
 
 int ApplicationHost::process_client_frame() {
+	PROFILE_ZONE("process_client_frame");
+	apply_external_changes();
 	handle_main_hotkeys();
 
-	static auto toggle_system_runtime = [](SystemInstance& system, bool state) noexcept {
-		if (state) {
-			if (system) { system->add_system_state(EmuState::HIDDEN); }
-		} else {
-			if (system) { system->sub_system_state(EmuState::HIDDEN); }
-		}
-	};
-
 	for (auto& [id, system] : m_systems) {
-		toggle_system_runtime(system, id == m_focus_mru.front()
+		if (!system) { continue; }
+		system->set_backgrounded(id == m_focus_mru.front()
 			? s_application_minimized : true);
 	}
 
@@ -302,6 +461,7 @@ void ApplicationHost::handle_main_hotkeys() noexcept {
 
 	if (s_input.is_pressed(KEY(F8))) {
 		CoreRegistry::load_game_database();
+		s_program_library.request_rescan();
 	}
 
 	if (s_input.is_pressed(KEY(F1))) {
@@ -309,6 +469,11 @@ void ApplicationHost::handle_main_hotkeys() noexcept {
 		s_fullscreen ^= BVS->set_fullscreen(!s_fullscreen);
 	}
 
+	if (s_input.is_pressed(KEY(F12))) {
+		if (zone_profiler::set_enabled(true)) { dump_trace_to_disk(); }
+		else { blog.info("Zone profiler enabled, press F12 again to dump trace."); }
+	}
+
 	if (!m_focus_mru.empty()) {
 		auto& system = m_systems[m_focus_mru.front()];
 		const auto& descriptor = system->get_descriptor();
@@ -13,6 +13,7 @@
 #include "SimpleMRU.hpp"
 #include "FileItem.hpp"
 #include "SettingWrapper.hpp"
+#include "ProgramLibrary.hpp"
 
 /*==================================================================*/
 
@@ -94,6 +95,8 @@ class ApplicationHost final {
 
 	static void set_open_file_dialog_result(std::string_view file) noexcept;
 
+	static inline double s_trace_window_secs = 10.0;
+
 	static constexpr std::size_t s_mru_limit = 10;
 	static inline SimpleMRU<FileItem> s_file_mru = s_mru_limit;
 
@@ -111,6 +114,25 @@ class ApplicationHost final {
 		}
 	}
 
+	static constexpr std::size_t s_library_path_limit = 8;
+	static inline ProgramLibrary s_program_library;
+
+	static void import_library_paths(std::string* src) noexcept {
+		std::vector<std::string> directories;
+		for (std::size_t i = 0; i < s_library_path_limit; ++i) {
+			if (src[i].empty()) { continue; }
+			directories.push_back(std::move(src[i]));
+		}
+		s_program_library.set_directories(std::move(directories));
+	}
+
+	static void export_library_paths(std::string* dst) noexcept {
+		const auto directories = s_program_library.get_directories();
+		for (std::size_t i = 0; i < directories.size() && i < s_library_path_limit; ++i) {
+			dst[i] = directories[i];
+		}
+	}
+
 /*==================================================================*/
 
 private:
@@ -155,27 +177,39 @@ public:
 		float ui_zoom_scale = 1.0f;
 		float ui_text_scale = 1.0f;
 		bool  borderless_view_mode = false;
+		bool  pooled_scheduler = false;
+		int   background_policy = 0;
+		float background_framerate = 10.0f;
 
 		std::string file_mru_cache[s_mru_limit];
+		std::string library_paths[s_library_path_limit];
 
 		SettingsMap map() noexcept;
 	};
 
 private:
 	auto export_settings() const noexcept -> Settings;
+	// Applies settings/ProgramDB edits staged by the HomeDirManager's file watcher.
+	void apply_external_changes() noexcept;
 
 /*==================================================================*/
 
 private:
 	void load_file_from_disk(std::string_view file_path) noexcept;
+	// Stages the named entry, or else the first one a core claims by extension.
+	void load_file_from_archive(std::string_view archive_path, std::string_view entry_name) noexcept;
+	// Stages a program picked from the library, reusing its indexed SHA1 if still valid.
+	void load_file_from_library(const ProgramLibrary::Record& record) noexcept;
 	void handle_main_hotkeys() noexcept;
+	void dump_trace_to_disk() noexcept;
 	void setup_gui_callables() noexcept;
 
 /*==================================================================*/
 
 public:
 	static ApplicationHost* init_application(
-		std::string_view game_file_path, bool headless = false) noexcept;
+		std::string_view game_file_path, bool headless = false,
+		double trace_window_secs = 0.0) noexcept;
 
 	void quit_application() noexcept;
 
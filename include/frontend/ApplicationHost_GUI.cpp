@@ -15,6 +15,7 @@
 #include "SystemDescriptor.hpp"
 #include "SystemStaging.hpp"
 #include "CoreRegistry.hpp"
+#include "InstanceScheduler.hpp"
 #include "BasicLogger.hpp"
 #include "Millis.hpp"
 #include "ColorOps.hpp"
@@ -256,6 +257,14 @@ void ApplicationHost::setup_gui_callables() noexcept {
 		EndDisabled();
 	});
 
+	static bool s_show_window_library{};
+	static auto s_menu_file__program_library = UserInterface::register_menu("",
+	{ 0, "File" }, [&]() noexcept {
+		if (MenuItem("Program Library...", nullptr, s_show_window_library)) {
+			s_show_window_library = !s_show_window_library;
+		}
+	});
+
 	static auto s_menu_file__recent_files = UserInterface::register_menu("",
 	{ 5, "File" }, [&]() noexcept {
 		if (!s_file_mru.size()) { return; }
@@ -390,6 +399,17 @@ void ApplicationHost::setup_gui_callables() noexcept {
 		}
 	});
 
+	static auto s_menu_settings__pooled_scheduler = UserInterface::register_menu("",
+	{ 30, "Settings" }, [&]() noexcept {
+		bool pooled_mode = InstanceScheduler::is_pooled_mode();
+		if (Checkbox("Pooled System Scheduler", &pooled_mode))
+			{ InstanceScheduler::set_pooled_mode(pooled_mode); }
+		if (IsItemHovered(ImGuiHoveredFlags_DelayShort)) {
+			SetTooltip("Runs Systems on a shared pool of worker threads instead of "
+				"one thread each. Applies to Systems loaded afterwards.");
+		}
+	});
+
 /*==================================================================*/
 
 	static auto s_window_none__imgui_demo = UserInterface::register_window(
@@ -516,6 +536,148 @@ void ApplicationHost::setup_gui_callables() noexcept {
 		End();
 	});
 
+	static auto s_window_none__program_library = UserInterface::register_window(
+	[&]() noexcept {
+		// the scanner keeps publishing while hidden, the keys catch up once shown again
+		static bool s_records_dirty = true;
+		s_records_dirty |= s_program_library.commit_scan_results();
+		if (!s_show_window_library) { return; }
+
+		static char s_filter_text[128]{};
+		static std::vector<std::string> s_search_keys;
+		static std::vector<std::size_t> s_filtered;
+		static bool s_filter_dirty = true;
+
+		const auto records = s_program_library.get_records();
+
+		// lowercased once per published index, so filtering is a plain substring scan
+		if (s_records_dirty) {
+			s_records_dirty = false;
+			s_search_keys.resize(records.size());
+			for (std::size_t i = 0; i < records.size(); ++i) {
+				auto& key = s_search_keys[i];
+				key.clear();
+				key.append(records[i].program_title).push_back('\n');
+				key.append(records[i].file_path).push_back('\n');
+				key.append(records[i].matching_cores);
+				std::transform(key.begin(), key.end(), key.begin(),
+					[](unsigned char c) { return char(std::tolower(c)); });
+			}
+			s_filter_dirty = true;
+		}
+
+		if (Begin("Program Library##program_library", &s_show_window_library,
+			ImGuiWindowFlags_NoCollapse
+		)) {
+			const auto directories = s_program_library.get_directories();
+
+			BeginDisabled(directories.size() >= s_library_path_limit);
+			if (Button("Add Folder...")) {
+				SDL_ShowOpenFolderDialog([](void*, const char* const* file_list, int) noexcept {
+					if (file_list && file_list[0]) { s_program_library.add_directory(file_list[0]); }
+				}, nullptr, BVS->get_main_window(), nullptr, false);
+			}
+			EndDisabled();
+
+			SameLine();
+			BeginDisabled(directories.empty() || s_program_library.is_scanning());
+			if (Button("Rescan")) { s_program_library.request_rescan(); }
+			EndDisabled();
+
+			SameLine();
+			AlignTextToFramePadding();
+			if (s_program_library.is_scanning()) {
+				const auto [done, total] = s_program_library.get_scan_progress();
+				Text("Scanning... %zu/%zu", done, total);
+			} else {
+				Text("%zu programs indexed", records.size());
+			}
+
+			if (TreeNode("Folders", "Folders (%zu/%zu)", directories.size(), s_library_path_limit)) {
+				for (const auto& directory : directories) {
+					PushID(directory.c_str());
+					if (SmallButton("Remove")) { s_program_library.remove_directory(directory); }
+					SameLine();
+					TextUnformatted(directory.c_str());
+					PopID();
+				}
+				TreePop();
+			}
+
+			SetNextItemWidth(-FLT_MIN);
+			if (InputTextWithHint("##filter", "Filter by title, path or core...",
+				s_filter_text, sizeof(s_filter_text))) { s_filter_dirty = true; }
+
+			if (s_filter_dirty) {
+				s_filter_dirty = false;
+
+				std::string needle(s_filter_text);
+				std::transform(needle.begin(), needle.end(), needle.begin(),
+					[](unsigned char c) { return char(std::tolower(c)); });
+
+				s_filtered.clear();
+				for (std::size_t i = 0; i < s_search_keys.size(); ++i) {
+					if (s_search_keys[i].find(needle) != std::string::npos) {
+						s_filtered.push_back(i);
+					}
+				}
+			}
+
+			if (BeginTable("LibraryTable", 4, ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg
+				| ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY
+			)) {
+				TableSetupScrollFreeze(0, 1);
+				TableSetupColumn("Title");
+				TableSetupColumn("File");
+				TableSetupColumn("Cores");
+				TableSetupColumn("SHA1", ImGuiTableColumnFlags_DefaultHide);
+				TableHeadersRow();
+
+				const ProgramLibrary::Record* launch_record = nullptr;
+
+				ImGuiListClipper clipper;
+				clipper.Begin(int(s_filtered.size()));
+				while (clipper.Step()) {
+					for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+						const auto& record = records[s_filtered[i]];
+						const auto  file_name = std::filesystem::path(record.file_path).filename().string();
+
+						TableNextRow();
+						PushID(i);
+
+						TableSetColumnIndex(0);
+						if (Selectable(record.program_title.empty() ? file_name.c_str()
+							: record.program_title.c_str(), false,
+							ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)
+						) {
+							if (IsMouseDoubleClicked(ImGuiMouseButton_Left)) { launch_record = &record; }
+						}
+						if (IsItemHovered(ImGuiHoveredFlags_DelayNormal)) {
+							SetTooltip("%s", record.file_path.c_str());
+						}
+
+						TableSetColumnIndex(1);
+						TextUnformatted(file_name.c_str());
+
+						TableSetColumnIndex(2);
+						TextUnformatted(record.matching_cores.c_str());
+
+						TableSetColumnIndex(3);
+						TextUnformatted(record.file_sha1.c_str());
+
+						PopID();
+					}
+				}
+				clipper.End();
+
+				EndTable();
+
+				if (launch_record) { load_file_from_library(*launch_record); }
+			}
+		}
+		End();
+	});
+
 	static auto s_window_none__load_image = UserInterface::register_window(
 	[&]() noexcept {
 		if (!SystemStaging::file_image.valid()) { return; }
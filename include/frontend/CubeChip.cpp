@@ -8,6 +8,12 @@
 #include "BasicLogger.hpp"
 #include "BasicInput.hpp"
 #include "AttachConsole.hpp"
+#include "BulkValidator.hpp"
+#include "DiffRunner.hpp"
+#include "GlobalAudioBase.hpp"
+#include "SimpleFileIO.hpp"
+#include "Millis.hpp"
+#include "DisplayDevice.hpp"
 
 #include <cxxopts.hpp>
 
@@ -36,6 +42,88 @@ BasicLogger& blog = *BasicLogger::initialize();
 
 /*==================================================================*/
 
+static SDL_AppResult run_bulk_validation(
+	const std::string& root_path, const std::string& report_path
+) {
+	fmt::println("Validating files under '{}'...", root_path);
+
+	const auto start_time = Millis::now();
+	const auto reports = bulk_validator::validate_directory(root_path);
+
+	std::size_t matched = 0, failed = 0;
+	for (const auto& report : reports) {
+		matched += !report.matching_cores.empty();
+		failed  += !report.error.empty();
+	}
+
+	fmt::println("Processed {} files in {}ms: {} matched a core, {} unmatched, {} unreadable.",
+		reports.size(), Millis::since(start_time), matched,
+		reports.size() - matched - failed, failed);
+
+	const auto output_path = fs::Path(report_path);
+	if (output_path.has_parent_path()) {
+		std::ignore = fs::create_directories(output_path.parent_path());
+	}
+
+	if (const auto file_written = ::write_file_data(output_path,
+		bulk_validator::format_report(reports))
+	) {
+		fmt::println("Report written to '{}'", output_path.string());
+		return SDL_APP_SUCCESS;
+	} else {
+		fmt::println(stderr, "Unable to write report '{}': {}",
+			output_path.string(), file_written.error().message());
+		return SDL_APP_FAILURE;
+	}
+}
+
+static SDL_AppResult run_differential(
+	const std::string& program_path, const std::string& core_list,
+	const std::string& keys_path, u32 frame_limit
+) {
+	diff_runner::Options options;
+	options.program_path = program_path;
+	options.frame_limit  = frame_limit;
+
+	for (std::size_t pos = 0; pos <= core_list.size();) {
+		const auto next = std::min(core_list.find(',', pos), core_list.size());
+		if (const auto spec = diff_runner::parse_core_spec(std::string_view(core_list).substr(pos, next - pos))) {
+			options.cores.push_back(*spec);
+		} else {
+			fmt::println(stderr, "Malformed core '{}', expected 'name[:+QUIRK|:-QUIRK]...'",
+				core_list.substr(pos, next - pos));
+			return SDL_APP_FAILURE;
+		}
+		pos = next + 1;
+	}
+
+	if (!keys_path.empty()) {
+		const auto file_data = ::read_file_data(keys_path);
+		const auto script = file_data ? diff_runner::parse_key_script(
+			std::string_view(file_data->data(), file_data->size())) : std::nullopt;
+
+		if (!script) {
+			fmt::println(stderr, "Unable to read input script '{}', expected '<frame> <key_states>' lines.", keys_path);
+			return SDL_APP_FAILURE;
+		}
+		options.key_script = *script;
+	}
+
+	// the cores still open their audio streams, keep them silent
+	SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+	GlobalAudioBase::initialize(GlobalAudioBase::Settings{})->is_muted(true);
+
+	fmt::println("Comparing '{}' on {} cores over {} frames...",
+		program_path, options.cores.size(), frame_limit);
+
+	const auto result = diff_runner::run(options);
+	fmt::print("{}", result.report);
+
+	return result.success && !result.diverged ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
+/*==================================================================*/
+
 SDL_AppResult SDL_AppInit(void **Host, int argc, char *argv[]) {
 	static_assert(std::endian::native == std::endian::little,
 		"Only little-endian systems are supported!");
@@ -57,7 +145,21 @@ SDL_AppResult SDL_AppInit(void **Host, int argc, char *argv[]) {
 			("program",  "Force application to load a program on startup.",
 				cxxopts::value<std::string>())
 			("headless", "Force application to run without a graphical user interface (stub).",
-				cxxopts::value<bool>()->default_value("false")->implicit_value("true"));
+				cxxopts::value<bool>()->default_value("false")->implicit_value("true"))
+			("trace",    "Record profiler zones from startup, keeping the last X seconds. Press F12 or quit to dump a Chrome trace JSON into the home directory.",
+				cxxopts::value<double>()->implicit_value("10"))
+			("record",   "Record every launched system's frames into the home directory, as a 'png' sequence or 'y4m' video.",
+				cxxopts::value<std::string>())
+			("validate", "Validate every file under a directory against all cores, write a report and exit.",
+				cxxopts::value<std::string>())
+			("report",   "Output path of the --validate report. Defaults to a timestamped file in the home directory.",
+				cxxopts::value<std::string>())
+			("diff",     "Run the program on a comma-separated list of cores in lockstep and report where they diverge, e.g. 'chip8_modern,schip_modern:+SHIFT_VX_REG'.",
+				cxxopts::value<std::string>())
+			("frames",   "Amount of frames compared by --diff.",
+				cxxopts::value<u32>()->default_value("600"))
+			("keys",     "Input script for --diff, with '<frame> <key_states>' lines holding keys from that frame on.",
+				cxxopts::value<std::string>());
 
 		options.add_options("Configuration")
 			("homedir",  "Force application to use a different home directory to read/write files. Takes precedence over --portable.",
@@ -109,9 +211,46 @@ SDL_AppResult SDL_AppInit(void **Host, int argc, char *argv[]) {
 	const auto* HDM = HomeDirManager::get_instance();
 	if (!HDM || HDM->get_home_path().empty()) { return SDL_APP_FAILURE; }
 
+	if (result.count("validate")) {
+		console::attach();
+		return run_bulk_validation(
+			result["validate"].as<std::string>(),
+			result["report"  ].as_optional<std::string>().value_or(
+				(fs::Path(HDM->get_home_path()) / "reports" / NanoTime(Millis::initial_wall())
+					.format_as_datetime("validation__{:%Y-%m-%d__%H-%M-%S}.tsv")).string())
+		);
+	}
+
+	if (result.count("diff")) {
+		console::attach();
+		if (!result.count("program")) {
+			fmt::println(stderr, "--diff needs a program to run.");
+			return SDL_APP_FAILURE;
+		}
+		return run_differential(
+			result["program"].as<std::string>(),
+			result["diff"   ].as<std::string>(),
+			result["keys"   ].as_optional<std::string>().value_or(""),
+			result["frames" ].as<u32>()
+		);
+	}
+
+	if (result.count("record")) {
+		const auto record_format = result["record"].as<std::string>();
+
+		if (record_format == "png") { DisplayDevice::set_autostart_capture(FrameRecorder::Format::PNG); }
+		else if (record_format == "y4m") { DisplayDevice::set_autostart_capture(FrameRecorder::Format::Y4M); }
+		else {
+			console::attach();
+			fmt::println(stderr, "Unknown --record format '{}', expected 'png' or 'y4m'.", record_format);
+			return SDL_APP_FAILURE;
+		}
+	}
+
 	*Host = ApplicationHost::init_application(
 		result["program" ].as_optional<std::string>().value_or(""),
-		result["headless"].as_optional<bool>().value_or(false)
+		result["headless"].as_optional<bool>().value_or(false),
+		result["trace"   ].as_optional<double>().value_or(0.0)
 	);
 
 	return *Host ? SDL_APP_CONTINUE : SDL_APP_FAILURE;
@@ -0,0 +1,157 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "HomeDirManager.hpp"
+#include "GlobalAudioBase.hpp"
+#include "BasicLogger.hpp"
+#include "SimpleFileIO.hpp"
+#include "CoreFuzzer.hpp"
+#include "Millis.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <SDL3/SDL_init.h>
+#include <SDL3/SDL_hints.h>
+
+#ifndef CUBECHIP_LIBFUZZER
+	#include <cxxopts.hpp>
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+	#define CUBECHIP_SANITIZED
+#elif defined(__has_feature)
+	#if __has_feature(address_sanitizer)
+		#define CUBECHIP_SANITIZED
+	#endif
+#endif
+
+#ifdef CUBECHIP_SANITIZED
+	#include <sanitizer/common_interface_defs.h>
+#endif
+
+/*==================================================================*/
+
+BasicLogger& blog = *BasicLogger::initialize();
+
+/*==================================================================*/
+
+static bool setup_fuzzer(const core_fuzzer::Options& options) noexcept {
+	if (!core_fuzzer::initialize(options)) { return false; }
+
+	// cores create their save/config paths under the home directory, keep it out of the user's
+	HomeDirManager::initialize((fs::Path(options.output_dir) / "home").string(),
+		"", false, "", "CubeChipFuzz");
+
+	const auto* HDM = HomeDirManager::get_instance();
+	if (!HDM || HDM->get_home_path().empty()) { return false; }
+
+	// audio devices are still opened by every core, make them cost nothing
+	SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+	GlobalAudioBase::initialize(GlobalAudioBase::Settings{})->is_muted(true);
+
+	return true;
+}
+
+/*==================================================================*/
+
+#ifdef CUBECHIP_LIBFUZZER
+
+extern "C" int LLVMFuzzerInitialize(int*, char***) {
+	core_fuzzer::Options options;
+
+	if (const char* output_dir = std::getenv("CUBECHIP_FUZZ_OUTPUT")) {
+		options.output_dir = output_dir;
+	}
+
+	return setup_fuzzer(options) ? 0 : -1;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+	core_fuzzer::run_input({ reinterpret_cast<const char*>(data), size });
+	return 0;
+}
+
+#else
+
+int main(int argc, char* argv[]) {
+	cxxopts::Options options("CubeChipFuzz", "Fuzzing driver for every registered core");
+
+	{
+		options.add_options("Fuzzing")
+			("corpus", "Directory of seed programs to mutate, purely random inputs are used otherwise.",
+				cxxopts::value<std::string>()->default_value(""))
+			("runs",   "Amount of inputs to generate and run.",
+				cxxopts::value<u32>()->default_value("1000"))
+			("seed",   "Seed of the input mutator, defaults to the current time.",
+				cxxopts::value<u64>())
+			("frames", "Maximum amount of frames run per accepting core and input.",
+				cxxopts::value<u32>()->default_value("300"))
+			("output", "Directory to write reproducers and findings.tsv into.",
+				cxxopts::value<std::string>()->default_value("fuzz_output"))
+			("replay", "Input files to run once each instead of fuzzing, e.g. saved reproducers.",
+				cxxopts::value<std::vector<std::string>>())
+			("help",   "List fuzzer options.");
+
+		options.parse_positional({ "replay" });
+		options.positional_help("reproducer_files...");
+	}
+
+	cxxopts::ParseResult result;
+	try { result = options.parse(argc, argv); }
+	catch (const cxxopts::exceptions::exception& e) {
+		fmt::println(stderr, "Error parsing options: {}", e.what());
+		return EXIT_FAILURE;
+	}
+
+	if (result.count("help")) {
+		fmt::println("{}", options.help({ "Fuzzing" }));
+		return EXIT_SUCCESS;
+	}
+
+	core_fuzzer::Options fuzzer_options;
+	fuzzer_options.output_dir      = result["output"].as<std::string>();
+	fuzzer_options.frames_per_core = result["frames"].as<u32>();
+
+	if (!setup_fuzzer(fuzzer_options)) {
+		fmt::println(stderr, "Unable to set up fuzzer output in '{}'", fuzzer_options.output_dir);
+		return EXIT_FAILURE;
+	}
+
+#ifdef CUBECHIP_SANITIZED
+	// the sanitizer report is printed first, the input that caused it is saved on the way out
+	__sanitizer_set_death_callback([]() {
+		core_fuzzer::save_current_input(core_fuzzer::FindingKind::SANITIZER);
+	});
+#endif
+
+	u32 findings = 0;
+
+	if (result.count("replay")) {
+		for (const auto& file_path : result["replay"].as<std::vector<std::string>>()) {
+			if (const auto file_data = ::read_file_data(file_path)) {
+				findings += core_fuzzer::run_input(*file_data);
+			} else {
+				fmt::println(stderr, "Unable to read '{}': {}",
+					file_path, file_data.error().message());
+			}
+		}
+	} else {
+		findings = core_fuzzer::run_random(
+			result["corpus"].as<std::string>(),
+			result["runs"  ].as<u32>(),
+			result["seed"  ].as_optional<u64>().value_or(u64(Millis::initial_wall()))
+		);
+	}
+
+	fmt::println("{} findings, see '{}'", findings, fuzzer_options.output_dir);
+
+	SDL_Quit();
+	blog.shutdown();
+	return findings ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif
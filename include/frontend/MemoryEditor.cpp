@@ -5,6 +5,7 @@
 */
 
 #include "MemoryEditor.hpp"
+#include "MemoryWriteTracker.hpp"
 
 #include <cstddef>
 #include <cstring>
@@ -146,6 +147,64 @@ void MemoryEditor::format_value(
 	}
 }
 
+void MemoryEditor::format_cell(char* output, u8 value) const noexcept {
+	static constexpr char digits_lower[] = "0123456789abcdef";
+	static constexpr char digits_upper[] = "0123456789ABCDEF";
+
+	const auto* digits = settings.toggle_capital_hex ? digits_upper : digits_lower;
+
+	output[2] = ' '; // The trailing space is not drawn, it only pads the cell.
+
+	if (settings.toggle_hexii_view) {
+		if (value == 0x00) { output[0] = output[1] = ' '; return; }
+		if (value == 0xFF) { output[0] = output[1] = '#'; return; }
+		if (value >= 32 && value < 127) { output[0] = '.'; output[1] = char(value); return; }
+	}
+	output[0] = digits[value >> 4];
+	output[1] = digits[value & 0xF];
+}
+
+auto MemoryEditor::fetch_row(std::size_t line, f32 current_time) -> RowCache& {
+	auto& row = internals.row_cache[line & (c_row_cache_size - 1)];
+
+	const auto address = line * settings.column_count;
+	const auto count   = std::min<std::size_t>(settings.column_count, internals.memory_size - address);
+
+	const auto generation = internals.write_tracker
+		? internals.write_tracker->get_range_generation(address, count) : 0;
+
+	const bool is_new_row = row.line != line;
+	if (!is_new_row && internals.write_tracker && row.generation == generation) {
+		return row;
+	}
+
+	std::array<u8, c_max_columns> fresh_bytes{};
+	read_bytes(
+		std::span(internals.memory_data, internals.memory_size),
+		std::span(fresh_bytes.data(), count), address);
+
+	if (is_new_row) {
+		row.line = line;
+		row.write_time.fill(c_no_write_time);
+		std::snprintf(row.address_text.data(), row.address_text.size(),
+			settings.toggle_capital_hex ? "%0*zX" : "%0*zx",
+			sizes.address_digit_count, internals.base_display_address + address);
+	}
+	row.generation = generation;
+
+	for (std::size_t n = 0; n < count; ++n) {
+		const auto value = fresh_bytes[n];
+		if (!is_new_row) {
+			if (value == row.bytes[n]) { continue; }
+			row.write_time[n] = current_time;
+		}
+		row.bytes[n] = value;
+		row.ascii_text[n] = (value < 32 || value >= 128) ? '.' : char(value);
+		format_cell(row.hex_text.data() + n * 3, value);
+	}
+	return row;
+}
+
 void MemoryEditor::render_memory_editor() {
 	using namespace ImGui;
 
@@ -194,7 +253,6 @@ void MemoryEditor::render_memory_editor() {
 
 	const auto rounding = GetStyle().FrameRounding;
 
-	bool cache_memory_for_reads = true;
 	bool advance_editing_cursor = false;
 	bool init_highlighting_once = true;
 	auto data_editing_addr_next = c_max_addr;
@@ -255,39 +313,57 @@ void MemoryEditor::render_memory_editor() {
 	const auto cell_text_color_off = settings.toggle_grey_zeroes
 		? GetColorU32(ImGuiCol_TextDisabled) : cell_text_color;
 
-	const char* format_data       = settings.toggle_capital_hex ? "%0*zX" : "%0*zx";
-	const char* format_byte       = settings.toggle_capital_hex ? "%02X"  : "%02x";
-	const char* format_byte_space = settings.toggle_capital_hex ? "%02X " : "%02x ";
+	const char* format_data = settings.toggle_capital_hex ? "%0*zX" : "%0*zx";
+	const char* format_byte = settings.toggle_capital_hex ? "%02X"  : "%02x";
+
+	// Lines are formatted once into the row cache and only rebuilt when their
+	// memory changes, drawing a line is then just a handful of AddText calls.
+	if (internals.row_cache.empty()) {
+		internals.row_cache.resize(c_row_cache_size);
+	}
+
+	const auto row_format_key = u32(settings.column_count)
+		| u32(settings.toggle_hexii_view)  << 8
+		| u32(settings.toggle_capital_hex) << 9
+		| u32(sizes.address_digit_count)   << 10;
+
+	if (internals.row_format_key != row_format_key) {
+		internals.row_format_key = row_format_key;
+		invalidate_row_cache();
+	}
+
+	const auto current_time = f32(GetTime());
+	const auto row_origin_x = window_pos.x - GetScrollX();
+
+	// Hex cells are not items, clicks on them are resolved by position instead
+	const auto mouse_pos = GetIO().MousePos;
+	const bool mouse_clicked = IsWindowHovered() && IsMouseClicked(ImGuiMouseButton_Left);
 
 	auto prev_highlight_type = HighlightInfo();
 	auto curr_highlight_type = HighlightInfo();
 
 	while (clipper.Step()) {
-		if (cache_memory_for_reads) {
-			cache_memory_for_reads = false;
-			const auto lines_count = clipper.DisplayEnd - clipper.DisplayStart;
-			const auto addr_offset = clipper.DisplayStart * settings.column_count;
-			internals.read_cache.resize(settings.column_count * lines_count);
-
-			read_bytes(
-				std::span(internals.memory_data, internals.memory_size),
-				std::span(internals.read_cache), addr_offset); // cache once per line
-		}
-
 		// Line Render: only render lines visible in the current clip region
-		for (auto line = clipper.DisplayStart, i = 0; line < clipper.DisplayEnd; ++line, ++i) {
+		for (auto line = clipper.DisplayStart; line < clipper.DisplayEnd; ++line) {
 			auto address = std::size_t(line) * settings.column_count;
-			const auto row_cache_offset = settings.column_count * i;
+			auto& row = fetch_row(std::size_t(line), current_time);
+
+			const auto line_pos = GetCursorScreenPos();
+			Dummy(ImVec2(sizes.ascii_offset_max, line_height));
+			const auto next_line_pos = GetCursorScreenPos();
+
+			const bool mouse_on_line = mouse_clicked
+				&& mouse_pos.y >= line_pos.y
+				&& mouse_pos.y <  line_pos.y + line_height;
 
 			// Segment: display the address offset of each memory line
 			{
-				const auto data_line_pos = GetCursorScreenPos();
-				draw_list->AddRectFilled(data_line_pos, data_line_pos + ImVec2(9999, line_height),
+				draw_list->AddRectFilled(line_pos, line_pos + ImVec2(9999, line_height),
 					GetColorU32((line & 1) ? ImGuiCol_TableRowBgAlt : ImGuiCol_TableRowBg)
 				);
 
-				SetCursorPosX(GetCursorPosX() + sizes.glyph_width * 0.5f);
-				Text(format_data, sizes.address_digit_count, internals.base_display_address + address);
+				draw_list->AddText(line_pos + ImVec2(sizes.glyph_width * 0.5f, 0.0f), cell_text_color,
+					row.address_text.data(), row.address_text.data() + sizes.address_digit_count);
 			}
 
 			if (init_highlighting_once) {
@@ -298,11 +374,25 @@ void MemoryEditor::render_memory_editor() {
 
 			// Segment: display each byte in hexadecimal format
 			for (auto n = 0u; n < settings.column_count && address < internals.memory_size; ++n, ++address) {
-				SameLine(sizes.hex_offset_min + sizes.hex_cell_width * n + sizes.col_group_spacing
-					* float(settings.column_group_size ? (n / settings.column_group_size) : 0));
+				const auto cell_pos = ImVec2(row_origin_x + sizes.hex_offset_min + sizes.hex_cell_width * n
+					+ sizes.col_group_spacing * float(settings.column_group_size ? (n / settings.column_group_size) : 0),
+					line_pos.y);
 
 				const auto next_highlight_type = get_highlight_type(address + 1);
 
+				// Recent writes fade out underneath any other highlighting
+				if (settings.toggle_write_fade) {
+					const auto write_age = current_time - row.write_time[n];
+					if (write_age >= 0.0f && write_age < settings.write_fade_seconds) {
+						auto fade_color = settings.cell_emphasis_color;
+						fade_color.A = u8(fade_color.A * (1.0f - write_age / settings.write_fade_seconds));
+
+						draw_list->AddRectFilled(cell_pos, ImVec2(
+							cell_pos.x + sizes.glyph_width * 2, cell_pos.y + line_height
+						), fade_color, rounding);
+					}
+				}
+
 				if (curr_highlight_type.color.A != 0) {
 					const bool same_as_prev = (prev_highlight_type & curr_highlight_type) != 0;
 					const bool same_as_next = (curr_highlight_type & next_highlight_type) != 0;
@@ -328,7 +418,7 @@ void MemoryEditor::render_memory_editor() {
 					const auto offset_x = (gap_cross * -1.0f) + sizes.col_group_spacing
 						* gap_cross * ((prev_highlight_type & curr_highlight_type) != 0);
 
-					const auto draw_pos = GetCursorScreenPos() - ImVec2(offset_x, 0.0f);
+					const auto draw_pos = cell_pos - ImVec2(offset_x, 0.0f);
 
 					const float bg_width = ((curr_highlight_type & next_highlight_type) != 0
 						? (n != 0 && settings.column_group_size
@@ -351,10 +441,12 @@ void MemoryEditor::render_memory_editor() {
 				prev_highlight_type = curr_highlight_type;
 				curr_highlight_type = next_highlight_type;
 
-				const auto cell_byte = internals.read_cache[row_cache_offset + n];
+				const auto cell_byte = row.bytes[n];
 
 				// Display text input on current byte ...
 				if (internals.data_editing_address == address) {
+					SetCursorScreenPos(cell_pos);
+
 					if (internals.acquire_edit_focus) {
 						SetKeyboardFocusHere();
 						std::snprintf(
@@ -453,35 +545,24 @@ void MemoryEditor::render_memory_editor() {
 							} else {
 								internals.memory_data[address] = data_input_value;
 							}
+							row.line = c_max_addr; // our own writes are not tracked, re-read next frame
 						}
 					}
 				}
-				// ... or else display byte as text only
+				// ... or else draw the preformatted cell text
 				else {
-					// The trailing space is not visible but ensures there's
-					// no gap that the mouse cannot click on.
-					if (settings.toggle_hexii_view) {
-						switch (cell_byte) {
-							case 0x00:
-								TextUnformatted("   ");
-								break;
-							case 0xFF:
-								TextUnformatted("## ", cell_text_color_off);
-								break;
-							default:
-								Text((cell_byte >= 32 && cell_byte < 127)
-									? ".%c " : format_byte_space, cell_byte);
-								break;
-						}
-					} else {
-						if (cell_byte == 0x00 && settings.toggle_grey_zeroes) {
-							TextUnformatted("00 ", cell_text_color_off);
-						} else {
-							Text(format_byte_space, cell_byte);
-						}
-					}
+					const auto* cell_text = row.hex_text.data() + n * 3;
+					const bool  is_dimmed = cell_byte == (settings.toggle_hexii_view ? 0xFF : 0x00);
+
+					draw_list->AddText(cell_pos, is_dimmed
+						? cell_text_color_off : cell_text_color,
+						cell_text, cell_text + 2
+					);
 
-					if (IsItemHovered() && IsMouseClicked(ImGuiMouseButton_Left)) {
+					if (mouse_on_line
+						&& mouse_pos.x >= cell_pos.x
+						&& mouse_pos.x <  cell_pos.x + sizes.hex_cell_width
+					) {
 						internals.acquire_edit_focus = true;
 						data_editing_addr_next = address;
 					}
@@ -490,7 +571,7 @@ void MemoryEditor::render_memory_editor() {
 
 			// Segment: display each byte as ASCII on the right side if enabled
 			if (settings.toggle_ascii_view) {
-				SameLine(sizes.ascii_offset_min);
+				SetCursorScreenPos(ImVec2(row_origin_x + sizes.ascii_offset_min, line_pos.y));
 				auto pos = GetCursorScreenPos();
 				address = std::size_t(line) * settings.column_count;
 
@@ -518,16 +599,16 @@ void MemoryEditor::render_memory_editor() {
 						), callbacks.bg_color(internals.memory_data, address), rounding);
 					}
 
-					const auto v = internals.read_cache[row_cache_offset + n];
-
-					char display_c = (v < 32 || v >= 128) ? '.' : v;
-					draw_list->AddText(pos, (display_c == v)
+					const auto* display_c = &row.ascii_text[n];
+					draw_list->AddText(pos, (*display_c == char(row.bytes[n]))
 						? cell_text_color : cell_text_color_off,
-						&display_c, &display_c + 1
+						display_c, display_c + 1
 					);
 					pos.x += sizes.glyph_width;
 				}
 			}
+
+			SetCursorScreenPos(next_line_pos);
 		}
 	}
 	PopStyleVar(2);
@@ -617,6 +698,7 @@ void MemoryEditor::render_memory_editor() {
 		Checkbox("Show Ascii", &settings.toggle_ascii_view);
 		Checkbox("Grey-out zeroes", &settings.toggle_grey_zeroes);
 		Checkbox("Uppercase Hex", &settings.toggle_capital_hex);
+		Checkbox("Fade Recent Writes", &settings.toggle_write_fade);
 
 		EndPopup();
 	}
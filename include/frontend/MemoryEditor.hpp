@@ -24,6 +24,8 @@
 
 /*==================================================================*/
 
+class MemoryWriteTracker;
+
 struct MemoryEditor {
 	enum DataFormat {
 		BIN, // Binary
@@ -78,6 +80,22 @@ private:
 	}
 
 private:
+	static constexpr std::size_t c_row_cache_size = 256; // power of two, enough rows to cover a tall window
+	static constexpr std::size_t c_max_columns    = 32;
+	static constexpr f32         c_no_write_time  = -1.0e9f;
+
+	// Bytes and display strings of one line, rebuilt only when its memory changes.
+	struct RowCache {
+		std::size_t line = c_max_addr;
+		u64         generation{};
+
+		std::array<u8,   c_max_columns>     bytes{};
+		std::array<f32,  c_max_columns>     write_time{}; // GUI time each byte was last seen changing
+		std::array<char, c_max_columns * 3> hex_text{};   // "ff " per cell
+		std::array<char, c_max_columns>     ascii_text{};
+		std::array<char, 24>                address_text{};
+	};
+
 	struct Internals {
 		std::size_t data_preview_address = c_max_addr;
 		std::size_t data_editing_address = c_max_addr;
@@ -95,7 +113,9 @@ private:
 		DataType preview_data_type  = DataType::S32;
 		bool     acquire_edit_focus = false;
 
-		std::vector<u8> read_cache;
+		const MemoryWriteTracker* write_tracker = nullptr;
+		std::vector<RowCache>     row_cache;
+		u32                       row_format_key{};
 
 		std::array<char, 32> cell_input_buffer{};
 		std::array<char, 32> goto_input_buffer{};
@@ -124,6 +144,13 @@ private:
 
 	auto get_highlight_type(std::size_t address) noexcept -> HighlightInfo;
 
+	void invalidate_row_cache() noexcept {
+		for (auto& row : internals.row_cache) { row.line = c_max_addr; }
+	}
+
+	void format_cell(char* output, u8 value) const noexcept;
+	auto fetch_row(std::size_t line, f32 current_time) -> RowCache&;
+
 	struct Sizes {
 		u32 address_digit_count{}; // Number of digits required to represent maximum address.
 		f32 glyph_width{};         // Glyph width (assume mono-space).
@@ -150,6 +177,8 @@ public:
 		bool toggle_ascii_view = true;  // Display ASCII representation on the right side of the Memory Viewer.
 		bool toggle_grey_zeroes = true;  // Grey-out null/zero bytes using the TextDisabled color.
 		bool toggle_capital_hex = false; // Present hexadecimal values as "FF" instead of "ff".
+		bool toggle_write_fade  = true;  // Briefly highlight bytes that changed since they were last displayed.
+		f32  write_fade_seconds = 0.75f; // Duration of the write highlight fade.
 
 		BoundedParam<u32(8), 4, 32> column_count;      // Number of columns to display.
 		BoundedParam<u32(8), 0, 16> column_group_size; // Insert spacing between N columns to separate groups. Use 0 to disable.
@@ -184,9 +213,19 @@ public:
 		internals.memory_data = reinterpret_cast<u8*>(const_cast<T*>(memory_data));
 		internals.memory_size = memory_size * sizeof(T);
 		internals.base_display_address = base_display_address;
+		invalidate_row_cache();
 		recalculate_all_sizes();
 	}
 
+	/**
+	 * @brief Sets the tracker whose write generations tell which lines must be read and
+	 *        reformatted again. Without one, visible lines are re-read every frame.
+	 */
+	void set_write_tracker(const MemoryWriteTracker* tracker) noexcept {
+		internals.write_tracker = tracker;
+		invalidate_row_cache();
+	}
+
 private:
 #ifdef _LP64
 	// Linux/macOS LP64: u64 is unsigned long, force long long for printf
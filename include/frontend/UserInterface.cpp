@@ -6,6 +6,7 @@
 
 #include "UserInterface.hpp"
 #include "BasicLogger.hpp"
+#include "ZoneProfiler.hpp"
 
 #include "fonts/RobotoMono.hpp"
 
@@ -454,6 +455,7 @@ void UserInterface::begin_new_frame() {
 }
 
 void UserInterface::render_frame(SDL_Renderer* renderer) {
+	PROFILE_ZONE("imgui_render");
 	ImGui::Render();
 	ImGui_ImplSDLRenderer3_RenderDrawData(ImGui::GetDrawData(),
 		renderer ? renderer : s_current_renderer);
@@ -7,14 +7,19 @@
 #include "LifetimeWrapperSDL.hpp"
 #include "BasicVideoSpec.hpp"
 #include "BasicLogger.hpp"
+#include "ZoneProfiler.hpp"
+#include "PixelScaler.hpp"
 
 #include <vector>
 #include <exception>
+#include <string_view>
 
 #include <SDL3/SDL_messagebox.h>
 #include <SDL3/SDL_init.h>
+#include <SDL3/SDL_hints.h>
 #include <SDL3/SDL_timer.h>
 #include <SDL3/SDL_render.h>
+#include <SDL3/SDL_video.h>
 
 #ifdef _WIN32
 	#ifdef WINDOWS_NO_ROUNDED_CORNERS
@@ -182,12 +187,90 @@ static void normalize_rect_to_display(ez::Rect& rect, ez::Rect& deco, bool first
 
 /*==================================================================*/
 
+// Video drivers with nothing to accelerate, where only the software renderer makes sense.
+static bool has_accelerated_video_driver() noexcept {
+	const auto* driver = SDL_GetCurrentVideoDriver();
+	return !driver || (std::string_view(driver) != "offscreen"
+		&& std::string_view(driver) != "dummy");
+}
+
+// Catches GL renderers that are backed by Mesa's CPU rasterizers, as found on
+// GPU-less machines and under Xvfb. Those pay for the GL pipeline on the CPU,
+// and are outrun by SDL's software renderer blitting into the window surface.
+static bool is_cpu_rasterized(SDL_Renderer* renderer) noexcept {
+	if (BasicVideoSpec::is_software_renderer(renderer)) { return true; }
+
+	const auto* name = SDL_GetRendererName(renderer);
+	if (!name || !std::string_view(name).starts_with("opengl")) { return false; }
+	if (!SDL_GL_GetCurrentContext()) { return false; }
+
+	using GetStringFn = const unsigned char* (*)(unsigned);
+	static constexpr unsigned GL_RENDERER = 0x1F01;
+
+	const auto gl_get_string = reinterpret_cast<GetStringFn>(SDL_GL_GetProcAddress("glGetString"));
+	const auto* gl_renderer = gl_get_string ? gl_get_string(GL_RENDERER) : nullptr;
+	if (!gl_renderer) { return false; }
+
+	const auto device = std::string_view(reinterpret_cast<const char*>(gl_renderer));
+	blog.info("OpenGL renderer device: {}", device);
+
+	for (const auto* cpu_device : { "llvmpipe", "softpipe", "swrast", "Software Rasterizer" }) {
+		if (device.find(cpu_device) != device.npos) { return true; }
+	}
+	return false;
+}
+
+static SDL_Renderer* create_main_renderer(
+	SDL_Window* window, BasicVideoSpec::RenderBackend backend
+) noexcept {
+	using enum BasicVideoSpec::RenderBackend;
+
+#ifdef _WIN32
+	// Under Windows' DWM, the default SDL render driver (direct3d11) misses the
+	// timing window for presenting frames when the window is moved or being resized,
+	// falling to a lower vsync bracket. OpenGL appears to be unaffected by this,
+	// most likely due to a different pipeline, as opposed to DXGI's flip model.
+	static constexpr const char* renderer_name = "opengl";
+#else
+	static constexpr const char* renderer_name = nullptr;
+#endif
+
+	if (backend == AUTO && !has_accelerated_video_driver()) { backend = SOFTWARE; }
+
+	if (backend != SOFTWARE) {
+		if (auto* renderer = SDL_CreateRenderer(window, renderer_name)) {
+			if (backend == HARDWARE || !is_cpu_rasterized(renderer)) { return renderer; }
+			blog.info("Renderer '{}' rasterizes on the CPU, switching to the software backend",
+				SDL_GetRendererName(renderer));
+			SDL_DestroyRenderer(renderer);
+		} else {
+			if (backend == HARDWARE) { return nullptr; }
+			blog.warn("Unable to create a hardware renderer, switching to the software "
+				"backend: {}", SDL_GetError());
+		}
+	}
+
+	// keep the window surface in system memory, rather than have SDL emulate it
+	// with a texture of yet another renderer that the software one draws through
+	SDL_SetHint(SDL_HINT_FRAMEBUFFER_ACCELERATION, "0");
+	return SDL_CreateRenderer(window, SDL_SOFTWARE_RENDERER);
+}
+
+/*==================================================================*/
+
 static SDL_Unique<SDL_Window>   s_main_window{};
 static SDL_Unique<SDL_Renderer> s_main_renderer{};
 
+static auto s_render_backend{ BasicVideoSpec::RenderBackend::AUTO };
+
 SDL_Window*   BasicVideoSpec::get_main_window()   const noexcept { return s_main_window; }
 SDL_Renderer* BasicVideoSpec::get_main_renderer() const noexcept { return s_main_renderer; }
 
+bool BasicVideoSpec::is_software_renderer(SDL_Renderer* renderer) noexcept {
+	const auto* name = renderer ? SDL_GetRendererName(renderer) : nullptr;
+	return name && std::string_view(name) == SDL_SOFTWARE_RENDERER;
+}
+
 /*==================================================================*/
 
 BasicVideoSpec::BasicVideoSpec(const Settings& settings, bool& success) noexcept {
@@ -253,18 +336,14 @@ BasicVideoSpec::BasicVideoSpec(const Settings& settings, bool& success) noexcept
 		SDL_SetWindowSize(s_main_window, window.w, window.h);
 		SDL_SetWindowMinimumSize(s_main_window, 960, 780);
 
-#ifdef _WIN32
-		// Under Windows' DWM, the default SDL render driver (direct3d11) misses the
-		// timing window for presenting frames when the window is moved or being resized,
-		// falling to a lower vsync bracket. OpenGL appears to be unaffected by this,
-		// most likely due to a different pipeline, as opposed to DXGI's flip model.
-		static constexpr const char* renderer_name = "opengl";
-#else
-		static constexpr const char* renderer_name = nullptr;
-#endif
-		s_main_renderer = SDL_CreateRenderer(s_main_window, renderer_name); \
+		s_render_backend = RenderBackend(std::clamp(settings.render_backend,
+			0, int(RenderBackend::COUNT) - 1));
+
+		s_main_renderer = create_main_renderer(s_main_window, s_render_backend); \
 		if (!s_main_renderer) { throw_fatal_error(__LINE__, __func__); }
 
+		blog.info("Main renderer: {}", SDL_GetRendererName(s_main_renderer));
+
 		SDL_ShowWindow(s_main_window);
 		SDL_RaiseWindow(s_main_window);
 	}
@@ -293,6 +372,7 @@ SettingsMap BasicVideoSpec::Settings::map() noexcept {
 		::make_setting_link("Window.Main.Size.W", &window.w),
 		::make_setting_link("Window.Main.Size.H", &window.h),
 		::make_setting_link("Window.Main.FirstRun", &first_run),
+		::make_setting_link("Window.Main.RenderBackend", &render_backend),
 	};
 }
 
@@ -307,6 +387,7 @@ auto BasicVideoSpec::export_settings() const noexcept -> Settings {
 	SDL_GetWindowPosition(s_main_window, &out.window.x, &out.window.y);
 	SDL_GetWindowSize(s_main_window, &out.window.w, &out.window.h);
 	out.first_run = false;
+	out.render_backend = int(s_render_backend);
 
 	return out;
 }
@@ -335,17 +416,52 @@ static SDL_Texture* create_texture(
 	}
 }
 
+// Frame buffers hold RGBX8888 pixels, which few hardware renderers take natively.
+// Handing SDL a format it lacks costs a staging copy and a conversion per upload,
+// so textures use the nearest native format instead, and the pixels are converted
+// in the same pass that copies them in. The software renderer's first format is
+// that of the window surface, and matching it spares a conversion on every blit.
+static SDL_PixelFormat select_texture_format(SDL_Renderer* renderer) noexcept {
+	const auto* formats = static_cast<const SDL_PixelFormat*>(SDL_GetPointerProperty(
+		SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr));
+	if (!formats) { return SDL_PIXELFORMAT_RGBX8888; }
+
+	static constexpr auto is_convertible = [](SDL_PixelFormat format) noexcept {
+		return format == SDL_PIXELFORMAT_RGBX8888
+			|| format == SDL_PIXELFORMAT_XRGB8888
+			|| format == SDL_PIXELFORMAT_XBGR8888;
+	};
+
+	if (BasicVideoSpec::is_software_renderer(renderer) && is_convertible(formats[0])) \
+		{ return formats[0]; }
+
+	auto best_format = SDL_PIXELFORMAT_UNKNOWN;
+	for (auto* format = formats; *format != SDL_PIXELFORMAT_UNKNOWN; ++format) {
+		if (*format == SDL_PIXELFORMAT_RGBX8888) { return *format; }
+		if (!best_format && is_convertible(*format)) { best_format = *format; }
+	}
+	return best_format ? best_format : SDL_PIXELFORMAT_RGBX8888;
+}
+
+static auto get_pixel_order(SDL_PixelFormat format) noexcept {
+	switch (format) {
+		case SDL_PIXELFORMAT_XRGB8888: return pixel_scaler::Order::XRGB;
+		case SDL_PIXELFORMAT_XBGR8888: return pixel_scaler::Order::XBGR;
+		default:                       return pixel_scaler::Order::RGBX;
+	}
+}
+
 SDL_Texture* BasicVideoSpec::create_stream_texture(
 	SDL_Renderer* renderer, int w, int h, bool linear_scalemode
 ) noexcept {
-	return ::create_texture(renderer, w, h, SDL_PIXELFORMAT_RGBX8888,
+	return ::create_texture(renderer, w, h, ::select_texture_format(renderer),
 		SDL_TEXTUREACCESS_STREAMING, SDL_ScaleMode(linear_scalemode));
 }
 
 SDL_Texture* BasicVideoSpec::create_target_texture(
 	SDL_Renderer* renderer, int w, int h, bool linear_scalemode
 ) noexcept {
-	return ::create_texture(renderer, w, h, SDL_PIXELFORMAT_RGBX8888,
+	return ::create_texture(renderer, w, h, ::select_texture_format(renderer),
 		SDL_TEXTUREACCESS_TARGET, SDL_ScaleMode(linear_scalemode));
 }
 
@@ -353,34 +469,53 @@ void BasicVideoSpec::write_stream_texture(
 	SDL_Renderer* renderer, SDL_Texture* texture, const std::byte* src_buffer
 ) noexcept {
 	if (!renderer || !texture) { return; }
+	PROFILE_ZONE("write_stream_texture");
 
 	void* pixels_ptr; int pitch;
 
 	if (!SDL_LockTexture(texture, nullptr, &pixels_ptr, &pitch)) { \
 		throw_fatal_error(__LINE__, __func__);
 	} else {
-		const auto total_rows = texture->h;
-		const auto row_length = texture->w * SDL_BYTESPERPIXEL(texture->format);
+		auto options = pixel_scaler::Options{};
+		options.order = ::get_pixel_order(texture->format);
 
-		for (int y = 0; y < total_rows; ++y) {
-			std::memcpy(static_cast<std::byte*>(pixels_ptr) + y * pitch,
-				src_buffer + y * row_length, row_length);
-		}
+		pixel_scaler::scale(
+			reinterpret_cast<const u32*>(src_buffer), texture->w, texture->w, texture->h,
+			static_cast<u32*>(pixels_ptr), pitch / s32(sizeof(u32)), texture->w, texture->h, options);
 
 		SDL_UnlockTexture(texture);
 	}
+}
 
-	const SDL_FRect dest_frect = { 0.0f, 0.0f,
-		float(texture->w), float(texture->h) };
+void BasicVideoSpec::write_scaled_texture(
+	SDL_Texture* texture, const std::byte* src_buffer, int src_w, int src_h,
+	const pixel_scaler::Options& options
+) noexcept {
+	if (!texture || !src_buffer) { return; }
+	PROFILE_ZONE("write_scaled_texture");
+
+	SDL_Surface* surface;
 
-	SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
-	SDL_RenderTexture(renderer, texture, nullptr, &dest_frect);
+	if (!SDL_LockTextureToSurface(texture, nullptr, &surface)) { \
+		throw_fatal_error(__LINE__, __func__);
+	} else {
+		auto surface_options = options;
+		surface_options.order = ::get_pixel_order(surface->format);
+
+		pixel_scaler::scale(
+			reinterpret_cast<const u32*>(src_buffer), src_w, src_w, src_h,
+			static_cast<u32*>(surface->pixels), surface->pitch / s32(sizeof(u32)),
+			surface->w, surface->h, surface_options);
+
+		SDL_UnlockTexture(texture);
+	}
 }
 
 void BasicVideoSpec::write_stream_texture(
 	SDL_Renderer* renderer, SDL_Texture* dst_texture, SDL_Texture* src_texture
 ) noexcept {
 	if (!renderer || !dst_texture || !src_texture) { return; }
+	PROFILE_ZONE("write_target_texture");
 
 	const SDL_FRect dest_frect = { 0.0f, 0.0f,
 		float(dst_texture->w), float(dst_texture->h) };
@@ -8,6 +8,7 @@
 
 #include "SettingWrapper.hpp"
 #include "EzMaths.hpp"
+#include "PixelScaler.hpp"
 
 /*==================================================================*/
 
@@ -17,12 +18,20 @@ struct SDL_Renderer;
 class BasicVideoSpec final {
 
 public:
+	enum class RenderBackend : int {
+		AUTO,     // hardware, unless it fails or turns out to rasterize on the CPU
+		HARDWARE, // whatever SDL picks as the platform's accelerated renderer
+		SOFTWARE, // SDL's software renderer, drawing straight into the window surface
+		COUNT
+	};
+
 	struct Settings {
 		static constexpr ez::Rect
 			defaults = { 0, 0, 640, 480 };
 
 		ez::Rect window = defaults;
 		bool first_run = true;
+		int  render_backend = int(RenderBackend::AUTO);
 
 		SettingsMap map() noexcept;
 	};
@@ -51,6 +60,9 @@ public:
 	SDL_Window*   get_main_window()   const noexcept;
 	SDL_Renderer* get_main_renderer() const noexcept;
 
+	// True if the renderer is SDL's software renderer, drawing on the CPU.
+	static bool is_software_renderer(SDL_Renderer* renderer) noexcept;
+
 /*==================================================================*/
 
 public:
@@ -68,6 +80,12 @@ public:
 	static void write_stream_texture(SDL_Renderer* renderer,
 		SDL_Texture* dst_texture, SDL_Texture* src_texture) noexcept;
 
+	// Scales pixel data from src_buffer of src_w*src_h into a given Stream texture
+	// on the CPU, filtered and tinted per options, in the texture's channel order.
+	static void write_scaled_texture(SDL_Texture* texture,
+		const std::byte* src_buffer, int src_w, int src_h,
+		const pixel_scaler::Options& options = {}) noexcept;
+
 /*==================================================================*/
 
 public:
@@ -12,6 +12,9 @@
 #include "PathGetters.hpp"
 
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
 #include <SDL3/SDL_messagebox.h>
 #include <fmt/format.h>
 
@@ -23,6 +26,10 @@
 static toml::table s_config_model{};
 static std::unique_ptr<HomeDirManager> s_instance{};
 
+static std::mutex                 s_staged_lock{};
+static std::optional<toml::table> s_staged_config{};
+static std::atomic<bool>          s_has_staged_config{};
+
 /*==================================================================*/
 
 template <typename... T>
@@ -156,4 +163,141 @@ void HomeDirManager::update_map_from_config(const SettingsMap& map) const noexce
 		});
 	}
 }
+
+/*==================================================================*/
+
+bool HomeDirManager::start_file_watcher(std::vector<WatchedFile> extra_files) noexcept {
+	if (m_config_at.empty() || m_file_watcher.is_running()) { return false; }
+
+	m_file_watcher.watch(m_config_at);
+	for (const auto& [file_path, on_change] : extra_files) {
+		m_file_watcher.watch(file_path);
+	}
+
+	const bool started = m_file_watcher.start([this, extra_files = std::move(extra_files)]
+		(const std::string& file_path) {
+			if (file_path == m_config_at) { stage_app_config_file(); return; }
+
+			for (const auto& [watched_path, on_change] : extra_files) {
+				if (watched_path == file_path && on_change) { on_change(); }
+			}
+		});
+
+	if (started) {
+		blog.info("[TOML] Watching App Config for external changes.");
+	} else {
+		blog.warn("[TOML] App Config will not be reloaded on external changes,"
+			" file watching is unavailable!");
+	}
+	return started;
+}
+
+void HomeDirManager::stop_file_watcher() noexcept {
+	m_file_watcher.stop();
+}
+
+bool HomeDirManager::has_staged_config() const noexcept {
+	return s_has_staged_config.load(std::memory_order::acquire);
+}
+
+void HomeDirManager::stage_app_config_file() const noexcept {
+	auto result = TomlConfig::parse_from_file(m_config_at.c_str());
+	if (!result) {
+		blog.warn("[TOML] App Config change rejected, failed to parse at line {}!"
+			" [{}]", result.error().source().begin.line, result.error().description());
+		return;
+	}
+
+	std::scoped_lock lock(s_staged_lock);
+	s_staged_config = std::move(result).table();
+	s_has_staged_config.store(true, std::memory_order::release);
+}
+
+/*==================================================================*/
+
+template <typename T>
+static bool is_compatible_node(toml::node_view<const toml::node> node, std::size_t elem_count) noexcept {
+	if (elem_count == 1) { return node.value<T>().has_value(); }
+
+	const auto* array = node.as_array();
+	if (!array) { return false; }
+
+	for (const auto& elem : *array) {
+		if (!elem.value<T>()) { return false; }
+	}
+	return true;
+}
+
+template <typename T>
+static bool apply_node_value(toml::node_view<const toml::node> node, T* dst, std::size_t elem_count) noexcept {
+	bool changed = false;
+
+	const auto assign = [&](T& current, T&& value) noexcept {
+		if (current != value) { current = std::move(value); changed = true; }
+	};
+
+	if (elem_count == 1) {
+		assign(*dst, *node.value<T>());
+	} else {
+		const auto& array = *node.as_array();
+		for (std::size_t i = 0; i < elem_count; ++i) {
+			assign(dst[i], i < array.size() ? *array[i].value<T>() : T());
+		}
+	}
+	return changed;
+}
+
+std::size_t HomeDirManager::apply_staged_config(std::initializer_list<const SettingsMap*> maps) const noexcept {
+	std::optional<toml::table> staged;
+	{
+		std::scoped_lock lock(s_staged_lock);
+		staged.swap(s_staged_config);
+		s_has_staged_config.store(false, std::memory_order::release);
+	}
+	if (!staged) { return 0; }
+
+	const toml::table& table = *staged;
+
+	// validate every key first, so the edit is either applied whole or not at all
+	for (const auto* map : maps) {
+		for (const auto& [key, setting] : *map) {
+			const auto node = table.at_path(key);
+			if (!node) { continue; }
+
+			bool compatible = false;
+			setting.visit([&](auto* ptr) noexcept {
+				using T = std::decay_t<decltype(*ptr)>;
+				compatible = ::is_compatible_node<T>(node, setting.elem_count());
+			});
+
+			if (!compatible) {
+				blog.warn("[TOML] App Config change rejected, setting '{}'"
+					" holds a value of an incompatible type!", key);
+				return 0;
+			}
+		}
+	}
+
+	std::size_t changes = 0;
+
+	for (const auto* map : maps) {
+		for (const auto& [key, setting] : *map) {
+			const auto node = table.at_path(key);
+			if (!node) { continue; }
+
+			setting.visit([&](auto* ptr) noexcept {
+				if (::apply_node_value(node, ptr, setting.elem_count())) {
+					blog.info("[TOML] Setting '{}' changed externally.", key);
+					++changes;
+				}
+			});
+		}
+	}
+
+	if (changes) {
+		TomlConfig::update_existing_table_contents(s_config_model, table);
+	}
+	return changes;
+}
+
 /*==================================================================*/
@@ -7,8 +7,12 @@
 #pragma once
 
 #include "SettingWrapper.hpp"
+#include "FileWatcher.hpp"
 
 #include <string_view>
+#include <functional>
+#include <initializer_list>
+#include <vector>
 
 /*==================================================================*/
 
@@ -56,6 +60,41 @@ private:
 	void insert_map_into_config(const SettingsMap& map) const noexcept;
 	void update_map_from_config(const SettingsMap& map) const noexcept;
 
+/*==================================================================*/
+
+public:
+	using WatchedFile = std::pair<std::string, std::function<void()>>;
+
+private:
+	FileWatcher m_file_watcher;
+
+	void stage_app_config_file() const noexcept;
+	std::size_t apply_staged_config(std::initializer_list<const SettingsMap*> maps) const noexcept;
+
+public:
+	/**
+	 * @brief Starts watching the App Config file for edits made outside the application.
+	 *        Each edit is parsed on the watcher thread and staged, to be picked up by
+	 *        apply_config_changes(). Extra files can be watched on the same thread, their
+	 *        callback is run there as well, so it must be thread-safe.
+	 * @return True if the watcher is running, false if unsupported on this platform.
+	 */
+	bool start_file_watcher(std::vector<WatchedFile> extra_files = {}) noexcept;
+	void stop_file_watcher() noexcept;
+
+	bool has_staged_config() const noexcept;
+
+	/**
+	 * @brief Applies a staged App Config edit to the given maps, if any. Only keys whose
+	 *        value differs from the map's current one are written. The edit is rejected
+	 *        as a whole, with a logged reason, if any key holds an incompatible value.
+	 * @return Amount of settings changed, 0 if nothing was staged or the edit was rejected.
+	 */
+	template <typename... Maps> requires (std::same_as<Maps, SettingsMap> && ...)
+	std::size_t apply_config_changes(const Maps&... maps) const noexcept {
+		return apply_staged_config({ &maps... });
+	}
+
 public:
 	static void initialize(
 		std::string_view home_override, std::string_view config_name,
@@ -0,0 +1,159 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "BulkValidator.hpp"
+#include "CoreRegistry.hpp"
+#include "SystemDescriptor.hpp"
+#include "SimpleFileIO.hpp"
+#include "ExecPolicy.hpp"
+#include "FileImage.hpp"
+#include "ZipArchive.hpp"
+#include "SHA1.hpp"
+
+#include <tuple>
+#include <algorithm>
+#include <filesystem>
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+/*==================================================================*/
+
+static constexpr std::string_view c_extension_mismatch = "extension not claimed by core";
+
+// a file to validate, an archive is validated entry by entry within the same task
+struct PendingSource {
+	std::string source_path{};
+	std::vector<bulk_validator::FileReport> reports{};
+};
+
+static void validate_image(
+	bulk_validator::FileReport& report, const FileImage& file_image,
+	std::string_view load_error
+) noexcept try {
+	if (!file_image.valid()) { report.error = load_error; return; }
+	if (!file_image.size())  { report.error = "file is empty"; return; }
+
+	report.file_sha1 = SHA1::from(file_image.span());
+
+	const auto extension = fs::Path(report.file_path).extension().string();
+	const auto claimants = CoreRegistry::get_extension_core_span(extension);
+
+	for (const auto& hook : CoreRegistry::get_candidate_core_span()) {
+		const auto& descriptor = *hook->descriptor;
+		const char* error_message = descriptor.validate_program(file_image.span());
+
+		if (error_message) {
+			report.rejections.push_back({ descriptor.system_name, error_message });
+		}
+		else if (std::find(claimants.begin(), claimants.end(), hook) == claimants.end()) {
+			report.rejections.push_back({ descriptor.system_name, c_extension_mismatch });
+		}
+		else {
+			report.matching_cores.push_back(descriptor.system_name);
+		}
+	}
+}
+catch (...) {
+	report.error = "out of memory";
+}
+
+static void validate_source(PendingSource& source) noexcept try {
+	if (!ZipArchive::is_archive(source.source_path)) {
+		auto& report = source.reports.emplace_back();
+		report.file_path = source.source_path;
+		::validate_image(report, FileImage(report.file_path), "unable to map file");
+		return;
+	}
+
+	// opened and released by the task, so no more archives are mapped than there are workers
+	const ZipArchive archive(source.source_path);
+	if (!archive.valid()) {
+		auto& report = source.reports.emplace_back();
+		report.file_path = source.source_path;
+		report.error = "unable to read archive";
+		return;
+	}
+
+	// archives are validated entry by entry, named as '<archive>/<entry>'
+	source.reports.reserve(archive.entries().size());
+	for (std::size_t i = 0; i < archive.entries().size(); ++i) {
+		auto& report = source.reports.emplace_back();
+		report.file_path = source.source_path + '/' + archive.entries()[i].name;
+		::validate_image(report, archive.load_entry(i), "unable to extract entry");
+	}
+}
+catch (...) { /* keep the reports gathered so far */ }
+
+/*==================================================================*/
+
+auto bulk_validator::validate_directory(std::string_view root_path) noexcept -> std::vector<FileReport> {
+	std::vector<FileReport> reports;
+
+	try {
+		std::vector<PendingSource> pending;
+
+		std::error_code error;
+		auto it = std::filesystem::recursive_directory_iterator(root_path,
+			std::filesystem::directory_options::skip_permission_denied, error);
+
+		for (const auto end = std::filesystem::recursive_directory_iterator(); \
+			!error && it != end; it.increment(error))
+		{
+			if (!it->is_regular_file(error)) { continue; }
+			pending.emplace_back().source_path = it->path().string();
+		}
+
+		// warm the candidate index before the workers contend over its lock
+		std::ignore = CoreRegistry::get_candidate_core_span();
+
+		std::for_each(EXEC_POLICY(par)
+			pending.begin(), pending.end(), [](PendingSource& source) noexcept {
+				::validate_source(source);
+			});
+
+		for (auto& source : pending) {
+			std::move(source.reports.begin(), source.reports.end(),
+				std::back_inserter(reports));
+		}
+
+		std::sort(reports.begin(), reports.end(),
+			[](const auto& lhs, const auto& rhs) noexcept
+				{ return lhs.file_path < rhs.file_path; });
+	}
+	catch (...) { /* return whatever was gathered */ }
+
+	return reports;
+}
+
+std::string bulk_validator::format_report(std::span<const FileReport> reports) noexcept {
+	try {
+		std::string output;
+		output.reserve(reports.size() * 128);
+		output += "path\tsha1\tmatching_cores\trejections\n";
+
+		for (const auto& report : reports) {
+			auto out = std::back_inserter(output);
+			fmt::format_to(out, "{}\t{}\t", report.file_path, report.file_sha1);
+
+			if (!report.error.empty()) {
+				fmt::format_to(out, "\terror: {}\n", report.error);
+				continue;
+			}
+
+			fmt::format_to(out, "{}\t", fmt::join(report.matching_cores, ","));
+
+			for (std::size_t i = 0; i < report.rejections.size(); ++i) {
+				fmt::format_to(out, "{}{}: {}", i ? "; " : "",
+					report.rejections[i].system_name, report.rejections[i].reason);
+			}
+			output += '\n';
+		}
+
+		return output;
+	}
+	catch (...) { return {}; }
+}
@@ -0,0 +1,52 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+
+/*==================================================================*/
+
+/**
+ * @brief Batch counterpart of the candidate list shown when loading a file:
+ *        walks a directory tree, maps every regular file through FileImage and
+ *        tests it against every registered core's extension list and
+ *        validate_program callable, with files processed in parallel. ZIP
+ *        archives are opened and each of their entries validated instead.
+ */
+namespace bulk_validator {
+	struct Rejection {
+		std::string_view system_name{}; // short name of the rejecting core
+		std::string_view reason{};      // message from validate_program, or extension mismatch
+	};
+
+	struct FileReport {
+		std::string file_path{}; // '<archive>/<entry>' for archive entries
+		std::string file_sha1{};
+		std::string error{}; // set if the file could not be mapped, other fields are then empty
+
+		std::vector<std::string_view> matching_cores{}; // cores claiming the extension and accepting the program
+		std::vector<Rejection>        rejections{};     // every other core, with the reason it was excluded
+	};
+
+	/**
+	 * @brief Recursively scans a directory and validates every regular file found.
+	 * @param[in] root_path :: Directory to scan, symlinks are not followed.
+	 * @return One report per file, sorted by path.
+	 */
+	[[nodiscard]]
+	std::vector<FileReport> validate_directory(std::string_view root_path) noexcept;
+
+	/**
+	 * @brief Formats reports as tab-separated values with a header row:
+	 *        path, sha1, matching cores, rejection reasons (or error).
+	 */
+	[[nodiscard]]
+	std::string format_report(std::span<const FileReport> reports) noexcept;
+}
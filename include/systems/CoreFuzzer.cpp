@@ -0,0 +1,311 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "CoreFuzzer.hpp"
+#include "CoreRegistry.hpp"
+#include "SystemDescriptor.hpp"
+#include "SystemStaging.hpp"
+#include "ISystemEmu.hpp"
+#include "LatencyHistogram.hpp"
+#include "SimpleFileIO.hpp"
+#include "BasicLogger.hpp"
+#include "Well512.hpp"
+#include "SHA1.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fmt/format.h>
+
+/*==================================================================*/
+
+using FrameHistogram = LatencyHistogram<1024, 10>; // 0..10.24ms in 10us steps
+
+static constexpr u32 c_min_median_samples = 64;
+static constexpr auto c_max_corpus_file = 16_MiB;
+static constexpr auto c_max_random_size = 64_KiB;
+
+static core_fuzzer::Options s_options{};
+static fs::Path s_input_path{};
+static fs::Path s_findings_path{};
+
+static std::vector<char> s_current_input{};
+static std::string       s_current_sha1{};
+static std::string_view  s_current_system{};
+
+// kept across inputs, so the median reflects the core's usual frame cost rather than this input's
+static std::unordered_map<const SystemDescriptor*, FrameHistogram> s_frame_times{};
+
+// cores that were already fatal before their first frame, e.g. for missing firmware
+static std::unordered_set<const SystemDescriptor*> s_unusable_cores{};
+
+/*==================================================================*/
+
+static constexpr std::string_view get_kind_name(core_fuzzer::FindingKind kind) noexcept {
+	switch (kind) {
+		case core_fuzzer::FindingKind::FATAL_STATE: return "fatal";
+		case core_fuzzer::FindingKind::SLOW_FRAME:  return "slow";
+		case core_fuzzer::FindingKind::SANITIZER:   return "sanitizer";
+		default: return "unknown";
+	}
+}
+
+static void record_finding(
+	core_fuzzer::FindingKind kind, u32 frame, f32 millis
+) noexcept {
+	try {
+		const auto system_name = s_current_system.empty()
+			? std::string_view("none") : s_current_system;
+		const auto file_path = fs::Path(s_options.output_dir) / fmt::format("{}__{}__{}.bin",
+			get_kind_name(kind), system_name, s_current_sha1);
+
+		if (const auto file_written = ::write_file_data(file_path, s_current_input); !file_written) {
+			blog.error("Unable to save reproducer '{}': {}",
+				file_path.string(), file_written.error().message());
+		}
+
+		std::ofstream findings(s_findings_path, std::ios::app);
+		findings << fmt::format("{}\t{}\t{}\t{}\t{:.3f}\t{}\n", get_kind_name(kind),
+			system_name, s_current_sha1, frame, millis, file_path.string());
+
+		blog.warn("Fuzzer finding [{}] in '{}' at frame {} ({:.3f}ms): {}",
+			get_kind_name(kind), system_name, frame, millis, file_path.string());
+	}
+	catch (...) { /* nothing more can be done */ }
+}
+
+/*==================================================================*/
+
+static u64 seed_from_sha1(std::string_view sha1) noexcept {
+	u64 seed{};
+	std::from_chars(sha1.data(), sha1.data() + std::min(sha1.size(), std::size_t(16)), seed, 16);
+	return seed;
+}
+
+static u32 run_core(const CoreRegistry::LiveHook& hook, u64 seed) noexcept {
+	const auto& descriptor = *hook->descriptor;
+
+	if (!SystemStaging::file_image.load(s_input_path.string())) { return 0; }
+	SystemStaging::sha1_hash = s_current_sha1;
+	s_current_system = descriptor.system_name;
+
+	auto* system = hook->construct_core();
+	SystemStaging::clear();
+	if (!system) { return 0; }
+
+	system->start_headless();
+
+	// a core that can't even start says nothing about the input, so it's no finding
+	if (system->has_system_state(EmuState::FATAL)) {
+		try {
+			if (s_unusable_cores.insert(&descriptor).second) {
+				blog.warn("Core '{}' is unable to start, skipping it", descriptor.system_name);
+			}
+		} catch (...) { /* only the warning is lost */ }
+
+		CoreRegistry::destroy_core_instance(system);
+		s_current_system = {};
+		return 0;
+	}
+
+	auto& frame_times = s_frame_times[&descriptor];
+	Well512 rng(seed);
+
+	u32 findings = 0;
+	u32 key_states = 0;
+	bool has_flagged_slow = false;
+
+	for (u32 frame = 0; frame < s_options.frames_per_core; ++frame) {
+		// hold a sparse set of keys for a few frames at a time, so press/release edges are seen
+		if (!(frame & 7)) { key_states = rng.next() & rng.next() & rng.next(); }
+		system->inject_key_states(key_states);
+
+		const auto start = std::chrono::steady_clock::now();
+		system->run_single_frame();
+		const auto millis = std::chrono::duration<f32, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+
+		if (system->has_system_state(EmuState::FATAL)) {
+			record_finding(core_fuzzer::FindingKind::FATAL_STATE, frame, millis);
+			++findings; break;
+		}
+
+		const bool is_slow = millis >= s_options.stall_millis
+			|| (frame_times.size() >= c_min_median_samples
+				&& millis > frame_times.percentile(0.5f) * s_options.slow_frame_factor);
+
+		if (is_slow && !has_flagged_slow) {
+			record_finding(core_fuzzer::FindingKind::SLOW_FRAME, frame, millis);
+			++findings; has_flagged_slow = true;
+		}
+		frame_times.add(millis);
+
+		if (system->has_system_state(EmuState::ANY_STOP)) { break; }
+	}
+
+	CoreRegistry::destroy_core_instance(system);
+	s_current_system = {};
+	return findings;
+}
+
+/*==================================================================*/
+
+bool core_fuzzer::initialize(const Options& options) noexcept {
+	s_options = options;
+	if (s_options.output_dir.empty()) { s_options.output_dir = "fuzz_output"; }
+
+	try {
+		s_input_path    = fs::Path(s_options.output_dir) / "current_input.bin";
+		s_findings_path = fs::Path(s_options.output_dir) / "findings.tsv";
+	}
+	catch (...) { return false; }
+
+	if (const auto dir_created = fs::create_directories(s_options.output_dir); !dir_created) {
+		blog.error("Unable to create fuzzer output directory '{}': {}",
+			s_options.output_dir, dir_created.error().message());
+		return false;
+	}
+
+	// warm the candidate index before the first input is timed
+	std::ignore = CoreRegistry::get_candidate_core_span();
+	return true;
+}
+
+u32  core_fuzzer::run_input(std::span<const char> input) noexcept {
+	if (input.empty() || s_input_path.empty()) { return 0; }
+
+	try { s_current_input.assign(input.begin(), input.end()); }
+	catch (...) { return 0; }
+
+	s_current_sha1 = SHA1::from(input);
+
+	// cores read their program through a mapped file, it also survives a hard crash this way
+	if (const auto file_written = ::write_file_data(s_input_path, s_current_input); !file_written) {
+		blog.error("Unable to write fuzzer input '{}': {}",
+			s_input_path.string(), file_written.error().message());
+		return 0;
+	}
+
+	const auto seed = seed_from_sha1(s_current_sha1);
+
+	u32 findings = 0;
+	u32 core_index = 0;
+
+	for (const auto& hook : CoreRegistry::get_candidate_core_span()) {
+		++core_index;
+		if (hook->descriptor->validate_program(input)) { continue; }
+		findings += ::run_core(hook, seed ^ core_index);
+	}
+
+	return findings;
+}
+
+/*==================================================================*/
+
+static auto gather_corpus(std::string_view corpus_dir) noexcept -> std::vector<std::string> {
+	std::vector<std::string> files;
+	if (corpus_dir.empty()) { return files; }
+
+	try {
+		std::error_code error;
+		auto it = std::filesystem::recursive_directory_iterator(corpus_dir,
+			std::filesystem::directory_options::skip_permission_denied, error);
+
+		for (const auto end = std::filesystem::recursive_directory_iterator(); \
+			!error && it != end; it.increment(error))
+		{
+			if (it->is_regular_file(error) && it->file_size(error) <= c_max_corpus_file) {
+				files.push_back(it->path().string());
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+	}
+	catch (...) { /* use whatever was gathered */ }
+
+	return files;
+}
+
+static void mutate_input(std::vector<char>& input, Well512& rng) noexcept {
+	const auto mutations = 1 + rng.next() % 8;
+
+	for (u32 i = 0; i < mutations && !input.empty(); ++i) {
+		const auto pos = rng.next() % input.size();
+
+		switch (rng.next() % 5) {
+			case 0: // flip a single bit
+				input[pos] ^= char(1 << (rng.next() & 7));
+				break;
+
+			case 1: // overwrite a byte
+				input[pos] = char(rng.next());
+				break;
+
+			case 2: // overwrite a short run of bytes
+				for (auto j = pos, end = std::min(input.size(), pos + 1 + rng.next() % 16); j < end; ++j)
+					{ input[j] = char(rng.next()); }
+				break;
+
+			case 3: // copy a chunk of the input over another place
+			{
+				const auto src = rng.next() % input.size();
+				const auto len = std::min({ input.size() - src, input.size() - pos,
+					std::size_t(1 + rng.next() % 64) });
+				std::memmove(input.data() + pos, input.data() + src, len);
+				break;
+			}
+			case 4: // truncate, sizes in headers often disagree with the file
+				if (input.size() > 1) { input.resize(1 + pos); }
+				break;
+		}
+	}
+}
+
+u32  core_fuzzer::run_random(std::string_view corpus_dir, u32 iterations, u64 seed) noexcept {
+	const auto corpus = ::gather_corpus(corpus_dir);
+	blog.info("Fuzzing {} iterations from {} corpus files, seed {}",
+		iterations, corpus.size(), seed);
+
+	Well512 rng(seed);
+	u32 findings = 0;
+
+	for (u32 i = 0; i < iterations; ++i) {
+		std::vector<char> input;
+
+		if (!corpus.empty() && (rng.next() & 3)) {
+			if (auto file_data = ::read_file_data(corpus[rng.next() % corpus.size()])) {
+				input = std::move(*file_data);
+			}
+			::mutate_input(input, rng);
+		}
+
+		if (input.empty()) {
+			try { input.resize(1 + rng.next() % c_max_random_size); }
+			catch (...) { continue; }
+
+			for (auto& byte : input) { byte = char(rng.next()); }
+		}
+
+		findings += run_input(input);
+	}
+
+	blog.info("Fuzzing done, {} findings recorded in '{}'",
+		findings, s_options.output_dir);
+	return findings;
+}
+
+/*==================================================================*/
+
+void core_fuzzer::save_current_input(FindingKind kind) noexcept {
+	if (s_current_input.empty()) { return; }
+	record_finding(kind, 0, 0.0f);
+}
@@ -0,0 +1,66 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <span>
+
+#include "EzMaths.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief Runs arbitrary program images through every registered core: each core
+ *        whose validate_program accepts the input is constructed headless and
+ *        driven for a bounded amount of frames with random keypad input. Cores
+ *        turning FATAL and frames far slower than the core's median are recorded,
+ *        the input being saved as a reproducer. Out-of-bounds accesses are left to
+ *        the sanitizers the fuzz target is built with, see save_current_input().
+ */
+namespace core_fuzzer {
+	enum class FindingKind : u8 {
+		FATAL_STATE, // core entered EmuState::FATAL
+		SLOW_FRAME,  // frame took slow_frame_factor times the median, or stall_millis
+		SANITIZER,   // process is being torn down by a sanitizer report
+	};
+
+	struct Options {
+		std::string output_dir{};      // reproducers and findings.tsv are written here
+		u32  frames_per_core   = 300;  // upper bound of frames run per accepting core
+		f32  slow_frame_factor = 100.0f;
+		f32  stall_millis      = 1000.0f; // flagged even before a median is established
+	};
+
+	/**
+	 * @brief Prepares the output directory, must be called before running inputs.
+	 * @return False if the output directory cannot be created.
+	 */
+	bool initialize(const Options& options) noexcept;
+
+	/**
+	 * @brief Runs a single input through every registered core.
+	 * @return Amount of findings recorded for this input.
+	 */
+	u32  run_input(std::span<const char> input) noexcept;
+
+	/**
+	 * @brief Runs inputs mutated from the files of a corpus directory, or purely
+	 *        random bytes if the corpus is empty or missing.
+	 * @param[in] corpus_dir :: Directory scanned recursively for seed files, may be empty.
+	 * @param[in] iterations :: Amount of inputs to generate and run.
+	 * @param[in] seed       :: Seed of the mutator, the same seed replays the same inputs.
+	 * @return Amount of findings recorded over all iterations.
+	 */
+	u32  run_random(std::string_view corpus_dir, u32 iterations, u64 seed) noexcept;
+
+	/**
+	 * @brief Saves the input currently being run as a reproducer of the given kind,
+	 *        meant to be called from a sanitizer death callback.
+	 */
+	void save_current_input(FindingKind kind) noexcept;
+}
@@ -6,12 +6,19 @@
 
 #include <vector>
 #include <tuple>
+#include <mutex>
+#include <string>
+#include <new>
+#include <optional>
+#include <unordered_map>
 
 #include "nlohmann/json.hpp"
 #include "BasicLogger.hpp"
 #include "PathGetters.hpp"
 #include "SimpleFileIO.hpp"
 #include "CoreRegistry.hpp"
+#include "ISystemEmu.hpp"
+#include "HDIS_HCIS.hpp"
 #include "SystemDescriptor.hpp"
 
 /*==================================================================*/
@@ -21,6 +28,9 @@ using Json = nlohmann::json;
 static Json s_game_database;
 static Json s_custom_core_cfg;
 
+// guards s_game_database against lookups from other threads while it's replaced
+static std::mutex s_game_database_lock;
+
 static bool load_json_from_file(std::string_view json_file_path, Json& output) noexcept {
 	if (auto json_data = ::read_file_data(json_file_path)) {
 		try {
@@ -34,18 +44,81 @@ static bool load_json_from_file(std::string_view json_file_path, Json& output) n
 	return false;
 }
 
-void CoreRegistry::load_game_database(std::string_view db_file_path) noexcept {
+auto CoreRegistry::get_game_database_path() noexcept -> const std::string& {
 	static const auto default_db_path = (::get_base_path() / fs::Path("programDB.json")).string();
-	std::string_view normalized_path = db_file_path.empty() ? default_db_path : db_file_path;
+	return default_db_path;
+}
+
+void CoreRegistry::load_game_database(std::string_view db_file_path) noexcept {
+	std::string_view normalized_path = db_file_path.empty() ? get_game_database_path() : db_file_path;
 
-	if (!load_json_from_file(normalized_path, s_game_database)) {
-		s_game_database.clear();
+	Json loaded;
+	const bool success = load_json_from_file(normalized_path, loaded);
+	{
+		std::scoped_lock lock(s_game_database_lock);
+		s_game_database = std::move(loaded);
+	}
+
+	if (!success) {
 		blog.warn("Failed to load ProgramDB: \"{}\"", normalized_path);
 	} else {
 		blog.info("Successfully loaded ProgramDB: \"{}\"", normalized_path);
 	}
 }
 
+static std::mutex          s_staged_database_lock;
+static std::optional<Json> s_staged_game_database;
+
+void CoreRegistry::stage_game_database() noexcept {
+	Json staged;
+	if (!load_json_from_file(get_game_database_path(), staged)) {
+		blog.warn("ProgramDB change rejected, keeping the loaded one: \"{}\"",
+			get_game_database_path());
+		return;
+	}
+
+	std::scoped_lock lock(s_staged_database_lock);
+	s_staged_game_database = std::move(staged);
+}
+
+bool CoreRegistry::commit_staged_game_database() noexcept {
+	std::optional<Json> staged;
+	{
+		std::scoped_lock lock(s_staged_database_lock);
+		staged.swap(s_staged_game_database);
+	}
+	if (!staged) { return false; }
+
+	{
+		std::scoped_lock lock(s_game_database_lock);
+		s_game_database = std::move(*staged);
+	}
+	blog.info("Successfully reloaded ProgramDB: \"{}\"", get_game_database_path());
+	return true;
+}
+
+auto CoreRegistry::find_program_title(std::string_view sha1_hash) noexcept -> std::string {
+	try {
+		std::scoped_lock lock(s_game_database_lock);
+		if (!s_game_database.is_object()) { return {}; }
+
+		// entries are keyed by SHA1: { "<sha1>": { "title": "...", ... } }
+		const auto entry = s_game_database.find(std::string(sha1_hash));
+		if (entry == s_game_database.end() || !entry->is_object()) { return {}; }
+
+		const auto title = entry->find("title");
+		if (title == entry->end() || !title->is_string()) { return {}; }
+		return title->get<std::string>();
+	}
+	catch (...) { return {}; }
+}
+
+void CoreRegistry::destroy_core_instance(ISystemEmu* system) noexcept {
+	if (!system) { return; }
+	system->~ISystemEmu();
+	::operator delete(system, std::align_val_t(::HDIS));
+}
+
 /*==================================================================*/
 
 static auto& get_registry() noexcept {
@@ -65,25 +138,84 @@ void CoreRegistry::insert_new_registration(const LiveHook& entry) noexcept {
 
 /*==================================================================*/
 
-auto CoreRegistry::get_candidate_core_span() noexcept -> std::span<const LiveHook> {
-	static std::vector<LiveHook>
-		s_candidate_systems{};
+static std::string to_lower_ascii(std::string_view str) {
+	std::string output(str);
+	for (auto& c : output) {
+		if (c >= 'A' && c <= 'Z') { c = char(c - 'A' + 'a'); }
+	}
+	return output;
+}
 
-	s_candidate_systems.clear();
+/**
+ * Registrations only happen during static initialization, so the sorted candidate
+ * list and the extension index are built once on first use and merely revalidated
+ * against the registry size afterwards, instead of being rebuilt on every query.
+ */
+struct CandidateIndex {
+	std::mutex  guard;
+	std::size_t registry_size = ~0ull;
+
+	std::vector<CoreRegistry::LiveHook> candidates;
+	std::unordered_map<std::string, std::vector<CoreRegistry::LiveHook>> by_extension;
+
+	void refresh_if_stale() {
+		const auto& registry = get_registry();
+		if (registry_size == registry.size()) { return; }
+
+		candidates.clear();
+		by_extension.clear();
+
+		for (const auto& entry_ptr : registry) {
+			if (const auto entry = entry_ptr.lock()) {
+				candidates.push_back(entry);
+			}
+		}
 
-	for (const auto& entry_ptr : get_registry()) {
-		if (const auto entry = entry_ptr.lock()) {
-			s_candidate_systems.push_back(entry);
+		std::sort(candidates.begin(), candidates.end(),
+			[](const auto& lhs, const auto& rhs) {
+				const auto& ldesc = *lhs->descriptor;
+				const auto& rdesc = *rhs->descriptor;
+				return std::tie(ldesc.family_name, ldesc.system_name)
+					 < std::tie(rdesc.family_name, rdesc.system_name);
+			});
+
+		for (const auto& entry : candidates) {
+			for (const auto& ext : entry->descriptor->known_extensions) {
+				auto& bucket = by_extension[::to_lower_ascii(ext)];
+				if (std::find(bucket.begin(), bucket.end(), entry) == bucket.end())
+					{ bucket.push_back(entry); }
+			}
 		}
+
+		registry_size = registry.size();
 	}
+};
+
+static auto& get_candidate_index() noexcept {
+	static CandidateIndex s_candidate_index;
+	return s_candidate_index;
+}
+
+auto CoreRegistry::get_candidate_core_span() noexcept -> std::span<const LiveHook> {
+	auto& index = get_candidate_index();
+
+	try {
+		std::scoped_lock lock(index.guard);
+		index.refresh_if_stale();
+	} catch (...) { return {}; }
+
+	return index.candidates;
+}
+
+auto CoreRegistry::get_extension_core_span(std::string_view extension) noexcept -> std::span<const LiveHook> {
+	auto& index = get_candidate_index();
 
-	std::sort(s_candidate_systems.begin(), s_candidate_systems.end(),
-		[](const auto& lhs, const auto& rhs) {
-			const auto& ldesc = *lhs->descriptor;
-			const auto& rdesc = *rhs->descriptor;
-			return std::tie(ldesc.family_name, ldesc.system_name)
-				 < std::tie(rdesc.family_name, rdesc.system_name);
-		});
+	try {
+		std::scoped_lock lock(index.guard);
+		index.refresh_if_stale();
 
-	return s_candidate_systems;
+		const auto it = index.by_extension.find(::to_lower_ascii(extension));
+		if (it == index.by_extension.end()) { return {}; }
+		return it->second;
+	} catch (...) { return {}; }
 }
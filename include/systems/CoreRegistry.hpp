@@ -8,6 +8,7 @@
 
 #include <span>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <algorithm>
 
@@ -83,10 +84,25 @@ private:
 	}
 
 public:
+	// Returns all live core registrations, sorted by family and system name.
 	static auto get_candidate_core_span() noexcept -> std::span<const LiveHook>;
+	// Returns the live core registrations claiming the given file extension (case-insensitive).
+	static auto get_extension_core_span(std::string_view extension) noexcept -> std::span<const LiveHook>;
 
+	static auto get_game_database_path() noexcept -> const std::string&;
 	static void load_game_database(std::string_view db_file_path = {}) noexcept;
 
+	// Parses the default ProgramDB off the main thread, keeping the result for a later commit.
+	static void stage_game_database() noexcept;
+	// Swaps in the ProgramDB staged last, if any. Must run on the main thread.
+	static bool commit_staged_game_database() noexcept;
+
+	// Title of the program with the given SHA1 in the ProgramDB, if listed. Thread-safe.
+	static auto find_program_title(std::string_view sha1_hash) noexcept -> std::string;
+
+	// Destroys a core made by a registration's construct_core, freeing its aligned storage.
+	static void destroy_core_instance(ISystemEmu* system) noexcept;
+
 	template <typename Core>
 		requires (std::derived_from<Core, ISystemEmu>)
 	static auto register_new_system_core()
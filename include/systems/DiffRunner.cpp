@@ -0,0 +1,504 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "DiffRunner.hpp"
+#include "CoreRegistry.hpp"
+#include "SystemDescriptor.hpp"
+#include "SystemStaging.hpp"
+#include "ISystemEmu.hpp"
+#include "DisplayDevice.hpp"
+
+#include <memory>
+#include <cctype>
+#include <cstring>
+#include <utility>
+#include <charconv>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+/*==================================================================*/
+
+static constexpr u32 c_max_frame_steps = 10'000'000; // instructions stepped through a divergent frame
+static constexpr u32 c_max_diff_lines  = 12;         // differences listed per category
+
+struct DestroyInstance {
+	void operator()(ISystemEmu* ptr) const noexcept {
+		CoreRegistry::destroy_core_instance(ptr);
+	}
+};
+using InstancePtr = std::unique_ptr<ISystemEmu, DestroyInstance>;
+
+struct Lane {
+	const diff_runner::CoreSpec* spec{};
+	CoreRegistry::LiveHook hook{};
+	std::string label{};
+	InstancePtr system{};
+
+	std::vector<u8> ignored{}; // memory bytes that already differed from the reference after init
+	bool frames_comparable = true;
+};
+
+enum class StepResult { EXECUTED, FRAME_DONE, STOPPED };
+
+/*==================================================================*/
+
+static bool equals_ignore_case(std::string_view lhs, std::string_view rhs) noexcept {
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+		[](char a, char b) noexcept { return (a | 0x20) == (b | 0x20); });
+}
+
+static auto find_core_hook(std::string_view system_name) noexcept -> CoreRegistry::LiveHook {
+	for (const auto& hook : CoreRegistry::get_candidate_core_span()) {
+		if (equals_ignore_case(hook->descriptor->system_name, system_name)) { return hook; }
+	}
+	return {};
+}
+
+static u32 key_states_at(std::span<const diff_runner::KeyEvent> script, u32 frame) noexcept {
+	u32 key_states = 0;
+	for (const auto& event : script) {
+		if (event.frame > frame) { break; }
+		key_states = event.key_states;
+	}
+	return key_states;
+}
+
+/*==================================================================*/
+
+static bool create_instance(Lane& lane, const std::string& program_path, std::string& error) noexcept {
+	lane.system.reset();
+
+	if (!SystemStaging::file_image.load(program_path)) {
+		error = fmt::format("Unable to map program '{}'", program_path);
+		return false;
+	}
+
+	if (const auto* reason = lane.hook->descriptor->validate_program(SystemStaging::file_image.span())) {
+		SystemStaging::clear();
+		error = fmt::format("Core '{}' rejects the program: {}", lane.label, reason);
+		return false;
+	}
+
+	lane.system.reset(lane.hook->construct_core());
+	SystemStaging::clear();
+
+	if (!lane.system) {
+		error = fmt::format("Unable to construct core '{}'", lane.label);
+		return false;
+	}
+
+	lane.system->start_headless();
+
+	if (lane.system->has_system_state(EmuState::FATAL)) {
+		error = fmt::format("Core '{}' is unable to start, see the log for why", lane.label);
+		return false;
+	}
+
+	for (const auto& [quirk, state] : lane.spec->quirks) {
+		if (!lane.system->override_quirk(quirk, state)) {
+			error = fmt::format("Core '{}' has no quirk named '{}'", lane.label, quirk);
+			return false;
+		}
+	}
+
+	if (auto* display = lane.system->get_display_device()) {
+		display->set_frame_checksums(true);
+	}
+	return true;
+}
+
+static bool create_instances(std::span<Lane> lanes, const std::string& program_path, std::string& error) noexcept {
+	for (auto& lane : lanes) {
+		if (!create_instance(lane, program_path, error)) { return false; }
+	}
+	return true;
+}
+
+static void run_frame(std::span<Lane> lanes, u32 key_states) noexcept {
+	for (auto& lane : lanes) {
+		lane.system->inject_key_states(key_states);
+		lane.system->run_single_frame();
+	}
+}
+
+static StepResult step_instruction(ISystemEmu& system) noexcept {
+	system.debugger_step_instruction(1);
+	system.run_single_frame();
+
+	if (system.has_system_state(EmuState::ANY_STOP)) { return StepResult::STOPPED; }
+	// a stop after the instruction leaves the system paused, a frame running out of cycles does not
+	return system.has_system_state(EmuState::PAUSED)
+		? StepResult::EXECUTED : StepResult::FRAME_DONE;
+}
+
+static void finish_frame(ISystemEmu& system) noexcept {
+	const auto frames = system.get_elapsed_frames();
+
+	system.debugger_step_instruction(0); // clears the pending step and unpauses
+	for (u32 attempt = 0; attempt < 4 && frames == system.get_elapsed_frames(); ++attempt) {
+		if (system.has_system_state(EmuState::ANY_STOP)) { return; }
+		system.run_single_frame();
+	}
+}
+
+/*==================================================================*/
+
+// Ranges of memory written by either core, merged and cut to 'size', the rest is zero on both.
+static auto get_written_ranges(const Lane& reference, const Lane& lane, std::size_t size)
+	-> std::vector<ISystemEmu::MemoryRange>
+{
+	std::vector<ISystemEmu::MemoryRange> ranges, merged;
+	reference.system->read_written_memory(ranges);
+	lane.system->read_written_memory(ranges);
+
+	std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) noexcept
+		{ return lhs.offset < rhs.offset; });
+
+	for (const auto& range : ranges) {
+		if (range.offset >= size) { break; }
+		const auto end = std::min(size, range.offset + range.size);
+
+		if (!merged.empty() && range.offset <= merged.back().offset + merged.back().size) {
+			auto& last = merged.back();
+			last.size = std::max(last.size, end - last.offset);
+		} else {
+			merged.push_back({ range.offset, end - range.offset });
+		}
+	}
+	return merged;
+}
+
+static void build_ignore_mask(const Lane& reference, Lane& lane) noexcept {
+	const auto ref_memory = reference.system->get_system_memory();
+	const auto memory = lane.system->get_system_memory();
+	const auto size = std::min(ref_memory.size(), memory.size());
+
+	try {
+		lane.ignored.assign(size, 0);
+
+		for (const auto& range : ::get_written_ranges(reference, lane, size)) {
+			for (auto i = range.offset; i < range.offset + range.size; ++i) {
+				lane.ignored[i] = ref_memory[i] != memory[i];
+			}
+		}
+	}
+	catch (...) { lane.ignored.clear(); }
+}
+
+static u32 read_pc(const ISystemEmu& system) noexcept {
+	std::vector<ISystemEmu::RegisterValue> registers;
+	system.read_register_file(registers);
+	return registers.empty() ? 0 : registers.front().value;
+}
+
+// Appends the differences between the reference and the lane, returns whether there were any.
+static bool compare_lane(const Lane& reference, Lane& lane, std::string& output) noexcept {
+	bool diverged = false;
+
+	try {
+		auto out = std::back_inserter(output);
+
+		std::vector<ISystemEmu::RegisterValue> ref_registers, registers;
+		reference.system->read_register_file(ref_registers);
+		lane.system->read_register_file(registers);
+
+		u32 lines = 0;
+		for (const auto& ref : ref_registers) {
+			const auto it = std::find_if(registers.begin(), registers.end(),
+				[&](const auto& entry) noexcept { return entry.name == ref.name; });
+
+			if (it == registers.end() || it->value == ref.value) { continue; }
+			if (lines++ < c_max_diff_lines) {
+				fmt::format_to(out, "    reg {:>3}: 0x{:X} vs 0x{:X}\n", ref.name, ref.value, it->value);
+			}
+			diverged = true;
+		}
+
+		const auto ref_memory = reference.system->get_system_memory();
+		const auto memory = lane.system->get_system_memory();
+		const auto size = std::min({ ref_memory.size(), memory.size(), lane.ignored.size() });
+
+		// only the written parts of large, mostly untouched memories need comparing
+		u32 count = 0;
+		for (const auto& range : ::get_written_ranges(reference, lane, size)) {
+			if (!std::memcmp(ref_memory.data() + range.offset,
+				memory.data() + range.offset, range.size)) { continue; }
+
+			for (auto i = range.offset; i < range.offset + range.size; ++i) {
+				if (lane.ignored[i] || ref_memory[i] == memory[i]) { continue; }
+				if (count++ < c_max_diff_lines) {
+					fmt::format_to(out, "    mem 0x{:04X}: 0x{:02X} vs 0x{:02X}\n", i, ref_memory[i], memory[i]);
+				}
+			}
+		}
+		if (count > c_max_diff_lines) {
+			fmt::format_to(out, "    ... {} differing bytes in total\n", count);
+		}
+		diverged |= count != 0;
+
+		const auto* ref_display = reference.system->get_display_device();
+		const auto* display = lane.system->get_display_device();
+
+		if (ref_display && display && lane.frames_comparable) {
+			const auto ref_frame = ref_display->get_frame_checksum();
+			const auto frame = display->get_frame_checksum();
+
+			if (ref_frame.w != frame.w || ref_frame.h != frame.h) {
+				fmt::format_to(out, "    note: frame sizes differ ({}x{} vs {}x{}), frames are no longer compared\n",
+					ref_frame.w, ref_frame.h, frame.w, frame.h);
+				lane.frames_comparable = false;
+			}
+			else if (!ref_frame.matches(frame)) {
+				fmt::format_to(out, "    frame crc: 0x{:08X} vs 0x{:08X}\n", ref_frame.crc, frame.crc);
+				diverged = true;
+			}
+		}
+	}
+	catch (...) { /* report what was gathered */ }
+
+	return diverged;
+}
+
+static void append_disassembly(const ISystemEmu& system, u32 pc, u32 window, std::string& output) noexcept {
+	try {
+		auto out = std::back_inserter(output);
+		std::string line;
+
+		// instructions are assumed to be at least 2 bytes wide to find a start before the PC
+		auto addr = pc - std::min(pc, (window / 2) * 2);
+		bool shown_pc = false;
+
+		for (u32 i = 0; i < window; ++i) {
+			// an instruction straddling the PC means the start was misaligned, resync on the PC
+			if (addr > pc && addr - pc < 4 && !std::exchange(shown_pc, true)) { addr = pc; }
+			shown_pc |= addr == pc;
+
+			const auto size = std::max(system.disassemble(addr, line), 1u);
+			fmt::format_to(out, "    {} {:04X}: {}\n", addr == pc ? '>' : ' ', addr, line);
+			addr += size;
+		}
+	}
+	catch (...) { /* report what was gathered */ }
+}
+
+/*==================================================================*/
+
+static u32 locate_instruction(
+	std::span<Lane> lanes, const diff_runner::Options& options,
+	u32 frame, std::string& output
+) noexcept {
+	auto out = std::back_inserter(output);
+	std::string error;
+
+	// cores are deterministic for a given program and input, so a replay reaches the same state
+	if (!create_instances(lanes, options.program_path, error)) {
+		fmt::format_to(out, "Replay failed: {}\n", error);
+		return 0;
+	}
+
+	for (u32 i = 0; i < frame; ++i) {
+		run_frame(lanes, key_states_at(options.key_script, i));
+	}
+
+	const auto key_states = key_states_at(options.key_script, frame);
+	for (auto& lane : lanes) { lane.system->inject_key_states(key_states); }
+
+	std::vector<u32> pcs(lanes.size());
+	std::vector<u32> executed(lanes.size());
+	std::vector<StepResult> results(lanes.size(), StepResult::EXECUTED);
+
+	for (u32 step = 0; step < c_max_frame_steps; ++step) {
+		bool in_lockstep = true;
+
+		for (std::size_t i = 0; i < lanes.size(); ++i) {
+			pcs[i] = read_pc(*lanes[i].system);
+			results[i] = step_instruction(*lanes[i].system);
+			if (results[i] != StepResult::EXECUTED) { in_lockstep = false; }
+			else { ++executed[i]; }
+		}
+		if (!in_lockstep) { break; }
+
+		std::string details;
+		for (std::size_t i = 1; i < lanes.size(); ++i) {
+			if (!compare_lane(lanes[0], lanes[i], details)) { continue; }
+
+			fmt::format_to(out, "First divergent instruction: #{} of frame {}, '{}' vs '{}':\n{}",
+				step, frame, lanes[0].label, lanes[i].label, details);
+
+			for (const auto j : { std::size_t(0), i }) {
+				fmt::format_to(out, "  {} at PC 0x{:04X}:\n", lanes[j].label, pcs[j]);
+				append_disassembly(*lanes[j].system, pcs[j], options.window_size, output);
+			}
+			return step;
+		}
+	}
+
+	// every instruction matched, the difference comes from the frame's boundary work,
+	// so only the lanes still mid-frame are run up to it, the rest are already there
+	for (std::size_t i = 0; i < lanes.size(); ++i) {
+		if (results[i] == StepResult::EXECUTED) { finish_frame(*lanes[i].system); }
+	}
+
+	fmt::format_to(out, "No single instruction of frame {} diverges, the difference arises at the frame"
+		" boundary (timers, interrupts, video or cycles per frame). Instructions executed:\n", frame);
+	for (std::size_t i = 0; i < lanes.size(); ++i) {
+		fmt::format_to(out, "  {}: {}\n", lanes[i].label, executed[i]);
+	}
+	for (std::size_t i = 1; i < lanes.size(); ++i) {
+		std::string details;
+		if (compare_lane(lanes[0], lanes[i], details)) {
+			fmt::format_to(out, "  '{}' vs '{}':\n{}", lanes[0].label, lanes[i].label, details);
+		}
+	}
+	return 0;
+}
+
+/*==================================================================*/
+
+auto diff_runner::parse_core_spec(std::string_view text) noexcept -> std::optional<CoreSpec> {
+	try {
+		CoreSpec spec;
+
+		auto pos = text.find(':');
+		spec.system_name = text.substr(0, pos);
+		if (spec.system_name.empty()) { return std::nullopt; }
+
+		while (pos != text.npos) {
+			const auto next = text.find(':', pos + 1);
+			const auto token = text.substr(pos + 1, next == text.npos ? next : next - pos - 1);
+
+			if (token.size() < 2 || (token[0] != '+' && token[0] != '-')) { return std::nullopt; }
+			spec.quirks.emplace_back(std::string(token.substr(1)), token[0] == '+');
+			pos = next;
+		}
+		return spec;
+	}
+	catch (...) { return std::nullopt; }
+}
+
+auto diff_runner::parse_key_script(std::string_view text) noexcept -> std::optional<std::vector<KeyEvent>> {
+	try {
+		std::vector<KeyEvent> events;
+
+		const auto parse_number = [](std::string_view token, u32& value) noexcept {
+			const auto is_hex = token.starts_with("0x") || token.starts_with("0X");
+			if (is_hex) { token.remove_prefix(2); }
+
+			const auto result = std::from_chars(token.data(), token.data() + token.size(), value, is_hex ? 16 : 10);
+			return result.ec == std::errc{} && result.ptr == token.data() + token.size() && !token.empty();
+		};
+
+		while (!text.empty()) {
+			const auto eol = text.find('\n');
+			auto line = text.substr(0, eol);
+			text.remove_prefix(eol == text.npos ? text.size() : eol + 1);
+
+			line = line.substr(0, line.find('#'));
+			while (!line.empty() && std::isspace(u8(line.back())))  { line.remove_suffix(1); }
+			while (!line.empty() && std::isspace(u8(line.front()))) { line.remove_prefix(1); }
+			if (line.empty()) { continue; }
+
+			const auto space = line.find_first_of(" \t");
+			if (space == line.npos) { return std::nullopt; }
+
+			auto second = line.substr(space);
+			while (!second.empty() && std::isspace(u8(second.front()))) { second.remove_prefix(1); }
+
+			KeyEvent event;
+			if (!parse_number(line.substr(0, space), event.frame)) { return std::nullopt; }
+			if (!parse_number(second, event.key_states)) { return std::nullopt; }
+			events.push_back(event);
+		}
+
+		std::stable_sort(events.begin(), events.end(),
+			[](const auto& lhs, const auto& rhs) noexcept { return lhs.frame < rhs.frame; });
+		return events;
+	}
+	catch (...) { return std::nullopt; }
+}
+
+/*==================================================================*/
+
+auto diff_runner::run(const Options& options) noexcept -> Result {
+	Result result;
+
+	try {
+		auto out = std::back_inserter(result.report);
+
+		if (options.cores.size() < 2) {
+			result.report = "At least two cores are needed for a comparison.\n";
+			return result;
+		}
+
+		std::vector<Lane> lanes(options.cores.size());
+
+		for (std::size_t i = 0; i < lanes.size(); ++i) {
+			auto& lane = lanes[i];
+			lane.spec  = &options.cores[i];
+			lane.label = lane.spec->system_name;
+
+			for (const auto& [quirk, state] : lane.spec->quirks) {
+				fmt::format_to(std::back_inserter(lane.label), ":{}{}", state ? '+' : '-', quirk);
+			}
+
+			lane.hook = find_core_hook(lane.spec->system_name);
+			if (!lane.hook) {
+				fmt::format_to(out, "No registered core named '{}'.\n", lane.spec->system_name);
+				return result;
+			}
+		}
+
+		std::string error;
+		if (!create_instances(lanes, options.program_path, error)) {
+			fmt::format_to(out, "{}.\n", error);
+			return result;
+		}
+
+		for (std::size_t i = 1; i < lanes.size(); ++i) {
+			build_ignore_mask(lanes[0], lanes[i]);
+		}
+		result.success = true;
+
+		for (u32 frame = 0; frame < options.frame_limit; ++frame) {
+			run_frame(lanes, key_states_at(options.key_script, frame));
+
+			std::string details;
+			for (std::size_t i = 1; i < lanes.size(); ++i) {
+				if (!compare_lane(lanes[0], lanes[i], details)) { continue; }
+
+				result.diverged = true;
+				result.frame    = frame;
+
+				fmt::format_to(out, "Divergence after frame {}, '{}' vs '{}':\n{}\n",
+					frame, lanes[0].label, lanes[i].label, details);
+
+				// the localization below reruns all lanes, the current states are no longer needed
+				locate_instruction(lanes, options, frame, result.report);
+				return result;
+			}
+			result.report += details; // notes only
+
+			if (std::all_of(lanes.begin(), lanes.end(), [](const auto& lane) noexcept
+				{ return lane.system->has_system_state(EmuState::ANY_STOP); }))
+			{
+				fmt::format_to(out, "All cores stopped at frame {}.\n", frame);
+				break;
+			}
+		}
+
+		if (!result.diverged) {
+			fmt::format_to(out, "No divergence over {} frames across {} cores.\n",
+				options.frame_limit, lanes.size());
+		}
+	}
+	catch (...) {
+		result.success = false;
+		result.report += "Out of memory.\n";
+	}
+
+	return result;
+}
@@ -0,0 +1,72 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+
+#include "EzMaths.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief Runs one program on several cores (or one core with different quirk sets)
+ *        in lockstep, headless, and compares their register files, main memory and
+ *        presented frames after every frame. On the first divergent frame, all cores
+ *        are replayed up to it and single-stepped through it by instruction, locating
+ *        the first instruction after which their states differ.
+ *
+ * Every core is compared against the first one listed. Memory is compared over the
+ * common size, ignoring bytes that already differed right after initialization
+ * (e.g. font sets), and frames are only compared while both have the same size.
+ */
+namespace diff_runner {
+	struct CoreSpec {
+		std::string system_name{}; // as in SystemDescriptor, case-insensitive
+		std::vector<std::pair<std::string, bool>>
+			quirks{}; // quirk overrides applied after initialization
+	};
+
+	struct KeyEvent {
+		u32 frame{};      // first frame the key states apply to
+		u32 key_states{}; // bitfield of held bind indices, until the next event
+	};
+
+	struct Options {
+		std::string program_path{};
+		std::vector<CoreSpec> cores{}; // at least two entries
+		std::vector<KeyEvent> key_script{};
+		u32 frame_limit = 600;
+		u32 window_size = 8; // instructions disassembled around each divergent PC
+	};
+
+	/**
+	 * @brief Parses 'system_name[:+QUIRK|:-QUIRK]...', e.g. 'schip_modern:+SHIFT_VX_REG'.
+	 */
+	[[nodiscard]]
+	auto parse_core_spec(std::string_view text) noexcept -> std::optional<CoreSpec>;
+
+	/**
+	 * @brief Parses an input script of '<frame> <key_states>' lines, '#' starting a comment.
+	 *        Key states may be given in decimal or as 0x-prefixed hex.
+	 * @return Events sorted by frame, or empty if a line is malformed.
+	 */
+	[[nodiscard]]
+	auto parse_key_script(std::string_view text) noexcept -> std::optional<std::vector<KeyEvent>>;
+
+	struct Result {
+		bool        success{};  // false if the run could not be set up, see 'report'
+		bool        diverged{};
+		u32         frame{};    // first divergent frame
+		std::string report{};   // human-readable summary of the run
+	};
+
+	[[nodiscard]]
+	Result run(const Options& options) noexcept;
+}
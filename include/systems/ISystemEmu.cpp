@@ -10,6 +10,8 @@
 #include "StringJoin.hpp"
 #include "SimpleFileIO.hpp"
 #include "Millis.hpp"
+#include "ZoneProfiler.hpp"
+#include "InstanceScheduler.hpp"
 #include "SHA1.hpp"
 
 #include "BasicLogger.hpp"
@@ -24,7 +26,6 @@ ISystemEmu::ISystemEmu(std::string_view window_name) noexcept
 		static std::atomic<u32> instance_counter = 1u;
 		return instance_counter.fetch_add(1, mo::relaxed);
 	}())
-	, m_statistics_data(std::make_shared<std::string>())
 	, m_rng(std::make_unique<Well512>(Millis::initial()))
 	, m_workspace_host({ window_name, make_system_id(instance_id, "system")})
 	, m_file_image(std::move(SystemStaging::file_image))
@@ -36,47 +37,44 @@ ISystemEmu::ISystemEmu(std::string_view window_name) noexcept
 }
 
 void ISystemEmu::start_worker() noexcept {
-	if (!m_system_thread.joinable()) {
+	if (!m_system_thread.joinable() && !m_is_pooled) {
 		initialize_family();
 		initialize_system();
 
+		if (InstanceScheduler::is_pooled_mode()) {
+			m_is_pooled = true;
+			InstanceScheduler::attach(this);
+			return;
+		}
+
 		m_system_thread = Thread([&](StopToken token) noexcept {
 			SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_HIGH);
 			thread_affinity::set_affinity(~0b11ull);
 			ScopedLogSource s(get_system_id());
-
-			bool is_bench  = false;
-			bool is_paused = false;
+			zone_profiler::set_thread_name(get_system_id());
 
 			do {
-				if (m_pacer.is_frame_ready(is_paused || !is_bench)) {
-					if (has_system_state(EmuState::RESET)) {
-						perform_instance_reset();
-						sub_system_state(EmuState::NOT_RUNNING);
-					}
-
-					m_cached_system_state = EmuState(get_system_state());
-					is_bench   = has_cached_system_state(EmuState::BENCH);
-					is_paused  = has_cached_system_state(EmuState::ANY_PAUSE);
-
-					if (has_cached_system_state(EmuState::ANY_STOP)) [[unlikely]] { continue; }
-					m_cached_real_framerate = m_base_system_framerate * m_framerate_multiplier;
-					if (!is_paused) { m_pacer.set_limiter_props(get_real_system_framerate()); }
-
-					main_system_loop();
-
-					if (!has_cached_system_state(EmuState::NOT_RUNNING)) {
-						m_elapsed_frames += 1;
-						m_benched_frames = is_bench
-							? m_benched_frames + 1 : 0;
-					}
-				}
+				const bool is_lazy = has_cached_system_state(EmuState::ANY_PAUSE)
+					|| !has_cached_system_state(EmuState::BENCH);
+
+				if (m_pacer.is_frame_ready(is_lazy)) { process_frame(); }
 			} while (!token.stop_requested());
 		});
 	}
 }
 
+void ISystemEmu::start_headless() noexcept {
+	if (!m_system_thread.joinable() && !m_is_pooled) {
+		initialize_family();
+		initialize_system();
+	}
+}
+
 void ISystemEmu::stop_worker() noexcept {
+	if (m_is_pooled) {
+		InstanceScheduler::detach(this);
+		m_is_pooled = false;
+	}
 	if (m_system_thread.joinable()) {
 		m_system_thread.request_stop();
 		m_system_thread.join();
@@ -85,12 +83,108 @@ void ISystemEmu::stop_worker() noexcept {
 
 /*==================================================================*/
 
+bool ISystemEmu::try_run_frame() noexcept {
+	if (!m_pacer.is_frame_ready_no_block()) { return false; }
+	process_frame();
+	return true;
+}
+
+auto ISystemEmu::get_frame_deadline() const noexcept
+	-> std::chrono::steady_clock::time_point
+{
+	return m_pacer.get_next_deadline();
+}
+
+void ISystemEmu::process_frame() noexcept {
+	if (has_system_state(EmuState::RESET)) {
+		perform_instance_reset();
+		sub_system_state(EmuState::NOT_RUNNING);
+	}
+
+	if (m_debugger.is_armed() != has_system_state(EmuState::DEBUG)) {
+		xor_system_state(EmuState::DEBUG);
+	}
+
+	m_cached_system_state = EmuState(get_system_state());
+	const bool is_bench  = has_cached_system_state(EmuState::BENCH);
+	const bool is_paused = has_cached_system_state(EmuState::ANY_PAUSE);
+
+	if (has_cached_system_state(EmuState::ANY_STOP)) [[unlikely]] { return; }
+	m_cached_real_framerate = m_base_system_framerate * m_framerate_multiplier;
+
+	const auto policy = get_background_policy();
+	const bool in_background = is_backgrounded();
+
+	m_cached_skip_video = in_background && (policy == BackgroundPolicy::THROTTLED
+		|| policy == BackgroundPolicy::NO_VIDEO);
+
+	if (in_background && policy == BackgroundPolicy::THROTTLED) {
+		m_cached_real_framerate = std::min(m_cached_real_framerate, get_background_framerate());
+	}
+
+	if (!is_paused) { m_pacer.set_limiter_props(get_real_system_framerate()); }
+
+	{
+		PROFILE_ZONE("main_system_loop");
+		main_system_loop();
+	}
+
+	if (!is_paused) {
+		// both must be consumed, a stop mid-frame supersedes the frame step
+		const bool has_stopped = m_debugger.consume_break();
+		if (m_debugger.consume_step_frame() || has_stopped) {
+			add_system_state(EmuState::PAUSED);
+		}
+	}
+
+	// a frame split by a debugger stop is only counted once it completes
+	if (!has_cached_system_state(EmuState::NOT_RUNNING) && !m_debugger.is_mid_frame()) {
+		m_elapsed_frames += 1;
+		m_benched_frames = is_bench
+			? m_benched_frames + 1 : 0;
+	}
+}
+
+/*==================================================================*/
+
+u32  ISystemEmu::poll_bind_states() noexcept {
+	if (m_injected_key_states) { return *m_injected_key_states; }
+
+	auto key_states = 0u;
+
+	m_input.advance_state();
+
+	for (const auto& mapping : m_custom_binds) {
+		if (m_input.is_held(mapping.key) || m_input.is_held(mapping.alt)) {
+			key_states |= 1 << mapping.idx;
+		}
+	}
+
+	return key_states;
+}
+
+/*==================================================================*/
+
+void ISystemEmu::set_backgrounded(bool state) noexcept {
+	m_is_backgrounded.store(state, mo::relaxed);
+
+	if (state && get_background_policy() == BackgroundPolicy::PAUSE) {
+		add_system_state(EmuState::HIDDEN);
+	} else {
+		sub_system_state(EmuState::HIDDEN);
+	}
+}
+
+/*==================================================================*/
+
 void ISystemEmu::perform_instance_reset() noexcept {
 	m_benched_frames = 0;
 	m_elapsed_frames = 0;
 	m_input.reset_state();
+	m_debugger.reset_frame_state();
 	reset_family_data();
 	reset_system_data();
+	m_memory_writes.mark_all();
 }
 
 void ISystemEmu::request_instance_reset() noexcept {
@@ -99,6 +193,23 @@ void ISystemEmu::request_instance_reset() noexcept {
 
 /*==================================================================*/
 
+void ISystemEmu::debugger_step_instruction(u32 count) noexcept {
+	m_debugger.request_steps(count);
+	sub_system_state(EmuState::PAUSED);
+}
+
+void ISystemEmu::debugger_step_frame() noexcept {
+	m_debugger.request_step_frame();
+	sub_system_state(EmuState::PAUSED);
+}
+
+void ISystemEmu::debugger_run_to(u32 addr) noexcept {
+	m_debugger.request_run_to(addr);
+	sub_system_state(EmuState::PAUSED);
+}
+
+/*==================================================================*/
+
 std::string ISystemEmu::get_system_id() const noexcept {
 	return make_system_id(instance_id, get_descriptor().family_name);
 }
@@ -156,16 +267,32 @@ auto ISystemEmu::add_system_path(
 
 /*==================================================================*/
 
+u32  ISystemEmu::disassemble(u32 addr, std::string& output) const noexcept {
+	try {
+		output = addr < m_system_memory.size()
+			? fmt::format("db 0x{:02X}", m_system_memory[addr]) : "db ??";
+	} catch (...) { output.clear(); }
+	return 1;
+}
+
+/*==================================================================*/
+
 void ISystemEmu::append_statistics_data() noexcept {
 	const auto framerate = get_real_system_framerate();
 	const auto frametime = m_pacer.get_elapsed_millis_since() - m_pacer.get_time_yield_accrued();
 	const auto framespan = m_pacer.get_target_time_period();
 
+	const auto& jitter = m_pacer.get_jitter_histogram();
+
 	format_statistics_data(
 		"Target:{:8.3f}ms | {:7.3f}hz\n"
-		"Render:{:8.3f}ms ({:>6.2f}%)\n",
+		"Render:{:8.3f}ms ({:>6.2f}%)\n"
+		"Jitter:{:8.3f}ms p50 |{:7.3f}ms p99\n"
+		"Missed:{:8} | Spin <{:5.2f}ms\n",
 		framespan, framerate, frametime,
-		frametime / framespan * 100.0f
+		frametime / framespan * 100.0f,
+		jitter.percentile(0.50f), jitter.percentile(0.99f),
+		m_pacer.get_missed_period_count(), m_pacer.get_spin_threshold()
 	);
 }
 
@@ -173,11 +300,18 @@ void ISystemEmu::create_statistics_data() noexcept {
 	if (!has_cached_system_state(EmuState::STATS)) { return; }
 	append_statistics_data();
 
-	m_statistics_data.store(std::make_shared<std::string>(
-		std::move(m_statistics_work_buffer)), mo::release);
-	m_statistics_work_buffer.clear();
+	m_statistics_data.edit([&](auto& text) noexcept {
+		text.size = u32(std::min(m_statistics_work_buffer.size(), sizeof(text.data)));
+		std::memcpy(text.data, m_statistics_work_buffer.data(), text.size);
+
+		if (m_statistics_work_buffer.size() > sizeof(text.data)) {
+			const auto& marker = StatisticsText::c_truncation_marker;
+			std::memcpy(text.data + text.size - marker.size(), marker.data(), marker.size());
+		}
+	});
+	m_statistics_work_buffer.clear(); // keeps capacity, no allocation next frame
 }
 
-std::string ISystemEmu::copy_statistics_string() const noexcept {
-	return *m_statistics_data.load(mo::acquire);
+auto ISystemEmu::copy_statistics_text() const noexcept -> StatisticsText {
+	return m_statistics_data.copy();
 }
@@ -12,12 +12,15 @@
 
 #include "EzMaths.hpp"
 #include "AtomSharedPtr.hpp"
+#include "SeqLockBox.hpp"
 #include "Thread.hpp"
 
 #include "MemoryEditor.hpp"
 #include "WindowHost.hpp"
 #include "Parameter.hpp"
 #include "FrameLimiter.hpp"
+#include "StepDebugger.hpp"
+#include "MemoryWriteTracker.hpp"
 #include "BasicInput.hpp"
 #include "Well512.hpp"
 #include "UserInterface.hpp"
@@ -38,7 +41,7 @@ enum EmuState : u8 {
 	BENCH  = 0x10, // benchmarking mode (cpu de-limited)
 	STATS  = 0x20, // collect/display OSD stats
 	RESET  = 0x40, // in-progress system reset
-	DEBUG  = 0x80, // debugger enabled (reserved for future use)
+	DEBUG  = 0x80, // debugger armed (breakpoints, watchpoints or stepping)
 
 	NOT_RUNNING  = HIDDEN | PAUSED | HALTED | FATAL | RESET, // emulation cannot progress
 	CANNOT_PAUSE = HIDDEN | HALTED | FATAL | RESET, // pause-trigger is not allowed
@@ -46,6 +49,14 @@ enum EmuState : u8 {
 	ANY_STOP     = HALTED | FATAL | RESET, // emulation is currently stopped
 };
 
+enum class BackgroundPolicy : u8 {
+	PAUSE,      // stop emulation while unfocused (hidden)
+	FULL_SPEED, // keep running as if focused, video included
+	THROTTLED,  // keep running at a reduced framerate, without video
+	NO_VIDEO,   // keep running at the normal framerate, without video
+	COUNT
+};
+
 struct SimpleKeyMapping {
 	u32          idx; // index value associated with entry
 	SDL_Scancode key; // primary key mapping
@@ -54,12 +65,14 @@ struct SimpleKeyMapping {
 using SimpleKeyVec = std::vector<SimpleKeyMapping>;
 
 struct SystemDescriptor;
+class  DisplayDevice;
 
 /*==================================================================*/
 
 class ISystemEmu {
 
 	Thread m_system_thread;
+	bool   m_is_pooled = false; // frames are run by the InstanceScheduler pool instead
 
 	std::atomic<u8> m_system_state = EmuState::NORMAL;
 	EmuState m_cached_system_state = EmuState::NORMAL;
@@ -113,6 +126,38 @@ public:
 		return std::exchange(m_is_viewport_focused, state);
 	}
 
+public:
+	static inline std::atomic<BackgroundPolicy> s_default_background_policy = BackgroundPolicy::PAUSE;
+	static inline std::atomic<f32>              s_default_background_framerate = 10.0f;
+
+	static constexpr f32 c_min_background_framerate =  1.0f;
+	static constexpr f32 c_max_background_framerate = 60.0f;
+
+private:
+	std::atomic<BackgroundPolicy> m_background_policy = s_default_background_policy.load(mo::relaxed);
+	std::atomic<f32> m_background_framerate = std::clamp(s_default_background_framerate.load(mo::relaxed),
+		c_min_background_framerate, c_max_background_framerate);
+	std::atomic<bool> m_is_backgrounded{};
+	bool m_cached_skip_video{};
+
+public:
+	auto get_background_policy() const noexcept { return m_background_policy.load(mo::relaxed); }
+	void set_background_policy(BackgroundPolicy policy) noexcept { m_background_policy.store(policy, mo::relaxed); }
+
+	auto get_background_framerate() const noexcept { return m_background_framerate.load(mo::relaxed); }
+	void set_background_framerate(f32 framerate) noexcept {
+		m_background_framerate.store(std::clamp(framerate,
+			c_min_background_framerate, c_max_background_framerate), mo::relaxed);
+	}
+
+	// Informs the System whether it is in the background, applying its background policy.
+	void set_backgrounded(bool state) noexcept;
+	bool is_backgrounded() const noexcept { return m_is_backgrounded.load(mo::relaxed); }
+
+protected:
+	// Tests whether video output should be produced this frame, per the background policy.
+	bool should_push_video() const noexcept { return !m_cached_skip_video; }
+
 private:
 	u32 : 32; // reserved for future use
 
@@ -134,18 +179,47 @@ protected:
 	u32 m_benched_frames = 0;
 	u32 m_elapsed_frames = 0;
 
+public:
+	// Frames completed since the last reset, a frame split by a debugger stop counts once done.
+	u32 get_elapsed_frames() const noexcept { return m_elapsed_frames; }
+
 protected:
 	FrameLimiter m_pacer{};
 
+protected:
+	// Fixed-capacity snapshot of the OSD stats, published without allocating.
+	// Text past the capacity is cut off, ending in a visible truncation marker.
+	struct StatisticsText {
+		static constexpr std::string_view c_truncation_marker = "[...]\n";
+
+		char data[512]{};
+		u32  size{};
+
+		std::string_view view() const noexcept { return { data, size }; }
+	};
+
 private:
 	std::string m_statistics_work_buffer{};
-	AtomSharedPtr<std::string>
+	SeqLockBox<StatisticsText>
 		m_statistics_data{};
 
 protected:
 	std::unique_ptr<Well512> m_rng;
 	BasicKeyboard m_input;
 
+private:
+	std::optional<u32> m_injected_key_states{};
+
+public:
+	// Overrides the bind states polled from the keyboard, or restores polling if empty.
+	void inject_key_states(std::optional<u32> key_states) noexcept {
+		m_injected_key_states = key_states;
+	}
+
+protected:
+	// Polls the keyboard and returns the bitfield of bind indices currently held.
+	u32 poll_bind_states() noexcept;
+
 protected:
 	ISystemEmu(std::string_view window_name) noexcept;
 
@@ -159,6 +233,19 @@ public:
 	void start_worker() noexcept;
 	void stop_worker() noexcept;
 
+	// Runs a single frame if the pacer's period has elapsed, used by the InstanceScheduler.
+	bool try_run_frame() noexcept;
+	auto get_frame_deadline() const noexcept -> std::chrono::steady_clock::time_point;
+
+private:
+	void process_frame() noexcept;
+
+public:
+	// Initializes the System without a worker, frames are then driven by run_single_frame().
+	void start_headless() noexcept;
+	// Runs exactly one frame on the calling thread, ignoring the pacer.
+	void run_single_frame() noexcept { process_frame(); }
+
 private:
 	virtual void reset_family_data() noexcept = 0;
 	virtual void reset_system_data() noexcept = 0;
@@ -201,6 +288,67 @@ protected:
 	WindowHost   m_memview_window;
 	MemoryEditor m_memory_editor;
 
+protected:
+	StepDebugger       m_debugger;
+	MemoryWriteTracker m_memory_writes; // bumped by the core's memory write paths
+
+private:
+	std::span<const u8> m_system_memory{};
+
+protected:
+	// Points the memory editor, debugger and write tracker at the system's main memory.
+	template <typename T>
+	void bind_system_memory(
+		T* memory_data, std::size_t memory_size,
+		std::size_t base_display_address = 0
+	) noexcept {
+		m_system_memory = { reinterpret_cast<const u8*>(memory_data), memory_size * sizeof(T) };
+		m_memory_editor.set_memory_range(memory_data, memory_size, base_display_address);
+		m_debugger.set_memory_range(memory_data, memory_size * sizeof(T));
+		m_memory_writes.resize(memory_size * sizeof(T));
+		m_memory_editor.set_write_tracker(&m_memory_writes);
+	}
+
+public:
+	// Main memory as bound by the core, empty until the system is initialized.
+	auto get_system_memory() const noexcept { return m_system_memory; }
+
+	struct RegisterValue {
+		std::string_view name;
+		u32 value;
+	};
+
+	// Appends the CPU-visible registers, program counter first. Cores without introspection add none.
+	virtual void read_register_file(std::vector<RegisterValue>&) const noexcept {}
+
+	struct MemoryRange {
+		std::size_t offset;
+		std::size_t size;
+	};
+
+	// Appends the ranges of main memory written since the last reset, anything outside them
+	// is still zero. Cores that don't track their writes report the whole memory.
+	virtual void read_written_memory(std::vector<MemoryRange>& output) const noexcept {
+		try { output.push_back({ 0, m_system_memory.size() }); }
+		catch (...) {}
+	}
+
+	// Writes a one-line disassembly of the instruction at 'addr' and returns its size in bytes.
+	virtual u32  disassemble(u32 addr, std::string& output) const noexcept;
+
+	// Forces a named emulation quirk on or off, returns false if the core has no such quirk.
+	virtual bool override_quirk(std::string_view, bool) noexcept { return false; }
+
+	virtual DisplayDevice* get_display_device() noexcept { return nullptr; }
+
+public:
+	// Runs until the given amount of instructions has executed, then pauses.
+	void debugger_step_instruction(u32 count = 1) noexcept;
+	// Runs until the current (or next) frame completes, then pauses.
+	void debugger_step_frame() noexcept;
+	// Runs until the instruction at the given address is about to execute, then pauses.
+	void debugger_run_to(u32 addr) noexcept;
+
 protected:
 	virtual void main_system_loop() = 0;
 	virtual void initialize_family() noexcept = 0;
@@ -226,13 +374,13 @@ protected:
 protected:
 	virtual void append_statistics_data() noexcept;
 	/*****/ void create_statistics_data() noexcept;
-	std::string  copy_statistics_string() const noexcept;
+	StatisticsText copy_statistics_text() const noexcept;
 };
 
 /*==================================================================*/
 
 namespace osd {
-	void simple_text_overlay(const std::string& overlay_data) noexcept;
+	void simple_text_overlay(std::string_view overlay_data) noexcept;
 	void key_press_indicator(float phase) noexcept;
 
 	inline void key_press_indicator(double phase) noexcept { key_press_indicator(float(phase)); }
@@ -53,6 +53,76 @@ void ISystemEmu::prepare_user_interface() noexcept {
 		}
 	));
 
+	m_frontend_hooks.emplace_back(UserInterface::register_menu(
+		m_workspace_host.get_window_label(), { 91, "Debug" },
+		[&, address = u32(), watch_size = u32(1), watch_flags = int(StepDebugger::WATCH_WRITE)]() mutable noexcept {
+			if (!BeginMenu("Debugger")) { return; }
+
+			const bool can_step = has_system_state(EmuState::PAUSED)
+				&& !has_system_state(EmuState::ANY_STOP);
+
+			if (MenuItem("Step Instruction", nullptr, false, can_step)) { debugger_step_instruction(); }
+			if (MenuItem("Step Frame",       nullptr, false, can_step)) { debugger_step_frame(); }
+
+			switch (const auto info = m_debugger.get_last_break(); info.reason) {
+				using enum StepDebugger::Reason;
+				case STEP:        TextDisabled("Stopped: step at %04X", info.pc); break;
+				case BREAKPOINT:  TextDisabled("Stopped: breakpoint at %04X", info.pc); break;
+				case RUN_TO:      TextDisabled("Stopped: run-to at %04X", info.pc); break;
+				case WATCH_READ:  TextDisabled("Stopped: read of %04X, next %04X", info.addr, info.pc); break;
+				case WATCH_WRITE: TextDisabled("Stopped: write to %04X, next %04X", info.addr, info.pc); break;
+				default: break;
+			}
+
+			SeparatorText("Address");
+			SetNextItemWidth(CalcTextSize("F").x * 12.0f);
+			InputScalar("##debugger_address", ImGuiDataType_U32, &address,
+				nullptr, nullptr, "%06X", ImGuiInputTextFlags_CharsHexadecimal);
+
+			if (MenuItem("Run To Address", nullptr, false, can_step)) { debugger_run_to(address); }
+			if (MenuItem("Toggle Breakpoint")) {
+				if (m_debugger.has_breakpoint(address)) { m_debugger.remove_breakpoint(address); }
+				else { m_debugger.add_breakpoint(address); }
+			}
+
+			SetNextItemWidth(CalcTextSize("F").x * 12.0f);
+			InputScalar("Size##debugger_watch_size", ImGuiDataType_U32, &watch_size);
+			CheckboxFlags("Read",  &watch_flags, StepDebugger::WATCH_READ); SameLine();
+			CheckboxFlags("Write", &watch_flags, StepDebugger::WATCH_WRITE);
+
+			if (MenuItem("Add Watchpoint", nullptr, false, watch_flags != 0)) {
+				m_debugger.add_watchpoint({ address, watch_size, u8(watch_flags) });
+			}
+
+			if (const auto breakpoints = m_debugger.get_breakpoints(); !breakpoints.empty()) {
+				SeparatorText("Breakpoints");
+				for (const auto addr : breakpoints) {
+					PushID(int(addr));
+					if (SmallButton("x")) { m_debugger.remove_breakpoint(addr); }
+					SameLine(); Text("%06X", addr);
+					PopID();
+				}
+				if (MenuItem("Clear Breakpoints")) { m_debugger.clear_breakpoints(); }
+			}
+
+			if (const auto watchpoints = m_debugger.get_watchpoints(); !watchpoints.empty()) {
+				SeparatorText("Watchpoints");
+				for (std::size_t i = 0; i < watchpoints.size(); ++i) {
+					const auto& watch = watchpoints[i];
+					PushID(int(i));
+					if (SmallButton("x")) { m_debugger.remove_watchpoint(i); }
+					SameLine(); Text("%06X +%-3u %s%s", watch.addr, watch.size,
+						watch.flags & StepDebugger::WATCH_READ  ? "R" : "",
+						watch.flags & StepDebugger::WATCH_WRITE ? "W" : "");
+					PopID();
+				}
+				if (MenuItem("Clear Watchpoints")) { m_debugger.clear_watchpoints(); }
+			}
+
+			EndMenu();
+		}
+	));
+
 	m_frontend_hooks.emplace_back(UserInterface::register_menu(
 		m_workspace_host.get_window_label(), { 50, "System" },
 		[&]() noexcept {
@@ -70,6 +140,40 @@ void ISystemEmu::prepare_user_interface() noexcept {
 		}
 	));
 
+	m_frontend_hooks.emplace_back(UserInterface::register_menu(
+		m_workspace_host.get_window_label(), { 58, "System" },
+		[&]() noexcept {
+			if (!BeginMenu("When Unfocused")) { return; }
+
+			static constexpr const char* c_policy_names[] = {
+				"Pause", "Run at Full Speed", "Run Throttled (no video)", "Run without Video",
+			};
+			static_assert(std::size(c_policy_names) == std::size_t(BackgroundPolicy::COUNT));
+
+			const auto current_policy = get_background_policy();
+			for (std::size_t i = 0; i < std::size(c_policy_names); ++i) {
+				if (MenuItem(c_policy_names[i], nullptr, current_policy == BackgroundPolicy(i))) {
+					set_background_policy(BackgroundPolicy(i));
+					s_default_background_policy.store(BackgroundPolicy(i), mo::relaxed);
+				}
+			}
+
+			BeginDisabled(current_policy != BackgroundPolicy::THROTTLED);
+			SetNextItemWidth(CalcTextSize("F").x * 28.0f);
+			auto background_framerate = get_background_framerate();
+			if (DragFloat("##background_framerate", &background_framerate, 0.1f,
+				c_min_background_framerate, c_max_background_framerate,
+				"Throttle: %5.1f hz", ImGuiSliderFlags_AlwaysClamp))
+			{
+				set_background_framerate(background_framerate);
+				s_default_background_framerate.store(background_framerate, mo::relaxed);
+			}
+			EndDisabled();
+
+			EndMenu();
+		}
+	));
+
 	m_frontend_hooks.emplace_back(UserInterface::register_menu(
 		m_workspace_host.get_window_label(), { 59, "System" },
 		[&]() noexcept {
@@ -196,8 +300,11 @@ namespace widgets {
 namespace osd {
 	using namespace ImGui;
 
-	void simple_text_overlay(const std::string& overlay_data) noexcept {
-		const auto text_zone = CalcTextSize(overlay_data.c_str())
+	void simple_text_overlay(std::string_view overlay_data) noexcept {
+		const auto text_begin = overlay_data.data();
+		const auto text_end   = text_begin + overlay_data.size();
+
+		const auto text_zone = CalcTextSize(text_begin, text_end)
 			+ GetStyle().WindowPadding * 2.0f;
 
 		AddCursorPos((GetContentRegionAvail() - text_zone) * ImVec2(0.0f, 1.0f));
@@ -205,7 +312,7 @@ namespace osd {
 		if (BeginChild("##text_overlay", text_zone, ImGuiChildFlags_Borders | ImGuiChildFlags_NavFlattened,
 			ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoNav
 		)) {
-			TextUnformatted(overlay_data.c_str());
+			TextUnformatted(text_begin, text_end);
 		}
 		EndChild();
 	}
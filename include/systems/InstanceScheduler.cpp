@@ -0,0 +1,220 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "InstanceScheduler.hpp"
+#include "ISystemEmu.hpp"
+
+#include "ThreadAffinity.hpp"
+#include "FrameLimiter.hpp"
+#include "ZoneProfiler.hpp"
+#include "BasicLogger.hpp"
+#include "RelaxCPU.hpp"
+#include "Thread.hpp"
+
+#include <bit>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <SDL3/SDL_thread.h>
+
+/*==================================================================*/
+
+namespace {
+	using steady = std::chrono::steady_clock;
+
+	// logical cores reserved for the main/gui thread, mirrors its affinity
+	constexpr auto c_reserved_core_mask = 0b11ull;
+
+	struct FrameTask {
+		ISystemEmu*       system;
+		steady::time_point deadline;
+	};
+
+	struct Worker {
+		std::mutex             lock;
+		std::vector<FrameTask> tasks;
+		Thread                 thread;
+
+		// Returns an iterator to the task with the nearest deadline, or end() if empty.
+		auto find_earliest() const noexcept {
+			return std::min_element(tasks.begin(), tasks.end(),
+				[](const auto& lhs, const auto& rhs) noexcept
+					{ return lhs.deadline < rhs.deadline; });
+		}
+	};
+
+	class WorkerPool {
+		std::unique_ptr<Worker[]> m_workers;
+		unsigned m_worker_count = 0;
+
+		// cores the process may use beyond the main thread's, or all of them if none are left
+		unsigned long long m_worker_core_mask = 0;
+
+		std::atomic<unsigned> m_next_worker{};
+		std::atomic<unsigned> m_returned_tasks{}; // bumped whenever a task goes back in a queue
+
+	public:
+		WorkerPool() noexcept {
+			const auto process_mask = thread_affinity::get_process_affinity_mask();
+			m_worker_core_mask = process_mask & ~c_reserved_core_mask
+				? process_mask & ~c_reserved_core_mask : process_mask;
+
+			m_worker_count = std::max(1, std::popcount(m_worker_core_mask));
+			m_workers = std::make_unique<Worker[]>(m_worker_count);
+
+			for (unsigned i = 0; i < m_worker_count; ++i) {
+				m_workers[i].thread = Thread([this, i](StopToken token) noexcept {
+					worker_loop(i, token);
+				});
+			}
+
+			blog.info("Instance scheduler started with {} worker(s)", m_worker_count);
+		}
+
+		~WorkerPool() noexcept {
+			// workers may steal from one another, all must stop before any is freed
+			for (unsigned i = 0; i < m_worker_count; ++i) { m_workers[i].thread.request_stop(); }
+			for (unsigned i = 0; i < m_worker_count; ++i) {
+				if (m_workers[i].thread.joinable()) { m_workers[i].thread.join(); }
+			}
+		}
+
+		auto worker_count() const noexcept { return m_worker_count; }
+
+		void push(ISystemEmu* system) noexcept {
+			auto& worker = m_workers[m_next_worker.fetch_add(1, mo::relaxed) % m_worker_count];
+			std::scoped_lock lock(worker.lock);
+			worker.tasks.push_back({ system, system->get_frame_deadline() });
+		}
+
+		// Erases a task, waiting for its worker to return it if it's mid-frame and in no queue.
+		void erase(ISystemEmu* system) noexcept {
+			while (true) {
+				const auto returned = m_returned_tasks.load(mo::acquire);
+				if (try_erase(system)) { return; }
+				m_returned_tasks.wait(returned, mo::acquire);
+			}
+		}
+
+	private:
+		bool try_erase(ISystemEmu* system) noexcept {
+			for (unsigned i = 0; i < m_worker_count; ++i) {
+				auto& worker = m_workers[i];
+				std::scoped_lock lock(worker.lock);
+
+				const auto it = std::find_if(worker.tasks.begin(), worker.tasks.end(),
+					[system](const auto& task) noexcept { return task.system == system; });
+
+				if (it != worker.tasks.end()) { worker.tasks.erase(it); return true; }
+			}
+			return false;
+		}
+
+		// Pops the own task with the nearest deadline if it's due, else reports that deadline.
+		bool pop_own_task(Worker& worker, steady::time_point now, FrameTask& out,
+			steady::time_point& next_deadline) noexcept
+		{
+			std::scoped_lock lock(worker.lock);
+			const auto it = worker.find_earliest();
+			if (it == worker.tasks.end()) { return false; }
+
+			if (it->deadline > now) { next_deadline = std::min(next_deadline, it->deadline); return false; }
+			out = *it; worker.tasks.erase(it);
+			return true;
+		}
+
+		bool steal_task(unsigned thief, steady::time_point now, FrameTask& out) noexcept {
+			for (unsigned offset = 1; offset < m_worker_count; ++offset) {
+				auto& victim = m_workers[(thief + offset) % m_worker_count];
+
+				std::unique_lock lock(victim.lock, std::try_to_lock);
+				if (!lock) { continue; }
+
+				const auto it = victim.find_earliest();
+				if (it == victim.tasks.end() || it->deadline > now) { continue; }
+
+				out = *it; victim.tasks.erase(it);
+				return true;
+			}
+			return false;
+		}
+
+		void worker_loop(unsigned index, StopToken token) noexcept {
+			SDL_SetCurrentThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+			thread_affinity::set_affinity(m_worker_core_mask);
+			zone_profiler::set_thread_name(fmt::format("scheduler.{}", index));
+
+			const auto spin_threshold = std::chrono::duration_cast<steady::duration>(
+				std::chrono::duration<float, std::milli>(FrameLimiter::get_host_spin_threshold()));
+
+			auto& self = m_workers[index];
+
+			while (!token.stop_requested()) {
+				const auto now = steady::now();
+				auto next_deadline = steady::time_point::max();
+				FrameTask task;
+
+				if (pop_own_task(self, now, task, next_deadline) || steal_task(index, now, task)) {
+					{
+						ScopedLogSource s(task.system->get_system_id());
+						task.system->try_run_frame();
+					}
+					task.deadline = task.system->get_frame_deadline();
+
+					{
+						std::scoped_lock lock(self.lock);
+						self.tasks.push_back(task);
+					}
+					m_returned_tasks.fetch_add(1, mo::release);
+					m_returned_tasks.notify_all();
+					continue;
+				}
+
+				if (next_deadline - now >= spin_threshold) {
+					PROFILE_ZONE("scheduler_sleep");
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				} else {
+					PROFILE_ZONE("scheduler_spin");
+					for (auto i = 0; ++i <= 128;) { ::cpu_relax(); }
+					std::this_thread::yield();
+				}
+			}
+		}
+	};
+
+	std::atomic<bool> s_pooled_mode{};
+
+	WorkerPool& get_worker_pool() noexcept {
+		static WorkerPool s_worker_pool;
+		return s_worker_pool;
+	}
+}
+
+/*==================================================================*/
+
+bool InstanceScheduler::is_pooled_mode() noexcept {
+	return s_pooled_mode.load(mo::relaxed);
+}
+
+void InstanceScheduler::set_pooled_mode(bool state) noexcept {
+	s_pooled_mode.store(state, mo::relaxed);
+}
+
+unsigned InstanceScheduler::get_worker_count() noexcept {
+	return get_worker_pool().worker_count();
+}
+
+void InstanceScheduler::attach(ISystemEmu* system) noexcept {
+	if (system) { get_worker_pool().push(system); }
+}
+
+void InstanceScheduler::detach(ISystemEmu* system) noexcept {
+	if (system) { get_worker_pool().erase(system); }
+}
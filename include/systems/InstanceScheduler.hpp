@@ -0,0 +1,40 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/*==================================================================*/
+
+class ISystemEmu;
+
+/**
+ * @brief Runs system instances as frame tasks over a fixed pool of worker threads,
+ *        as an alternative to every instance owning a dedicated worker thread.
+ *
+ * The pool is sized to the logical cores of the process affinity mask left over by
+ * the main thread's, and is only spun up on the first attach. Each worker keeps its own queue of
+ * instances and always runs the one whose frame deadline (from its FrameLimiter) is
+ * nearest. A worker with nothing due steals an overdue instance from another queue.
+ *
+ * An instance is only ever held by one worker at a time: it is taken out of its
+ * queue while its frame runs, and then returned to the queue of whoever ran it.
+ *
+ * @warning The pooled mode setting only affects instances started afterwards.
+ */
+class InstanceScheduler final {
+	InstanceScheduler() = delete;
+
+public:
+	static bool is_pooled_mode() noexcept;
+	static void set_pooled_mode(bool state) noexcept;
+
+	static unsigned get_worker_count() noexcept;
+
+	// Hands an instance over to the worker pool, starting the pool if needed.
+	static void attach(ISystemEmu* system) noexcept;
+	// Removes an instance from the worker pool, waiting out any frame in progress.
+	static void detach(ISystemEmu* system) noexcept;
+};
@@ -0,0 +1,648 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ProgramLibrary.hpp"
+#include "CoreRegistry.hpp"
+#include "SystemDescriptor.hpp"
+#include "SimpleFileIO.hpp"
+#include "ExecPolicy.hpp"
+#include "BasicLogger.hpp"
+#include "ZipArchive.hpp"
+#include "FileImage.hpp"
+#include "Thread.hpp"
+#include "SHA1.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <optional>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+#include <condition_variable>
+
+/*==================================================================*/
+
+namespace {
+	using u8  = std::uint8_t;
+	using u16 = std::uint16_t;
+	using u32 = std::uint32_t;
+	using u64 = std::uint64_t;
+	using s64 = std::int64_t;
+
+	using Record = ProgramLibrary::Record;
+
+	constexpr auto c_poll_interval = std::chrono::seconds(30);
+
+	constexpr char c_index_magic[4] = { 'C', 'C', 'P', 'L' };
+	constexpr u32  c_index_version  = 2;
+	constexpr u32  c_sha1_bytes     = 20;
+
+	// serialized size of a record/skipped source whose strings are all empty
+	constexpr u32  c_min_record_size  = 8 + 8 + 8 + c_sha1_bytes + 2 + 2 + 2;
+	constexpr u32  c_min_skipped_size = 8 + 8 + 2;
+
+	constexpr std::string_view c_hex_digits = "0123456789abcdef";
+
+	/*==============================================================*/
+
+	// Little-endian writer for the index file, strings are u16 length-prefixed.
+	class IndexWriter {
+		std::vector<char>& m_output;
+
+	public:
+		explicit IndexWriter(std::vector<char>& output) noexcept : m_output(output) {}
+
+		template <typename T>
+		void put(T value) {
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+				{ m_output.push_back(char(u64(value) >> (8 * i))); }
+		}
+
+		void put_string(std::string_view str) {
+			const auto size = std::min<std::size_t>(str.size(), 0xFFFF);
+			put(u16(size));
+			m_output.insert(m_output.end(), str.begin(), str.begin() + size);
+		}
+
+		// stored as the 20 raw bytes rather than 40 hex digits
+		void put_sha1(std::string_view hash) {
+			for (std::size_t i = 0; i < c_sha1_bytes; ++i) {
+				const auto hi = c_hex_digits.find(hash[i * 2 + 0]);
+				const auto lo = c_hex_digits.find(hash[i * 2 + 1]);
+				m_output.push_back(char((hi << 4) | lo));
+			}
+		}
+	};
+
+	// Bounds-checked counterpart of IndexWriter, any overrun fails the whole read.
+	class IndexReader {
+		std::span<const char> m_input;
+		std::size_t m_offset{};
+		bool m_failed{};
+
+		bool has(std::size_t size) noexcept {
+			if (m_failed || size > m_input.size() - m_offset) { m_failed = true; }
+			return !m_failed;
+		}
+
+	public:
+		explicit IndexReader(std::span<const char> input) noexcept : m_input(input) {}
+
+		bool failed() const noexcept { return m_failed; }
+		bool at_end() const noexcept { return m_offset == m_input.size(); }
+
+		// reads an element count, failing if not even that many minimal elements could fit
+		std::size_t get_count(std::size_t min_element_size) noexcept {
+			const auto count = get<u32>();
+			if (m_failed || count > (m_input.size() - m_offset) / min_element_size)
+				{ m_failed = true; return 0; }
+			return count;
+		}
+
+		template <typename T>
+		T get() noexcept {
+			if (!has(sizeof(T))) { return T{}; }
+			u64 value{};
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+				{ value |= u64(u8(m_input[m_offset++])) << (8 * i); }
+			return T(value);
+		}
+
+		std::string get_string() {
+			const auto size = get<u16>();
+			if (!has(size)) { return {}; }
+			std::string output(m_input.data() + m_offset, size);
+			m_offset += size;
+			return output;
+		}
+
+		std::string get_sha1() {
+			if (!has(c_sha1_bytes)) { return {}; }
+			std::string output;
+			output.reserve(c_sha1_bytes * 2);
+			for (std::size_t i = 0; i < c_sha1_bytes; ++i) {
+				const auto byte = u8(m_input[m_offset++]);
+				output += c_hex_digits[byte >> 4];
+				output += c_hex_digits[byte & 0xF];
+			}
+			return output;
+		}
+	};
+
+	bool is_sha1_hash(std::string_view hash) noexcept {
+		return hash.size() == c_sha1_bytes * 2 && std::all_of(hash.begin(), hash.end(),
+			[](char c) noexcept { return c_hex_digits.find(c) != c_hex_digits.npos; });
+	}
+
+	/*==============================================================*/
+
+	auto get_source_path(std::string_view file_path) noexcept -> std::string_view {
+		const auto archive_path = ZipArchive::split_entry_path(file_path).first;
+		return archive_path.empty() ? file_path : archive_path;
+	}
+
+	bool is_claimed_extension(const std::filesystem::path& file_path) {
+		return !CoreRegistry::get_extension_core_span(file_path.extension().string()).empty();
+	}
+
+	std::string find_matching_cores(const FileImage& file_image) {
+		const auto extension = fs::Path(file_image.path()).extension().string();
+
+		std::string matching_cores;
+		for (const auto& hook : CoreRegistry::get_extension_core_span(extension)) {
+			if (hook->descriptor->validate_program(file_image.span())) { continue; }
+			if (!matching_cores.empty()) { matching_cores += ','; }
+			matching_cores += hook->descriptor->system_name;
+		}
+		return matching_cores;
+	}
+
+	// a file on disk that held no indexable program when last seen
+	struct SkippedSource {
+		std::string source_path{};
+		u64         source_size{};
+		s64         source_time{};
+
+		bool operator==(const SkippedSource&) const noexcept = default;
+	};
+
+	// a file found by the walk, either new or changed since it was last seen
+	struct PendingSource {
+		std::string source_path{};
+		u64         source_size{};
+		s64         source_time{};
+
+		std::vector<Record> records{}; // the programs it holds, filled in by the hashing
+	};
+
+	void add_program(PendingSource& source, const FileImage& file_image) {
+		if (!file_image.valid() || !file_image.size()) { return; }
+
+		Record record;
+		record.file_sha1 = SHA1::from(file_image.span());
+		if (!::is_sha1_hash(record.file_sha1)) { return; }
+
+		record.file_path      = file_image.path();
+		record.matching_cores = ::find_matching_cores(file_image);
+		record.file_size      = file_image.size();
+		record.source_size    = source.source_size;
+		record.source_time    = source.source_time;
+		source.records.push_back(std::move(record));
+	}
+
+	// archives are opened here, one per task, so only as many are mapped as there are workers
+	void index_source(PendingSource& source) {
+		if (!ZipArchive::is_archive(source.source_path)) {
+			::add_program(source, FileImage(source.source_path));
+			return;
+		}
+
+		const ZipArchive archive(source.source_path);
+		if (!archive.valid()) { return; }
+
+		for (std::size_t i = 0; i < archive.entries().size(); ++i) {
+			const auto& archive_entry = archive.entries()[i];
+			if (!archive_entry.is_supported()) { continue; }
+			if (!::is_claimed_extension(fs::Path(archive_entry.name))) { continue; }
+
+			::add_program(source, archive.load_entry(i));
+		}
+	}
+
+	// canonical roots with any root nested in (or equal to) another one dropped,
+	// so overlapping directories and trailing slashes don't walk a file twice
+	auto collect_scan_roots(const std::vector<std::string>& scan_paths) {
+		std::vector<std::filesystem::path> roots;
+		for (const auto& scan_path : scan_paths) {
+			std::error_code error;
+			auto root = std::filesystem::weakly_canonical(scan_path, error);
+			if (error || root.empty()) { continue; }
+			if (!root.has_filename()) { root = root.parent_path(); }
+			roots.push_back(std::move(root));
+		}
+
+		const auto is_within = [](const std::filesystem::path& path, const std::filesystem::path& root) noexcept {
+			return std::mismatch(root.begin(), root.end(), path.begin(), path.end()).first == root.end();
+		};
+
+		// shorter paths first, so a parent is kept before any of its children are seen
+		std::sort(roots.begin(), roots.end(), [](const auto& lhs, const auto& rhs) noexcept
+			{ return std::distance(lhs.begin(), lhs.end()) < std::distance(rhs.begin(), rhs.end()); });
+
+		std::vector<std::filesystem::path> unique_roots;
+		for (auto& root : roots) {
+			if (std::none_of(unique_roots.begin(), unique_roots.end(),
+				[&](const auto& kept) noexcept { return is_within(root, kept); }))
+				{ unique_roots.push_back(std::move(root)); }
+		}
+		return unique_roots;
+	}
+}
+
+/*==================================================================*/
+
+struct ProgramLibrary::Context {
+	mutable std::mutex      control_lock;
+	std::condition_variable control_signal;
+
+	std::vector<std::string> directories{};
+	std::string index_path{};
+	bool rescan_requested{};
+
+	std::atomic_bool stop_requested{};
+	std::atomic_bool scanning{};
+	std::atomic_size_t files_done{};
+	std::atomic_size_t files_total{};
+
+	// owned by the scanner thread, both sorted by path
+	std::vector<Record> index{};
+	std::vector<SkippedSource> skipped{};
+
+	// latest index published by the scanner, awaiting the main thread
+	std::mutex staged_lock;
+	std::optional<std::vector<Record>> staged{};
+
+	// main thread's copy
+	std::vector<Record> records{};
+
+	Thread thread;
+
+	void load_index() noexcept;
+	void save_index() const noexcept;
+	void publish_index() noexcept;
+
+	void scanner_loop() noexcept;
+	bool scan_directories(const std::vector<std::string>& scan_paths);
+};
+
+/*==================================================================*/
+
+void ProgramLibrary::Context::load_index() noexcept {
+	const auto file_data = ::read_file_data(index_path);
+	if (!file_data) { return; }
+
+	try {
+		IndexReader reader(*file_data);
+		for (const auto c : c_index_magic) {
+			if (reader.get<char>() != c) { return; }
+		}
+		if (reader.get<u32>() != c_index_version) {
+			blog.info("Program library index is outdated, rebuilding it.");
+			return;
+		}
+
+		std::vector<Record> loaded(reader.get_count(c_min_record_size));
+		for (auto& record : loaded) {
+			record.file_size      = reader.get<u64>();
+			record.source_size    = reader.get<u64>();
+			record.source_time    = reader.get<s64>();
+			record.file_sha1      = reader.get_sha1();
+			record.file_path      = reader.get_string();
+			record.program_title  = reader.get_string();
+			record.matching_cores = reader.get_string();
+			if (reader.failed()) { break; }
+		}
+
+		std::vector<SkippedSource> loaded_skipped(reader.get_count(c_min_skipped_size));
+		for (auto& source : loaded_skipped) {
+			source.source_size = reader.get<u64>();
+			source.source_time = reader.get<s64>();
+			source.source_path = reader.get_string();
+			if (reader.failed()) { break; }
+		}
+
+		if (reader.failed() || !reader.at_end()) {
+			blog.warn("Program library index is corrupt, rebuilding it: \"{}\"", index_path);
+			return;
+		}
+
+		index   = std::move(loaded);
+		skipped = std::move(loaded_skipped);
+		blog.info("Loaded program library index with {} entries.", index.size());
+	}
+	catch (...) { index.clear(); skipped.clear(); }
+}
+
+void ProgramLibrary::Context::save_index() const noexcept {
+	try {
+		std::vector<char> file_data;
+		file_data.reserve(16 + index.size() * 128);
+		IndexWriter writer(file_data);
+
+		for (const auto c : c_index_magic) { writer.put(c); }
+		writer.put(c_index_version);
+		writer.put(u32(index.size()));
+
+		for (const auto& record : index) {
+			writer.put(record.file_size);
+			writer.put(record.source_size);
+			writer.put(record.source_time);
+			writer.put_sha1(record.file_sha1);
+			writer.put_string(record.file_path);
+			writer.put_string(record.program_title);
+			writer.put_string(record.matching_cores);
+		}
+
+		writer.put(u32(skipped.size()));
+		for (const auto& source : skipped) {
+			writer.put(source.source_size);
+			writer.put(source.source_time);
+			writer.put_string(source.source_path);
+		}
+
+		// written aside first, so that an interrupted save can't leave a torn index
+		const auto temp_path = index_path + ".tmp";
+		if (const auto file_written = ::write_file_data(temp_path, file_data); !file_written) {
+			blog.error("Unable to write program library index '{}': {}",
+				temp_path, file_written.error().message());
+			return;
+		}
+		if (const auto file_moved = fs::rename(temp_path, index_path); !file_moved) {
+			blog.error("Unable to replace program library index '{}': {}",
+				index_path, file_moved.error().message());
+		}
+	}
+	catch (...) {}
+}
+
+void ProgramLibrary::Context::publish_index() noexcept {
+	try {
+		auto snapshot = index;
+		std::scoped_lock lock(staged_lock);
+		staged = std::move(snapshot);
+	}
+	catch (...) {}
+}
+
+/*==================================================================*/
+
+void ProgramLibrary::Context::scanner_loop() noexcept {
+	for (;;) {
+		std::vector<std::string> scan_paths;
+		{
+			std::unique_lock lock(control_lock);
+			control_signal.wait_for(lock, c_poll_interval, [&]() noexcept
+				{ return rescan_requested || stop_requested.load(); });
+
+			if (stop_requested) { return; }
+			rescan_requested = false;
+
+			try { scan_paths = directories; }
+			catch (...) { continue; }
+		}
+
+		scanning.store(true);
+		try {
+			if (scan_directories(scan_paths)) {
+				save_index();
+				publish_index();
+			}
+		}
+		catch (...) { blog.error("Program library scan ran out of memory!"); }
+
+		files_done.store(0); files_total.store(0);
+		scanning.store(false);
+	}
+}
+
+bool ProgramLibrary::Context::scan_directories(const std::vector<std::string>& scan_paths) {
+	// previous results of each file on disk, to be reused if it's unchanged
+	std::unordered_map<std::string_view, std::vector<std::size_t>> indexed_sources;
+	for (std::size_t i = 0; i < index.size(); ++i) {
+		indexed_sources[::get_source_path(index[i].file_path)].push_back(i);
+	}
+	std::unordered_map<std::string_view, std::size_t> skipped_sources;
+	for (std::size_t i = 0; i < skipped.size(); ++i) {
+		skipped_sources[skipped[i].source_path] = i;
+	}
+
+	std::vector<Record>        new_index;
+	std::vector<SkippedSource> new_skipped;
+	std::vector<PendingSource> pending;
+
+	const auto visit_file = [&](const std::filesystem::directory_entry& entry) {
+		std::error_code error;
+		const auto file_size  = entry.file_size(error);       if (error) { return; }
+		const auto write_time = entry.last_write_time(error); if (error) { return; }
+
+		auto file_path = entry.path().string();
+		const auto source_time = s64(write_time.time_since_epoch().count());
+
+		if (const auto it = indexed_sources.find(file_path); it != indexed_sources.end()) {
+			const auto& first = index[it->second.front()];
+			if (first.source_size == file_size && first.source_time == source_time) {
+				for (const auto i : it->second) { new_index.push_back(index[i]); }
+				return;
+			}
+		}
+		if (const auto it = skipped_sources.find(file_path); it != skipped_sources.end()) {
+			const auto& source = skipped[it->second];
+			if (source.source_size == file_size && source.source_time == source_time) {
+				new_skipped.push_back(source);
+				return;
+			}
+		}
+
+		auto& source = pending.emplace_back();
+		source.source_path = std::move(file_path);
+		source.source_size = file_size;
+		source.source_time = source_time;
+	};
+
+	for (const auto& scan_root : ::collect_scan_roots(scan_paths)) {
+		std::error_code error;
+		auto it = std::filesystem::recursive_directory_iterator(scan_root,
+			std::filesystem::directory_options::skip_permission_denied, error);
+
+		for (const auto end = std::filesystem::recursive_directory_iterator(); \
+			!error && it != end; it.increment(error))
+		{
+			if (stop_requested) { return false; }
+			if (!it->is_regular_file(error)) { continue; }
+
+			const auto& file_path = it->path();
+			if (ZipArchive::is_archive(file_path.string()) || ::is_claimed_extension(file_path))
+				{ visit_file(*it); }
+		}
+	}
+
+	files_total.store(pending.size());
+
+	std::for_each(EXEC_POLICY(par)
+		pending.begin(), pending.end(), [&](PendingSource& source) noexcept {
+			if (stop_requested) { return; }
+			try { ::index_source(source); }
+			catch (...) { source.records.clear(); }
+			files_done.fetch_add(1);
+		});
+
+	if (stop_requested) { return false; }
+
+	// sources without a single program are remembered too, so they aren't reopened each pass
+	for (auto& source : pending) {
+		if (source.records.empty()) {
+			new_skipped.push_back({ std::move(source.source_path),
+				source.source_size, source.source_time });
+		} else {
+			std::move(source.records.begin(), source.records.end(),
+				std::back_inserter(new_index));
+		}
+	}
+
+	// titles are looked up anew every pass, the ProgramDB may have changed since
+	for (auto& record : new_index) {
+		record.program_title = CoreRegistry::find_program_title(record.file_sha1);
+	}
+
+	std::sort(new_index.begin(), new_index.end(),
+		[](const Record& lhs, const Record& rhs) noexcept
+			{ return lhs.file_path < rhs.file_path; });
+	std::sort(new_skipped.begin(), new_skipped.end(),
+		[](const SkippedSource& lhs, const SkippedSource& rhs) noexcept
+			{ return lhs.source_path < rhs.source_path; });
+
+	if (new_index == index && new_skipped == skipped) { return false; }
+
+	index   = std::move(new_index);
+	skipped = std::move(new_skipped);
+	blog.info("Program library indexed {} entries, {} file(s) (re)scanned.",
+		index.size(), pending.size());
+	return true;
+}
+
+/*==================================================================*/
+
+ProgramLibrary::ProgramLibrary() noexcept
+	: m_context(std::make_unique<Context>())
+{}
+
+ProgramLibrary::~ProgramLibrary() noexcept { stop(); }
+
+bool ProgramLibrary::start(std::string index_path) noexcept {
+	if (!m_context || m_context->thread.joinable()) { return false; }
+	auto* ctx = m_context.get();
+
+	ctx->index_path = std::move(index_path);
+	ctx->load_index();
+	ctx->publish_index();
+
+	try {
+		ctx->stop_requested.store(false);
+		ctx->rescan_requested = true;
+		ctx->thread = Thread([ctx]() noexcept { ctx->scanner_loop(); });
+		return true;
+	}
+	catch (...) {
+		blog.error("Unable to start the program library scanner thread!");
+		return false;
+	}
+}
+
+void ProgramLibrary::stop() noexcept {
+	if (!m_context || !m_context->thread.joinable()) { return; }
+	{
+		std::scoped_lock lock(m_context->control_lock);
+		m_context->stop_requested.store(true);
+	}
+	m_context->control_signal.notify_all();
+	m_context->thread.join();
+}
+
+void ProgramLibrary::set_directories(std::vector<std::string> directories) noexcept {
+	if (!m_context) { return; }
+	{
+		std::scoped_lock lock(m_context->control_lock);
+		if (m_context->directories == directories) { return; }
+		m_context->directories = std::move(directories);
+		m_context->rescan_requested = true;
+	}
+	m_context->control_signal.notify_all();
+}
+
+void ProgramLibrary::add_directory(std::string directory) noexcept {
+	if (!m_context || directory.empty()) { return; }
+	try {
+		{
+			std::scoped_lock lock(m_context->control_lock);
+			auto& directories = m_context->directories;
+			if (std::find(directories.begin(), directories.end(), directory)
+				!= directories.end()) { return; }
+			directories.push_back(std::move(directory));
+			m_context->rescan_requested = true;
+		}
+		m_context->control_signal.notify_all();
+	}
+	catch (...) {}
+}
+
+void ProgramLibrary::remove_directory(std::string_view directory) noexcept {
+	if (!m_context) { return; }
+	{
+		std::scoped_lock lock(m_context->control_lock);
+		std::erase(m_context->directories, directory);
+		m_context->rescan_requested = true;
+	}
+	m_context->control_signal.notify_all();
+}
+
+auto ProgramLibrary::get_directories() const noexcept -> std::vector<std::string> {
+	if (!m_context) { return {}; }
+	try {
+		std::scoped_lock lock(m_context->control_lock);
+		return m_context->directories;
+	}
+	catch (...) { return {}; }
+}
+
+void ProgramLibrary::request_rescan() noexcept {
+	if (!m_context) { return; }
+	{
+		std::scoped_lock lock(m_context->control_lock);
+		m_context->rescan_requested = true;
+	}
+	m_context->control_signal.notify_all();
+}
+
+bool ProgramLibrary::is_scanning() const noexcept {
+	return m_context && m_context->scanning.load();
+}
+
+auto ProgramLibrary::get_scan_progress() const noexcept -> std::pair<std::size_t, std::size_t> {
+	if (!m_context) { return {}; }
+	return { m_context->files_done.load(), m_context->files_total.load() };
+}
+
+bool ProgramLibrary::commit_scan_results() noexcept {
+	if (!m_context) { return false; }
+
+	std::optional<std::vector<Record>> staged;
+	{
+		std::scoped_lock lock(m_context->staged_lock);
+		staged.swap(m_context->staged);
+	}
+	if (!staged) { return false; }
+
+	m_context->records = std::move(*staged);
+	return true;
+}
+
+auto ProgramLibrary::get_records() const noexcept -> std::span<const Record> {
+	if (!m_context) { return {}; }
+	return m_context->records;
+}
+
+bool ProgramLibrary::is_current(const Record& record) noexcept {
+	std::error_code error;
+	const auto source_path = std::filesystem::path(::get_source_path(record.file_path));
+
+	const auto file_size = std::filesystem::file_size(source_path, error);
+	if (error || file_size != record.source_size) { return false; }
+
+	const auto write_time = std::filesystem::last_write_time(source_path, error);
+	return !error && s64(write_time.time_since_epoch().count()) == record.source_time;
+}
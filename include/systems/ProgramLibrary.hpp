@@ -0,0 +1,81 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <span>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <string_view>
+
+/*==================================================================*/
+
+/**
+ * @brief Indexes the programs found in a set of directories, ZIP archive entries
+ *        included, for browsing without opening each file. A scanner thread walks
+ *        the directories on request and at a fixed interval, and only files that
+ *        are new or whose size/write time changed are hashed and validated, in
+ *        parallel. The index is cached in a binary file between sessions.
+ *
+ * Only files with an extension claimed by a registered core are indexed.
+ *
+ * @note Results are handed over to the main thread via 'commit_scan_results()',
+ *       and 'get_records()' must only be used from that same thread.
+ */
+class ProgramLibrary final {
+	struct Context;
+	std::unique_ptr<Context> m_context;
+
+public:
+	struct Record {
+		std::string   file_path{};      // '<archive>/<entry>' for archive entries
+		std::string   file_sha1{};
+		std::string   program_title{};  // from the ProgramDB, empty if not listed
+		std::string   matching_cores{}; // comma-separated names of the accepting cores
+		std::uint64_t file_size{};
+		std::uint64_t source_size{};    // of the file on disk holding the program,
+		std::int64_t  source_time{};    // with its write time, for change detection
+
+		bool operator==(const Record&) const noexcept = default;
+	};
+
+	ProgramLibrary() noexcept;
+	~ProgramLibrary() noexcept;
+
+	ProgramLibrary(const ProgramLibrary&) = delete;
+	ProgramLibrary& operator=(const ProgramLibrary&) = delete;
+
+	/**
+	 * @brief Loads the cached index, if any, and starts the scanner thread.
+	 * @param[in] index_path :: File the index is cached in.
+	 */
+	bool start(std::string index_path) noexcept;
+	void stop() noexcept;
+
+	// Sets the directories to index, scanning them anew if they changed. Thread-safe.
+	void set_directories(std::vector<std::string> directories) noexcept;
+	// Adds a directory to index, unless present already. Thread-safe.
+	void add_directory(std::string directory) noexcept;
+	void remove_directory(std::string_view directory) noexcept;
+	auto get_directories() const noexcept -> std::vector<std::string>;
+
+	// Wakes the scanner up ahead of its next periodic pass. Thread-safe.
+	void request_rescan() noexcept;
+
+	bool is_scanning() const noexcept;
+	// Files scanned so far in the current pass, and the amount the pass has to scan.
+	auto get_scan_progress() const noexcept -> std::pair<std::size_t, std::size_t>;
+
+	// Swaps in the index published by the scanner since the last call, if any.
+	bool commit_scan_results() noexcept;
+	auto get_records() const noexcept -> std::span<const Record>;
+
+	// True if the file holding the program is unchanged since it was indexed.
+	static bool is_current(const Record& record) noexcept;
+};
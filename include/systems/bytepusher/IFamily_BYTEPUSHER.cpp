@@ -11,6 +11,7 @@
 #include "BasicLogger.hpp"
 #include "BasicInput.hpp"
 #include "SimpleFileIO.hpp"
+#include "ZoneProfiler.hpp"
 
 /*==================================================================*/
 
@@ -32,6 +33,10 @@ void IFamily_BYTEPUSHER::initialize_family() noexcept {
 				"savestates will be unavailable!", family_pretty_name);
 		}
 	}
+
+	if (auto* path = add_system_path("captures", family_name)) {
+		m_display_device.set_capture_directory(*path, get_system_id());
+	}
 }
 
 /*==================================================================*/
@@ -42,9 +47,24 @@ void IFamily_BYTEPUSHER::main_system_loop() {
 		return;
 	}
 
-	handle_cycle_loop();
-	push_audio_data();
-	push_video_data();
+	{
+		PROFILE_ZONE("handle_cycle_loop");
+		handle_cycle_loop();
+	}
+	if (m_debugger.is_mid_frame()) {
+		// stopped mid-frame, show the partial frame but hold off the frame end
+		if (should_push_video()) { push_video_data(); }
+		create_statistics_data();
+		return;
+	}
+	{
+		PROFILE_ZONE("push_audio_data");
+		push_audio_data();
+	}
+	if (should_push_video()) {
+		PROFILE_ZONE("push_video_data");
+		push_video_data();
+	}
 	create_statistics_data();
 }
 
@@ -61,17 +81,7 @@ void IFamily_BYTEPUSHER::load_preset_binds() noexcept {
 }
 
 u32  IFamily_BYTEPUSHER::get_key_states() noexcept {
-	auto key_states = 0u;
-
-	m_input.advance_state();
-
-	for (const auto& mapping : m_custom_binds) {
-		if (m_input.is_held(mapping.key) || m_input.is_held(mapping.alt)) {
-			key_states |= 1 << mapping.idx;
-		}
-	}
-
-	return key_states;
+	return poll_bind_states();
 }
 
 #endif
@@ -37,6 +37,10 @@ protected:
 	WindowHost    m_display_window;
 	DisplayDevice m_display_device;
 
+public:
+	DisplayDevice* get_display_device() noexcept override final { return &m_display_device; }
+
+protected:
 	AudioDevice   m_audio_device;
 
 protected:
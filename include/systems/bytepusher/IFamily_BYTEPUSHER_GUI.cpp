@@ -53,7 +53,7 @@ void IFamily_BYTEPUSHER::prepare_user_interface() noexcept {
 
 	m_display_device.set_osd_callable([&]() noexcept {
 		if (!has_cached_system_state(EmuState::STATS)) { return; }
-		osd::simple_text_overlay(copy_statistics_string());
+		osd::simple_text_overlay(copy_statistics_text().view());
 	});
 
 	m_memory_editor.set_preview_endianness(MemoryEditor::Endian::BE);
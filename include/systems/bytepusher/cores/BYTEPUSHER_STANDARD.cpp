@@ -15,6 +15,12 @@ REGISTER_SYSTEM_CORE(BYTEPUSHER_STANDARD)
 /*==================================================================*/
 
 void BYTEPUSHER_STANDARD::initialize_system() noexcept {
+	if (!m_memory.is_valid()) {
+		blog.error("Unable to allocate {} bytes of system memory!", m_memory.size());
+		add_system_state(EmuState::FATAL);
+		return;
+	}
+
 	copy_file_image_to(m_memory, 0);
 
 	m_base_system_framerate = c_sys_refresh_rate;
@@ -22,7 +28,7 @@ void BYTEPUSHER_STANDARD::initialize_system() noexcept {
 	m_audio_device.init_stream(s32(c_sys_refresh_rate * c_sys_audio_sample_total), 1);
 	m_audio_device.resume();
 
-	m_memory_editor.set_memory_range(m_memory.data(), m_memory.size());
+	bind_system_memory(m_memory.data(), m_memory.size());
 
 	m_display_device.metadata().edit([](auto& meta) noexcept {
 		meta.minimum_zoom = 2;
@@ -33,33 +39,69 @@ void BYTEPUSHER_STANDARD::initialize_system() noexcept {
 }
 
 void BYTEPUSHER_STANDARD::reset_system_data() noexcept {
+	if (!m_memory.is_valid()) { return; }
+
 	m_memory.clear();
 	copy_file_image_to(m_memory, 0);
 }
 
 /*==================================================================*/
 
+template <bool DEBUG>
 void BYTEPUSHER_STANDARD::handle_cycle_loop() noexcept {
-	const auto input_states = get_key_states();
-	/***/ auto prog_pointer = get_program_counter();
+	// a reset lifts the fatal state, so without memory it has to be raised again
+	if (!m_memory.is_valid()) [[unlikely]] { add_system_state(EmuState::FATAL); return; }
+
+	const auto start_cycle = DEBUG ? m_debugger.begin_slice() : 0u;
+	/***/ auto prog_pointer = m_resume_pointer;
 
-	::assign_cast(m_memory[0], input_states >> 0x8);
-	::assign_cast(m_memory[1], input_states & 0xFF);
+	if (!start_cycle) {
+		const auto input_states = get_key_states();
+		prog_pointer = get_program_counter();
+
+		::assign_cast(m_memory[0], input_states >> 0x8);
+		::assign_cast(m_memory[1], input_states & 0xFF);
+		m_memory_writes.mark(0, 2);
+	}
+
+	for (auto cycle_count = start_cycle; cycle_count < c_sys_standard_cpf; ++cycle_count) {
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(prog_pointer, cycle_count)) {
+				m_resume_pointer = prog_pointer;
+				return;
+			}
+			m_debugger.note_read(read_data<ByteSpan::TRIPLE>(prog_pointer + 0), 1);
+		}
 
-	for (auto cycle_count = 0; cycle_count < c_sys_standard_cpf; ++cycle_count) {
-		m_memory[read_data<ByteSpan::TRIPLE>(prog_pointer + 3)] =
-		m_memory[read_data<ByteSpan::TRIPLE>(prog_pointer + 0)];
+		const auto write_address = read_data<ByteSpan::TRIPLE>(prog_pointer + 3);
+
+		m_memory[write_address] = m_memory[read_data<ByteSpan::TRIPLE>(prog_pointer + 0)];
+		m_memory_writes.mark(write_address);
 		prog_pointer = read_data<ByteSpan::TRIPLE>(prog_pointer + 6);
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(prog_pointer, cycle_count + 1)) {
+				m_resume_pointer = prog_pointer;
+				return;
+			}
+		}
 	}
 }
 
+void BYTEPUSHER_STANDARD::handle_cycle_loop() noexcept {
+	// the debug loop also finishes a frame that a stop left half-done
+	if (has_cached_system_state(EmuState::DEBUG) || m_debugger.is_mid_frame())
+		[[unlikely]] { handle_cycle_loop<true>(); }
+	else { handle_cycle_loop<false>(); }
+}
+
 void BYTEPUSHER_STANDARD::push_audio_data() noexcept {
 	if (m_audio_device) {
 		m_audio_device.set_freq_ratio(m_framerate_multiplier);
 
 		float buffer[c_sys_audio_sample_total]{};
 
-		if (!has_cached_system_state(EmuState::ANY_PAUSE)) {
+		if (!has_cached_system_state(EmuState::ANY_PAUSE) && m_memory.is_valid()) {
 			static constexpr auto c_master_gain = 0.5f;
 
 			const auto samples = std::span(m_memory.data()
@@ -78,7 +120,9 @@ void BYTEPUSHER_STANDARD::push_audio_data() noexcept {
 }
 
 void BYTEPUSHER_STANDARD::push_video_data() noexcept {
-	m_display_device.swapchain().acquire([&](auto& frame) noexcept {
+	if (!m_memory.is_valid()) [[unlikely]] { return; }
+
+	m_display_device.present([&](auto& frame) noexcept {
 		frame.metadata = m_display_device.metadata().copy();
 		frame.copy_from(&m_memory[read_data<ByteSpan::SINGLE>(5) << 16],
 			c_sys_screen_W * c_sys_screen_H,
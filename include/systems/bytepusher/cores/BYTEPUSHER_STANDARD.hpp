@@ -48,9 +48,13 @@ public:
 /*==================================================================*/
 
 private:
-	MirroredMemory<c_sys_memory_size>
+	// programs read and write all over it, huge pages spare the TLB the most misses
+	SparseMirroredMemory<c_sys_memory_size, u8, AllocPolicy::HUGE_PAGES>
 		m_memory{};
 
+	// program pointer to continue from after a debugger stop mid-frame
+	u32 m_resume_pointer{};
+
 	enum class ByteSpan { SINGLE, DOUBLE, TRIPLE };
 	template<ByteSpan SPAN>
 	u32 read_data(u32 pos) const noexcept {
@@ -70,6 +74,9 @@ private:
 		return read_data<ByteSpan::TRIPLE>(2);
 	}
 
+	template <bool DEBUG>
+	void handle_cycle_loop() noexcept;
+
 	void handle_cycle_loop() noexcept override final;
 	void push_audio_data() noexcept override;
 	void push_video_data() noexcept override;
@@ -11,6 +11,7 @@
 #include "BasicLogger.hpp"
 #include "SimpleFileIO.hpp"
 #include "SimpleTimer.hpp"
+#include "ZoneProfiler.hpp"
 
 /*==================================================================*/
 
@@ -42,6 +43,10 @@ void IFamily_CHIP8::initialize_family() noexcept {
 				"permanent register storage will be unavailable!", family_pretty_name);
 		}
 	}
+
+	if (auto* path = add_system_path("captures", family_name)) {
+		m_display_device.set_capture_directory(*path, get_system_id());
+	}
 }
 
 void IFamily_CHIP8::reset_family_data() noexcept {
@@ -58,23 +63,15 @@ void IFamily_CHIP8::reset_family_data() noexcept {
 
 /*==================================================================*/
 
-void IFamily_CHIP8::HexInput::update(BasicKeyboard& input, const SimpleKeyVec& binds) noexcept {
-	input.advance_state();
-
+void IFamily_CHIP8::HexInput::update(u32 key_states) noexcept {
 	m_keys_last = m_keys_this;
-	m_keys_this = 0;
-
-	for (const auto& mapping : binds) {
-		if (input.is_held(mapping.key) || input.is_held(mapping.alt)) {
-			m_keys_this |= 1 << mapping.idx;
-		}
-	}
+	m_keys_this = key_states;
 
 	m_keys_loop &= m_keys_hide &= ~(m_keys_last ^ m_keys_this);
 }
 
 void IFamily_CHIP8::update_keypad_data() noexcept {
-	m_keypad.update(m_input, m_custom_binds);
+	m_keypad.update(poll_bind_states());
 }
 
 void IFamily_CHIP8::load_preset_binds() noexcept {
@@ -194,7 +191,30 @@ void IFamily_CHIP8::jump_program_to(u32 next) noexcept {
 		{ trigger_interrupt(Interrupt::SOUND); }
 }
 
+void IFamily_CHIP8::note_debug_opcode(u32 HI, u32 LO) noexcept {
+	switch (HI >> 4) {
+		case 0xD:
+			m_debugger.note_read(m_register_I, (LO & 0xF) ? (LO & 0xF) : 32);
+			return;
+
+		case 0xF:
+			if (LO == 0x65) { m_debugger.note_read(m_register_I, (HI & 0xF) + 1); }
+			return;
+	}
+}
+
 void IFamily_CHIP8::execute_cycle_loop() noexcept {
+	PROFILE_ZONE("execute_cycle_loop");
+
+	// the debug loop also finishes a frame that a stop left half-done
+	const bool use_debug_loop = has_cached_system_state(EmuState::DEBUG)
+		|| m_debugger.is_mid_frame();
+
+	const auto run_instruction_loop = [&]() noexcept {
+		if (use_debug_loop) [[unlikely]] { instruction_loop_debug(); }
+		else { instruction_loop_fast(); }
+	};
+
 	if (has_cached_system_state(EmuState::BENCH)) {
 		// avg time multiplier to cushion against slice jitter
 		static constexpr auto c_jitter_multiplier = 1.1f;
@@ -207,16 +227,17 @@ void IFamily_CHIP8::execute_cycle_loop() noexcept {
 		slice_timer.start();
 
 		do {
-			instruction_loop();
+			run_instruction_loop();
 			total_cycles += m_cycle_count;
 			if (m_interrupt != Interrupt::CLEAR) { break; }
+			if (m_debugger.is_mid_frame()) { break; }
 			frametime_ema.add(slice_timer.lap_millis());
 		}
 		while (frametime_ema.avg() * c_jitter_multiplier < m_pacer.get_period_remaining());
 		m_cycle_count = total_cycles;
 		return;
 	} else {
-		instruction_loop();
+		run_instruction_loop();
 	}
 }
 
@@ -231,15 +252,31 @@ void IFamily_CHIP8::main_system_loop() {
 		return;
 	}
 
-	update_keypad_data();
+	// resuming a frame split by a debugger stop, its start was already handled
+	if (!m_debugger.is_mid_frame()) {
+		update_keypad_data();
 
-	handle_timer_ticks();
-	handle_pre_work_interrupts();
+		handle_timer_ticks();
+		handle_pre_work_interrupts();
+	}
 	execute_cycle_loop();
+
+	if (m_debugger.is_mid_frame()) {
+		// stopped again, show the partial frame but hold off the frame end
+		if (should_push_video()) { push_video_data(); }
+		create_statistics_data();
+		return;
+	}
 	handle_post_work_interrupts();
 
-	push_audio_data();
-	push_video_data();
+	{
+		PROFILE_ZONE("push_audio_data");
+		push_audio_data();
+	}
+	if (should_push_video()) {
+		PROFILE_ZONE("push_video_data");
+		push_video_data();
+	}
 	create_statistics_data();
 }
 
@@ -259,6 +296,143 @@ void IFamily_CHIP8::append_statistics_data() noexcept {
 
 /*==================================================================*/
 
+void IFamily_CHIP8::read_register_file(std::vector<RegisterValue>& output) const noexcept {
+	static constexpr std::string_view c_names_V[] = {
+		"V0", "V1", "V2", "V3", "V4", "V5", "V6", "V7",
+		"V8", "V9", "VA", "VB", "VC", "VD", "VE", "VF",
+	};
+	static constexpr std::string_view c_names_S[] = {
+		"S0", "S1", "S2", "S3", "S4", "S5", "S6", "S7",
+		"S8", "S9", "SA", "SB", "SC", "SD", "SE", "SF",
+	};
+
+	try {
+		output.push_back({ "PC", m_current_pc });
+		output.push_back({ "I",  m_register_I });
+		output.push_back({ "DT", m_delay_timer });
+		output.push_back({ "SP", m_stack.head() });
+
+		for (u32 i = 0; i < 16; ++i) { output.push_back({ c_names_V[i], m_registers_V[i] }); }
+		for (u32 i = 0; i < m_stack.head(); ++i) { output.push_back({ c_names_S[i], m_stack.peek(i) }); }
+	} catch (...) { /* partial output is still useful */ }
+}
+
+u32  IFamily_CHIP8::disassemble(u32 addr, std::string& output) const noexcept {
+	const auto memory = get_system_memory();
+	if (memory.empty()) { return ISystemEmu::disassemble(addr, output); }
+
+	const auto read = [&](u32 offset) noexcept { return u32(memory[(addr + offset) % memory.size()]); };
+
+	const auto HI = read(0), LO = read(1);
+	const auto NNN = (HI << 8 | LO) & 0xFFF;
+	const auto X = HI & 0xF, Y = LO >> 4, N = LO & 0xF;
+
+	u32 size = 2;
+
+	try {
+		const auto format = [&]<typename... Args>(fmt::format_string<Args...> text, Args&&... args) {
+			output = fmt::format(text, std::forward<Args>(args)...);
+		};
+
+		switch (HI >> 4) {
+			case 0x0:
+				if      (HI == 0x00 && LO == 0xE0) { format("cls"); }
+				else if (HI == 0x00 && LO == 0xEE) { format("ret"); }
+				else if (HI == 0x00 && LO == 0xFB) { format("scr"); }
+				else if (HI == 0x00 && LO == 0xFC) { format("scl"); }
+				else if (HI == 0x00 && LO == 0xFD) { format("exit"); }
+				else if (HI == 0x00 && LO == 0xFE) { format("low"); }
+				else if (HI == 0x00 && LO == 0xFF) { format("high"); }
+				else if (HI == 0x00 && Y == 0xB)   { format("scu {}", N); }
+				else if (HI == 0x00 && Y == 0xC)   { format("scd {}", N); }
+				else { format("sys 0x{:03X}", NNN); }
+				break;
+			case 0x1: format("jp 0x{:03X}", NNN); break;
+			case 0x2: format("call 0x{:03X}", NNN); break;
+			case 0x3: format("se v{:X}, 0x{:02X}", X, LO); break;
+			case 0x4: format("sne v{:X}, 0x{:02X}", X, LO); break;
+			case 0x5:
+				switch (N) {
+					case 0x0: format("se v{:X}, v{:X}", X, Y); break;
+					case 0x2: format("ld [i], v{:X}-v{:X}", X, Y); break;
+					case 0x3: format("ld v{:X}-v{:X}, [i]", X, Y); break;
+					default:  format("dw 0x{:02X}{:02X}", HI, LO); break;
+				}
+				break;
+			case 0x6: format("ld v{:X}, 0x{:02X}", X, LO); break;
+			case 0x7: format("add v{:X}, 0x{:02X}", X, LO); break;
+			case 0x8:
+				switch (N) {
+					case 0x0: format("ld v{:X}, v{:X}", X, Y); break;
+					case 0x1: format("or v{:X}, v{:X}", X, Y); break;
+					case 0x2: format("and v{:X}, v{:X}", X, Y); break;
+					case 0x3: format("xor v{:X}, v{:X}", X, Y); break;
+					case 0x4: format("add v{:X}, v{:X}", X, Y); break;
+					case 0x5: format("sub v{:X}, v{:X}", X, Y); break;
+					case 0x6: format("shr v{:X}, v{:X}", X, Y); break;
+					case 0x7: format("subn v{:X}, v{:X}", X, Y); break;
+					case 0xE: format("shl v{:X}, v{:X}", X, Y); break;
+					default:  format("dw 0x{:02X}{:02X}", HI, LO); break;
+				}
+				break;
+			case 0x9: format("sne v{:X}, v{:X}", X, Y); break;
+			case 0xA: format("ld i, 0x{:03X}", NNN); break;
+			case 0xB: format("jp v0, 0x{:03X}", NNN); break;
+			case 0xC: format("rnd v{:X}, 0x{:02X}", X, LO); break;
+			case 0xD: format("drw v{:X}, v{:X}, {}", X, Y, N); break;
+			case 0xE:
+				if      (LO == 0x9E) { format("skp v{:X}", X); }
+				else if (LO == 0xA1) { format("sknp v{:X}", X); }
+				else { format("dw 0x{:02X}{:02X}", HI, LO); }
+				break;
+			case 0xF:
+				switch (LO) {
+					case 0x00:
+						if (X) { format("dw 0x{:02X}{:02X}", HI, LO); break; }
+						format("ld i, 0x{:04X}", read(2) << 8 | read(3));
+						size = 4; break;
+					case 0x01: format("plane {}", X); break;
+					case 0x02: format("audio"); break;
+					case 0x07: format("ld v{:X}, dt", X); break;
+					case 0x0A: format("ld v{:X}, k", X); break;
+					case 0x15: format("ld dt, v{:X}", X); break;
+					case 0x18: format("ld st, v{:X}", X); break;
+					case 0x1E: format("add i, v{:X}", X); break;
+					case 0x29: format("ld f, v{:X}", X); break;
+					case 0x30: format("ld hf, v{:X}", X); break;
+					case 0x33: format("ld b, v{:X}", X); break;
+					case 0x3A: format("pitch v{:X}", X); break;
+					case 0x55: format("ld [i], v{:X}", X); break;
+					case 0x65: format("ld v{:X}, [i]", X); break;
+					case 0x75: format("ld r, v{:X}", X); break;
+					case 0x85: format("ld v{:X}, r", X); break;
+					default:   format("dw 0x{:02X}{:02X}", HI, LO); break;
+				}
+				break;
+		}
+	} catch (...) { output.clear(); }
+
+	return size;
+}
+
+bool IFamily_CHIP8::override_quirk(std::string_view name, bool state) noexcept {
+	static constexpr std::pair<std::string_view, QuirkFlag> c_quirk_tokens[] = {
+		{ "RESET_VF_REG", RESET_VF_REG }, { "JUMP_WITH_VX", JUMP_WITH_VX },
+		{ "SHIFT_VX_REG", SHIFT_VX_REG }, { "NO_INC_I_REG", NO_INC_I_REG },
+		{ "X1_INC_I_REG", X1_INC_I_REG }, { "AWAIT_VBLANK", AWAIT_VBLANK },
+		{ "AWAIT_SCROLL", AWAIT_SCROLL }, { "WRAP_SPRITES", WRAP_SPRITES },
+	};
+
+	for (const auto& [token, flag] : c_quirk_tokens) {
+		if (token != name || !(get_avail_quirks() & flag)) { continue; }
+		if (state) { add_quirk(flag); } else { sub_quirk(flag); }
+		return true;
+	}
+	return false;
+}
+
+/*==================================================================*/
+
 void IFamily_CHIP8::start_voice(u32 duration) noexcept {
 	start_voice_at(m_last_voice_index, duration);
 	if (duration) { ++m_last_voice_index %= VOICE::COUNT - 1; }
@@ -14,6 +14,7 @@
 #include "../ISystemEmu.hpp"
 
 #include "AssignCast.hpp"
+#include "ZoneProfiler.hpp"
 #include "AudioDevice.hpp"
 #include "Voice.hpp"
 #include "DisplayDevice.hpp"
@@ -86,7 +87,7 @@ protected:
 		void set_reg_ptr(u8* reg_ptr) noexcept { m_key_reg_ptr = reg_ptr; }
 		auto* get_reg_ptr() const noexcept { return m_key_reg_ptr; }
 
-		void update(BasicKeyboard& input, const SimpleKeyVec& binds) noexcept;
+		void update(u32 key_states) noexcept;
 		bool catch_press(u32 frame_count) noexcept;
 
 		bool is_key_held_P1(u32 key_index) const noexcept;
@@ -110,6 +111,9 @@ protected:
 	WindowHost    m_display_window;
 	DisplayDevice m_display_device;
 
+public:
+	DisplayDevice* get_display_device() noexcept override final { return &m_display_device; }
+
 /*==================================================================*/
 
 protected:
@@ -133,6 +137,8 @@ protected:
 	template <typename... Generator>
 		requires ((IsSampleGenerator<Generator> && ...))
 	void mix_audio_data(Generator&&... generators) noexcept {
+		PROFILE_ZONE("mix_audio_data");
+
 		if (m_audio_device) {
 			m_audio_device.set_freq_ratio(m_framerate_multiplier);
 
@@ -298,7 +304,11 @@ protected:
 	/*   */ void handle_post_work_interrupts() noexcept;
 
 	/*   */ void handle_timer_ticks() noexcept;
-	virtual void instruction_loop()   noexcept = 0;
+	virtual void instruction_loop_fast()  noexcept = 0;
+	virtual void instruction_loop_debug() noexcept = 0;
+
+	// Reports the memory read by the standard I-indexed opcodes to the debugger.
+	/*   */ void note_debug_opcode(u32 HI, u32 LO) noexcept;
 
 	virtual void skip_instruction() noexcept;
 	/*   */ void jump_program_to(u32 next) noexcept;
@@ -320,6 +330,10 @@ public:
 
 	void append_statistics_data() noexcept override final;
 
+	void read_register_file(std::vector<RegisterValue>& output) const noexcept override;
+	u32  disassemble(u32 addr, std::string& output) const noexcept override;
+	bool override_quirk(std::string_view name, bool state) noexcept override final;
+
 /*==================================================================*/
 
 protected:
@@ -58,7 +58,7 @@ void IFamily_CHIP8::prepare_user_interface() noexcept {
 				500, u32(Millis::now())).as_unipolar());
 		}
 		if (!has_cached_system_state(EmuState::STATS)) { return; }
-		osd::simple_text_overlay(copy_statistics_string());
+		osd::simple_text_overlay(copy_statistics_text().view());
 	});
 
 	m_frontend_hooks.emplace_back(UserInterface::register_menu(m_workspace_host,
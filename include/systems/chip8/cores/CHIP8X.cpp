@@ -22,7 +22,7 @@ void CHIP8X::initialize_system() noexcept {
 
 	m_base_system_framerate = c_sys_refresh_rate;
 
-	m_memory_editor.set_memory_range(m_memory.data(), m_memory.size(), 0x8000);
+	bind_system_memory(m_memory.data(), m_memory.size(), 0x8000);
 
 	m_current_pc = c_sys_boot_pos;
 	m_standard_cpf = c_sys_speed_hi;
@@ -53,14 +53,20 @@ void CHIP8X::reset_system_data() noexcept {
 	m_standard_cpf = c_sys_speed_hi;
 }
 
+template <bool DEBUG>
 void CHIP8X::instruction_loop() noexcept {
 	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
 		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
-	for (m_cycle_count = 0; m_interrupt == Interrupt::CLEAR
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
 		&& m_cycle_count < target_cpf; ++m_cycle_count)
 	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
 		const auto HI = m_memory[m_current_pc++];
 		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
 
 		#define _NNN ((HI << 8 | LO) & 0xFFF)
 		#define _X (HI & 0xF)
@@ -231,9 +237,16 @@ void CHIP8X::instruction_loop() noexcept {
 				}
 				break;
 		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
 	}
 }
 
+void CHIP8X::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void CHIP8X::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
 void CHIP8X::push_audio_data() noexcept {
 	mix_audio_data(
 		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::UNIQUE]); },
@@ -251,7 +264,7 @@ void CHIP8X::push_audio_data() noexcept {
 
 void CHIP8X::push_video_data() noexcept {
 	if (use_pixel_trails()) {
-		m_display_device.swapchain().acquire([&](auto& frame) noexcept {
+		m_display_device.present([&](auto& frame) noexcept {
 			frame.metadata = m_display_device.metadata().copy();
 			frame.copy_from(m_display_map, [&](auto& pixel) noexcept {
 				if (pixel == 0) {
@@ -272,7 +285,7 @@ void CHIP8X::push_video_data() noexcept {
 			}
 		);
 	} else {
-		m_display_device.swapchain().acquire([&](auto& frame) noexcept {
+		m_display_device.present([&](auto& frame) noexcept {
 			frame.metadata = m_display_device.metadata().copy();
 			frame.copy_from(m_display_map, [&](auto& pixel) noexcept {
 				if (pixel == 0) {
@@ -601,9 +614,11 @@ void CHIP8X::color_hires_zone(u32 X, u32 Y, u32 idx, u32 N) noexcept {
 		m_memory[m_register_I + 0] = bcd.digit[2];
 		m_memory[m_register_I + 1] = bcd.digit[1];
 		m_memory[m_register_I + 2] = bcd.digit[0];
+		m_memory_writes.mark(m_register_I, 3);
 	}
 	void CHIP8X::instruction_FN55(u32 N) noexcept {
 		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		m_memory_writes.mark(m_register_I, N + 1);
 		::assign_cast_add(m_register_I, N + 1);
 	}
 	void CHIP8X::instruction_FN65(u32 N) noexcept {
@@ -88,7 +88,11 @@ private:
 	void initialize_system() noexcept override final;
 	void reset_system_data() noexcept override final;
 
-	void instruction_loop() noexcept override final;
+	template <bool DEBUG>
+	void instruction_loop() noexcept;
+
+	void instruction_loop_fast()  noexcept override final;
+	void instruction_loop_debug() noexcept override final;
 
 	void push_audio_data() noexcept override final;
 	void push_video_data() noexcept override final;
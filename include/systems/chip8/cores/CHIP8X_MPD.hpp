@@ -0,0 +1,340 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "../IFamily_CHIP8.hpp"
+
+#define ENABLE_CHIP8X_MPD
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_CHIP8X_MPD)
+
+#include "SystemDescriptor.hpp"
+#include "ArrayOps.hpp"
+
+/*==================================================================*/
+
+class CHIP8X_MPD : public IFamily_CHIP8 {
+protected:
+	static constexpr u64 c_sys_memory_size  = 4_KiB;
+	static constexpr u32 c_game_load_pos    = 0x300;
+	static constexpr u32 c_sys_boot_pos     = 0x300;
+	static constexpr f32 c_sys_refresh_rate = 61.0f;
+
+	static constexpr u32 c_sys_screen_W = 64;
+	static constexpr u32 c_max_screen_H = 128;
+
+	static constexpr u32 c_sys_speed_hi = 30;
+	static constexpr u32 c_sys_speed_lo = 15;
+
+	static constexpr const char* validate_program(std::span<const char> file) noexcept {
+		return Family::validate_program(file, c_game_load_pos, c_sys_memory_size);
+	}
+
+/*==================================================================*/
+
+private:
+	const u32 m_page_count;
+	const u32 m_screen_H;
+
+	u32 m_background_color = 0x00;
+	u32 m_color_row_mask   = 0xFC;
+	u32 m_page_guard       = 0x00;
+
+	MirroredMemory<c_sys_memory_size>
+		m_memory{};
+
+	static constexpr u32 c_zones_per_row = c_sys_screen_W / 8;
+
+	// one color per 8px zone, looked up a row at a time with the row mask applied
+	std::array<RGBA, c_zones_per_row * c_max_screen_H>
+		m_zone_colors{};
+
+	// one bit per pixel, a u64 per row; planes 1..3 hold the trail history
+	using DisplayRows = std::array<u64, c_max_screen_H>;
+
+	DisplayRows m_display_rows[4]{};
+
+	void set_pulse_pitch(u32 pitch) noexcept;
+
+	static constexpr std::array<RGBA, 8> c_fore_colors = {
+		0x000000FF, 0xEE1111FF, 0x1111EEFF, 0xEE11EEFF,
+		0x11EE11FF, 0xEEEE11FF, 0x11EEEEFF, 0xEEEEEEFF,
+	};
+	static constexpr std::array<RGBA, 4> c_back_colors = {
+		0x111133FF, 0x111111FF, 0x113311FF, 0x331111FF,
+	};
+
+	RGBA& zone_color(u32 X, u32 Y) noexcept {
+		return m_zone_colors[(Y & (m_screen_H - 1)) * c_zones_per_row + (X & (c_zones_per_row - 1))];
+	}
+
+	void color_lores_zone(u32 X, u32 Y, u32 idx)        noexcept;
+	void color_hires_zone(u32 X, u32 Y, u32 idx, u32 N) noexcept;
+
+	void erase_display_pages() noexcept;
+
+protected:
+	CHIP8X_MPD(u32 page_count) noexcept
+		: IFamily_CHIP8(c_sys_screen_W, page_count * 32)
+		, m_page_count(page_count)
+		, m_screen_H(page_count * 32)
+	{}
+
+private:
+	void initialize_system() noexcept override final;
+	void reset_system_data() noexcept override final;
+
+	template <bool DEBUG>
+	void instruction_loop() noexcept;
+
+	void instruction_loop_fast()  noexcept override final;
+	void instruction_loop_debug() noexcept override final;
+
+	void push_audio_data() noexcept override final;
+	void push_video_data() noexcept override final;
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	// 00E0 - erase whole display
+	void instruction_00E0() noexcept;
+	// 00EE - return from subroutine
+	void instruction_00EE() noexcept;
+	// 00F0 - return from subroutine
+	void instruction_00F0() noexcept;
+	// 0200 - erase unprotected pages (4-page)
+	void instruction_0200() noexcept;
+	// 0216 - protect pages from V0 (4-page)
+	void instruction_0216() noexcept;
+	// 0230 - erase display pages (2-page)
+	void instruction_0230() noexcept;
+	// 02F0 - cycle background color
+	void instruction_02F0() noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	// 1NNN - jump to NNN
+	void instruction_1NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	// 2NNN - call subroutine at NNN
+	void instruction_2NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	// 3XNN - skip next instruction if VX == NN
+	void instruction_3xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	// 4XNN - skip next instruction if VX != NN
+	void instruction_4xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	// 5XY0 - skip next instruction if VX == VY
+	void instruction_5xy0(u32 X, u32 Y) noexcept;
+	// 5XY1 - set VX to added lo/hi nibbles of VX and VY
+	void instruction_5xy1(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	// 6XNN - set VX = NN
+	void instruction_6xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	// 7XNN - set VX = VX + NN
+	void instruction_7xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	// 8XY0 - set VX = VY
+	void instruction_8xy0(u32 X, u32 Y) noexcept;
+	// 8XY1 - set VX = VX | VY
+	void instruction_8xy1(u32 X, u32 Y) noexcept;
+	// 8XY2 - set VX = VX & VY
+	void instruction_8xy2(u32 X, u32 Y) noexcept;
+	// 8XY3 - set VX = VX ^ VY
+	void instruction_8xy3(u32 X, u32 Y) noexcept;
+	// 8XY4 - set VX = VX + VY, VF = carry
+	void instruction_8xy4(u32 X, u32 Y) noexcept;
+	// 8XY5 - set VX = VX - VY, VF = !borrow
+	void instruction_8xy5(u32 X, u32 Y) noexcept;
+	// 8XY7 - set VX = VY - VX, VF = !borrow
+	void instruction_8xy7(u32 X, u32 Y) noexcept;
+	// 8XY6 - set VX = VY >> 1, VF = carry
+	void instruction_8xy6(u32 X, u32 Y) noexcept;
+	// 8XYE - set VX = VY << 1, VF = carry
+	void instruction_8xyE(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	// 9XY0 - skip next instruction if VX != VY
+	void instruction_9xy0(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	// ANNN - set I = NNN
+	void instruction_ANNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	// BxyN - set foreground color
+	void instruction_BxyN(u32 X, u32 Y, u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	// CXNN - set VX = rnd(256) & NN
+	void instruction_CxNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	void draw_byte(u32 X, u32 Y, u32 DATA) noexcept;
+
+	// DXYN - draw N sprite rows at VX and VY
+	void instruction_DxyN(u32 X, u32 Y, u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	// EX9E - skip next instruction if key VX down (p1)
+	void instruction_Ex9E(u32 X) noexcept;
+	// EXA1 - skip next instruction if key VX up (p1)
+	void instruction_ExA1(u32 X) noexcept;
+	// EXF2 - skip next instruction if key VX down (p2)
+	void instruction_ExF2(u32 X) noexcept;
+	// EXF2 - skip next instruction if key VX up (p2)
+	void instruction_ExF5(u32 X) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	// FX07 - set VX = delay timer
+	void instruction_Fx07(u32 X) noexcept;
+	// FX0A - set VX = key, wait for keypress
+	void instruction_Fx0A(u32 X) noexcept;
+	// FX15 - set delay timer = VX
+	void instruction_Fx15(u32 X) noexcept;
+	// FX18 - set sound timer = VX
+	void instruction_Fx18(u32 X) noexcept;
+	// FX1E - set I = I + VX
+	void instruction_Fx1E(u32 X) noexcept;
+	// FX29 - set I to 5-byte hex sprite from VX
+	void instruction_Fx29(u32 X) noexcept;
+	// FX33 - store BCD of VX to RAM at I..I+2
+	void instruction_Fx33(u32 X) noexcept;
+	// FN55 - store V0..VN to RAM at I..I+N
+	void instruction_FN55(u32 N) noexcept;
+	// FN65 - load V0..VN from RAM at I..I+N
+	void instruction_FN65(u32 N) noexcept;
+	// FXF8 - output VX to port (sound freq)
+	void instruction_FxF8(u32 X) noexcept;
+	// FXFB - wait for port input, load to VX
+	void instruction_FxFB(u32 X) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+};
+
+/*==================================================================*/
+
+class CHIP8X_2PD final : public CHIP8X_MPD {
+	static constexpr std::string_view c_supported_extensions[] = { ".c2x" };
+
+public:
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"CHIP-8X 2PD", "chip8x_2pd", "CHIP-8X core with the 2-page (64x64) hires display.",
+		c_supported_extensions, validate_program
+	};
+
+	const SystemDescriptor& get_descriptor() const noexcept override final {
+		return descriptor;
+	}
+
+	CHIP8X_2PD() noexcept : CHIP8X_MPD(2) {}
+};
+
+/*==================================================================*/
+
+class CHIP8X_4PD final : public CHIP8X_MPD {
+	static constexpr std::string_view c_supported_extensions[] = { ".c4x" };
+
+public:
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"CHIP-8X 4PD", "chip8x_4pd", "CHIP-8X core with the 4-page (64x128) hires display.",
+		c_supported_extensions, validate_program
+	};
+
+	const SystemDescriptor& get_descriptor() const noexcept override final {
+		return descriptor;
+	}
+
+	CHIP8X_4PD() noexcept : CHIP8X_MPD(4) {}
+};
+
+#endif
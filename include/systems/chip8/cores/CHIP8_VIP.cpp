@@ -0,0 +1,576 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "CHIP8_VIP.hpp"
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_CHIP8_VIP)
+
+#include "CoreRegistry.inl"
+
+REGISTER_SYSTEM_CORE(CHIP8_VIP)
+
+/*==================================================================*/
+
+void CHIP8_VIP::initialize_system() noexcept {
+	copy_file_image_to(m_memory, c_game_load_pos);
+	copy_font_data_to(m_memory, 80);
+
+	m_base_system_framerate = c_sys_refresh_rate;
+
+	bind_system_memory(m_memory.data(), m_memory.size());
+
+	m_current_pc = c_sys_boot_pos;
+
+	m_display_device.metadata().edit([](auto& meta) noexcept {
+		meta.minimum_zoom = 8;
+		meta.inner_margin = 4;
+		meta.texture_tint = s_bit_colors[0];
+		meta.enabled = true;
+	});
+}
+
+void CHIP8_VIP::reset_system_data() noexcept {
+	m_memory.clear();
+
+	copy_file_image_to(m_memory, c_game_load_pos);
+	copy_font_data_to(m_memory, 80);
+
+	m_display_map.fill();
+
+	m_current_pc   = c_sys_boot_pos;
+	m_standard_cpf = c_sys_speed_lo;
+	m_cycle_budget = 0;
+}
+
+template <bool DEBUG>
+void CHIP8_VIP::instruction_loop() noexcept {
+	m_standard_cpf = c_sys_speed_lo;
+	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
+		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
+
+	// a frame resumed after a debugger stop keeps the budget it was stopped with
+	if (!DEBUG || !m_debugger.is_mid_frame()) {
+		// time left over while waiting on the display interrupt is lost, debt carries over
+		m_cycle_budget = std::min(m_cycle_budget, 0) + s32(target_cpf);
+	}
+
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
+		&& m_cycle_budget > 0; ++m_cycle_count)
+	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
+		const auto HI = m_memory[m_current_pc++];
+		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
+
+		#define _NNN ((HI << 8 | LO) & 0xFFF)
+		#define _X (HI & 0xF)
+		#define Y_ (LO >> 4)
+		#define _N (LO & 0xF)
+
+		switch (HI) {
+			case 0x00:
+				switch (LO) {
+					case 0xE0:
+						instruction_00E0();
+						break;
+					case 0xEE:
+						instruction_00EE();
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			[[unlikely]]
+			CASE_xNF0(0x00): // 0NNN - machine code subroutine, needs the 1802 itself
+				instruction_error(HI, LO);
+				break;
+			CASE_xNF(0x10):
+				instruction_1NNN(_NNN);
+				break;
+			CASE_xNF(0x20):
+				instruction_2NNN(_NNN);
+				break;
+			CASE_xNF(0x30):
+				instruction_3xNN(_X, LO);
+				break;
+			CASE_xNF(0x40):
+				instruction_4xNN(_X, LO);
+				break;
+			CASE_xNF(0x50):
+				if (_N) [[unlikely]] {
+					instruction_error(HI, LO);
+				} else {
+					instruction_5xy0(_X, Y_);
+				}
+				break;
+			CASE_xNF(0x60):
+				instruction_6xNN(_X, LO);
+				break;
+			CASE_xNF(0x70):
+				instruction_7xNN(_X, LO);
+				break;
+			CASE_xNF(0x80):
+				switch (LO) {
+					CASE_xFN(0x0):
+						instruction_8xy0(_X, Y_);
+						break;
+					CASE_xFN(0x1):
+						instruction_8xy1(_X, Y_);
+						break;
+					CASE_xFN(0x2):
+						instruction_8xy2(_X, Y_);
+						break;
+					CASE_xFN(0x3):
+						instruction_8xy3(_X, Y_);
+						break;
+					CASE_xFN(0x4):
+						instruction_8xy4(_X, Y_);
+						break;
+					CASE_xFN(0x5):
+						instruction_8xy5(_X, Y_);
+						break;
+					CASE_xFN(0x7):
+						instruction_8xy7(_X, Y_);
+						break;
+					CASE_xFN(0x6):
+						instruction_8xy6(_X, Y_);
+						break;
+					CASE_xFN(0xE):
+						instruction_8xyE(_X, Y_);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0x90):
+				if (_N) [[unlikely]] {
+					instruction_error(HI, LO);
+				} else {
+					instruction_9xy0(_X, Y_);
+				}
+				break;
+			CASE_xNF(0xA0):
+				instruction_ANNN(_NNN);
+				break;
+			CASE_xNF(0xB0):
+				instruction_BNNN(_NNN);
+				break;
+			CASE_xNF(0xC0):
+				instruction_CxNN(_X, LO);
+				break;
+			CASE_xNF(0xD0):
+				instruction_DxyN(_X, Y_, _N);
+				break;
+			CASE_xNF(0xE0):
+				switch (LO) {
+					case 0x9E:
+						instruction_Ex9E(_X);
+						break;
+					case 0xA1:
+						instruction_ExA1(_X);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0xF0):
+				switch (LO) {
+					case 0x07:
+						instruction_Fx07(_X);
+						break;
+					case 0x0A:
+						instruction_Fx0A(_X);
+						break;
+					case 0x15:
+						instruction_Fx15(_X);
+						break;
+					case 0x18:
+						instruction_Fx18(_X);
+						break;
+					case 0x1E:
+						instruction_Fx1E(_X);
+						break;
+					case 0x29:
+						instruction_Fx29(_X);
+						break;
+					case 0x33:
+						instruction_Fx33(_X);
+						break;
+					case 0x55:
+						instruction_FN55(_X);
+						break;
+					case 0x65:
+						instruction_FN65(_X);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
+	}
+}
+
+void CHIP8_VIP::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void CHIP8_VIP::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
+void CHIP8_VIP::push_audio_data() noexcept {
+	mix_audio_data(
+		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::ID_0]); },
+		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::ID_1]); },
+		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::ID_2]); },
+		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::BUZZER]); }
+	);
+
+	if (has_cached_system_state(EmuState::ANY_PAUSE)) { return; }
+	m_display_device.metadata().edit([&](auto& meta) noexcept {
+		meta.set_border_color_if(!!::accumulate(m_voices, 0), s_bit_colors[1]);
+	});
+}
+
+void CHIP8_VIP::push_video_data() noexcept {
+	m_display_device.present([&](auto& frame) noexcept {
+		frame.metadata = m_display_device.metadata().copy();
+		frame.copy_from(m_display_map, use_pixel_trails()
+			? [](u32 pixel) noexcept { return RGBA::premul(s_bit_colors[pixel != 0], c_bit_weight[pixel]); }
+			: [](u32 pixel) noexcept { return s_bit_colors[pixel >> 3]; }
+		);
+	});
+
+	std::for_each(EXEC_POLICY(unseq)
+		m_display_map.begin(), m_display_map.end(),
+		[](auto& pixel) noexcept
+			{ ::assign_cast(pixel, (pixel & 0x8) | (pixel >> 1)); }
+	);
+}
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	void CHIP8_VIP::instruction_00E0() noexcept {
+		charge_cycles<c_cost_00E0>();
+		m_display_map.fill();
+	}
+	void CHIP8_VIP::instruction_00EE() noexcept {
+		charge_cycles<c_cost_00EE>();
+		m_current_pc = m_stack.pop();
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	void CHIP8_VIP::instruction_1NNN(u32 NNN) noexcept {
+		charge_cycles<c_cost_1NNN>();
+		jump_program_to(NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	void CHIP8_VIP::instruction_2NNN(u32 NNN) noexcept {
+		charge_cycles<c_cost_2NNN>();
+		m_stack.push(m_current_pc);
+		jump_program_to(NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	void CHIP8_VIP::instruction_3xNN(u32 X, u32 NN) noexcept {
+		const bool skip = m_registers_V[X] == NN;
+		charge_cycles<c_cost_3xNN>(skip);
+		if (skip) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	void CHIP8_VIP::instruction_4xNN(u32 X, u32 NN) noexcept {
+		const bool skip = m_registers_V[X] != NN;
+		charge_cycles<c_cost_4xNN>(skip);
+		if (skip) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	void CHIP8_VIP::instruction_5xy0(u32 X, u32 Y) noexcept {
+		const bool skip = m_registers_V[X] == m_registers_V[Y];
+		charge_cycles<c_cost_5xy0>(skip);
+		if (skip) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	void CHIP8_VIP::instruction_6xNN(u32 X, u32 NN) noexcept {
+		charge_cycles<c_cost_6xNN>();
+		::assign_cast(m_registers_V[X], NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	void CHIP8_VIP::instruction_7xNN(u32 X, u32 NN) noexcept {
+		charge_cycles<c_cost_7xNN>();
+		::assign_cast_add(m_registers_V[X], NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	void CHIP8_VIP::instruction_8xy0(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+	}
+	void CHIP8_VIP::instruction_8xy1(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		::assign_cast_or(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], 0);
+	}
+	void CHIP8_VIP::instruction_8xy2(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		::assign_cast_and(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], 0);
+	}
+	void CHIP8_VIP::instruction_8xy3(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		::assign_cast_xor(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], 0);
+	}
+	void CHIP8_VIP::instruction_8xy4(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		const auto sum = m_registers_V[X] + m_registers_V[Y];
+		::assign_cast(m_registers_V[X], sum);
+		::assign_cast(m_registers_V[0xF], sum >> 8);
+	}
+	void CHIP8_VIP::instruction_8xy5(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		const bool nborrow = m_registers_V[X] >= m_registers_V[Y];
+		::assign_cast_sub(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], nborrow);
+	}
+	void CHIP8_VIP::instruction_8xy7(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		const bool nborrow = m_registers_V[Y] >= m_registers_V[X];
+		::assign_cast_rsub(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], nborrow);
+	}
+	void CHIP8_VIP::instruction_8xy6(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+		const bool lsb = (m_registers_V[X] & 0x01) != 0;
+		::assign_cast_shr(m_registers_V[X], 1);
+		::assign_cast(m_registers_V[0xF], lsb);
+	}
+	void CHIP8_VIP::instruction_8xyE(u32 X, u32 Y) noexcept {
+		charge_cycles<c_cost_8xyN>();
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+		const bool msb = (m_registers_V[X] & 0x80) != 0;
+		::assign_cast_shl(m_registers_V[X], 1);
+		::assign_cast(m_registers_V[0xF], msb);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	void CHIP8_VIP::instruction_9xy0(u32 X, u32 Y) noexcept {
+		const bool skip = m_registers_V[X] != m_registers_V[Y];
+		charge_cycles<c_cost_9xy0>(skip);
+		if (skip) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	void CHIP8_VIP::instruction_ANNN(u32 NNN) noexcept {
+		charge_cycles<c_cost_ANNN>();
+		::assign_cast(m_register_I, NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	void CHIP8_VIP::instruction_BNNN(u32 NNN) noexcept {
+		const auto next = NNN + m_registers_V[0];
+		charge_cycles<c_cost_BNNN>((next ^ NNN) & 0xF00);
+		jump_program_to(next);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	void CHIP8_VIP::instruction_CxNN(u32 X, u32 NN) noexcept {
+		charge_cycles<c_cost_CxNN>();
+		::assign_cast(m_registers_V[X], m_rng->next() & NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	void CHIP8_VIP::draw_byte(u32 X, u32 Y, u32 DATA) noexcept {
+		switch (DATA) {
+			[[unlikely]]
+			case 0b00000000:
+				return;
+
+			[[likely]]
+			case 0b10000000:
+				if (!((m_display_map(X, Y) ^= 0x8) & 0x8))
+					[[unlikely]] { m_registers_V[0xF] = 1; }
+				return;
+
+			[[unlikely]]
+			default:
+				for (auto B = 0; B < 8; ++B, ++X) {
+					if (DATA & 0x80 >> B) {
+						if (!((m_display_map(X, Y) ^= 0x8) & 0x8))
+							[[unlikely]] { m_registers_V[0xF] = 1; }
+					}
+					if (X == (c_sys_screen_W - 1)) { return; }
+				}
+				return;
+		}
+	}
+
+	void CHIP8_VIP::instruction_DxyN(u32 X, u32 Y, u32 N) noexcept {
+		auto pX = m_registers_V[X] & (c_sys_screen_W - 1);
+		auto pY = m_registers_V[Y] & (c_sys_screen_H - 1);
+
+		m_registers_V[0xF] = 0;
+
+		auto rows = 0u;
+		for (; rows < N; ++rows, ++pY) {
+			draw_byte(pX, pY, m_memory[m_register_I + rows]);
+			if (pY == (c_sys_screen_H - 1)) { ++rows; break; }
+		}
+
+		// the interpreter draws right after the display interrupt, whatever was left
+		// of this frame is spent waiting on it, and the drawing is paid from the next
+		m_cycle_budget = 0;
+		charge_cycles<c_cost_DxyN>(false, rows * ((pX & 7)
+			? c_cost_sprite_row.other : c_cost_sprite_row.base));
+		trigger_interrupt(Interrupt::FRAME);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	void CHIP8_VIP::instruction_Ex9E(u32 X) noexcept {
+		const bool skip = m_keypad.is_key_held_P1(m_registers_V[X]);
+		charge_cycles<c_cost_ExNN>(skip);
+		if (skip) { skip_instruction(); }
+	}
+	void CHIP8_VIP::instruction_ExA1(u32 X) noexcept {
+		const bool skip = !m_keypad.is_key_held_P1(m_registers_V[X]);
+		charge_cycles<c_cost_ExNN>(skip);
+		if (skip) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	void CHIP8_VIP::instruction_Fx07(u32 X) noexcept {
+		charge_cycles<c_cost_Fx07>();
+		::assign_cast(m_registers_V[X], m_delay_timer);
+	}
+	void CHIP8_VIP::instruction_Fx0A(u32 X) noexcept {
+		charge_cycles<c_cost_Fx0A>();
+		m_keypad.set_reg_ptr(&m_registers_V[X]);
+		trigger_interrupt(Interrupt::INPUT);
+	}
+	void CHIP8_VIP::instruction_Fx15(u32 X) noexcept {
+		charge_cycles<c_cost_Fx15>();
+		::assign_cast(m_delay_timer, m_registers_V[X]);
+	}
+	void CHIP8_VIP::instruction_Fx18(u32 X) noexcept {
+		charge_cycles<c_cost_Fx18>();
+		start_voice(m_registers_V[X] + (m_registers_V[X] == 1));
+	}
+	void CHIP8_VIP::instruction_Fx1E(u32 X) noexcept {
+		charge_cycles<c_cost_Fx1E>();
+		::assign_cast_add(m_register_I, m_registers_V[X]);
+	}
+	void CHIP8_VIP::instruction_Fx29(u32 X) noexcept {
+		charge_cycles<c_cost_Fx29>();
+		::assign_cast(m_register_I, (m_registers_V[X] & 0xF) * 5 + c_small_font_offset);
+	}
+	void CHIP8_VIP::instruction_Fx33(u32 X) noexcept {
+		const TriBCD bcd{ m_registers_V[X] };
+		charge_cycles<c_cost_Fx33>(false, c_cost_bcd_count
+			* (bcd.digit[2] + bcd.digit[1] + bcd.digit[0]));
+
+		m_memory[m_register_I + 0] = bcd.digit[2];
+		m_memory[m_register_I + 1] = bcd.digit[1];
+		m_memory[m_register_I + 2] = bcd.digit[0];
+		m_memory_writes.mark(m_register_I, 3);
+	}
+	void CHIP8_VIP::instruction_FN55(u32 N) noexcept {
+		charge_cycles<c_cost_FN55>(false, c_cost_reg_copy * (N + 1));
+		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		m_memory_writes.mark(m_register_I, N + 1);
+		::assign_cast_add(m_register_I, N + 1);
+	}
+	void CHIP8_VIP::instruction_FN65(u32 N) noexcept {
+		charge_cycles<c_cost_FN65>(false, c_cost_reg_copy * (N + 1));
+		for (auto i = 0u; i <= N; ++i) { m_registers_V[i] = m_memory[m_register_I + i]; }
+		::assign_cast_add(m_register_I, N + 1);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+#endif
@@ -0,0 +1,330 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "../IFamily_CHIP8.hpp"
+
+#define ENABLE_CHIP8_VIP
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_CHIP8_VIP)
+
+#include "SystemDescriptor.hpp"
+#include "Map2D.hpp"
+#include "ArrayOps.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief CHIP-8 as run by the original interpreter of the COSMAC VIP. Instead of a
+ *        fixed instruction count per frame, every instruction charges the machine
+ *        cycles the VIP interpreter spends on it against a per-frame cycle budget.
+ *        Dxyn waits for the display interrupt before drawing, and pays per sprite row.
+ *
+ * Cycle counts are in CDP1802 machine cycles (8 clocks at 1.7609 MHz). Overshooting
+ * the budget carries the debt into the next frame, so long instructions such as 00E0
+ * stall the following frames the same way they did on the real machine.
+ */
+class CHIP8_VIP final : public IFamily_CHIP8 {
+	static constexpr u64 c_sys_memory_size  = 4_KiB;
+	static constexpr u64 c_sys_usable_size  = 0xEA0; // stack, work area and display above
+	static constexpr u32 c_game_load_pos    = 0x200;
+	static constexpr u32 c_sys_boot_pos     = 0x200;
+	static constexpr f32 c_sys_refresh_rate = 60.0f;
+
+	static constexpr u32 c_sys_screen_W = 64;
+	static constexpr u32 c_sys_screen_H = 32;
+
+	// 1861 frame: 262 lines of 14 machine cycles each
+	static constexpr u32 c_sys_frame_cycles = 262 * 14;
+	// display DMA steals 8 cycles on each of the 128 visible lines
+	static constexpr u32 c_sys_dma_cycles   = 128 * 8;
+	// interrupt routine: timer updates and DMA pointer setup
+	static constexpr u32 c_sys_irq_cycles   = 46;
+
+	// cycles per frame left to the interpreter
+	static constexpr u32 c_sys_speed_lo = c_sys_frame_cycles - c_sys_dma_cycles - c_sys_irq_cycles;
+
+	static constexpr std::string_view c_supported_extensions[] = { ".ch8" };
+
+	static constexpr const char* validate_program(std::span<const char> file) noexcept {
+		return Family::validate_program(file, c_game_load_pos, c_sys_usable_size);
+	}
+
+public:
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"CHIP-8 (VIP)", "chip8_vip", "Cycle-accurate COSMAC VIP Chip-8 core.",
+		c_supported_extensions, validate_program
+	};
+
+	const SystemDescriptor& get_descriptor() const noexcept override final {
+		return descriptor;
+	}
+
+/*==================================================================*/
+
+private:
+	struct CycleCost final {
+		u16 base;  // cycles of the common path
+		u16 other; // cycles of the alternate path, e.g. a taken skip
+	};
+
+	// fetch and decode of the interpreter loop, paid by every instruction
+	static constexpr u32 c_fetch_cycles = 40;
+
+	static constexpr CycleCost c_cost_00E0{ 24 + 3078, 0 };
+	static constexpr CycleCost c_cost_00EE{ 10, 0 };
+	static constexpr CycleCost c_cost_1NNN{ 12, 0 };
+	static constexpr CycleCost c_cost_2NNN{ 26, 0 };
+	static constexpr CycleCost c_cost_3xNN{ 10, 14 };
+	static constexpr CycleCost c_cost_4xNN{ 10, 14 };
+	static constexpr CycleCost c_cost_5xy0{ 14, 18 };
+	static constexpr CycleCost c_cost_6xNN{  6, 0 };
+	static constexpr CycleCost c_cost_7xNN{ 10, 0 };
+	static constexpr CycleCost c_cost_8xyN{ 44, 0 };
+	static constexpr CycleCost c_cost_9xy0{ 14, 18 };
+	static constexpr CycleCost c_cost_ANNN{ 12, 0 };
+	static constexpr CycleCost c_cost_BNNN{ 22, 24 }; // other: target in another page
+	static constexpr CycleCost c_cost_CxNN{ 36, 0 };
+	static constexpr CycleCost c_cost_DxyN{ 26, 0 };
+	static constexpr CycleCost c_cost_ExNN{ 14, 18 };
+	static constexpr CycleCost c_cost_Fx07{ 10, 0 };
+	static constexpr CycleCost c_cost_Fx0A{ 18, 0 };
+	static constexpr CycleCost c_cost_Fx15{ 10, 0 };
+	static constexpr CycleCost c_cost_Fx18{ 10, 0 };
+	static constexpr CycleCost c_cost_Fx1E{ 16, 0 };
+	static constexpr CycleCost c_cost_Fx29{ 16, 0 };
+	static constexpr CycleCost c_cost_Fx33{ 80, 0 };
+	static constexpr CycleCost c_cost_FN55{ 14, 0 };
+	static constexpr CycleCost c_cost_FN65{ 14, 0 };
+
+	// per sprite row drawn, a row straddling two display bytes costs more
+	static constexpr CycleCost c_cost_sprite_row{ 34, 46 };
+	// per register moved by Fn55/Fn65, per decimal unit counted by Fx33
+	static constexpr u32 c_cost_reg_copy  = 14;
+	static constexpr u32 c_cost_bcd_count = 16;
+
+	s32 m_cycle_budget{};
+
+	template <CycleCost COST>
+	void charge_cycles(bool other = false, u32 extra = 0) noexcept {
+		m_cycle_budget -= s32(c_fetch_cycles + (other ? COST.other : COST.base) + extra);
+	}
+
+/*==================================================================*/
+
+private:
+	MirroredMemory<c_sys_memory_size>
+		m_memory{};
+
+	std::array<u8, c_sys_screen_W * c_sys_screen_H>
+		m_display_buffer{};
+
+	Map2D<u8> m_display_map;
+
+public:
+	CHIP8_VIP() noexcept
+		: IFamily_CHIP8(c_sys_screen_W, c_sys_screen_H)
+		, m_display_map(m_display_buffer, c_sys_screen_W, c_sys_screen_H)
+	{}
+
+private:
+	void initialize_system() noexcept override final;
+	void reset_system_data() noexcept override final;
+
+	template <bool DEBUG>
+	void instruction_loop() noexcept;
+
+	void instruction_loop_fast()  noexcept override final;
+	void instruction_loop_debug() noexcept override final;
+
+	void push_audio_data() noexcept override final;
+	void push_video_data() noexcept override final;
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	// 00E0 - erase whole display
+	void instruction_00E0() noexcept;
+	// 00EE - return from subroutine
+	void instruction_00EE() noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	// 1NNN - jump to NNN
+	void instruction_1NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	// 2NNN - call subroutine at NNN
+	void instruction_2NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	// 3XNN - skip next instruction if VX == NN
+	void instruction_3xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	// 4XNN - skip next instruction if VX != NN
+	void instruction_4xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	// 5XY0 - skip next instruction if VX == VY
+	void instruction_5xy0(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	// 6XNN - set VX = NN
+	void instruction_6xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	// 7XNN - set VX = VX + NN
+	void instruction_7xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	// 8XY0 - set VX = VY
+	void instruction_8xy0(u32 X, u32 Y) noexcept;
+	// 8XY1 - set VX = VX | VY
+	void instruction_8xy1(u32 X, u32 Y) noexcept;
+	// 8XY2 - set VX = VX & VY
+	void instruction_8xy2(u32 X, u32 Y) noexcept;
+	// 8XY3 - set VX = VX ^ VY
+	void instruction_8xy3(u32 X, u32 Y) noexcept;
+	// 8XY4 - set VX = VX + VY, VF = carry
+	void instruction_8xy4(u32 X, u32 Y) noexcept;
+	// 8XY5 - set VX = VX - VY, VF = !borrow
+	void instruction_8xy5(u32 X, u32 Y) noexcept;
+	// 8XY7 - set VX = VY - VX, VF = !borrow
+	void instruction_8xy7(u32 X, u32 Y) noexcept;
+	// 8XY6 - set VX = VY >> 1, VF = carry
+	void instruction_8xy6(u32 X, u32 Y) noexcept;
+	// 8XYE - set VX = VY << 1, VF = carry
+	void instruction_8xyE(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	// 9XY0 - skip next instruction if VX != VY
+	void instruction_9xy0(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	// ANNN - set I = NNN
+	void instruction_ANNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	// BNNN - jump to NNN + V0
+	void instruction_BNNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	// CXNN - set VX = rnd(256) & NN
+	void instruction_CxNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	void draw_byte(u32 X, u32 Y, u32 DATA) noexcept;
+
+	// DXYN - draw N sprite rows at VX and VY
+	void instruction_DxyN(u32 X, u32 Y, u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	// EX9E - skip next instruction if key VX down (p1)
+	void instruction_Ex9E(u32 X) noexcept;
+	// EXA1 - skip next instruction if key VX up (p1)
+	void instruction_ExA1(u32 X) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	// FX07 - set VX = delay timer
+	void instruction_Fx07(u32 X) noexcept;
+	// FX0A - set VX = key, wait for keypress
+	void instruction_Fx0A(u32 X) noexcept;
+	// FX15 - set delay timer = VX
+	void instruction_Fx15(u32 X) noexcept;
+	// FX18 - set sound timer = VX
+	void instruction_Fx18(u32 X) noexcept;
+	// FX1E - set I = I + VX
+	void instruction_Fx1E(u32 X) noexcept;
+	// FX29 - set I to 5-byte hex sprite from VX
+	void instruction_Fx29(u32 X) noexcept;
+	// FX33 - store BCD of VX to RAM at I..I+2
+	void instruction_Fx33(u32 X) noexcept;
+	// FN55 - store V0..VN to RAM at I..I+N
+	void instruction_FN55(u32 N) noexcept;
+	// FN65 - load V0..VN from RAM at I..I+N
+	void instruction_FN65(u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+};
+
+#endif
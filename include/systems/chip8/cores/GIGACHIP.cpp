@@ -0,0 +1,944 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "GIGACHIP.hpp"
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_GIGACHIP)
+
+#include "CoreRegistry.inl"
+
+REGISTER_SYSTEM_CORE(GIGACHIP)
+
+/*==================================================================*/
+
+void GIGACHIP::load_memory_image() noexcept {
+	// without memory there is nothing to run, park the core on the error path
+	if (!m_memory.is_valid()) { m_interrupt = Interrupt::ERROR; return; }
+
+	copy_file_image_to(m_memory, c_game_load_pos);
+	copy_font_data_to(m_memory, 180);
+
+	m_memory.mark_dirty(c_game_load_pos, m_file_image.size());
+	m_memory.mark_dirty(c_small_font_offset, 180);
+}
+
+void GIGACHIP::initialize_system() noexcept {
+	if (!m_memory.is_valid()) {
+		blog.error("Unable to allocate {} bytes of system memory!", m_memory.size());
+	}
+
+	load_memory_image();
+
+	m_base_system_framerate = c_sys_refresh_rate;
+
+	bind_system_memory(m_memory.data(), m_memory.size());
+
+	m_current_pc = c_sys_boot_pos;
+
+	set_display_properties();
+	set_blend_callable(BlendMode::NORMAL);
+	refresh_trait_palette();
+
+	m_display_device.metadata().edit([](auto& meta) noexcept {
+		meta.minimum_zoom = 2;
+		meta.inner_margin = 4;
+		meta.enabled = true;
+	});
+}
+
+void GIGACHIP::reset_system_data() noexcept {
+	m_memory.clear();
+
+	load_memory_image();
+
+	set_display_properties();
+
+	m_old_render_map.fill();
+	m_background_map.fill();
+	m_collision_map.fill();
+
+	m_color_palette.fill(0);
+
+	m_track.reset();
+	m_texture.reset();
+
+	m_current_pc = c_sys_boot_pos;
+
+	set_blend_callable(BlendMode::NORMAL);
+	refresh_trait_palette();
+}
+
+template <bool DEBUG>
+void GIGACHIP::instruction_loop() noexcept {
+	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
+		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
+		&& m_cycle_count < target_cpf; ++m_cycle_count)
+	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
+		const auto HI = m_memory[m_current_pc++];
+		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
+
+		#define _NNN ((HI << 8 | LO) & 0xFFF)
+		#define _X (HI & 0xF)
+		#define Y_ (LO >> 4)
+		#define _N (LO & 0xF)
+
+		switch (HI) {
+			CASE_xNF(0x00):
+				switch (_NNN) {
+					case 0x0011:
+						instruction_0011();
+						break;
+					case 0x0700:
+						instruction_0700();
+						break;
+					CASE_xNF(0x0600):
+						instruction_060N(_N);
+						break;
+					CASE_xNF(0x0800):
+						instruction_080N(_N);
+						break;
+					CASE_xNF(0x00B0):
+						instruction_00BN(_N);
+						break;
+					CASE_xNF(0x00C0):
+						instruction_00CN(_N);
+						break;
+					case 0x00E0:
+						instruction_00E0();
+						break;
+					case 0x00EE:
+						instruction_00EE();
+						break;
+					case 0x00FB:
+						instruction_00FB();
+						break;
+					case 0x00FC:
+						instruction_00FC();
+						break;
+					case 0x00FD:
+						instruction_00FD();
+						break;
+					default:
+						switch (_X) {
+							case 0x01:
+								instruction_01NN(LO);
+								break;
+							case 0x02:
+								instruction_02NN(LO);
+								break;
+							case 0x03:
+								instruction_03NN(LO);
+								break;
+							case 0x04:
+								instruction_04NN(LO);
+								break;
+							case 0x05:
+								instruction_05NN(LO);
+								break;
+							case 0x09:
+								instruction_09NN(LO);
+								break;
+							[[unlikely]]
+							default: instruction_error(HI, LO);
+						}
+				}
+				break;
+			CASE_xNF(0x10):
+				instruction_1NNN(_NNN);
+				break;
+			CASE_xNF(0x20):
+				instruction_2NNN(_NNN);
+				break;
+			CASE_xNF(0x30):
+				instruction_3xNN(_X, LO);
+				break;
+			CASE_xNF(0x40):
+				instruction_4xNN(_X, LO);
+				break;
+			CASE_xNF(0x50):
+				if (_N) [[unlikely]] {
+					instruction_error(HI, LO);
+				} else {
+					instruction_5xy0(_X, Y_);
+				}
+				break;
+			CASE_xNF(0x60):
+				instruction_6xNN(_X, LO);
+				break;
+			CASE_xNF(0x70):
+				instruction_7xNN(_X, LO);
+				break;
+			CASE_xNF(0x80):
+				switch (LO) {
+					CASE_xFN(0x0):
+						instruction_8xy0(_X, Y_);
+						break;
+					CASE_xFN(0x1):
+						instruction_8xy1(_X, Y_);
+						break;
+					CASE_xFN(0x2):
+						instruction_8xy2(_X, Y_);
+						break;
+					CASE_xFN(0x3):
+						instruction_8xy3(_X, Y_);
+						break;
+					CASE_xFN(0x4):
+						instruction_8xy4(_X, Y_);
+						break;
+					CASE_xFN(0x5):
+						instruction_8xy5(_X, Y_);
+						break;
+					CASE_xFN(0x7):
+						instruction_8xy7(_X, Y_);
+						break;
+					CASE_xFN(0x6):
+						instruction_8xy6(_X, Y_);
+						break;
+					CASE_xFN(0xE):
+						instruction_8xyE(_X, Y_);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0x90):
+				if (_N) [[unlikely]] {
+					instruction_error(HI, LO);
+				} else {
+					instruction_9xy0(_X, Y_);
+				}
+				break;
+			CASE_xNF(0xA0):
+				instruction_ANNN(_NNN);
+				break;
+			CASE_xNF(0xB0):
+				instruction_BNNN(_NNN);
+				break;
+			CASE_xNF(0xC0):
+				instruction_CxNN(_X, LO);
+				break;
+			CASE_xNF(0xD0):
+				instruction_DxyN(_X, Y_, _N);
+				break;
+			CASE_xNF(0xE0):
+				switch (LO) {
+					case 0x9E:
+						instruction_Ex9E(_X);
+						break;
+					case 0xA1:
+						instruction_ExA1(_X);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0xF0):
+				switch (LO) {
+					case 0x07:
+						instruction_Fx07(_X);
+						break;
+					case 0x0A:
+						instruction_Fx0A(_X);
+						break;
+					case 0x15:
+						instruction_Fx15(_X);
+						break;
+					case 0x18:
+						instruction_Fx18(_X);
+						break;
+					case 0x1E:
+						instruction_Fx1E(_X);
+						break;
+					case 0x29:
+						instruction_Fx29(_X);
+						break;
+					case 0x30:
+						instruction_Fx30(_X);
+						break;
+					case 0x33:
+						instruction_Fx33(_X);
+						break;
+					case 0x55:
+						instruction_FN55(_X);
+						break;
+					case 0x65:
+						instruction_FN65(_X);
+						break;
+					case 0x75:
+						instruction_FN75(_X);
+						break;
+					case 0x85:
+						instruction_FN85(_X);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
+	}
+}
+
+void GIGACHIP::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void GIGACHIP::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
+void GIGACHIP::push_audio_data() noexcept {
+	mix_audio_data(
+		[&](auto buffer) noexcept { make_stream_wave(buffer, m_voices[VOICE::UNIQUE], m_track); },
+		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::BUZZER]); }
+	);
+
+	if (has_cached_system_state(EmuState::ANY_PAUSE)) { return; }
+	m_display_device.metadata().edit([&](auto& meta) noexcept {
+		meta.set_border_color_if(!!m_voices[VOICE::BUZZER].timer, s_bit_colors[1]);
+	});
+}
+
+void GIGACHIP::push_video_data() noexcept {
+	if (m_interrupt == Interrupt::INPUT) {
+		// During the INPUT interrupt, we want to keep the swapchain
+		// alive with updates, even if the background map is stale.
+		flush_all_video_buffers(false, false);
+	}
+}
+
+void GIGACHIP::set_display_properties() noexcept {
+	use_manual_vsync(true);
+
+	m_display_device.metadata().edit(
+	[&](auto& meta) noexcept {
+		meta.set_viewport(c_sys_screen_W, c_sys_screen_H);
+		meta.texture_tint = RGBA::Black;
+	});
+
+	m_standard_cpf = c_sys_speed_lo;
+}
+
+/*==================================================================*/
+
+void GIGACHIP::skip_instruction() noexcept {
+	m_current_pc += m_memory[m_current_pc] == 0x01 ? 4 : 2;
+}
+
+void GIGACHIP::set_blend_callable(u32 mode) noexcept {
+	switch (mode) {
+		default:
+		case BlendMode::NORMAL:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::None>;
+			break;
+
+		case BlendMode::LIGHTEN_ONLY:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Lighten>;
+			break;
+		case BlendMode::SCREEN:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Screen>;
+			break;
+		case BlendMode::COLOR_DODGE:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::ColorDodge>;
+			break;
+		case BlendMode::LINEAR_DODGE:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::LinearDodge>;
+			break;
+
+		case BlendMode::DARKEN_ONLY:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Darken>;
+			break;
+		case BlendMode::MULTIPLY:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Multiply>;
+			break;
+		case BlendMode::COLOR_BURN:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::ColorBurn>;
+			break;
+		case BlendMode::LINEAR_BURN:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::LinearBurn>;
+			break;
+
+		case BlendMode::AVERAGE:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Average>;
+			break;
+		case BlendMode::DIFFERENCE:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Difference>;
+			break;
+		case BlendMode::NEGATION:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Negation>;
+			break;
+
+		case BlendMode::OVERLAY:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Overlay>;
+			break;
+		case BlendMode::REFLECT:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Reflect>;
+			break;
+		case BlendMode::GLOW:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<RGBA::Blend::Glow>;
+			break;
+
+		case BlendMode::OVERWRITE:
+			m_draw_texture_row = &GIGACHIP::draw_texture_row<Overwrite>;
+			break;
+	}
+}
+
+void GIGACHIP::refresh_trait_palette() noexcept {
+	// The traits apply to every texel alike, so they're baked into a copy of
+	// the palette here instead of being re-evaluated for each pixel drawn.
+	const auto mask = u8(m_texture.invert ? 0xFF : 0x00);
+
+	const auto transform = [&](auto&& convert) noexcept {
+		std::transform(EXEC_POLICY(unseq)
+			m_color_palette.begin(), m_color_palette.end(),
+			m_trait_palette.begin(), [=](RGBA color) noexcept {
+				return convert(u8(color.R ^ mask), u8(color.G ^ mask), u8(color.B ^ mask), color.A);
+			}
+		);
+	};
+
+	switch (m_texture.rgbmod) {
+		default:
+		case ColorTrait::RGB:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept { return RGBA(R, G, B, A); });
+			break;
+		case ColorTrait::BRG:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept { return RGBA(B, R, G, A); });
+			break;
+		case ColorTrait::GBR:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept { return RGBA(G, B, R, A); });
+			break;
+		case ColorTrait::RBG:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept { return RGBA(R, B, G, A); });
+			break;
+		case ColorTrait::GRB:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept { return RGBA(G, R, B, A); });
+			break;
+		case ColorTrait::BGR:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept { return RGBA(B, G, R, A); });
+			break;
+
+		case ColorTrait::GRAY:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept {
+				const auto luma = u8((77u * R + 150u * G + 29u * B + 128u) >> 8);
+				return RGBA(luma, luma, luma, A);
+			});
+			break;
+		case ColorTrait::SEPIA:
+			transform([](u8 R, u8 G, u8 B, u8 A) noexcept {
+				return RGBA(
+					u8(std::min((101u * R + 197u * G + 51u * B + 128u) >> 8, 255u)),
+					u8(std::min(( 89u * R + 176u * G + 43u * B + 128u) >> 8, 255u)),
+					u8(std::min(( 70u * R + 137u * G + 34u * B + 128u) >> 8, 255u)),
+					A
+				);
+			});
+			break;
+	}
+}
+
+void GIGACHIP::scrap_all_video_buffers() noexcept {
+	m_old_render_map.fill();
+	m_background_map.fill();
+	m_collision_map.fill();
+}
+
+void GIGACHIP::flush_all_video_buffers(bool by_blending, bool and_advance) noexcept {
+	m_display_device.present([&](auto& frame) noexcept {
+		frame.metadata = m_display_device.metadata().copy();
+		if (by_blending) {
+			frame.copy_from(m_old_render_map, m_background_map, RGBA::alpha_blend);
+		} else {
+			frame.copy_from(m_background_map);
+		}
+	});
+
+	if (and_advance) {
+		std::copy(EXEC_POLICY(unseq)
+			m_background_map.begin(), m_background_map.end(),
+			m_old_render_map.begin()
+		);
+		m_background_map.fill();
+		m_collision_map.fill();
+	}
+}
+
+void GIGACHIP::start_audio_track(bool repeat) noexcept {
+	if (m_audio_device) {
+		// the header is read through the mirror, the track itself is then
+		// streamed by pointer, so it has to fit before the end of memory
+		const auto track_pos = m_register_I & (m_memory.size() - 1);
+		const auto header = [&](u32 offset) noexcept -> u32
+			{ return m_memory[track_pos + offset]; };
+
+		m_track.loop = repeat;
+		m_track.size = header(2) << 16
+					 | header(3) <<  8
+					 | header(4);
+
+		const bool oob = track_pos + 6 + m_track.size > m_memory.size();
+		if (!m_track.size || oob) { m_track.reset(); }
+		else {
+			m_track.data = &m_memory[track_pos + 6];
+			m_voices[VOICE::UNIQUE].set_phase(0.0).set_step(
+				(header(0) << 8 | header(1)) \
+				/ f64(m_track.size) / m_audio_device.get_freq());
+		}
+	}
+}
+
+void GIGACHIP::make_stream_wave(SampleBuffer buffer, Voice& voice, TrackData& track) noexcept {
+	if (const auto sample_count = u32(buffer.size() * track.enabled())) {
+		for (auto i = 0u; i < sample_count; ++i) {
+			const auto head = voice.peek_raw_phase(i);
+			if (!track.loop && head >= 1.0) {
+				track.reset(); return;
+			} else {
+				::assign_cast_add(buffer[i],
+					(1.0 / 128) * track.pos(head));
+			}
+		}
+		voice.step_phase(sample_count);
+	}
+}
+
+void GIGACHIP::scroll_buffers_up(u32 N) noexcept {
+	m_old_render_map.rotate(0, -s32(N));
+	flush_all_video_buffers(true, false);
+}
+void GIGACHIP::scroll_buffers_dn(u32 N) noexcept {
+	m_old_render_map.rotate(0, +s32(N));
+	flush_all_video_buffers(true, false);
+}
+void GIGACHIP::scroll_buffers_lt() noexcept {
+	m_old_render_map.rotate(-4, 0);
+	flush_all_video_buffers(true, false);
+}
+void GIGACHIP::scroll_buffers_rt() noexcept {
+	m_old_render_map.rotate(+4, 0);
+	flush_all_video_buffers(true, false);
+}
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	void GIGACHIP::instruction_00BN(u32 N) noexcept {
+		scroll_buffers_up(N);
+	}
+	void GIGACHIP::instruction_00CN(u32 N) noexcept {
+		scroll_buffers_dn(N);
+	}
+	void GIGACHIP::instruction_00E0() noexcept {
+		flush_all_video_buffers(false, true);
+		trigger_interrupt(Interrupt::FRAME);
+	}
+	void GIGACHIP::instruction_00EE() noexcept {
+		m_current_pc = m_stack.pop();
+	}
+	void GIGACHIP::instruction_00FB() noexcept {
+		scroll_buffers_rt();
+	}
+	void GIGACHIP::instruction_00FC() noexcept {
+		scroll_buffers_lt();
+	}
+	void GIGACHIP::instruction_00FD() noexcept {
+		trigger_interrupt(Interrupt::SOUND);
+	}
+
+	void GIGACHIP::instruction_0011() noexcept {
+		m_texture.reset();
+		m_track.reset();
+
+		set_blend_callable(BlendMode::NORMAL);
+		refresh_trait_palette();
+		scrap_all_video_buffers();
+
+		trigger_interrupt(Interrupt::FRAME);
+	}
+	void GIGACHIP::instruction_01NN(u32 NN) noexcept {
+		::assign_cast(m_register_I, (NN << 16) | NNNN());
+		::assign_cast_add(m_current_pc, 2);
+	}
+	void GIGACHIP::instruction_02NN(u32 NN) noexcept {
+		for (auto pos = 0u, src = m_register_I; pos < NN; src += 4) {
+			m_color_palette[++pos] = { m_memory[src + 1],
+				m_memory[src + 2], m_memory[src + 3], m_memory[src + 0] };
+		}
+		refresh_trait_palette();
+	}
+	void GIGACHIP::instruction_03NN(u32 NN) noexcept {
+		m_texture.w = NN ? NN : 256u;
+	}
+	void GIGACHIP::instruction_04NN(u32 NN) noexcept {
+		m_texture.h = NN ? NN : 256u;
+	}
+	void GIGACHIP::instruction_05NN(u32 NN) noexcept {
+		m_display_device.metadata().edit([&](auto& meta) noexcept {
+			meta.texture_tint.set_A(NN & 0xFF);
+		});
+	}
+	void GIGACHIP::instruction_060N(u32 N) noexcept {
+		start_audio_track(N == 0u);
+	}
+	void GIGACHIP::instruction_0700() noexcept {
+		m_track.reset();
+	}
+	void GIGACHIP::instruction_080N(u32 N) noexcept {
+		m_texture.set_traits(m_registers_V[0xF]);
+		set_blend_callable(N);
+		refresh_trait_palette();
+	}
+	void GIGACHIP::instruction_09NN(u32 NN) noexcept {
+		m_texture.collide = NN;
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	void GIGACHIP::instruction_1NNN(u32 NNN) noexcept {
+		jump_program_to(NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	void GIGACHIP::instruction_2NNN(u32 NNN) noexcept {
+		m_stack.push(m_current_pc);
+		jump_program_to(NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	void GIGACHIP::instruction_3xNN(u32 X, u32 NN) noexcept {
+		if (m_registers_V[X] == NN) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	void GIGACHIP::instruction_4xNN(u32 X, u32 NN) noexcept {
+		if (m_registers_V[X] != NN) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	void GIGACHIP::instruction_5xy0(u32 X, u32 Y) noexcept {
+		if (m_registers_V[X] == m_registers_V[Y]) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	void GIGACHIP::instruction_6xNN(u32 X, u32 NN) noexcept {
+		::assign_cast(m_registers_V[X], NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	void GIGACHIP::instruction_7xNN(u32 X, u32 NN) noexcept {
+		::assign_cast_add(m_registers_V[X], NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	void GIGACHIP::instruction_8xy0(u32 X, u32 Y) noexcept {
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+	}
+	void GIGACHIP::instruction_8xy1(u32 X, u32 Y) noexcept {
+		::assign_cast_or(m_registers_V[X], m_registers_V[Y]);
+	}
+	void GIGACHIP::instruction_8xy2(u32 X, u32 Y) noexcept {
+		::assign_cast_and(m_registers_V[X], m_registers_V[Y]);
+	}
+	void GIGACHIP::instruction_8xy3(u32 X, u32 Y) noexcept {
+		::assign_cast_xor(m_registers_V[X], m_registers_V[Y]);
+	}
+	void GIGACHIP::instruction_8xy4(u32 X, u32 Y) noexcept {
+		const auto sum = m_registers_V[X] + m_registers_V[Y];
+		::assign_cast(m_registers_V[X], sum);
+		::assign_cast(m_registers_V[0xF], sum >> 8);
+	}
+	void GIGACHIP::instruction_8xy5(u32 X, u32 Y) noexcept {
+		const bool nborrow = m_registers_V[X] >= m_registers_V[Y];
+		::assign_cast_sub(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], nborrow);
+	}
+	void GIGACHIP::instruction_8xy7(u32 X, u32 Y) noexcept {
+		const bool nborrow = m_registers_V[Y] >= m_registers_V[X];
+		::assign_cast_rsub(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], nborrow);
+	}
+	void GIGACHIP::instruction_8xy6(u32 X, u32 Y) noexcept {
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+		const bool lsb = (m_registers_V[X] & 0x01) != 0;
+		::assign_cast_shr(m_registers_V[X], 1);
+		::assign_cast(m_registers_V[0xF], lsb);
+	}
+	void GIGACHIP::instruction_8xyE(u32 X, u32 Y) noexcept {
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+		const bool msb = (m_registers_V[X] & 0x80) != 0;
+		::assign_cast_shl(m_registers_V[X], 1);
+		::assign_cast(m_registers_V[0xF], msb);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	void GIGACHIP::instruction_9xy0(u32 X, u32 Y) noexcept {
+		if (m_registers_V[X] != m_registers_V[Y]) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	void GIGACHIP::instruction_ANNN(u32 NNN) noexcept {
+		::assign_cast(m_register_I, NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	void GIGACHIP::instruction_BNNN(u32 NNN) noexcept {
+		jump_program_to(NNN + m_registers_V[0]);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	void GIGACHIP::instruction_CxNN(u32 X, u32 NN) noexcept {
+		::assign_cast(m_registers_V[X], m_rng->next() & NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	template <IsBlendMode BlendMode>
+	constexpr RGBA GIGACHIP::blend_pixel(RGBA src, RGBA dst, u8 weight) noexcept {
+		const auto alpha = ez::fixed_mul8(src.A, weight);
+		if constexpr (std::same_as<BlendMode, Overwrite>) {
+			return alpha ? RGBA(src.R, src.G, src.B, alpha) : dst;
+		} else {
+			// same result as composite_blend, the lerp is exact at both ends of
+			// the weight so its early-outs are only branches the loop can't take
+			return RGBA::lerp(dst, RGBA::channel_blend<BlendMode>(src, dst), alpha);
+		}
+	}
+
+	template <IsBlendMode BlendMode>
+	bool GIGACHIP::draw_texture_row(
+		const u8* src_row, u8* collision_row,
+		RGBA* bg_buffer_row, u32 count, u8 weight
+	) noexcept {
+		// locals keep the u8 stores below from forcing member reloads,
+		// leaving both passes free of branches the compiler can't select away
+		const auto  collide = m_texture.collide;
+		const auto* palette = m_trait_palette.data();
+
+		bool collided = false;
+
+		for (auto col = 0u; col < count; ++col) {
+			const auto src_color_idx = src_row[col];
+			collided |= src_color_idx && collision_row[col] == collide;
+			collision_row[col] = src_color_idx ? src_color_idx : collision_row[col];
+		}
+
+		if (m_texture.nodraw) { return collided; }
+
+		// the palette lookup is a gather, kept apart so the blend below vectorizes,
+		// with index 0 turned transparent as blending that leaves the pixel as is
+		auto* texel_row = m_texel_row.data();
+
+		for (auto col = 0u; col < count; ++col) {
+			const auto src_color = palette[src_row[col]];
+			texel_row[col] = src_row[col] ? src_color : RGBA(RGBA::Transparent);
+		}
+
+		for (auto col = 0u; col < count; ++col) {
+			bg_buffer_row[col] = blend_pixel<BlendMode>(
+				texel_row[col], bg_buffer_row[col], weight);
+		}
+		return collided;
+	}
+
+	void GIGACHIP::instruction_DxyN(u32 X, u32 Y, u32 N) noexcept {
+		m_registers_V[0xF] = 0;
+
+		const auto wrap_sprites = has_quirk(WRAP_SPRITES);
+
+		const auto x_begin = u32(m_registers_V[X]);
+		/***/ auto y_begin = u32(m_registers_V[Y]);
+
+		if (y_begin >= c_sys_screen_H) {
+			if (!wrap_sprites) { return; }
+			y_begin %= c_sys_screen_H;
+		}
+
+		// a rotated non-square texture swaps its dimensions and flips
+		const auto uneven = m_texture.rotate && m_texture.w != m_texture.h;
+		const auto tex_w  = uneven ? m_texture.h : m_texture.w;
+		const auto tex_h  = uneven ? m_texture.w : m_texture.h;
+		const auto flip_x = uneven ? m_texture.flip_y : m_texture.flip_x;
+		const auto flip_y = uneven ? m_texture.flip_x : m_texture.flip_y;
+
+		// texel address of (row, col) is I + row_base(row) + col * col_step,
+		// relying on the mirrored memory to fold any wrapped offset back in
+		const auto col_step = m_texture.rotate
+			? (flip_y ? m_texture.w : 0u - m_texture.w)
+			: (flip_x ? 0u - 1u : 1u);
+
+		const auto row_base = [&](u32 row) noexcept {
+			return m_texture.rotate
+				? (flip_x ? m_texture.w - 1 - row : row) + (flip_y ? 0u : (m_texture.h - 1) * m_texture.w)
+				: (flip_y ? m_texture.h - 1 - row : row) * m_texture.w + (flip_x ? m_texture.w - 1 : 0u);
+		};
+
+		const auto weight = u8((N ^ 0xF) * 0x11);
+		const auto head_w = std::min(tex_w, c_sys_screen_W - x_begin);
+
+		bool collided = false;
+
+		for (auto row = 0u, true_y = y_begin; row < tex_h; ++row) {
+			const auto src_base = m_register_I + row_base(row);
+			for (auto col = 0u; col < tex_w; ++col) {
+				m_texture_row[col] = m_memory[src_base + col * col_step];
+			}
+
+			auto* collision_row = &m_collision_map(0, true_y);
+			auto* bg_buffer_row = &m_background_map(0, true_y);
+
+			collided |= (this->*m_draw_texture_row)(m_texture_row.data(),
+				collision_row + x_begin, bg_buffer_row + x_begin, head_w, weight);
+
+			if (wrap_sprites && head_w < tex_w) {
+				collided |= (this->*m_draw_texture_row)(m_texture_row.data() + head_w,
+					collision_row, bg_buffer_row, tex_w - head_w, weight);
+			}
+
+			if (++true_y == c_sys_screen_H) {
+				if (!wrap_sprites) { break; }
+				true_y = 0;
+			}
+		}
+
+		::assign_cast(m_registers_V[0xF], collided);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	void GIGACHIP::instruction_Ex9E(u32 X) noexcept {
+		if (m_keypad.is_key_held_P1(m_registers_V[X])) { skip_instruction(); }
+	}
+	void GIGACHIP::instruction_ExA1(u32 X) noexcept {
+		if (!m_keypad.is_key_held_P1(m_registers_V[X])) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	void GIGACHIP::instruction_Fx07(u32 X) noexcept {
+		::assign_cast(m_registers_V[X], m_delay_timer);
+	}
+	void GIGACHIP::instruction_Fx0A(u32 X) noexcept {
+		m_keypad.set_reg_ptr(&m_registers_V[X]);
+		trigger_interrupt(Interrupt::INPUT);
+	}
+	void GIGACHIP::instruction_Fx15(u32 X) noexcept {
+		::assign_cast(m_delay_timer, m_registers_V[X]);
+	}
+	void GIGACHIP::instruction_Fx18(u32 X) noexcept {
+		start_voice_at(VOICE::BUZZER, m_registers_V[X] + (m_registers_V[X] == 1));
+	}
+	void GIGACHIP::instruction_Fx1E(u32 X) noexcept {
+		::assign_cast_add(m_register_I, m_registers_V[X]);
+	}
+	void GIGACHIP::instruction_Fx29(u32 X) noexcept {
+		::assign_cast(m_register_I, (m_registers_V[X] & 0xF) * 5 + c_small_font_offset);
+	}
+	void GIGACHIP::instruction_Fx30(u32 X) noexcept {
+		::assign_cast(m_register_I, (m_registers_V[X] & 0xF) * 10 + c_large_font_offset);
+	}
+	void GIGACHIP::instruction_Fx33(u32 X) noexcept {
+		const TriBCD bcd{ m_registers_V[X] };
+
+		m_memory[m_register_I + 0] = bcd.digit[2];
+		m_memory[m_register_I + 1] = bcd.digit[1];
+		m_memory[m_register_I + 2] = bcd.digit[0];
+		mark_memory_written(m_register_I, 3);
+	}
+	void GIGACHIP::instruction_FN55(u32 N) noexcept {
+		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		mark_memory_written(m_register_I, N + 1);
+		::assign_cast_add(m_register_I, N + 1);
+	}
+	void GIGACHIP::instruction_FN65(u32 N) noexcept {
+		for (auto i = 0u; i <= N; ++i) { m_registers_V[i] = m_memory[m_register_I + i]; }
+		::assign_cast_add(m_register_I, N + 1);
+	}
+	void GIGACHIP::instruction_FN75(u32 N) noexcept {
+		set_permaregs(std::min(N, 7u) + 1);
+	}
+	void GIGACHIP::instruction_FN85(u32 N) noexcept {
+		get_permaregs(std::min(N, 7u) + 1);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+#endif
@@ -0,0 +1,442 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "../IFamily_CHIP8.hpp"
+
+#define ENABLE_GIGACHIP
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_GIGACHIP)
+
+#include "SystemDescriptor.hpp"
+#include "Map2D.hpp"
+#include "ArrayOps.hpp"
+#include "Aligned.hpp"
+
+/*==================================================================*/
+
+class GIGACHIP final : public IFamily_CHIP8 {
+	static constexpr u64 c_sys_memory_size  = 16_MiB;
+	static constexpr u32 c_game_load_pos    = 0x200;
+	static constexpr u32 c_sys_boot_pos     = 0x200;
+	static constexpr f32 c_sys_refresh_rate = 60.0f;
+
+	static constexpr u32 c_sys_screen_W = 256;
+	static constexpr u32 c_sys_screen_H = 192;
+
+	static constexpr u32 c_sys_speed_lo = 10'000;
+
+	static constexpr std::string_view c_supported_extensions[] = { ".gc8" };
+
+	static constexpr const char* validate_program(std::span<const char> file) noexcept {
+		return Family::validate_program(file, c_game_load_pos, c_sys_memory_size);
+	}
+
+	u8 get_avail_quirks() const noexcept override final {
+		return WRAP_SPRITES;
+	}
+
+public:
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"GIGACHIP", "gigachip", "GIGACHIP core, MEGACHIP with sprite traits and blend modes.",
+		c_supported_extensions, validate_program
+	};
+
+	const SystemDescriptor& get_descriptor() const noexcept override final {
+		return descriptor;
+	}
+
+/*==================================================================*/
+
+	// mostly untouched by programs, so only the pages written are ever backed
+	SparseMirroredMemory<c_sys_memory_size>
+		m_memory{};
+
+	// reports a write to both the dirty page map and the memory write tracker
+	void mark_memory_written(u32 addr, u32 size) noexcept {
+		m_memory.mark_dirty(addr, size);
+		m_memory_writes.mark(addr, size);
+	}
+
+	void load_memory_image() noexcept;
+
+	void read_written_memory(std::vector<MemoryRange>& output) const noexcept override {
+		try {
+			m_memory.for_each_dirty_range([&](std::size_t offset, std::size_t size)
+				{ output.push_back({ offset, size }); });
+		}
+		catch (...) {}
+	}
+
+	// backing stores of the maps below, left for the emulation thread to first-touch
+	template <typename T>
+	using MapBuffer = AlignedUniqueArray<T, HDIS, AllocPolicy::FIRST_TOUCH>;
+
+	template <typename T>
+	static auto allocate_map_buffer() noexcept {
+		return ::allocate_n<T, HDIS, AllocPolicy::FIRST_TOUCH>
+			(c_sys_screen_W * c_sys_screen_H).as_value().release();
+	}
+
+	MapBuffer<RGBA> m_old_render_buffer;
+	MapBuffer<RGBA> m_background_buffer;
+	MapBuffer<u8>   m_collision_buffer;
+
+	Map2D<RGBA> m_old_render_map;
+	Map2D<RGBA> m_background_map;
+	Map2D<u8>   m_collision_map;
+
+	std::array<RGBA, 256> // 256-color palette, as loaded by 02NN
+		m_color_palette{};
+
+	std::array<RGBA, 256> // palette with the texture's color traits applied
+		m_trait_palette{};
+
+	std::array<u8, c_sys_screen_W> // scratch row of palette indices for DxyN
+		m_texture_row{};
+
+	std::array<RGBA, c_sys_screen_W> // scratch row of texel colors for DxyN
+		m_texel_row{};
+
+/*==================================================================*/
+
+	enum ColorTrait : u8 {
+		RGB, BRG, GBR,
+		RBG, GRB, BGR,
+		GRAY, SEPIA,
+	};
+
+	struct Texture {
+		u32  w{}, h{};
+		u32  collide = 0xFF;
+		u8   rgbmod = ColorTrait::RGB;
+		bool rotate{}; // 90° clockwise
+		bool flip_x{}; // rotation agnostic
+		bool flip_y{}; // rotation agnostic
+		bool invert{}; // invert RGB channels
+		bool nodraw{}; // collision indices only
+
+		constexpr void reset() noexcept
+			{ *this = Texture{}; }
+
+		constexpr void set_traits(u32 bits) noexcept {
+			rotate = !!(bits & 0x01);
+			flip_x = !!(bits & 0x02);
+			flip_y = !!(bits & 0x04);
+			invert = !!(bits & 0x08);
+			rgbmod = u8(bits >> 4 & 0x7);
+			nodraw = !!(bits & 0x80);
+		}
+	} m_texture;
+
+	enum BlendMode {
+		NORMAL,
+		LIGHTEN_ONLY, SCREEN,   COLOR_DODGE, LINEAR_DODGE,
+		DARKEN_ONLY,  MULTIPLY, COLOR_BURN,  LINEAR_BURN,
+		AVERAGE, DIFFERENCE, NEGATION,
+		OVERLAY, REFLECT,    GLOW,
+		OVERWRITE,
+	};
+
+	// Tag for OVERWRITE, which replaces the pixel outright, alpha included.
+	struct Overwrite {
+		[[nodiscard]] static constexpr
+		u8 impl(u8 src, u8) noexcept { return src; }
+	};
+
+	using DrawTextureRow = bool (GIGACHIP::*)(const u8*, u8*, RGBA*, u32, u8) noexcept;
+
+	DrawTextureRow m_draw_texture_row{};
+
+	void set_blend_callable(u32 mode) noexcept;
+	void refresh_trait_palette() noexcept;
+
+	void scrap_all_video_buffers() noexcept;
+	void flush_all_video_buffers(bool by_blending, bool and_advance) noexcept;
+
+	struct TrackData {
+		u8*  data{};
+		u32  size{};
+		bool loop{};
+
+		constexpr void reset() noexcept
+			{ *this = TrackData{}; }
+
+		constexpr bool enabled() const noexcept
+			{ return data != nullptr; }
+
+		constexpr auto pos(Phase head) const noexcept
+			{ return data[u32(head * size)] - 128; }
+	} m_track;
+
+	void start_audio_track(bool repeat) noexcept;
+
+	static void make_stream_wave(SampleBuffer buffer, Voice& voice, TrackData& track) noexcept;
+
+/*==================================================================*/
+
+	auto NNNN() const noexcept { return m_memory[m_current_pc] << 8 | m_memory[m_current_pc + 1]; }
+
+public:
+	GIGACHIP() noexcept
+		: IFamily_CHIP8(c_sys_screen_W, c_sys_screen_H)
+		, m_old_render_buffer(allocate_map_buffer<RGBA>())
+		, m_background_buffer(allocate_map_buffer<RGBA>())
+		, m_collision_buffer(allocate_map_buffer<u8>())
+		, m_old_render_map(m_old_render_buffer.get(), c_sys_screen_W, c_sys_screen_H)
+		, m_background_map(m_background_buffer.get(), c_sys_screen_W, c_sys_screen_H)
+		, m_collision_map(m_collision_buffer.get(), c_sys_screen_W, c_sys_screen_H)
+	{}
+
+private:
+	void initialize_system() noexcept override final;
+	void reset_system_data() noexcept override final;
+
+	template <bool DEBUG>
+	void instruction_loop() noexcept;
+
+	void instruction_loop_fast()  noexcept override final;
+	void instruction_loop_debug() noexcept override final;
+
+	void push_audio_data() noexcept override final;
+	void push_video_data() noexcept override final;
+
+	void set_display_properties() noexcept;
+
+	void skip_instruction() noexcept override final;
+
+	void scroll_buffers_up(u32 N) noexcept;
+	void scroll_buffers_dn(u32 N) noexcept;
+	void scroll_buffers_lt() noexcept;
+	void scroll_buffers_rt() noexcept;
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	// 00BN - scroll plane N lines up
+	void instruction_00BN(u32 N) noexcept;
+	// 00CN - scroll plane N lines down
+	void instruction_00CN(u32 N) noexcept;
+	// 00E0 - flush and advance the frame
+	void instruction_00E0() noexcept;
+	// 00EE - return from subroutine
+	void instruction_00EE() noexcept;
+	// 00FB - scroll plane 4 pixels right
+	void instruction_00FB() noexcept;
+	// 00FC - scroll plane 4 pixels left
+	void instruction_00FC() noexcept;
+	// 00FD - stop signal
+	void instruction_00FD() noexcept;
+
+	// 0011 - reset graphics state
+	void instruction_0011() noexcept;
+	// 01NN - set I to NN'NNNN
+	void instruction_01NN(u32 NN) noexcept;
+	// 02NN - load NN palette colors from RAM at I
+	void instruction_02NN(u32 NN) noexcept;
+	// 03NN - set sprite width to NN
+	void instruction_03NN(u32 NN) noexcept;
+	// 04NN - set sprite height to NN
+	void instruction_04NN(u32 NN) noexcept;
+	// 05NN - set screen brightness to NN
+	void instruction_05NN(u32 NN) noexcept;
+	// 060N - start digital sound from RAM at I, repeat if N == 0
+	void instruction_060N(u32 N) noexcept;
+	// 0700 - stop digital sound
+	void instruction_0700() noexcept;
+	// 080N - set sprite traits to VF, blend mode to N
+	void instruction_080N(u32 N) noexcept;
+	// 09NN - set collision color to palette entry NN
+	void instruction_09NN(u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	// 1NNN - jump to NNN
+	void instruction_1NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	// 2NNN - call subroutine at NNN
+	void instruction_2NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	// 3XNN - skip next instruction if VX == NN
+	void instruction_3xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	// 4XNN - skip next instruction if VX != NN
+	void instruction_4xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	// 5XY0 - skip next instruction if VX == VY
+	void instruction_5xy0(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	// 6XNN - set VX = NN
+	void instruction_6xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	// 7XNN - set VX = VX + NN
+	void instruction_7xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	// 8XY0 - set VX = VY
+	void instruction_8xy0(u32 X, u32 Y) noexcept;
+	// 8XY1 - set VX = VX | VY
+	void instruction_8xy1(u32 X, u32 Y) noexcept;
+	// 8XY2 - set VX = VX & VY
+	void instruction_8xy2(u32 X, u32 Y) noexcept;
+	// 8XY3 - set VX = VX ^ VY
+	void instruction_8xy3(u32 X, u32 Y) noexcept;
+	// 8XY4 - set VX = VX + VY, VF = carry
+	void instruction_8xy4(u32 X, u32 Y) noexcept;
+	// 8XY5 - set VX = VX - VY, VF = !borrow
+	void instruction_8xy5(u32 X, u32 Y) noexcept;
+	// 8XY7 - set VX = VY - VX, VF = !borrow
+	void instruction_8xy7(u32 X, u32 Y) noexcept;
+	// 8XY6 - set VX = VY >> 1, VF = carry
+	void instruction_8xy6(u32 X, u32 Y) noexcept;
+	// 8XYE - set VX = VY << 1, VF = carry
+	void instruction_8xyE(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	// 9XY0 - skip next instruction if VX != VY
+	void instruction_9xy0(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	// ANNN - set I = NNN
+	void instruction_ANNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	// BNNN - jump to NNN + V0
+	void instruction_BNNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	// CXNN - set VX = rnd(256) & NN
+	void instruction_CxNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	template <IsBlendMode BlendMode>
+	static constexpr RGBA blend_pixel(RGBA src, RGBA dst, u8 weight) noexcept;
+
+	template <IsBlendMode BlendMode>
+	bool draw_texture_row(const u8* src_row, u8* collision_row,
+		RGBA* bg_buffer_row, u32 count, u8 weight) noexcept;
+
+	// DXYN - draw texture at VX and VY, N = transparency
+	void instruction_DxyN(u32 X, u32 Y, u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	// EX9E - skip next instruction if key VX down (p1)
+	void instruction_Ex9E(u32 X) noexcept;
+	// EXA1 - skip next instruction if key VX up (p1)
+	void instruction_ExA1(u32 X) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	// FX07 - set VX = delay timer
+	void instruction_Fx07(u32 X) noexcept;
+	// FX0A - set VX = key, wait for keypress
+	void instruction_Fx0A(u32 X) noexcept;
+	// FX15 - set delay timer = VX
+	void instruction_Fx15(u32 X) noexcept;
+	// FX18 - set sound timer = VX
+	void instruction_Fx18(u32 X) noexcept;
+	// FX1E - set I = I + VX
+	void instruction_Fx1E(u32 X) noexcept;
+	// FX29 - set I to 5-byte hex sprite from VX
+	void instruction_Fx29(u32 X) noexcept;
+	// FX30 - set I to 10-byte hex sprite from VX
+	void instruction_Fx30(u32 X) noexcept;
+	// FX33 - store BCD of VX to RAM at I..I+2
+	void instruction_Fx33(u32 X) noexcept;
+	// FN55 - store V0..VN to RAM at I..I+N
+	void instruction_FN55(u32 N) noexcept;
+	// FN65 - load V0..VN from RAM at I..I+N
+	void instruction_FN65(u32 N) noexcept;
+	// FN75 - store V0..VN to the permanent regs
+	void instruction_FN75(u32 N) noexcept;
+	// FN85 - load V0..VN from the permanent regs
+	void instruction_FN85(u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+};
+
+#endif
@@ -0,0 +1,924 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "HWCHIP64.hpp"
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_HWCHIP64)
+
+#include "CoreRegistry.inl"
+
+REGISTER_SYSTEM_CORE(HWCHIP64)
+
+/*==================================================================*/
+
+void HWCHIP64::initialize_system() noexcept {
+	add_quirk(WRAP_SPRITES);
+
+	copy_file_image_to(m_memory, c_game_load_pos);
+	copy_font_data_to(m_memory, 240);
+
+	m_base_system_framerate = c_sys_refresh_rate;
+
+	bind_system_memory(m_memory.data(), m_memory.size());
+
+	set_pattern_pitch(64);
+
+	m_current_pc = c_sys_boot_pos;
+	m_standard_cpf = c_sys_speed_lo;
+
+	m_display_device.metadata().edit([&](auto& meta) noexcept {
+		meta.minimum_zoom = 4;
+		meta.inner_margin = 4;
+		meta.texture_tint = m_bit_colors[0];
+		meta.enabled = true;
+	});
+}
+
+void HWCHIP64::reset_system_data() noexcept {
+	m_memory.clear();
+
+	copy_file_image_to(m_memory, c_game_load_pos);
+	copy_font_data_to(m_memory, 240);
+
+	m_display_map.fill().resize(
+		c_sys_screen_W/2, c_sys_screen_H/2);
+
+	m_current_pc   = c_sys_boot_pos;
+	m_standard_cpf = c_sys_speed_lo;
+	m_bit_colors   = s_bit_colors;
+	m_plane_mask   = 0x1;
+	m_paint_brush  = c_brush_XOR;
+
+	set_pattern_pitch(64);
+	m_pulse_pattern_data = c_default_pattern_data;
+}
+
+template <bool DEBUG>
+void HWCHIP64::instruction_loop() noexcept {
+	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
+		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
+		&& m_cycle_count < target_cpf; ++m_cycle_count)
+	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
+		const auto HI = m_memory[m_current_pc++];
+		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
+
+		#define _NNN ((HI << 8 | LO) & 0xFFF)
+		#define _X (HI & 0xF)
+		#define Y_ (LO >> 4)
+		#define _N (LO & 0xF)
+
+		switch (HI) {
+			case 0x00:
+				switch (LO) {
+					CASE_xNF(0xC0):
+						instruction_00CN(_N);
+						break;
+					CASE_xNF(0xD0):
+						instruction_00DN(_N);
+						break;
+					case 0xE0:
+						instruction_00E0();
+						break;
+					case 0xE1:
+						instruction_00E1();
+						break;
+					case 0xEE:
+						instruction_00EE();
+						break;
+					case 0xF1:
+						instruction_00F1();
+						break;
+					case 0xF2:
+						instruction_00F2();
+						break;
+					case 0xF3:
+						instruction_00F3();
+						break;
+					case 0xFB:
+						instruction_00FB();
+						break;
+					case 0xFC:
+						instruction_00FC();
+						break;
+					case 0xFD:
+						instruction_00FD();
+						break;
+					case 0xFE:
+						instruction_00FE();
+						break;
+					case 0xFF:
+						instruction_00FF();
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0x10):
+				instruction_1NNN(_NNN);
+				break;
+			CASE_xNF(0x20):
+				instruction_2NNN(_NNN);
+				break;
+			CASE_xNF(0x30):
+				instruction_3xNN(_X, LO);
+				break;
+			CASE_xNF(0x40):
+				instruction_4xNN(_X, LO);
+				break;
+			CASE_xNF(0x50):
+				switch (LO) {
+					CASE_xFN(0x00):
+						instruction_5xy0(_X, Y_);
+						break;
+					CASE_xFN(0x02):
+						instruction_5xy2(_X, Y_);
+						break;
+					CASE_xFN(0x03):
+						instruction_5xy3(_X, Y_);
+						break;
+					CASE_xFN(0x04):
+						instruction_5xy4(_X, Y_);
+						break;
+					[[unlikely]]
+					default:
+						instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0x60):
+				instruction_6xNN(_X, LO);
+				break;
+			CASE_xNF(0x70):
+				instruction_7xNN(_X, LO);
+				break;
+			CASE_xNF(0x80):
+				switch (LO) {
+					CASE_xFN(0x0):
+						instruction_8xy0(_X, Y_);
+						break;
+					CASE_xFN(0x1):
+						instruction_8xy1(_X, Y_);
+						break;
+					CASE_xFN(0x2):
+						instruction_8xy2(_X, Y_);
+						break;
+					CASE_xFN(0x3):
+						instruction_8xy3(_X, Y_);
+						break;
+					CASE_xFN(0x4):
+						instruction_8xy4(_X, Y_);
+						break;
+					CASE_xFN(0x5):
+						instruction_8xy5(_X, Y_);
+						break;
+					CASE_xFN(0x7):
+						instruction_8xy7(_X, Y_);
+						break;
+					CASE_xFN(0x6):
+						instruction_8xy6(_X, Y_);
+						break;
+					CASE_xFN(0xE):
+						instruction_8xyE(_X, Y_);
+						break;
+					CASE_xFN(0xC):
+						instruction_8xyC(_X, Y_);
+						break;
+					CASE_xFN(0xD):
+						instruction_8xyD(_X, Y_);
+						break;
+					CASE_xFN(0xF):
+						instruction_8xyF(_X, Y_);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			CASE_xNF(0x90):
+				if (_N) [[unlikely]] {
+					instruction_error(HI, LO);
+				} else {
+					instruction_9xy0(_X, Y_);
+				}
+				break;
+			CASE_xNF(0xA0):
+				instruction_ANNN(_NNN);
+				break;
+			CASE_xNF(0xB0):
+				instruction_BNNN(_NNN);
+				break;
+			CASE_xNF(0xC0):
+				instruction_CxNN(_X, LO);
+				break;
+			CASE_xNF(0xD0):
+				instruction_DxyN(_X, Y_, _N);
+				break;
+			CASE_xNF(0xE0):
+				switch (LO) {
+					case 0x9E:
+						instruction_Ex9E(_X);
+						break;
+					case 0xA1:
+						instruction_ExA1(_X);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+			case 0xF0:
+				/**/ if (LO == 0x00) {
+					instruction_F000();
+					break;
+				}
+				else if (LO == 0x02) {
+					instruction_F002();
+					break;
+				}
+				[[fallthrough]];
+			CASE_xNF0(0xF0):
+				switch (LO) {
+					case 0x00:
+						switch (HI) {
+							case 0xF1:
+								instruction_F100();
+								break;
+							case 0xF2:
+								instruction_F200();
+								break;
+							case 0xF3:
+								instruction_F300();
+								break;
+							[[unlikely]]
+							default: instruction_error(HI, LO);
+						}
+						break;
+					case 0x01:
+						instruction_FN01(_X);
+						break;
+					case 0x03:
+						instruction_Fx03(_X);
+						break;
+					case 0x07:
+						instruction_Fx07(_X);
+						break;
+					case 0x0A:
+						instruction_Fx0A(_X);
+						break;
+					case 0x15:
+						instruction_Fx15(_X);
+						break;
+					case 0x18:
+						instruction_Fx18(_X);
+						break;
+					case 0x1E:
+						instruction_Fx1E(_X);
+						break;
+					case 0x1F:
+						instruction_Fx1F(_X);
+						break;
+					case 0x29:
+						instruction_Fx29(_X);
+						break;
+					case 0x30:
+						instruction_Fx30(_X);
+						break;
+					case 0x33:
+						instruction_Fx33(_X);
+						break;
+					case 0x3A:
+						instruction_Fx3A(_X);
+						break;
+					case 0x55:
+						instruction_FN55(_X);
+						break;
+					case 0x65:
+						instruction_FN65(_X);
+						break;
+					case 0x75:
+						instruction_FN75(_X);
+						break;
+					case 0x85:
+						instruction_FN85(_X);
+						break;
+					[[unlikely]]
+					default: instruction_error(HI, LO);
+				}
+				break;
+		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
+	}
+}
+
+void HWCHIP64::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void HWCHIP64::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
+void HWCHIP64::push_audio_data() noexcept {
+	mix_audio_data(
+		[&](auto buffer) noexcept { make_pattern_wave(buffer, m_voices[VOICE::UNIQUE], m_pulse_pattern_data); },
+		[&](auto buffer) noexcept { make_pulse_wave  (buffer, m_voices[VOICE::BUZZER]); }
+	);
+
+	if (has_cached_system_state(EmuState::ANY_PAUSE)) { return; }
+	m_display_device.metadata().edit([&](auto& meta) noexcept {
+		meta.set_border_color_if(!!m_voices[VOICE::BUZZER], get_bit_color(1));
+	});
+}
+
+void HWCHIP64::push_video_data() noexcept {
+	// packed planes already hold the palette index, only lores needs upscaling
+	if (use_hires_screen()) {
+		m_display_device.present([&](auto& frame) noexcept {
+			frame.metadata = m_display_device.metadata().copy();
+			frame.copy_from(m_display_buffer, [&](auto pixel) noexcept { return get_bit_color(pixel); });
+		});
+	} else {
+		std::array<u8, c_sys_screen_W * c_sys_screen_H> composite_buffer{};
+
+		std::for_each(EXEC_POLICY(unseq)
+			composite_buffer.begin(), composite_buffer.end(),
+			[&](auto& pixel) noexcept {
+				const auto idx = &pixel - composite_buffer.data();
+
+				const auto x = idx % c_sys_screen_W;
+				const auto y = idx / c_sys_screen_W;
+
+				::assign_cast(pixel, m_display_buffer[(y/2) * c_sys_screen_H + (x/2)]);
+			}
+		);
+
+		m_display_device.present([&](auto& frame) noexcept {
+			frame.metadata = m_display_device.metadata().copy();
+			frame.copy_from(composite_buffer, [&](auto pixel) noexcept { return get_bit_color(pixel); });
+		});
+	}
+}
+
+void HWCHIP64::set_pattern_pitch(s32 pitch) noexcept {
+	if (m_audio_device) {
+		m_voices[VOICE::UNIQUE].set_step(std::bit_cast<f32>(
+			xochip_tables::c_pitch_frequency_lut[pitch]) / m_audio_device.get_freq());
+	}
+}
+
+void HWCHIP64::make_pattern_wave(
+	SampleBuffer buffer, Voice& voice,
+	const PatternData& pattern_data
+) noexcept {
+	if (const auto sample_count = u32(buffer.size())) {
+		const auto fade_step = ::calc_fade_step(sample_count);
+
+		for (auto i = 0u; i < sample_count; ++i) {
+			if (const auto gain = voice.get_level(i, voice.timer, fade_step)) {
+				const auto bit_step = s32(voice.peek_phase(i) * 128.0f);
+				const auto bit_mask = 1 << (0x7 ^ (bit_step & 0x7));
+				::assign_cast_add(buffer[i], \
+					(pattern_data[bit_step >> 3] & bit_mask) ? gain : -gain);
+			}
+			else break;
+		}
+		voice.step_phase(sample_count);
+	}
+}
+
+/*==================================================================*/
+
+void HWCHIP64::skip_instruction() noexcept {
+	switch (NNNN()) {
+		case 0xF000: case 0xF100:
+		case 0xF200: case 0xF300:
+			::assign_cast_add(m_current_pc, 4);
+			break;
+		default:
+			::assign_cast_add(m_current_pc, 2);
+	}
+}
+
+void HWCHIP64::scroll_selected_planes(s32 cols, s32 rows) noexcept {
+	const auto plane_mask = u8(m_plane_mask & 0xF);
+	if (!plane_mask) { return; }
+
+	if (plane_mask == 0xF) {
+		m_display_map.shift(cols, rows);
+		return;
+	}
+
+	const auto W = s32(m_display_map.width());
+	const auto H = s32(m_display_map.height());
+
+	const auto scrolled_buffer = m_display_buffer;
+
+	for (auto y = 0; y < H; ++y) {
+		for (auto x = 0; x < W; ++x) {
+			const auto src_x = x - cols;
+			const auto src_y = y - rows;
+
+			const auto src_pixel = (src_x >= 0 && src_x < W && src_y >= 0 && src_y < H)
+				? scrolled_buffer[src_y * W + src_x] : u8(0);
+
+			auto& pixel = m_display_map(x, y);
+			::assign_cast(pixel, (pixel & ~plane_mask) | (src_pixel & plane_mask));
+		}
+	}
+}
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	void HWCHIP64::instruction_00CN(u32 N) noexcept {
+		if (N) { scroll_selected_planes(0, +s32(N)); }
+		trigger_interrupt(Interrupt::FRAME, has_quirk(AWAIT_SCROLL));
+	}
+	void HWCHIP64::instruction_00DN(u32 N) noexcept {
+		if (N) { scroll_selected_planes(0, -s32(N)); }
+		trigger_interrupt(Interrupt::FRAME, has_quirk(AWAIT_SCROLL));
+	}
+	void HWCHIP64::instruction_00E0() noexcept {
+		const auto plane_mask = u8(m_plane_mask & 0xF);
+		std::for_each(EXEC_POLICY(unseq)
+			m_display_map.begin(), m_display_map.end(),
+			[plane_mask](auto& pixel) noexcept {
+				::assign_cast_and(pixel, ~plane_mask);
+			}
+		);
+	}
+	void HWCHIP64::instruction_00E1() noexcept {
+		const auto plane_mask = u8(m_plane_mask & 0xF);
+		std::for_each(EXEC_POLICY(unseq)
+			m_display_map.begin(), m_display_map.end(),
+			[plane_mask](auto& pixel) noexcept {
+				::assign_cast_xor(pixel, plane_mask);
+			}
+		);
+	}
+	void HWCHIP64::instruction_00EE() noexcept {
+		m_current_pc = m_stack.pop();
+	}
+	void HWCHIP64::instruction_00F1() noexcept {
+		m_paint_brush = c_brush_ADD;
+	}
+	void HWCHIP64::instruction_00F2() noexcept {
+		m_paint_brush = c_brush_SUB;
+	}
+	void HWCHIP64::instruction_00F3() noexcept {
+		m_paint_brush = c_brush_XOR;
+	}
+	void HWCHIP64::instruction_00FB() noexcept {
+		scroll_selected_planes(+4, 0);
+		trigger_interrupt(Interrupt::FRAME, has_quirk(AWAIT_SCROLL));
+	}
+	void HWCHIP64::instruction_00FC() noexcept {
+		scroll_selected_planes(-4, 0);
+		trigger_interrupt(Interrupt::FRAME, has_quirk(AWAIT_SCROLL));
+	}
+	void HWCHIP64::instruction_00FD() noexcept {
+		trigger_interrupt(Interrupt::SOUND);
+	}
+	void HWCHIP64::instruction_00FE() noexcept {
+		use_hires_screen(false);
+		m_display_map.resize(c_sys_screen_W/2, c_sys_screen_H/2).fill();
+	}
+	void HWCHIP64::instruction_00FF() noexcept {
+		use_hires_screen(true);
+		m_display_map.resize(c_sys_screen_W, c_sys_screen_H).fill();
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	void HWCHIP64::instruction_1NNN(u32 NNN) noexcept {
+		jump_program_to(NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	void HWCHIP64::instruction_2NNN(u32 NNN) noexcept {
+		m_stack.push(m_current_pc);
+		jump_program_to(NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	void HWCHIP64::instruction_3xNN(u32 X, u32 NN) noexcept {
+		if (m_registers_V[X] == NN) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	void HWCHIP64::instruction_4xNN(u32 X, u32 NN) noexcept {
+		if (m_registers_V[X] != NN) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	void HWCHIP64::instruction_5xy0(u32 X, u32 Y) noexcept {
+		if (m_registers_V[X] == m_registers_V[Y]) { skip_instruction(); }
+	}
+	void HWCHIP64::instruction_5xy2(u32 X, u32 Y) noexcept {
+		if (X < Y) {
+			for (auto i = s32(X); i <= s32(Y); ++i) {
+				m_memory[m_register_I + (i - X)] = m_registers_V[i];
+			}
+		} else {
+			for (auto i = s32(X); i >= s32(Y); --i) {
+				m_memory[m_register_I + (X - i)] = m_registers_V[i];
+			}
+		}
+		m_memory_writes.mark(m_register_I, (X < Y ? Y - X : X - Y) + 1);
+	}
+	void HWCHIP64::instruction_5xy3(u32 X, u32 Y) noexcept {
+		if (X < Y) {
+			for (auto i = s32(X); i <= s32(Y); ++i) {
+				m_registers_V[i] = m_memory[m_register_I + (i - X)];
+			}
+		} else {
+			for (auto i = s32(X); i >= s32(Y); --i) {
+				m_registers_V[i] = m_memory[m_register_I + (X - i)];
+			}
+		}
+	}
+	void HWCHIP64::instruction_5xy4(u32 X, u32 Y) noexcept {
+		if (X < Y) {
+			for (auto i = s32(X); i <= s32(Y); ++i) {
+				m_bit_colors[i] = xochip_tables::c_color_palette[m_memory[m_register_I + (i - X)]];
+			}
+		} else {
+			for (auto i = s32(X); i >= s32(Y); --i) {
+				m_bit_colors[i] = xochip_tables::c_color_palette[m_memory[m_register_I + (X - i)]];
+			}
+		}
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	void HWCHIP64::instruction_6xNN(u32 X, u32 NN) noexcept {
+		::assign_cast(m_registers_V[X], NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	void HWCHIP64::instruction_7xNN(u32 X, u32 NN) noexcept {
+		::assign_cast_add(m_registers_V[X], NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	void HWCHIP64::instruction_8xy0(u32 X, u32 Y) noexcept {
+		::assign_cast(m_registers_V[X], m_registers_V[Y]);
+	}
+	void HWCHIP64::instruction_8xy1(u32 X, u32 Y) noexcept {
+		::assign_cast_or(m_registers_V[X], m_registers_V[Y]);
+		if (has_quirk(RESET_VF_REG)) { ::assign_cast(m_registers_V[0xF], 0); }
+	}
+	void HWCHIP64::instruction_8xy2(u32 X, u32 Y) noexcept {
+		::assign_cast_and(m_registers_V[X], m_registers_V[Y]);
+		if (has_quirk(RESET_VF_REG)) { ::assign_cast(m_registers_V[0xF], 0); }
+	}
+	void HWCHIP64::instruction_8xy3(u32 X, u32 Y) noexcept {
+		::assign_cast_xor(m_registers_V[X], m_registers_V[Y]);
+		if (has_quirk(RESET_VF_REG)) { ::assign_cast(m_registers_V[0xF], 0); }
+	}
+	void HWCHIP64::instruction_8xy4(u32 X, u32 Y) noexcept {
+		const auto sum = m_registers_V[X] + m_registers_V[Y];
+		::assign_cast(m_registers_V[X], sum);
+		::assign_cast(m_registers_V[0xF], sum >> 8);
+	}
+	void HWCHIP64::instruction_8xy5(u32 X, u32 Y) noexcept {
+		const bool nborrow = m_registers_V[X] >= m_registers_V[Y];
+		::assign_cast_sub(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], nborrow);
+	}
+	void HWCHIP64::instruction_8xy7(u32 X, u32 Y) noexcept {
+		const bool nborrow = m_registers_V[Y] >= m_registers_V[X];
+		::assign_cast_rsub(m_registers_V[X], m_registers_V[Y]);
+		::assign_cast(m_registers_V[0xF], nborrow);
+	}
+	void HWCHIP64::instruction_8xy6(u32 X, u32 Y) noexcept {
+		if (!has_quirk(SHIFT_VX_REG)) { m_registers_V[X] = m_registers_V[Y]; }
+		const bool lsb = (m_registers_V[X] & 1) == 1;
+		::assign_cast_shr(m_registers_V[X], 1);
+		::assign_cast(m_registers_V[0xF], lsb);
+	}
+	void HWCHIP64::instruction_8xyE(u32 X, u32 Y) noexcept {
+		if (!has_quirk(SHIFT_VX_REG)) { m_registers_V[X] = m_registers_V[Y]; }
+		const bool msb = (m_registers_V[X] >> 7) == 1;
+		::assign_cast_shl(m_registers_V[X], 1);
+		::assign_cast(m_registers_V[0xF], msb);
+	}
+	void HWCHIP64::instruction_8xyC(u32 X, u32 Y) noexcept {
+		const auto mul = m_registers_V[X] * m_registers_V[Y];
+		::assign_cast(m_registers_V[X], mul);
+		::assign_cast(m_registers_V[0xF], mul >> 8);
+	}
+	void HWCHIP64::instruction_8xyD(u32 X, u32 Y) noexcept {
+		if (!m_registers_V[Y]) {
+			::assign_cast(m_registers_V[X], 0);
+			::assign_cast(m_registers_V[0xF], 0);
+		} else {
+			const auto rem = m_registers_V[X] % m_registers_V[Y];
+			::assign_cast(m_registers_V[X], m_registers_V[X] / m_registers_V[Y]);
+			::assign_cast(m_registers_V[0xF], rem);
+		}
+	}
+	void HWCHIP64::instruction_8xyF(u32 X, u32 Y) noexcept {
+		if (!m_registers_V[X]) {
+			::assign_cast(m_registers_V[0xF], 0);
+		} else {
+			const auto rem = m_registers_V[Y] % m_registers_V[X];
+			::assign_cast(m_registers_V[X], m_registers_V[Y] / m_registers_V[X]);
+			::assign_cast(m_registers_V[0xF], rem);
+		}
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	void HWCHIP64::instruction_9xy0(u32 X, u32 Y) noexcept {
+		if (m_registers_V[X] != m_registers_V[Y]) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	void HWCHIP64::instruction_ANNN(u32 NNN) noexcept {
+		::assign_cast(m_register_I, NNN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	void HWCHIP64::instruction_BNNN(u32 NNN) noexcept {
+		jump_program_to(NNN + m_registers_V[0]);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	void HWCHIP64::instruction_CxNN(u32 X, u32 NN) noexcept {
+		::assign_cast(m_registers_V[X], m_rng->next() & NN);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	void HWCHIP64::draw_pixel(u32 X, u32 Y, u32 P) noexcept {
+		const auto plane_bit = u8(1 << P);
+		auto& pixel = m_display_map(X, Y);
+
+		if (pixel & plane_bit) { m_registers_V[0xF] = 1; }
+		::assign_cast(pixel, (pixel & ~(m_paint_brush.clear & plane_bit))
+			^ (m_paint_brush.flip & plane_bit));
+	}
+
+	void HWCHIP64::draw_byte(u32 X, u32 Y, u32 P, u32 DATA) noexcept {
+		switch (DATA) {
+			[[unlikely]]
+			case 0b00000000:
+				return;
+
+			[[unlikely]]
+			case 0b10000000:
+				if (has_quirk(WRAP_SPRITES)) { X &= (m_display_map.width() - 1); }
+				if (X < m_display_map.width()) { draw_pixel(X, Y, P); }
+				return;
+
+			[[likely]]
+			default:
+				if (has_quirk(WRAP_SPRITES)) { X &= (m_display_map.width() - 1); }
+				else if (X >= m_display_map.width()) { return; }
+
+				for (auto B = 0; B < 8; ++B, ++X &= (m_display_map.width() - 1)) {
+					if (DATA & 0x80 >> B) { draw_pixel(X, Y, P); }
+					if (!has_quirk(WRAP_SPRITES) && X == (m_display_map.width() - 1)) { return; }
+				}
+				return;
+		}
+	}
+
+	template <std::size_t P>
+	void HWCHIP64::draw_single_row(u32 X, u32 Y) noexcept {
+		const auto I = m_register_I + c_plane_mask[P][m_plane_mask];
+
+		draw_byte(X, Y, P, m_memory[I]);
+	}
+
+	template <std::size_t P>
+	void HWCHIP64::draw_double_row(u32 X, u32 Y) noexcept {
+		const auto I = m_register_I + c_plane_mask[P][m_plane_mask] * 32;
+
+		for (auto H = 0u; H < 16u; ++H) {
+			draw_byte(X + 0, Y, P, m_memory[I + H * 2 + 0]);
+			draw_byte(X + 8, Y, P, m_memory[I + H * 2 + 1]);
+
+			if (!has_quirk(WRAP_SPRITES) && Y == (m_display_map.height() - 1)) { break; }
+			else { ++Y &= (m_display_map.height() - 1); }
+		}
+	}
+
+	template <std::size_t P>
+	void HWCHIP64::draw_n_rows(u32 X, u32 Y, u32 N) noexcept {
+		const auto I = m_register_I + c_plane_mask[P][m_plane_mask] * N;
+
+		for (auto H = 0u; H < N; ++H) {
+			draw_byte(X, Y, P, m_memory[I + H]);
+
+			if (!has_quirk(WRAP_SPRITES) && Y == (m_display_map.height() - 1)) { break; }
+			else { ++Y &= (m_display_map.height() - 1); }
+		}
+	}
+
+	void HWCHIP64::instruction_DxyN(u32 X, u32 Y, u32 N) noexcept {
+		const auto pX = m_registers_V[X] & (m_display_map.width()  - 1);
+		const auto pY = m_registers_V[Y] & (m_display_map.height() - 1);
+
+		m_registers_V[0xF] = 0;
+
+		switch (N) {
+			case 0:
+				if (m_plane_mask & P0M) { draw_double_row<P0>(pX, pY); }
+				if (m_plane_mask & P1M) { draw_double_row<P1>(pX, pY); }
+				if (m_plane_mask & P2M) { draw_double_row<P2>(pX, pY); }
+				if (m_plane_mask & P3M) { draw_double_row<P3>(pX, pY); }
+				break;
+
+			case 1:
+				if (m_plane_mask & P0M) { draw_single_row<P0>(pX, pY); }
+				if (m_plane_mask & P1M) { draw_single_row<P1>(pX, pY); }
+				if (m_plane_mask & P2M) { draw_single_row<P2>(pX, pY); }
+				if (m_plane_mask & P3M) { draw_single_row<P3>(pX, pY); }
+				break;
+
+			default:
+				if (m_plane_mask & P0M) { draw_n_rows<P0>(pX, pY, N); }
+				if (m_plane_mask & P1M) { draw_n_rows<P1>(pX, pY, N); }
+				if (m_plane_mask & P2M) { draw_n_rows<P2>(pX, pY, N); }
+				if (m_plane_mask & P3M) { draw_n_rows<P3>(pX, pY, N); }
+				break;
+		}
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	void HWCHIP64::instruction_Ex9E(u32 X) noexcept {
+		if (m_keypad.is_key_held_P1(m_registers_V[X])) { skip_instruction(); }
+	}
+	void HWCHIP64::instruction_ExA1(u32 X) noexcept {
+		if (!m_keypad.is_key_held_P1(m_registers_V[X])) { skip_instruction(); }
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	void HWCHIP64::instruction_F000() noexcept {
+		::assign_cast(m_register_I, NNNN());
+		::assign_cast_add(m_current_pc, 2);
+	}
+	void HWCHIP64::instruction_F100() noexcept {
+		jump_program_to(NNNN());
+	}
+	void HWCHIP64::instruction_F200() noexcept {
+		m_stack.push(m_current_pc + 2);
+		jump_program_to(NNNN());
+	}
+	void HWCHIP64::instruction_F300() noexcept {
+		jump_program_to(NNNN() + m_registers_V[0]);
+	}
+	void HWCHIP64::instruction_F002() noexcept {
+		for (auto i = 0u; i < 16u; ++i) {
+			m_pulse_pattern_data[i] = m_memory[m_register_I + i];
+		}
+	}
+	void HWCHIP64::instruction_FN01(u32 N) noexcept {
+		m_plane_mask = N;
+	}
+	void HWCHIP64::instruction_Fx03(u32 X) noexcept {
+		m_bit_colors[X] = RGBA(
+			m_memory[m_register_I + 0],
+			m_memory[m_register_I + 1],
+			m_memory[m_register_I + 2]
+		);
+
+		if (X == 0) {
+			m_display_device.metadata().edit([&](auto& meta) noexcept {
+				meta.texture_tint = m_bit_colors[0];
+			});
+		}
+	}
+	void HWCHIP64::instruction_Fx07(u32 X) noexcept {
+		::assign_cast(m_registers_V[X], m_delay_timer);
+	}
+	void HWCHIP64::instruction_Fx0A(u32 X) noexcept {
+		m_keypad.set_reg_ptr(&m_registers_V[X]);
+		trigger_interrupt(Interrupt::INPUT);
+	}
+	void HWCHIP64::instruction_Fx15(u32 X) noexcept {
+		::assign_cast(m_delay_timer, m_registers_V[X]);
+	}
+	void HWCHIP64::instruction_Fx18(u32 X) noexcept {
+		m_voices[VOICE::UNIQUE].timer.set(m_registers_V[X] + (m_registers_V[X] == 1));
+	}
+	void HWCHIP64::instruction_Fx1E(u32 X) noexcept {
+		::assign_cast_add(m_register_I, m_registers_V[X]);
+	}
+	void HWCHIP64::instruction_Fx1F(u32 X) noexcept {
+		::assign_cast_sub(m_register_I, m_registers_V[X]);
+	}
+	void HWCHIP64::instruction_Fx29(u32 X) noexcept {
+		::assign_cast(m_register_I, (m_registers_V[X] & 0xF) * 5 + c_small_font_offset);
+	}
+	void HWCHIP64::instruction_Fx30(u32 X) noexcept {
+		::assign_cast(m_register_I, (m_registers_V[X] & 0xF) * 10 + c_large_font_offset);
+	}
+	void HWCHIP64::instruction_Fx33(u32 X) noexcept {
+		const TriBCD bcd{ m_registers_V[X] };
+
+		m_memory[m_register_I + 0] = bcd.digit[2];
+		m_memory[m_register_I + 1] = bcd.digit[1];
+		m_memory[m_register_I + 2] = bcd.digit[0];
+		m_memory_writes.mark(m_register_I, 3);
+	}
+	void HWCHIP64::instruction_Fx3A(u32 X) noexcept {
+		set_pattern_pitch(m_registers_V[X]);
+	}
+	void HWCHIP64::instruction_FN55(u32 N) noexcept {
+		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		m_memory_writes.mark(m_register_I, N + 1);
+		if (!has_quirk(NO_INC_I_REG)) [[likely]] { ::assign_cast_add(m_register_I, N + 1); }
+	}
+	void HWCHIP64::instruction_FN65(u32 N) noexcept {
+		for (auto i = 0u; i <= N; ++i) { m_registers_V[i] = m_memory[m_register_I + i]; }
+		if (!has_quirk(NO_INC_I_REG)) [[likely]] { ::assign_cast_add(m_register_I, N + 1); }
+	}
+	void HWCHIP64::instruction_FN75(u32 N) noexcept {
+		set_permaregs(N + 1);
+	}
+	void HWCHIP64::instruction_FN85(u32 N) noexcept {
+		get_permaregs(N + 1);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+#endif
@@ -0,0 +1,400 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "../IFamily_CHIP8.hpp"
+#include "../XOCHIP_Tables.hpp"
+
+#define ENABLE_HWCHIP64
+#if defined(ENABLE_CHIP8_SYSTEM) && defined(ENABLE_HWCHIP64)
+
+#include "SystemDescriptor.hpp"
+#include "Map2D.hpp"
+#include "ArrayOps.hpp"
+
+/*==================================================================*/
+
+class HWCHIP64 final : public IFamily_CHIP8 {
+	static constexpr u64 c_sys_memory_size  = 64_KiB;
+	static constexpr u32 c_game_load_pos    =   512;
+	static constexpr u32 c_sys_boot_pos     =   512;
+	static constexpr f32 c_sys_refresh_rate = 60.0f;
+
+	static constexpr u32 c_sys_speed_hi = 200000;
+	static constexpr u32 c_sys_speed_lo =   1000;
+
+	static constexpr u32 c_sys_screen_W = 128;
+	static constexpr u32 c_sys_screen_H =  64;
+
+	static constexpr std::string_view c_supported_extensions[] = { ".hw8" };
+
+	static constexpr const char* validate_program(std::span<const char> file) noexcept {
+		return Family::validate_program(file, c_game_load_pos, c_sys_memory_size);
+	}
+
+	u8 get_avail_quirks() const noexcept override final {
+		return RESET_VF_REG | SHIFT_VX_REG | NO_INC_I_REG | AWAIT_SCROLL | WRAP_SPRITES;
+	}
+
+public:
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"HWCHIP64", "hwchip64", "HyperWaveCHIP-64 core, extending XOCHIP.",
+		c_supported_extensions, validate_program,
+	};
+
+	const SystemDescriptor& get_descriptor() const noexcept override final {
+		return descriptor;
+	}
+
+/*==================================================================*/
+
+private:
+	MirroredMemory<c_sys_memory_size>
+		m_memory{};
+
+	// all four color planes packed as bits P0..P3 of a single byte per pixel
+	std::array<u8, c_sys_screen_W * c_sys_screen_H>
+		m_display_buffer{};
+
+	Map2D<u8> m_display_map;
+
+/*==================================================================*/
+
+	std::array<RGBA, 16> m_bit_colors{};
+
+	auto get_bit_color(u32 index) const noexcept {
+		index &= 0xF;
+		return m_bit_colors[index]
+			? m_bit_colors[index]
+			: s_bit_colors[index];
+	}
+
+/*==================================================================*/
+
+	using PatternData = std::array<u8, 16>;
+	static constexpr PatternData c_default_pattern_data = {
+		0x0F, 0x00,	0x0F, 0x00, 0x0F, 0x00, 0x0F, 0x00,
+		0x0F, 0x00,	0x0F, 0x00, 0x0F, 0x00, 0x0F, 0x00,
+	};
+
+	PatternData m_pulse_pattern_data = c_default_pattern_data;
+
+	void set_pattern_pitch(s32 pitch) noexcept;
+
+	static void make_pattern_wave(
+		SampleBuffer buffer, Voice& voice,
+		const PatternData& pattern_data
+	) noexcept;
+
+/*==================================================================*/
+
+	u32 m_plane_mask = 0x1;
+
+	// pixel = (pixel & ~clear) ^ flip, per selected plane bit
+	struct Brush { u8 clear, flip; };
+
+	static constexpr Brush c_brush_XOR = { 0x0, 0xF };
+	static constexpr Brush c_brush_SUB = { 0xF, 0x0 };
+	static constexpr Brush c_brush_ADD = { 0xF, 0xF };
+
+	Brush m_paint_brush = c_brush_XOR;
+
+	auto NNNN() const noexcept { return m_memory[m_current_pc] << 8 | m_memory[m_current_pc + 1]; }
+
+public:
+	HWCHIP64() noexcept
+		: IFamily_CHIP8(c_sys_screen_W, c_sys_screen_H)
+		, m_display_map(m_display_buffer, c_sys_screen_W/2, c_sys_screen_H/2)
+	{}
+
+private:
+	void initialize_system() noexcept override final;
+	void reset_system_data() noexcept override final;
+
+	template <bool DEBUG>
+	void instruction_loop() noexcept;
+
+	void instruction_loop_fast()  noexcept override final;
+	void instruction_loop_debug() noexcept override final;
+
+	void push_audio_data() noexcept override final;
+	void push_video_data() noexcept override final;
+
+	void skip_instruction() noexcept override final;
+
+	void scroll_selected_planes(s32 cols, s32 rows) noexcept;
+
+/*==================================================================*/
+	#pragma region 0 instruction branch
+
+	// 00DN - scroll selected color plane N lines down
+	void instruction_00CN(u32 N) noexcept;
+	// 00DN - scroll selected color plane N lines up
+	void instruction_00DN(u32 N) noexcept;
+	// 00E0 - erase selected color plane
+	void instruction_00E0() noexcept;
+	// 00E1 - invert selected color plane
+	void instruction_00E1() noexcept;
+	// 00EE - return from subroutine
+	void instruction_00EE() noexcept;
+	// 00F1 - set DRAW mode to ADD
+	void instruction_00F1() noexcept;
+	// 00F2 - set DRAW mode to SUB
+	void instruction_00F2() noexcept;
+	// 00F3 - set DRAW mode to XOR
+	void instruction_00F3() noexcept;
+	// 00FB - scroll selected color plane 4 pixels right
+	void instruction_00FB() noexcept;
+	// 00FC - scroll selected color plane 4 pixels left
+	void instruction_00FC() noexcept;
+	// 00FD - stop signal
+	void instruction_00FD() noexcept;
+	// 00FE - display res == 64x32, erase whole display
+	void instruction_00FE() noexcept;
+	// 00FF - display res == 128x64, erase whole display
+	void instruction_00FF() noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 1 instruction branch
+
+	// 1NNN - jump to NNN
+	void instruction_1NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 2 instruction branch
+
+	// 2NNN - call subroutine at NNN
+	void instruction_2NNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 3 instruction branch
+
+	// 3XNN - skip next instruction if VX == NN
+	void instruction_3xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 4 instruction branch
+
+	// 4XNN - skip next instruction if VX != NN
+	void instruction_4xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 5 instruction branch
+
+	// 5XY0 - skip next instruction if VX == VY
+	void instruction_5xy0(u32 X, u32 Y) noexcept;
+	// 5XY2 - store range of registers to memory
+	void instruction_5xy2(u32 X, u32 Y) noexcept;
+	// 5XY3 - load range of registers from memory
+	void instruction_5xy3(u32 X, u32 Y) noexcept;
+	// 5XY4 - load range of colors from memory *EXPERIMENTAL*
+	void instruction_5xy4(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 6 instruction branch
+
+	// 6XNN - set VX = NN
+	void instruction_6xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 7 instruction branch
+
+	// 7XNN - set VX = VX + NN
+	void instruction_7xNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 8 instruction branch
+
+	// 8XY0 - set VX = VY
+	void instruction_8xy0(u32 X, u32 Y) noexcept;
+	// 8XY1 - set VX = VX | VY
+	void instruction_8xy1(u32 X, u32 Y) noexcept;
+	// 8XY2 - set VX = VX & VY
+	void instruction_8xy2(u32 X, u32 Y) noexcept;
+	// 8XY3 - set VX = VX ^ VY
+	void instruction_8xy3(u32 X, u32 Y) noexcept;
+	// 8XY4 - set VX = VX + VY, VF = carry
+	void instruction_8xy4(u32 X, u32 Y) noexcept;
+	// 8XY5 - set VX = VX - VY, VF = !borrow
+	void instruction_8xy5(u32 X, u32 Y) noexcept;
+	// 8XY7 - set VX = VY - VX, VF = !borrow
+	void instruction_8xy7(u32 X, u32 Y) noexcept;
+	// 8XY6 - set VX = VY >> 1, VF = carry
+	void instruction_8xy6(u32 X, u32 Y) noexcept;
+	// 8XYE - set VX = VY << 1, VF = carry
+	void instruction_8xyE(u32 X, u32 Y) noexcept;
+	// 8XYC - set VX = VX * VY, VF = overflow
+	void instruction_8xyC(u32 X, u32 Y) noexcept;
+	// 8XYD - set VX = VX / VY, VF = VX % VY
+	void instruction_8xyD(u32 X, u32 Y) noexcept;
+	// 8XYF - set VX = VY / VX, VF = VY % VX
+	void instruction_8xyF(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region 9 instruction branch
+
+	// 9XY0 - skip next instruction if VX != VY
+	void instruction_9xy0(u32 X, u32 Y) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region A instruction branch
+
+	// ANNN - set I = NNN
+	void instruction_ANNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region B instruction branch
+
+	// BNNN - jump to NNN + V0
+	void instruction_BNNN(u32 NNN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region C instruction branch
+
+	// CXNN - set VX = rnd(256) & NN
+	void instruction_CxNN(u32 X, u32 NN) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region D instruction branch
+
+	void draw_pixel(u32 X, u32 Y, u32 P) noexcept;
+	void draw_byte(u32 X, u32 Y, u32 P, u32 DATA) noexcept;
+
+	enum Plane {
+		P0, P1, P2, P3,
+		P0M = 1 << P0,
+		P1M = 1 << P1,
+		P2M = 1 << P2,
+		P3M = 1 << P3,
+	};
+
+	// For planar mask N (0000 to 1111), count set bits
+	// to the right of bit (currently drawn plane) 0..3
+	static constexpr u8 c_plane_mask[4][16] = {
+		{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}, // Plane 0
+		{0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1}, // Plane 1
+		{0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2}, // Plane 2
+		{0,1,1,2,1,2,2,3,0,1,1,2,1,2,2,3}, // Plane 3
+	};
+
+	template <std::size_t P>
+	void draw_single_row(u32 X, u32 Y) noexcept;
+
+	template <std::size_t P>
+	void draw_double_row(u32 X, u32 Y) noexcept;
+
+	template <std::size_t P>
+	void draw_n_rows(u32 X, u32 Y, u32 N) noexcept;
+
+	// DXYN - draw N sprite rows at VX and VY
+	void instruction_DxyN(u32 X, u32 Y, u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region E instruction branch
+
+	// EX9E - skip next instruction if key VX down (p1)
+	void instruction_Ex9E(u32 X) noexcept;
+	// EXA1 - skip next instruction if key VX up (p1)
+	void instruction_ExA1(u32 X) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+/*==================================================================*/
+	#pragma region F instruction branch
+
+	// F000 - set I = NEXT NNNN then skip instruction
+	void instruction_F000() noexcept;
+	// F002 - load 16-byte audio pattern from RAM at I
+	void instruction_F002() noexcept;
+	// F100 - long jump to NEXT NNNN
+	void instruction_F100() noexcept;
+	// F200 - call long subroutine at NEXT NNNN
+	void instruction_F200() noexcept;
+	// F300 - long jump to NEXT NNNN + V0
+	void instruction_F300() noexcept;
+	// FN01 - set plane drawing to N
+	void instruction_FN01(u32 N) noexcept;
+	// FX03 - load 24-bit color X from RAM at I..I+2
+	void instruction_Fx03(u32 X) noexcept;
+	// FX07 - set VX = delay timer
+	void instruction_Fx07(u32 X) noexcept;
+	// FX0A - set VX = key, wait for keypress
+	void instruction_Fx0A(u32 X) noexcept;
+	// FX15 - set delay timer = VX
+	void instruction_Fx15(u32 X) noexcept;
+	// FX18 - set sound timer = VX
+	void instruction_Fx18(u32 X) noexcept;
+	// FX1E - set I = I + VX
+	void instruction_Fx1E(u32 X) noexcept;
+	// FX1F - set I = I - VX
+	void instruction_Fx1F(u32 X) noexcept;
+	// FX29 - set I to 5-byte hex sprite from VX
+	void instruction_Fx29(u32 X) noexcept;
+	// FX30 - set I to 10-byte hex sprite from VX
+	void instruction_Fx30(u32 X) noexcept;
+	// FX33 - store BCD of VX to RAM at I..I+2
+	void instruction_Fx33(u32 X) noexcept;
+	// FX3A - set sound pitch = VX
+	void instruction_Fx3A(u32 X) noexcept;
+	// FN55 - store V0..VN to RAM at I..I+N
+	void instruction_FN55(u32 N) noexcept;
+	// FN65 - load V0..VN from RAM at I..I+N
+	void instruction_FN65(u32 N) noexcept;
+	// FN75 - store V0..VN to the permanent regs
+	void instruction_FN75(u32 N) noexcept;
+	// FN85 - load V0..VN from the permanent regs
+	void instruction_FN85(u32 N) noexcept;
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+};
+
+#endif
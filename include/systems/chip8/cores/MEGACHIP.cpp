@@ -13,13 +13,27 @@ REGISTER_SYSTEM_CORE(MEGACHIP)
 
 /*==================================================================*/
 
-void MEGACHIP::initialize_system() noexcept {
+void MEGACHIP::load_memory_image() noexcept {
+	// without memory there is nothing to run, park the core on the error path
+	if (!m_memory.is_valid()) { m_interrupt = Interrupt::ERROR; return; }
+
 	copy_file_image_to(m_memory, c_game_load_pos);
 	copy_font_data_to(m_memory, 180);
 
+	m_memory.mark_dirty(c_game_load_pos, m_file_image.size());
+	m_memory.mark_dirty(c_small_font_offset, 180);
+}
+
+void MEGACHIP::initialize_system() noexcept {
+	if (!m_memory.is_valid()) {
+		blog.error("Unable to allocate {} bytes of system memory!", m_memory.size());
+	}
+
+	load_memory_image();
+
 	m_base_system_framerate = c_sys_refresh_rate;
 
-	m_memory_editor.set_memory_range(m_memory.data(), m_memory.size());
+	bind_system_memory(m_memory.data(), m_memory.size());
 
 	m_current_pc = c_sys_boot_pos;
 
@@ -36,8 +50,7 @@ void MEGACHIP::initialize_system() noexcept {
 void MEGACHIP::reset_system_data() noexcept {
 	m_memory.clear();
 
-	copy_file_image_to(m_memory, c_game_load_pos);
-	copy_font_data_to(m_memory, 180);
+	load_memory_image();
 
 	set_display_properties(Resolution::LO);
 
@@ -55,14 +68,20 @@ void MEGACHIP::reset_system_data() noexcept {
 	m_blend_mode = BlendMode::ALPHA_BLEND;
 }
 
+template <bool DEBUG>
 void MEGACHIP::instruction_loop() noexcept {
 	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
 		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
-	for (m_cycle_count = 0; m_interrupt == Interrupt::CLEAR
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
 		&& m_cycle_count < target_cpf; ++m_cycle_count)
 	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
 		const auto HI = m_memory[m_current_pc++];
 		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
 
 		#define _NNN ((HI << 8 | LO) & 0xFFF)
 		#define _X (HI & 0xF)
@@ -304,9 +323,16 @@ void MEGACHIP::instruction_loop() noexcept {
 				}
 				break;
 		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
 	}
 }
 
+void MEGACHIP::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void MEGACHIP::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
 void MEGACHIP::push_audio_data() noexcept {
 	if (use_manual_vsync()) {
 		mix_audio_data(
@@ -448,7 +474,7 @@ void MEGACHIP::scrap_all_video_buffers() noexcept {
 }
 
 void MEGACHIP::flush_all_video_buffers(bool by_blending, bool and_advance) noexcept {
-	m_display_device.swapchain().acquire([&](auto& frame) noexcept {
+	m_display_device.present([&](auto& frame) noexcept {
 		frame.metadata = m_display_device.metadata().copy();
 		if (by_blending) {
 			frame.copy_from(m_old_render_map, m_background_map, RGBA::alpha_blend);
@@ -469,19 +495,23 @@ void MEGACHIP::flush_all_video_buffers(bool by_blending, bool and_advance) noexc
 
 void MEGACHIP::start_audio_track(bool repeat) noexcept {
 	if (m_audio_device) {
-		auto* track_src = &m_memory[m_register_I];
+		// the header is read through the mirror, the track itself is then
+		// streamed by pointer, so it has to fit before the end of memory
+		const auto track_pos = m_register_I & (m_memory.size() - 1);
+		const auto header = [&](u32 offset) noexcept -> u32
+			{ return m_memory[track_pos + offset]; };
 
 		m_track.loop = repeat;
-		m_track.data = track_src + 6;
-		m_track.size = track_src[2] << 16
-					 | track_src[3] <<  8
-					 | track_src[4];
+		m_track.size = header(2) << 16
+					 | header(3) <<  8
+					 | header(4);
 
-		const bool oob = m_track.data + m_track.size > &m_memory.back();
+		const bool oob = track_pos + 6 + m_track.size > m_memory.size();
 		if (!m_track.size || oob) { m_track.reset(); }
 		else {
+			m_track.data = &m_memory[track_pos + 6];
 			m_voices[VOICE::UNIQUE].set_phase(0.0).set_step(
-				(track_src[0] << 8 | track_src[1]) \
+				(header(0) << 8 | header(1)) \
 				/ f64(m_track.size) / m_audio_device.get_freq());
 		}
 	}
@@ -594,9 +624,9 @@ void MEGACHIP::scroll_buffers_rt() noexcept {
 		::assign_cast_add(m_current_pc, 2);
 	}
 	void MEGACHIP::instruction_02NN(u32 NN) noexcept {
-		auto* src = &m_memory[m_register_I];
-		for (auto pos = 0u; pos < NN; src += 4) {
-			m_color_palette[++pos] = { src[1], src[2], src[3], src[0] };
+		for (auto pos = 0u, src = m_register_I; pos < NN; src += 4) {
+			m_color_palette[++pos] = { m_memory[src + 1],
+				m_memory[src + 2], m_memory[src + 3], m_memory[src + 0] };
 		}
 	}
 	void MEGACHIP::instruction_03NN(u32 NN) noexcept {
@@ -841,10 +871,10 @@ void MEGACHIP::scroll_buffers_rt() noexcept {
 
 			auto* collision_row = &m_collision_map(0, true_y);
 			auto* bg_buffer_row = &m_background_map(0, true_y);
-			auto* data_line_row = &m_memory[m_register_I + row * m_texture.w];
+			const auto data_line_row = m_register_I + row * m_texture.w;
 
 			for (auto col = 0u, true_x = x_begin; col < m_texture.w; ++col) {
-				if (const auto src_color_idx = data_line_row[col]) {
+				if (const auto src_color_idx = m_memory[data_line_row + col]) {
 					auto& collision_idx = collision_row[true_x];
 					auto& bg_buffer_idx = bg_buffer_row[true_x];
 
@@ -1026,9 +1056,11 @@ void MEGACHIP::scroll_buffers_rt() noexcept {
 		m_memory[m_register_I + 0] = bcd.digit[2];
 		m_memory[m_register_I + 1] = bcd.digit[1];
 		m_memory[m_register_I + 2] = bcd.digit[0];
+		mark_memory_written(m_register_I, 3);
 	}
 	void MEGACHIP::instruction_FN55(u32 N) noexcept {
 		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		mark_memory_written(m_register_I, N + 1);
 	}
 	void MEGACHIP::instruction_FN65(u32 N) noexcept {
 		for (auto i = 0u; i <= N; ++i) { m_registers_V[i] = m_memory[m_register_I + i]; }
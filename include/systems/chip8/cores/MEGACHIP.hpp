@@ -14,6 +14,7 @@
 #include "SystemDescriptor.hpp"
 #include "Map2D.hpp"
 #include "ArrayOps.hpp"
+#include "Aligned.hpp"
 
 /*==================================================================*/
 
@@ -52,15 +53,42 @@ public:
 
 /*==================================================================*/
 
-	MirroredMemory<c_sys_memory_size>
+	// mostly untouched by programs, so only the pages written are ever backed
+	SparseMirroredMemory<c_sys_memory_size>
 		m_memory{};
 
+	// reports a write to both the dirty page map and the memory write tracker
+	void mark_memory_written(u32 addr, u32 size) noexcept {
+		m_memory.mark_dirty(addr, size);
+		m_memory_writes.mark(addr, size);
+	}
+
+	void load_memory_image() noexcept;
+
+	void read_written_memory(std::vector<MemoryRange>& output) const noexcept override {
+		try {
+			m_memory.for_each_dirty_range([&](std::size_t offset, std::size_t size)
+				{ output.push_back({ offset, size }); });
+		}
+		catch (...) {}
+	}
+
 	std::array<u8, c_sys_screen_W/2 * c_sys_screen_H/3>
 		m_display_buffer{};
 
-	RGBA m_old_render_buffer[c_sys_screen_W * c_sys_screen_H];
-	RGBA m_background_buffer[c_sys_screen_W * c_sys_screen_H];
-	u8   m_collision_buffer[c_sys_screen_W * c_sys_screen_H];
+	// backing stores of the maps below, left for the emulation thread to first-touch
+	template <typename T>
+	using MapBuffer = AlignedUniqueArray<T, HDIS, AllocPolicy::FIRST_TOUCH>;
+
+	template <typename T>
+	static auto allocate_map_buffer() noexcept {
+		return ::allocate_n<T, HDIS, AllocPolicy::FIRST_TOUCH>
+			(c_sys_screen_W * c_sys_screen_H).as_value().release();
+	}
+
+	MapBuffer<RGBA> m_old_render_buffer;
+	MapBuffer<RGBA> m_background_buffer;
+	MapBuffer<u8>   m_collision_buffer;
 
 	Map2D<u8>   m_display_map;
 
@@ -128,16 +156,23 @@ public:
 	MEGACHIP() noexcept
 		: IFamily_CHIP8(c_sys_screen_W, c_sys_screen_H)
 		, m_display_map(m_display_buffer, c_sys_screen_W/2, c_sys_screen_H/3)
-		, m_old_render_map(m_old_render_buffer, c_sys_screen_W, c_sys_screen_H)
-		, m_background_map(m_background_buffer, c_sys_screen_W, c_sys_screen_H)
-		, m_collision_map(m_collision_buffer, c_sys_screen_W, c_sys_screen_H)
+		, m_old_render_buffer(allocate_map_buffer<RGBA>())
+		, m_background_buffer(allocate_map_buffer<RGBA>())
+		, m_collision_buffer(allocate_map_buffer<u8>())
+		, m_old_render_map(m_old_render_buffer.get(), c_sys_screen_W, c_sys_screen_H)
+		, m_background_map(m_background_buffer.get(), c_sys_screen_W, c_sys_screen_H)
+		, m_collision_map(m_collision_buffer.get(), c_sys_screen_W, c_sys_screen_H)
 	{}
 
 private:
 	void initialize_system() noexcept override final;
 	void reset_system_data() noexcept override final;
 
-	void instruction_loop() noexcept override final;
+	template <bool DEBUG>
+	void instruction_loop() noexcept;
+
+	void instruction_loop_fast()  noexcept override final;
+	void instruction_loop_debug() noexcept override final;
 
 	void push_audio_data() noexcept override final;
 	void push_video_data() noexcept override final;
@@ -22,7 +22,7 @@ void SCHIP_LEGACY::initialize_system() noexcept {
 
 	m_base_system_framerate = c_sys_refresh_rate;
 
-	m_memory_editor.set_memory_range(m_memory.data(), m_memory.size(), 0x8000);
+	bind_system_memory(m_memory.data(), m_memory.size(), 0x8000);
 
 	m_current_pc = c_sys_boot_pos;
 	m_standard_cpf = c_sys_speed_hi;
@@ -47,15 +47,21 @@ void SCHIP_LEGACY::reset_system_data() noexcept {
 	m_standard_cpf = c_sys_speed_hi;
 }
 
+template <bool DEBUG>
 void SCHIP_LEGACY::instruction_loop() noexcept {
 	m_standard_cpf = has_quirk(AWAIT_VBLANK) ? c_sys_speed_hi : c_sys_speed_lo;
 	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
 		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
-	for (m_cycle_count = 0; m_interrupt == Interrupt::CLEAR
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
 		&& m_cycle_count < target_cpf; ++m_cycle_count)
 	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
 		const auto HI = m_memory[m_current_pc++];
 		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
 
 		#define _NNN ((HI << 8 | LO) & 0xFFF)
 		#define _X (HI & 0xF)
@@ -225,9 +231,16 @@ void SCHIP_LEGACY::instruction_loop() noexcept {
 				}
 				break;
 		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
 	}
 }
 
+void SCHIP_LEGACY::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void SCHIP_LEGACY::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
 void SCHIP_LEGACY::push_audio_data() noexcept {
 	mix_audio_data(
 		[&](auto buffer) noexcept { make_pulse_wave(buffer, m_voices[VOICE::ID_0]); },
@@ -243,7 +256,7 @@ void SCHIP_LEGACY::push_audio_data() noexcept {
 }
 
 void SCHIP_LEGACY::push_video_data() noexcept {
-	m_display_device.swapchain().acquire([&](auto& frame) noexcept {
+	m_display_device.present([&](auto& frame) noexcept {
 		frame.metadata = m_display_device.metadata().copy();
 		frame.copy_from(m_display_map, use_pixel_trails()
 			? [](u32 pixel) noexcept { return RGBA::premul(s_bit_colors[pixel != 0], c_bit_weight[pixel]); }
@@ -601,9 +614,11 @@ void SCHIP_LEGACY::scroll_display_rt() noexcept {
 		m_memory[m_register_I + 0] = bcd.digit[2];
 		m_memory[m_register_I + 1] = bcd.digit[1];
 		m_memory[m_register_I + 2] = bcd.digit[0];
+		m_memory_writes.mark(m_register_I, 3);
 	}
 	void SCHIP_LEGACY::instruction_FN55(u32 N) noexcept {
 		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		m_memory_writes.mark(m_register_I, N + 1);
 		if (has_quirk(X1_INC_I_REG)) [[likely]] { ::assign_cast_add(m_register_I, N); }
 	}
 	void SCHIP_LEGACY::instruction_FN65(u32 N) noexcept {
@@ -21,7 +21,7 @@ void XOCHIP::initialize_system() noexcept {
 
 	m_base_system_framerate = c_sys_refresh_rate;
 
-	m_memory_editor.set_memory_range(m_memory.data(), m_memory.size());
+	bind_system_memory(m_memory.data(), m_memory.size());
 
 	set_pattern_pitch(64);
 
@@ -40,7 +40,7 @@ void XOCHIP::reset_system_data() noexcept {
 	m_memory.clear();
 
 	copy_file_image_to(m_memory, c_game_load_pos);
-	copy_font_data_to(m_memory, 80);
+	copy_font_data_to(m_memory, 240);
 
 	m_display_map[P0].fill().resize(
 		c_sys_screen_W/2, c_sys_screen_H/2);
@@ -60,14 +60,20 @@ void XOCHIP::reset_system_data() noexcept {
 	m_pulse_pattern_data = c_default_pattern_data;
 }
 
+template <bool DEBUG>
 void XOCHIP::instruction_loop() noexcept {
 	const auto target_cpf = has_cached_system_state(EmuState::BENCH)
 		&& m_debugger_cpf ? m_debugger_cpf : m_standard_cpf;
-	for (m_cycle_count = 0; m_interrupt == Interrupt::CLEAR
+	for (m_cycle_count = DEBUG ? m_debugger.begin_slice() : 0; m_interrupt == Interrupt::CLEAR
 		&& m_cycle_count < target_cpf; ++m_cycle_count)
 	{
+		if constexpr (DEBUG) {
+			if (m_debugger.break_before(m_current_pc, m_cycle_count)) { break; }
+		}
+
 		const auto HI = m_memory[m_current_pc++];
 		const auto LO = m_memory[m_current_pc++];
+		if constexpr (DEBUG) { note_debug_opcode(HI, LO); }
 
 		#define _NNN ((HI << 8 | LO) & 0xFFF)
 		#define _X (HI & 0xF)
@@ -268,9 +274,16 @@ void XOCHIP::instruction_loop() noexcept {
 				}
 				break;
 		}
+
+		if constexpr (DEBUG) {
+			if (m_debugger.break_after(m_current_pc, m_cycle_count + 1)) { ++m_cycle_count; break; }
+		}
 	}
 }
 
+void XOCHIP::instruction_loop_fast()  noexcept { instruction_loop<false>(); }
+void XOCHIP::instruction_loop_debug() noexcept { instruction_loop<true>(); }
+
 void XOCHIP::push_audio_data() noexcept {
 	mix_audio_data(
 		[&](auto buffer) noexcept { make_pattern_wave(buffer, m_voices[VOICE::UNIQUE], m_pulse_pattern_data); },
@@ -316,7 +329,7 @@ void XOCHIP::push_video_data() noexcept {
 		);
 	}
 
-	m_display_device.swapchain().acquire([&](auto& frame) noexcept {
+	m_display_device.present([&](auto& frame) noexcept {
 		frame.metadata = m_display_device.metadata().copy();
 		frame.copy_from(composite_buffer, [&](auto pixel) noexcept { return get_bit_color(pixel); });
 	});
@@ -325,7 +338,7 @@ void XOCHIP::push_video_data() noexcept {
 void XOCHIP::set_pattern_pitch(s32 pitch) noexcept {
 	if (m_audio_device) {
 		m_voices[VOICE::UNIQUE].set_step(std::bit_cast<f32>(
-			c_pitch_frequency_lut[pitch]) / m_audio_device.get_freq());
+			xochip_tables::c_pitch_frequency_lut[pitch]) / m_audio_device.get_freq());
 	}
 }
 
@@ -486,6 +499,7 @@ void XOCHIP::scroll_display_rt() noexcept {
 				m_memory[m_register_I + (X - i)] = m_registers_V[i];
 			}
 		}
+		m_memory_writes.mark(m_register_I, (X < Y ? Y - X : X - Y) + 1);
 	}
 	void XOCHIP::instruction_5xy3(u32 X, u32 Y) noexcept {
 		if (X < Y) {
@@ -501,11 +515,11 @@ void XOCHIP::scroll_display_rt() noexcept {
 	void XOCHIP::instruction_5xy4(u32 X, u32 Y) noexcept {
 		if (X < Y) {
 			for (auto i = s32(X); i <= s32(Y); ++i) {
-				m_bit_colors[i] = c_color_palette[m_memory[m_register_I + (i - X)]];
+				m_bit_colors[i] = xochip_tables::c_color_palette[m_memory[m_register_I + (i - X)]];
 			}
 		} else {
 			for (auto i = s32(X); i >= s32(Y); --i) {
-				m_bit_colors[i] = c_color_palette[m_memory[m_register_I + (X - i)]];
+				m_bit_colors[i] = xochip_tables::c_color_palette[m_memory[m_register_I + (X - i)]];
 			}
 		}
 	}
@@ -777,12 +791,14 @@ void XOCHIP::scroll_display_rt() noexcept {
 		m_memory[m_register_I + 0] = bcd.digit[2];
 		m_memory[m_register_I + 1] = bcd.digit[1];
 		m_memory[m_register_I + 2] = bcd.digit[0];
+		m_memory_writes.mark(m_register_I, 3);
 	}
 	void XOCHIP::instruction_Fx3A(u32 X) noexcept {
 		set_pattern_pitch(m_registers_V[X]);
 	}
 	void XOCHIP::instruction_FN55(u32 N) noexcept {
 		for (auto i = 0u; i <= N; ++i) { m_memory[m_register_I + i] = m_registers_V[i]; }
+		m_memory_writes.mark(m_register_I, N + 1);
 		if (!has_quirk(NO_INC_I_REG)) [[likely]] { ::assign_cast_add(m_register_I, N + 1); }
 	}
 	void XOCHIP::instruction_FN65(u32 N) noexcept {
@@ -0,0 +1,119 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "IFamily_COSMAC.hpp"
+
+#ifdef ENABLE_COSMAC_SYSTEM
+
+#include "BasicLogger.hpp"
+#include "BasicInput.hpp"
+#include "SimpleFileIO.hpp"
+#include "ZoneProfiler.hpp"
+
+/*==================================================================*/
+
+IFamily_COSMAC::IFamily_COSMAC(std::size_t W, std::size_t H) noexcept
+	: ISystemEmu(family_pretty_name)
+	, m_display_window({ "Display", make_system_id(instance_id, "display") })
+	, m_display_device(W, H, UserInterface::get_current_renderer())
+{
+	prepare_user_interface();
+	load_preset_binds();
+
+	m_audio_device.init_stream(0, 1);
+	m_audio_device.resume();
+}
+
+void IFamily_COSMAC::initialize_family() noexcept {
+	if (calc_file_image_sha1()) {
+		if (auto* path = add_system_path("savestate", family_name)) {
+			m_savestate_path = (fs::Path(*path) / m_file_sha1_hash).string();
+		} else {
+			blog.error("Unable to create savestate directory for system '{}', "
+				"savestates will be unavailable!", family_pretty_name);
+		}
+	}
+
+	if (auto* path = add_system_path("captures", family_name)) {
+		m_display_device.set_capture_directory(*path, get_system_id());
+	}
+
+	if (auto* path = add_system_path("firmware", family_name)) {
+		m_firmware_path = *path;
+	} else {
+		blog.error("Unable to create firmware directory for system '{}', "
+			"firmware images cannot be loaded!", family_pretty_name);
+	}
+}
+
+bool IFamily_COSMAC::load_firmware(std::string_view file_name, std::span<u8> output) noexcept {
+	if (m_firmware_path.empty()) { return false; }
+
+	const auto file_path = fs::Path(m_firmware_path) / file_name;
+	const auto file_data = ::read_file_data(file_path);
+
+	if (!file_data) {
+		blog.error("Unable to load firmware '{}': {}",
+			file_path.string(), file_data.error().message());
+		return false;
+	}
+	if (file_data->empty() || file_data->size() > output.size()) {
+		blog.error("Unable to load firmware '{}': expected up to {} bytes, found {}",
+			file_path.string(), output.size(), file_data->size());
+		return false;
+	}
+
+	std::fill(output.begin(), output.end(), u8{});
+	std::copy(file_data->begin(), file_data->end(), output.begin());
+	return true;
+}
+
+/*==================================================================*/
+
+void IFamily_COSMAC::main_system_loop() {
+	if (has_cached_system_state(EmuState::ANY_PAUSE)) {
+		push_audio_data();
+		return;
+	}
+
+	{
+		PROFILE_ZONE("handle_cycle_loop");
+		handle_cycle_loop();
+	}
+	if (m_debugger.is_mid_frame()) {
+		// stopped mid-frame, show the partial frame but hold off the frame end
+		if (should_push_video()) { push_video_data(); }
+		create_statistics_data();
+		return;
+	}
+	{
+		PROFILE_ZONE("push_audio_data");
+		push_audio_data();
+	}
+	if (should_push_video()) {
+		PROFILE_ZONE("push_video_data");
+		push_video_data();
+	}
+	create_statistics_data();
+}
+
+void IFamily_COSMAC::load_preset_binds() noexcept {
+	static constexpr auto _ = SDL_SCANCODE_UNKNOWN;
+	static constexpr SimpleKeyMapping default_key_mappings[]{
+		{0x1, KEY(1), _}, {0x2, KEY(2), _}, {0x3, KEY(3), _}, {0xC, KEY(4), _},
+		{0x4, KEY(Q), _}, {0x5, KEY(W), _}, {0x6, KEY(E), _}, {0xD, KEY(R), _},
+		{0x7, KEY(A), _}, {0x8, KEY(S), _}, {0x9, KEY(D), _}, {0xE, KEY(F), _},
+		{0xA, KEY(Z), _}, {0x0, KEY(X), _}, {0xB, KEY(C), _}, {0xF, KEY(V), _},
+	};
+
+	load_custom_binds(std::span(default_key_mappings));
+}
+
+u32  IFamily_COSMAC::get_key_states() noexcept {
+	return poll_bind_states();
+}
+
+#endif
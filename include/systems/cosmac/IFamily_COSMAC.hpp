@@ -0,0 +1,89 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#define ENABLE_COSMAC_SYSTEM
+#ifdef ENABLE_COSMAC_SYSTEM
+
+#include <array>
+#include <span>
+
+#include "../ISystemEmu.hpp"
+
+#include "AudioDevice.hpp"
+#include "Voice.hpp"
+#include "DisplayDevice.hpp"
+
+/*==================================================================*/
+
+class IFamily_COSMAC : public ISystemEmu {
+	void prepare_user_interface() noexcept;
+
+protected:
+	static constexpr std::string_view family_pretty_name = "COSMAC";
+	static constexpr std::string_view family_name = "cosmac";
+	static constexpr std::string_view family_desc = "RCA COSMAC (CDP1802) family line.";
+	using Family = IFamily_COSMAC;
+
+	std::string m_savestate_path{};
+	std::string m_firmware_path{};
+
+	enum STREAM { MAIN };
+	enum VOICE { BUZZER, COUNT };
+
+protected:
+	WindowHost    m_display_window;
+	DisplayDevice m_display_device;
+
+public:
+	DisplayDevice* get_display_device() noexcept override final { return &m_display_device; }
+
+protected:
+	AudioDevice   m_audio_device;
+
+	std::array<Voice, VOICE::COUNT>
+		m_voices{};
+
+protected:
+	u32  get_key_states() noexcept;
+	void load_preset_binds() noexcept;
+
+	template <IsContiguousContainer T>
+		requires (SameValueTypes<T, decltype(m_custom_binds)>)
+	void load_custom_binds(const T& binds) {
+		m_custom_binds.assign(std::begin(binds), std::end(binds));
+	}
+
+	/**
+	 * @brief Reads a firmware image from the family's firmware directory in the
+	 *        home path. These are not distributed, the user has to supply them.
+	 * @return False (and logs why) if the file is missing, empty or too large.
+	 */
+	bool load_firmware(std::string_view file_name, std::span<u8> output) noexcept;
+
+	virtual void handle_cycle_loop() noexcept = 0;
+	virtual void push_audio_data() noexcept = 0;
+	virtual void push_video_data() noexcept = 0;
+
+protected:
+	IFamily_COSMAC(std::size_t W, std::size_t H) noexcept;
+	virtual u32 get_program_counter() const noexcept = 0;
+
+private:
+	void initialize_family() noexcept override final;
+	void reset_family_data() noexcept override final {}
+
+public:
+	void main_system_loop() override final;
+
+protected:
+	static constexpr std::array<RGBA, 2> c_bit_colors = {
+		0x000000FF, 0xFFFFFFFF,
+	};
+};
+
+#endif
@@ -0,0 +1,539 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "COSMAC_VIP.hpp"
+#if defined(ENABLE_COSMAC_SYSTEM) && defined(ENABLE_COSMAC_VIP)
+
+#include <utility>
+#include <algorithm>
+
+#include "AssignCast.hpp"
+#include "BasicLogger.hpp"
+#include "CoreRegistry.inl"
+
+REGISTER_SYSTEM_CORE(COSMAC_VIP)
+
+/*==================================================================*/
+
+void COSMAC_VIP::initialize_system() noexcept {
+	m_firmware_ready = load_firmware(c_monitor_file,
+		std::span(m_monitor_rom.data(), m_monitor_rom.size()))
+		&& load_firmware(c_interpreter_file, m_interpreter);
+
+	if (!m_firmware_ready) {
+		blog.error("System '{}' requires '{}' and '{}' in its firmware directory: '{}'",
+			descriptor.system_pretty_name, c_monitor_file, c_interpreter_file, m_firmware_path);
+		// raised right away too, so hosts can tell the core never started
+		add_system_state(EmuState::FATAL);
+	}
+
+	power_on();
+
+	m_base_system_framerate = c_sys_refresh_rate;
+
+	if (m_audio_device) {
+		m_voices[VOICE::BUZZER].set_step(c_buzzer_tone / m_audio_device.get_freq());
+	}
+
+	bind_system_memory(m_memory.data(), m_memory.size());
+
+	m_display_device.metadata().edit([](auto& meta) noexcept {
+		meta.minimum_zoom = 4;
+		meta.inner_margin = 4;
+		meta.texture_tint = c_bit_colors[0];
+		// the 1861 draws 128 lines of 64 wide pixels each
+		meta.pixel_ratio  = 4.0f;
+		meta.enabled = true;
+	});
+}
+
+void COSMAC_VIP::reset_system_data() noexcept {
+	power_on();
+}
+
+void COSMAC_VIP::power_on() noexcept {
+	m_memory.clear();
+	std::copy(m_interpreter.begin(), m_interpreter.end(), m_memory.data());
+	copy_file_image_to(m_memory, c_game_load_pos);
+
+	m_display_map.fill(0);
+
+	// the monitor ROM runs first, handing over to the interpreter at 0x0000
+	m_registers.fill(0);
+	m_d  = m_t = 0;
+	m_p  = m_x = 0;
+	m_df = false;
+	m_ie = true;
+	m_q  = false;
+	m_idle = false;
+	m_rom_overlay = true;
+
+	m_display_on = false;
+	m_int_line   = false;
+	m_key_latch  = 0;
+
+	m_cycles      = 0;
+	m_frame_start = 0;
+	m_frame_end   = 0;
+	m_vdc_next    = c_never;
+	m_q_since     = 0;
+	m_q_cycles    = 0;
+	refresh_next_event();
+
+	m_voices[VOICE::BUZZER].timer.reset();
+}
+
+/*==================================================================*/
+	#pragma region I/O and Flags
+
+	bool COSMAC_VIP::get_display_flag() const noexcept {
+		if (!m_display_on) { return false; }
+
+		const auto line = u32((m_cycles - m_frame_start) / c_sys_line_time);
+		// raised for the 4 lines leading into the display area, and the last 4 within it
+		return (line - c_vdc_flag_top    < 4)
+			|| (line - c_vdc_flag_bottom < 4);
+	}
+
+	bool COSMAC_VIP::get_input_flag(u32 N) const noexcept {
+		switch (N) {
+			case 0: return get_display_flag(); // EF1
+			case 2: return m_key_states >> m_key_latch & 1; // EF3
+			default: return false; // EF2 is the cassette input, EF4 unused
+		}
+	}
+
+	void COSMAC_VIP::output_port(u32 N, u8 value) noexcept {
+		switch (N) {
+			case 1: m_display_on = false; break;
+			case 2: m_key_latch = value & 0xF; break;
+		}
+	}
+
+	u8   COSMAC_VIP::input_port(u32 N) noexcept {
+		if (N == 1) { m_display_on = true; }
+		// nothing drives the data bus, it floats high
+		return 0xFF;
+	}
+
+	void COSMAC_VIP::set_q(bool state) noexcept {
+		if (m_q == state) { return; }
+
+		if (m_q) { m_q_cycles += m_cycles - std::min(m_q_since, m_cycles); }
+		else     { m_q_since = m_cycles; }
+		m_q = state;
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region Video Chip
+
+	void COSMAC_VIP::schedule_vdc_line(u32 line) noexcept {
+		m_vdc_line = line;
+		m_vdc_next = m_frame_start + line * c_sys_line_time
+			+ (line >= c_vdc_display_line ? c_vdc_dma_offset : 0);
+	}
+
+	void COSMAC_VIP::transfer_dma_row() noexcept {
+		auto* row = &m_display_map[(m_vdc_line - c_vdc_display_line) * c_sys_screen_W];
+
+		for (auto i = 0u; i < c_vdc_dma_length; ++i) {
+			const auto value = read_byte(m_registers[0]++);
+			for (auto bit = 0u; bit < 8; ++bit) {
+				*row++ = value >> (7 - bit) & 1;
+			}
+		}
+
+		// the CPU is held off for the whole transfer, it also ends an IDL
+		m_cycles += c_vdc_dma_length;
+		m_idle = false;
+		++m_dma_rows;
+	}
+
+	void COSMAC_VIP::handle_vdc_event() noexcept {
+		if (m_vdc_line == c_vdc_int_line) {
+			m_int_line = m_display_on;
+			schedule_vdc_line(c_vdc_display_line);
+		} else {
+			m_int_line = false;
+			if (m_display_on) { transfer_dma_row(); }
+
+			if (m_vdc_line + 1 < c_vdc_display_line + c_sys_screen_H)
+				{ schedule_vdc_line(m_vdc_line + 1); }
+			else { m_vdc_next = c_never; }
+		}
+		refresh_next_event();
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region CPU Core
+
+	void COSMAC_VIP::service_interrupt() noexcept {
+		m_t  = u8(m_x << 4 | m_p);
+		m_p  = 1;
+		m_x  = 2;
+		m_ie = false;
+		m_idle = false;
+		m_cycles += 1;
+	}
+
+	void COSMAC_VIP::step_cpu() noexcept {
+		if (m_int_line && m_ie) [[unlikely]] {
+			service_interrupt();
+			return;
+		}
+
+		if (m_idle) [[unlikely]] {
+			// only a DMA transfer or an interrupt can wake the CPU
+			m_cycles = m_next_event;
+			return;
+		}
+
+		s_instruction_table[fetch_byte()](*this);
+	}
+
+	template <bool DEBUG>
+	void COSMAC_VIP::handle_cycle_loop() noexcept {
+		if (!m_firmware_ready) [[unlikely]] {
+			add_system_state(EmuState::FATAL);
+			return;
+		}
+
+		if (!(DEBUG ? m_debugger.begin_slice() : 0u)) {
+			m_key_states  = get_key_states();
+			m_frame_start = m_frame_end;
+			m_frame_end   = m_frame_start + c_sys_frame_time;
+			m_frame_step  = 0;
+			m_dma_rows    = 0;
+			m_q_cycles    = 0;
+			schedule_vdc_line(c_vdc_int_line);
+			refresh_next_event();
+		}
+
+		while (m_cycles < m_frame_end) {
+			// run uninterrupted up to the next interrupt or DMA request
+			while (m_cycles < m_next_event) {
+				if constexpr (DEBUG) {
+					if (m_debugger.break_before(get_program_counter(), m_frame_step)) { return; }
+				}
+
+				step_cpu();
+
+				if constexpr (DEBUG) {
+					if (m_debugger.break_after(get_program_counter(), ++m_frame_step)) { return; }
+				}
+			}
+			if (m_cycles >= m_vdc_next) { handle_vdc_event(); }
+		}
+
+		if (m_q) {
+			m_q_cycles += m_frame_end - std::min(m_q_since, m_frame_end);
+			m_q_since   = m_frame_end;
+		}
+		// the interpreter holds Q for whole frames, shorter blips are inaudible anyway
+		m_voices[VOICE::BUZZER].timer.set(m_q_cycles * 2 >= c_sys_frame_time);
+
+		if (!m_dma_rows) { m_display_map.fill(0); }
+	}
+
+	void COSMAC_VIP::handle_cycle_loop() noexcept {
+		// the debug loop also finishes a frame that a stop left half-done
+		if (has_cached_system_state(EmuState::DEBUG) || m_debugger.is_mid_frame())
+			[[unlikely]] { handle_cycle_loop<true>(); }
+		else { handle_cycle_loop<false>(); }
+	}
+
+	void COSMAC_VIP::push_audio_data() noexcept {
+		auto& voice = m_voices[VOICE::BUZZER];
+
+		if (m_audio_device) {
+			m_audio_device.set_freq_ratio(m_framerate_multiplier);
+
+			auto buffer = allocate_n<f32>(
+				m_audio_device.next_frame_sample_count(get_real_system_framerate())
+			).as_value().release_as_container();
+
+			if (!has_cached_system_state(EmuState::ANY_PAUSE)) {
+				const auto sample_count = u32(buffer.size());
+				const auto fade_step = ::calc_fade_step(sample_count);
+
+				for (auto i = 0u; i < sample_count; ++i) {
+					if (const auto gain = voice.get_level(i, voice.timer, fade_step)) {
+						::assign_cast(buffer[i], WaveForms::pulse(voice.peek_phase(i)) * gain);
+					}
+					else break;
+				}
+				voice.step_phase(sample_count);
+			}
+
+			m_audio_device.push_audio_data(buffer);
+		}
+
+		if (has_cached_system_state(EmuState::ANY_PAUSE)) { return; }
+		m_display_device.metadata().edit([&](auto& meta) noexcept {
+			meta.set_border_color_if(!!voice.timer, c_bit_colors[1]);
+		});
+	}
+
+	void COSMAC_VIP::push_video_data() noexcept {
+		m_display_device.present([&](auto& frame) noexcept {
+			frame.metadata = m_display_device.metadata().copy();
+			frame.copy_from(m_display_map,
+				[](const auto pixel) noexcept { return c_bit_colors[pixel]; }
+			);
+		});
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region Introspection
+
+	void COSMAC_VIP::read_register_file(std::vector<RegisterValue>& output) const noexcept {
+		static constexpr std::string_view c_names_R[] = {
+			"R0", "R1", "R2", "R3", "R4", "R5", "R6", "R7",
+			"R8", "R9", "RA", "RB", "RC", "RD", "RE", "RF",
+		};
+
+		try {
+			output.push_back({ "PC", get_program_counter() });
+			output.push_back({ "D",  m_d });
+			output.push_back({ "DF", m_df });
+			output.push_back({ "P",  m_p });
+			output.push_back({ "X",  m_x });
+			output.push_back({ "T",  m_t });
+			output.push_back({ "IE", m_ie });
+			output.push_back({ "Q",  m_q });
+
+			for (u32 i = 0; i < 16; ++i) { output.push_back({ c_names_R[i], m_registers[i] }); }
+		} catch (...) { /* partial output is still useful */ }
+	}
+
+	u32  COSMAC_VIP::disassemble(u32 addr, std::string& output) const noexcept {
+		static constexpr std::string_view c_short_branches[] = {
+			"br",  "bq",  "bz",  "bdf", "b1",  "b2",  "b3",  "b4",
+			"skp", "bnq", "bnz", "bnf", "bn1", "bn2", "bn3", "bn4",
+		};
+		static constexpr std::string_view c_long_branches[] = {
+			"lbr",  "lbq",  "lbz",  "lbdf", "nop",  "lsnq", "lsnz", "lsnf",
+			"lskp", "lbnq", "lbnz", "lbnf", "lsie", "lsq",  "lsz",  "lsdf",
+		};
+		static constexpr std::string_view c_group_7[] = {
+			"ret",  "dis",  "ldxa", "stxd", "adc",  "sdb",  "shrc", "smb",
+			"sav",  "mark", "req",  "seq",  "adci", "sdbi", "shlc", "smbi",
+		};
+		static constexpr std::string_view c_group_F[] = {
+			"ldx",  "or",   "and",  "xor",  "add",  "sd",   "shr",  "sm",
+			"ldi",  "ori",  "ani",  "xri",  "adi",  "sdi",  "shl",  "smi",
+		};
+		static constexpr std::string_view c_register_ops[] = {
+			"ldn",  "inc",  "dec",  "",     "lda",  "str",  "",     "",
+			"glo",  "ghi",  "plo",  "phi",  "",     "sep",  "sex",  "",
+		};
+
+		const auto read = [&](u32 offset) noexcept { return u32(peek_byte((addr + offset) & 0xFFFF)); };
+
+		const auto OP = read(0);
+		const auto I = OP >> 4, N = OP & 0xF;
+
+		u32 size = 1;
+
+		try {
+			const auto format = [&]<typename... Args>(fmt::format_string<Args...> text, Args&&... args) {
+				output = fmt::format(text, std::forward<Args>(args)...);
+			};
+
+			switch (I) {
+				case 0x3:
+					format("{} 0x{:04X}", c_short_branches[N], ((addr + 1) & 0xFF00) | read(1));
+					size = 2;
+					break;
+				case 0x6:
+					if      (N == 0) { format("irx"); }
+					else if (N <  8) { format("out {}", N); }
+					else             { format("inp {}", N & 7); }
+					break;
+				case 0x7:
+					if (N >= 0xC && N != 0xE) {
+						format("{} 0x{:02X}", c_group_7[N], read(1));
+						size = 2;
+					}
+					else { format("{}", c_group_7[N]); }
+					break;
+				case 0xC:
+					if (N & 0x4) { format("{}", c_long_branches[N]); }
+					else {
+						format("{} 0x{:04X}", c_long_branches[N], read(1) << 8 | read(2));
+						size = 3;
+					}
+					break;
+				case 0xF:
+					if (N >= 0x8 && N != 0xE) {
+						format("{} 0x{:02X}", c_group_F[N], read(1));
+						size = 2;
+					}
+					else { format("{}", c_group_F[N]); }
+					break;
+				default:
+					if (OP == 0x00) { format("idl"); }
+					else { format("{} r{:X}", c_register_ops[I], N); }
+					break;
+			}
+		} catch (...) { output.clear(); }
+
+		return size;
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region Instructions
+
+	template <u32 CC>
+	bool COSMAC_VIP::test_condition() const noexcept {
+		static constexpr bool INVERT = CC & 0x8;
+
+		bool state;
+		if      constexpr ((CC & 7) == 0) { state = true; }
+		else if constexpr ((CC & 7) == 1) { state = m_q; }
+		else if constexpr ((CC & 7) == 2) { state = !m_d; }
+		else if constexpr ((CC & 7) == 3) { state = m_df; }
+		else { state = get_input_flag(CC & 3); }
+
+		return state != INVERT;
+	}
+
+	template <u32 OP>
+	void COSMAC_VIP::alu_operation(u8 value) noexcept {
+		// the subtractions add the complement, so DF ends up set when nothing was borrowed
+		static constexpr bool WITH_CARRY = (OP >> 4) == 0x7;
+		const u32 carry_in = WITH_CARRY ? m_df : 1;
+
+		if      constexpr ((OP & 7) == 1) { m_d |= value; }
+		else if constexpr ((OP & 7) == 2) { m_d &= value; }
+		else if constexpr ((OP & 7) == 3) { m_d ^= value; }
+		else {
+			u32 result;
+			if      constexpr ((OP & 7) == 4) { result = m_d + value + (WITH_CARRY ? m_df : 0); }
+			else if constexpr ((OP & 7) == 5) { result = value + (m_d ^ 0xFF) + carry_in; }
+			else                              { result = m_d + (value ^ 0xFF) + carry_in; }
+
+			m_d  = u8(result);
+			m_df = result > 0xFF;
+		}
+	}
+
+	template <u32 OP>
+	void COSMAC_VIP::instruction() noexcept {
+		static constexpr u32 I = OP >> 4, N = OP & 0xF;
+
+		if constexpr (I == 0x0) {
+			if constexpr (N == 0) { m_idle = true; } // IDL
+			else { m_d = read_byte(m_registers[N]); } // LDN
+		}
+		else if constexpr (I == 0x1) { ++m_registers[N]; } // INC
+		else if constexpr (I == 0x2) { --m_registers[N]; } // DEC
+		else if constexpr (I == 0x3) { // short branches stay within the page of their operand
+			auto& pc = get_pc();
+			if (test_condition<N>()) { pc = u16((pc & 0xFF00) | read_byte(pc)); }
+			else { ++pc; }
+		}
+		else if constexpr (I == 0x4) { m_d = read_byte(m_registers[N]++); } // LDA
+		else if constexpr (I == 0x5) { write_byte(m_registers[N], m_d); } // STR
+		else if constexpr (I == 0x6) {
+			if constexpr (N == 0) { ++get_rx(); } // IRX
+			else if constexpr (N < 8) { // OUT
+				const auto value = read_byte(get_rx()++);
+				output_port(N, value);
+			}
+			else { // INP, 0x68 is undefined on the 1802 and selects no port
+				m_d = input_port(N & 7);
+				write_byte(get_rx(), m_d);
+			}
+		}
+		else if constexpr (I == 0x7) {
+			if constexpr (N == 0x0 || N == 0x1) { // RET, DIS
+				const auto value = read_byte(get_rx()++);
+				m_x  = value >> 4;
+				m_p  = value & 0xF;
+				m_ie = N == 0x0;
+			}
+			else if constexpr (N == 0x2) { m_d = read_byte(get_rx()++); } // LDXA
+			else if constexpr (N == 0x3) { write_byte(get_rx()--, m_d); } // STXD
+			else if constexpr (N == 0x6) { // SHRC
+				const bool carry = m_d & 1;
+				m_d  = u8(m_d >> 1 | m_df << 7);
+				m_df = carry;
+			}
+			else if constexpr (N == 0x8) { write_byte(get_rx(), m_t); } // SAV
+			else if constexpr (N == 0x9) { // MARK
+				m_t = u8(m_x << 4 | m_p);
+				write_byte(m_registers[2]--, m_t);
+				m_x = m_p;
+			}
+			else if constexpr (N == 0xA || N == 0xB) { set_q(N == 0xB); } // REQ, SEQ
+			else if constexpr (N == 0xE) { // SHLC
+				const bool carry = m_d >> 7;
+				m_d  = u8(m_d << 1 | m_df);
+				m_df = carry;
+			}
+			else if constexpr (N < 0x8) { alu_operation<OP>(read_byte(get_rx())); } // ADC, SDB, SMB
+			else { alu_operation<OP>(fetch_byte()); } // ADCI, SDBI, SMBI
+		}
+		else if constexpr (I == 0x8) { m_d = u8(m_registers[N]); } // GLO
+		else if constexpr (I == 0x9) { m_d = u8(m_registers[N] >> 8); } // GHI
+		else if constexpr (I == 0xA) { m_registers[N] = u16((m_registers[N] & 0xFF00) | m_d); } // PLO
+		else if constexpr (I == 0xB) { m_registers[N] = u16((m_registers[N] & 0x00FF) | m_d << 8); } // PHI
+		else if constexpr (I == 0xC) { // long branches and skips take an extra machine cycle
+			auto& pc = get_pc();
+			if constexpr (N == 0x4) {} // NOP
+			else if constexpr (N == 0xC) { if (m_ie) { pc += 2; } } // LSIE
+			else if constexpr (N & 0x4) { // long skips test the opposite polarity of their branch
+				if (test_condition<(N & 0x3) | (~N & 0x8)>()) { pc += 2; }
+			}
+			else if (test_condition<N>()) {
+				const auto hi = read_byte(pc);
+				pc = u16(hi << 8 | read_byte(pc + 1));
+			}
+			else { pc += 2; }
+			m_cycles += 1;
+		}
+		else if constexpr (I == 0xD) { m_p = N; } // SEP
+		else if constexpr (I == 0xE) { m_x = N; } // SEX
+		else {
+			if constexpr (N == 0x0) { m_d = read_byte(get_rx()); } // LDX
+			else if constexpr (N == 0x8) { m_d = fetch_byte(); } // LDI
+			else if constexpr (N == 0x6) { m_df = m_d & 1;  m_d = u8(m_d >> 1); } // SHR
+			else if constexpr (N == 0xE) { m_df = m_d >> 7; m_d = u8(m_d << 1); } // SHL
+			else if constexpr (N < 0x8) { alu_operation<OP>(read_byte(get_rx())); }
+			else { alu_operation<OP>(fetch_byte()); }
+		}
+
+		m_cycles += 2;
+	}
+
+	const std::array<COSMAC_VIP::Instruction, 256>
+		COSMAC_VIP::s_instruction_table = []<u32... OP>
+		(std::integer_sequence<u32, OP...>) noexcept {
+			return std::array<Instruction, 256>{ +[](COSMAC_VIP& self) noexcept
+				{ self.instruction<OP>(); }... };
+		}(std::make_integer_sequence<u32, 256>{});
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+#endif
@@ -0,0 +1,217 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "../IFamily_COSMAC.hpp"
+
+#define ENABLE_COSMAC_VIP
+#if defined(ENABLE_COSMAC_SYSTEM) && defined(ENABLE_COSMAC_VIP)
+
+#include "SystemDescriptor.hpp"
+#include "ArrayOps.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief RCA COSMAC VIP: a CDP1802 CPU, a CDP1861 video chip fed by DMA, and the
+ *        hex keypad, running the original 1977 CHIP-8 interpreter out of RAM with
+ *        the program loaded after it. Neither the monitor ROM nor the interpreter
+ *        are distributed, both are loaded from the family's firmware directory.
+ *
+ * Time is kept in machine cycles (8 clocks). DMA happens between instructions as
+ * on the real CPU, so each display line's 8 bytes are transferred in one go.
+ */
+class COSMAC_VIP final : public IFamily_COSMAC {
+	static constexpr u64 c_sys_memory_size = 4_KiB;
+	static constexpr u64 c_sys_rom_size    = 512;
+
+	// 1.76064 MHz clock, machine cycles are 8 clocks each
+	static constexpr u32 c_sys_cycle_rate  = 1'760'640 / 8;
+	static constexpr u32 c_sys_line_time   = 14;
+	static constexpr u32 c_sys_frame_lines = 262;
+	static constexpr u32 c_sys_frame_time  = c_sys_line_time * c_sys_frame_lines;
+
+	static constexpr f32 c_sys_refresh_rate = f32(c_sys_cycle_rate) / c_sys_frame_time;
+
+	// CDP1861 timing, in lines from the top of the frame
+	static constexpr u32 c_vdc_int_line     = 78;
+	static constexpr u32 c_vdc_display_line = 80;
+	static constexpr u32 c_vdc_flag_top     = 76;
+	static constexpr u32 c_vdc_flag_bottom  = 204;
+	static constexpr u32 c_vdc_dma_offset   = 2; // cycles into a display line
+	static constexpr u32 c_vdc_dma_length   = 8;
+
+	static constexpr u32 c_sys_screen_W = 64;
+	static constexpr u32 c_sys_screen_H = 128;
+
+	static constexpr u32 c_game_load_pos = 0x200;
+	static constexpr u32 c_game_max_size = 0xEA0 - c_game_load_pos; // stack, work area and display above
+
+	static constexpr f32 c_buzzer_tone = 1400.0f; // approximately, it's an RC oscillator
+
+	static constexpr std::string_view c_monitor_file     = "vip_monitor.bin";
+	static constexpr std::string_view c_interpreter_file = "vip_chip8.bin";
+
+	static constexpr std::string_view c_supported_extensions[] = { ".ch8" };
+
+	static constexpr const char* validate_program(std::span<const char> file) noexcept {
+		if (file.empty()) { return "empty file"; }
+		return (file.size() <= c_game_max_size)
+			? nullptr : "file too large";
+	}
+
+public:
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"COSMAC VIP", "cosmac_vip", "COSMAC VIP running the original CHIP-8 interpreter.",
+		c_supported_extensions, validate_program
+	};
+
+	const SystemDescriptor& get_descriptor() const noexcept override {
+		return descriptor;
+	}
+
+/*==================================================================*/
+
+private:
+	static constexpr u64 c_never = ~0ull;
+
+	MirroredMemory<c_sys_memory_size>
+		m_memory{};
+	MirroredMemory<c_sys_rom_size>
+		m_monitor_rom{};
+
+	// kept to restore the interpreter on reset, programs are free to overwrite it
+	std::array<u8, c_sys_rom_size>
+		m_interpreter{};
+
+	bool m_firmware_ready{};
+
+	// reads below 0x8000 are routed to the ROM from reset until A15 is first set
+	bool m_rom_overlay{ true };
+
+	std::array<u16, 16> m_registers{};
+
+	u8   m_d{};
+	u8   m_t{};
+	u8   m_p{};
+	u8   m_x{};
+	bool m_df{};
+	bool m_ie{ true };
+	bool m_q{};
+	bool m_idle{};
+
+	// every scheduled time below is an absolute count of machine cycles
+	u64  m_cycles{};
+	u64  m_next_event{};
+	u64  m_frame_start{};
+	u64  m_frame_end{};
+
+	u64  m_vdc_next{ c_never };
+	u32  m_vdc_line{};
+	u32  m_dma_rows{};
+	bool m_display_on{};
+	bool m_int_line{};
+
+	u32  m_key_latch{};
+	u32  m_key_states{};
+	u32  m_frame_step{};
+
+	// Q drives the buzzer, its active time is summed up over each frame
+	u64  m_q_since{};
+	u64  m_q_cycles{};
+
+	std::array<u8, c_sys_screen_W * c_sys_screen_H>
+		m_display_map{};
+
+/*==================================================================*/
+
+private:
+	u8   peek_byte(u32 addr) const noexcept {
+		return (addr & 0x8000) || m_rom_overlay
+			? m_monitor_rom[addr] : m_memory[addr];
+	}
+
+	u8   read_byte(u32 addr) noexcept {
+		const auto value = peek_byte(addr);
+		if (addr & 0x8000) { m_rom_overlay = false; }
+		return value;
+	}
+
+	void write_byte(u32 addr, u8 value) noexcept {
+		if (addr & 0x8000) { m_rom_overlay = false; return; }
+		m_memory[addr] = value;
+		m_memory_writes.mark(addr & (c_sys_memory_size - 1));
+	}
+
+	u16& get_pc() noexcept { return m_registers[m_p]; }
+	u16& get_rx() noexcept { return m_registers[m_x]; }
+
+	u8   fetch_byte() noexcept { return read_byte(get_pc()++); }
+
+	bool get_display_flag() const noexcept;
+	bool get_input_flag(u32 N) const noexcept;
+
+	void output_port(u32 N, u8 value) noexcept;
+	u8   input_port(u32 N) noexcept;
+	void set_q(bool state) noexcept;
+
+	void refresh_next_event() noexcept {
+		m_next_event = std::min(m_vdc_next, m_frame_end);
+	}
+
+	void schedule_vdc_line(u32 line) noexcept;
+	void handle_vdc_event() noexcept;
+	void transfer_dma_row() noexcept;
+
+	void service_interrupt() noexcept;
+	void step_cpu() noexcept;
+
+	void power_on() noexcept;
+
+/*==================================================================*/
+
+private:
+	// plain function pointers, sparing each dispatch the member pointer adjustments
+	using Instruction = void (*)(COSMAC_VIP&) noexcept;
+
+	static const std::array<Instruction, 256> s_instruction_table;
+
+	template <u32 OP> void instruction() noexcept;
+
+	template <u32 CC> bool test_condition() const noexcept;
+	template <u32 OP> void alu_operation(u8 value) noexcept;
+
+/*==================================================================*/
+
+private:
+	u32 get_program_counter() const noexcept override {
+		return m_registers[m_p];
+	}
+
+	template <bool DEBUG>
+	void handle_cycle_loop() noexcept;
+
+	void handle_cycle_loop() noexcept override final;
+	void push_audio_data() noexcept override;
+	void push_video_data() noexcept override;
+
+public:
+	void read_register_file(std::vector<RegisterValue>& output) const noexcept override;
+	u32  disassemble(u32 addr, std::string& output) const noexcept override;
+
+public:
+	COSMAC_VIP() noexcept
+		: IFamily_COSMAC(c_sys_screen_W, c_sys_screen_H)
+	{}
+
+private:
+	void initialize_system() noexcept override final;
+	void reset_system_data() noexcept override final;
+};
+
+#endif
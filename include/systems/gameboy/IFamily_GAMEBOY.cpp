@@ -4,73 +4,88 @@
 	file, You can obtain one at http://mozilla.org/MPL/2.0/.
 */
 
-#include "BasicInput.hpp"
-
 #include "IFamily_GAMEBOY.hpp"
 
 #ifdef ENABLE_GAMEBOY_SYSTEM
 
+#include "BasicLogger.hpp"
+#include "BasicInput.hpp"
+#include "SimpleFileIO.hpp"
+#include "ZoneProfiler.hpp"
+
 /*==================================================================*/
 
-IFamily_GAMEBOY::IFamily_GAMEBOY() noexcept {
-	if (const auto* path{ HDM->addSystemDir("savestate", "GAMEBOY") })
-		{ s_savestate_path = *path / HDM->getFileSHA1(); }
+IFamily_GAMEBOY::IFamily_GAMEBOY(std::size_t W, std::size_t H) noexcept
+	: ISystemEmu(family_pretty_name)
+	, m_display_window({ "Display", make_system_id(instance_id, "display") })
+	, m_display_device(W, H, UserInterface::get_current_renderer())
+{
+	prepare_user_interface();
+	load_preset_binds();
+}
 
-	m_audio_device.addAudioStream(STREAM::MAIN, 48'000, 1);
-	m_audio_device.resumeStreams();
+void IFamily_GAMEBOY::initialize_family() noexcept {
+	if (calc_file_image_sha1()) {
+		if (auto* path = add_system_path("savestate", family_name)) {
+			m_savestate_path = (fs::Path(*path) / m_file_sha1_hash).string();
+		} else {
+			blog.error("Unable to create savestate directory for system '{}', "
+				"savestates will be unavailable!", family_pretty_name);
+		}
+	}
 
-	load_preset_binds();
+	if (auto* path = add_system_path("captures", family_name)) {
+		m_display_device.set_capture_directory(*path, get_system_id());
+	}
 }
 
 /*==================================================================*/
 
 void IFamily_GAMEBOY::main_system_loop() {
-	if (!isSystemRunning())
-		[[unlikely]] { return; }
+	if (has_cached_system_state(EmuState::ANY_PAUSE)) {
+		push_audio_data();
+		return;
+	}
 
-	update_key_states();
-	instruction_loop();
-	push_audio_data();
-	push_video_data();
-	pushOverlayData();
+	{
+		PROFILE_ZONE("handle_cycle_loop");
+		handle_cycle_loop();
+	}
+	if (m_debugger.is_mid_frame()) {
+		// stopped mid-frame, show the partial frame but hold off the frame end
+		if (should_push_video()) { push_video_data(); }
+		create_statistics_data();
+		return;
+	}
+	{
+		PROFILE_ZONE("push_audio_data");
+		push_audio_data();
+	}
+	if (should_push_video()) {
+		PROFILE_ZONE("push_video_data");
+		push_video_data();
+	}
+	create_statistics_data();
 }
 
-void IFamily_GAMEBOY::load_preset_binds() {
-	static constexpr auto _{ SDL_SCANCODE_UNKNOWN };
-	static constexpr SimpleKeyMapping defaultKeyMappings[]{
-		{0x7, KEY(G), _}, // START
-		{0x6, KEY(F), _}, // SELECT
-		{0x5, KEY(Q), _}, // B
-		{0x4, KEY(E), _}, // A
-		{0x3, KEY(S), _}, // ↓
-		{0x2, KEY(W), _}, // ↑
-		{0x1, KEY(A), _}, // ←
-		{0x0, KEY(D), _}, // →
+void IFamily_GAMEBOY::load_preset_binds() noexcept {
+	static constexpr auto _ = SDL_SCANCODE_UNKNOWN;
+	static constexpr SimpleKeyMapping default_key_mappings[]{
+		{PAD::START,  KEY(G), _},
+		{PAD::SELECT, KEY(F), _},
+		{PAD::BTN_B,  KEY(Q), _},
+		{PAD::BTN_A,  KEY(E), _},
+		{PAD::DOWN,   KEY(S), _},
+		{PAD::UP,     KEY(W), _},
+		{PAD::LEFT,   KEY(A), _},
+		{PAD::RIGHT,  KEY(D), _},
 	};
 
-	load_custom_binds(std::span(defaultKeyMappings));
-}
-
-u32  IFamily_GAMEBOY::getKeyStates() {
-	auto keyStates{ 0u };
-
-	Input->updateStates();
-
-	for (const auto& mapping : m_custom_binds) {
-		if (Input->areAnyHeld(mapping.key, mapping.alt)) {
-			keyStates |= 1u << mapping.idx;
-		}
-	}
-
-	return keyStates;
+	load_custom_binds(std::span(default_key_mappings));
 }
 
-void IFamily_GAMEBOY::copy_game_to_memory(u8* dest) noexcept {
-	std::copy_n(EXEC_POLICY(unseq)
-		HDM->getFileData(),
-		HDM->getFileSize(),
-		dest
-	);
+u32  IFamily_GAMEBOY::get_key_states() noexcept {
+	return poll_bind_states();
 }
 
 #endif
@@ -6,48 +6,77 @@
 
 #pragma once
 
-//#define ENABLE_GAMEBOY_SYSTEM
+#define ENABLE_GAMEBOY_SYSTEM
 #ifdef ENABLE_GAMEBOY_SYSTEM
 
-#include "../ISystem.hpp"
+#include <array>
+
+#include "../ISystemEmu.hpp"
+
+#include "AudioDevice.hpp"
+#include "DisplayDevice.hpp"
 
 /*==================================================================*/
 
-class IFamily_GAMEBOY : public ISystem {
+class IFamily_GAMEBOY : public ISystemEmu {
+	void prepare_user_interface() noexcept;
 
 protected:
+	static constexpr std::string_view family_pretty_name = "GameBoy";
+	static constexpr std::string_view family_name = "gameboy";
+	static constexpr std::string_view family_desc = "GameBoy family line.";
+	using Family = IFamily_GAMEBOY;
+
+	std::string m_savestate_path{};
+
 	enum STREAM { MAIN };
-	enum VOICE {
-		ID_0, ID_1, ID_2, ID_3, COUNT
+
+	// bit positions of the joypad lines within the key states
+	enum PAD {
+		RIGHT, LEFT, UP, DOWN,
+		BTN_A, BTN_B, SELECT, START,
 	};
 
-	static inline Path s_savestate_path{};
+protected:
+	WindowHost    m_display_window;
+	DisplayDevice m_display_device;
 
-	AudioDevice m_audio_device;
+public:
+	DisplayDevice* get_display_device() noexcept override final { return &m_display_device; }
 
-	std::vector<SimpleKeyMapping> m_custom_binds;
+protected:
+	AudioDevice   m_audio_device;
 
-	u32  getKeyStates();
-	void load_preset_binds();
+protected:
+	u32  get_key_states() noexcept;
+	void load_preset_binds() noexcept;
 
-	template <IsContiguousContainer T> requires
-		SameValueTypes<T, decltype(m_custom_binds)>
+	template <IsContiguousContainer T>
+		requires (SameValueTypes<T, decltype(m_custom_binds)>)
 	void load_custom_binds(const T& binds) {
 		m_custom_binds.assign(std::begin(binds), std::end(binds));
 	}
 
-	void copy_game_to_memory(u8* dest) noexcept;
-
-	virtual void update_key_states() noexcept = 0;
-	virtual void instruction_loop() noexcept = 0;
-	virtual void push_audio_data() = 0;
-	virtual void push_video_data() = 0;
+	virtual void handle_cycle_loop() noexcept = 0;
+	virtual void push_audio_data() noexcept = 0;
+	virtual void push_video_data() noexcept = 0;
 
 protected:
-	IFamily_GAMEBOY() noexcept;
+	IFamily_GAMEBOY(std::size_t W, std::size_t H) noexcept;
+	virtual u32 get_program_counter() const noexcept = 0;
+
+private:
+	void initialize_family() noexcept override final;
+	void reset_family_data() noexcept override final {}
 
 public:
 	void main_system_loop() override final;
+
+protected:
+	// the four shades of the original green-tinted panel, lightest first
+	static constexpr std::array<RGBA, 4> c_shade_colors = {
+		0xE0F8D0FF, 0x88C070FF, 0x346856FF, 0x081820FF,
+	};
 };
 
 #endif
@@ -7,36 +7,1178 @@
 #include "GAMEBOY_CLASSIC.hpp"
 #if defined(ENABLE_GAMEBOY_SYSTEM) && defined(ENABLE_GAMEBOY_CLASSIC)
 
-#include "BasicVideoSpec.hpp"
-#include "CoreRegistry.hpp"
+#include <bit>
+#include <cstring>
+#include <utility>
+#include <algorithm>
 
-REGISTER_CORE(GAMEBOY_CLASSIC, ".gb")
+#include "BasicLogger.hpp"
+#include "CoreRegistry.inl"
+
+REGISTER_SYSTEM_CORE(GAMEBOY_CLASSIC)
 
 /*==================================================================*/
 
-GAMEBOY_CLASSIC::GAMEBOY_CLASSIC() {
+void GAMEBOY_CLASSIC::initialize_system() noexcept {
+	setup_cartridge();
+	power_on();
+
+	m_base_system_framerate = c_sys_refresh_rate;
+
+	bind_system_memory(m_memory.data(), m_memory.size());
+
+	m_display_device.metadata().edit([](auto& meta) noexcept {
+		meta.minimum_zoom = 2;
+		meta.inner_margin = 4;
+		meta.texture_tint = c_shade_colors[0];
+		meta.enabled = true;
+	});
+}
+
+void GAMEBOY_CLASSIC::reset_system_data() noexcept {
+	power_on();
+}
+
+void GAMEBOY_CLASSIC::power_on() noexcept {
+	m_memory.clear();
+	m_cart_ram.clear();
+	m_lcd_shades.fill(0);
+
+	// register state as left behind by the DMG boot ROM
+	m_registers = { 0x00, 0x13, 0x00, 0xD8, 0x01, 0x4D, 0xB0, 0x01 };
+	m_sp = 0xFFFE;
+	m_pc = 0x0100;
+
+	m_ime       = false;
+	m_ime_delay = 0;
+	m_halt_bug  = false;
+	m_cpu_mode  = CpuMode::RUNNING;
+
+	m_rom_bank    = 1;
+	m_ram_bank    = 0;
+	m_mbc1_mode   = false;
+	m_ram_enabled = m_mapper == Mapper::NONE;
+	update_memory_pages();
 
-	setBaseSystemFramerate(c_sys_refresh_rate);
-	setViewportSizes(true, cScreenSizeX, cScreenSizeY, cResSizeMult, 2);
+	m_memory[IO::SC]   = 0x7E;
+	m_memory[IO::IF]   = IRQ::VBLANK;
+	m_memory[IO::STAT] = 0x04;
+	m_memory[IO::DMA]  = 0xFF;
+	m_memory[IO::BGP]  = 0xFC;
+	m_memory[IO::OBP0] = 0xFF;
+	m_memory[IO::OBP1] = 0xFF;
+
+	// the boot ROM leaves DIV at 0xAB by the time it hands over
+	m_div_origin = 0;
+	m_cycles     = 0xABCC;
+	m_timer_sync = m_cycles;
+	m_key_states = 0;
+	m_frame_step = 0;
+	m_frame_end  = m_cycles;
+
+	m_ppu_mode = PpuMode::DISABLED;
+	m_memory[IO::LCDC] = 0x91;
+	enable_lcd();
+	schedule_timer();
 }
 
 /*==================================================================*/
+	#pragma region Cartridge & Bus
+
+	void GAMEBOY_CLASSIC::setup_cartridge() noexcept {
+		copy_file_image_to(m_cart_rom, 0);
 
-void GAMEBOY_CLASSIC::instruction_loop() noexcept {
-	const auto maxCycles{ static_cast<s32>(cCylesPerSec / c_sys_refresh_rate) };
+		static constexpr u32 c_ram_sizes[] = { 0, 2_KiB, 8_KiB, 32_KiB, 128_KiB, 64_KiB };
 
-	auto curCycles{ 0 };
-	while (curCycles < maxCycles) {
+		const auto rom_size = std::bit_ceil(std::max<std::size_t>(m_file_image.size(), 32_KiB));
+		const auto ram_code = m_cart_rom[0x149];
 
+		m_mapper = get_mapper(m_cart_rom[0x147]);
+		m_rom_bank_mask = u32(rom_size / 16_KiB - 1);
+		m_ram_size = ram_code < std::size(c_ram_sizes) ? c_ram_sizes[ram_code] : 0;
 	}
-}
 
-void GAMEBOY_CLASSIC::push_audio_data() {
+	void GAMEBOY_CLASSIC::write_mapper(u32 addr, u8 value) noexcept {
+		switch (m_mapper) {
+			case Mapper::NONE:
+				return;
 
-}
+			case Mapper::MBC1:
+				switch (addr >> 13) {
+					case 0: m_ram_enabled = (value & 0xF) == 0xA; break;
+					case 1: m_rom_bank = (value & 0x1F) ? (value & 0x1F) : 1; break;
+					case 2: m_ram_bank = value & 0x03; break;
+					case 3: m_mbc1_mode = value & 0x01; break;
+				}
+				break;
 
-void GAMEBOY_CLASSIC::push_video_data() {
+			case Mapper::MBC3:
+				switch (addr >> 13) {
+					case 0: m_ram_enabled = (value & 0xF) == 0xA; break;
+					case 1: m_rom_bank = (value & 0x7F) ? (value & 0x7F) : 1; break;
+					case 2: m_ram_bank = value & 0x0F; break;
+					case 3: break; // RTC latch, the clock is not emulated
+				}
+				break;
 
-}
+			case Mapper::MBC5:
+				switch (addr >> 12) {
+					case 0: case 1: m_ram_enabled = (value & 0xF) == 0xA; break;
+					case 2: m_rom_bank = (m_rom_bank & 0x100) | value; break;
+					case 3: m_rom_bank = (m_rom_bank & 0x0FF) | (value & 0x01) << 8; break;
+					case 4: case 5: m_ram_bank = value & 0x0F; break;
+				}
+				break;
+
+			default:
+				return;
+		}
+		update_memory_pages();
+	}
+
+	void GAMEBOY_CLASSIC::update_memory_pages() noexcept {
+		auto rom_lo = 0u;
+		auto rom_hi = m_rom_bank;
+		auto ram_id = m_ram_bank;
+
+		if (m_mapper == Mapper::MBC1) {
+			rom_hi |= m_ram_bank << 5;
+			if (m_mbc1_mode) { rom_lo = m_ram_bank << 5; }
+			else { ram_id = 0; }
+		}
+
+		rom_lo &= m_rom_bank_mask;
+		rom_hi &= m_rom_bank_mask;
+
+		for (auto page = 0u; page < 4; ++page) {
+			m_read_pages[0x0 + page] = m_cart_rom.data() + rom_lo * 16_KiB + page * 4_KiB;
+			m_read_pages[0x4 + page] = m_cart_rom.data() + rom_hi * 16_KiB + page * 4_KiB;
+			m_write_pages[0x0 + page] = nullptr;
+			m_write_pages[0x4 + page] = nullptr;
+		}
+
+		// MBC3 banks past 0x07 select the (absent) clock registers instead
+		const auto ram_mapped = m_ram_enabled && m_ram_size && ram_id < 0x08;
+		const auto ram_span   = std::max<u32>(m_ram_size, 8_KiB);
+
+		for (auto page = 0u; page < 2; ++page) {
+			auto* ram = ram_mapped ? m_cart_ram.data()
+				+ ((ram_id * 8_KiB) & (ram_span - 1)) + page * 4_KiB : nullptr;
+			m_read_pages[0xA + page]  = ram;
+			m_write_pages[0xA + page] = ram;
+		}
+
+		for (const auto page : { 0x8u, 0x9u, 0xCu, 0xDu }) {
+			m_read_pages[page]  = m_memory.data() + page * 4_KiB;
+			m_write_pages[page] = m_memory.data() + page * 4_KiB;
+		}
+
+		// echo RAM and the OAM/IO/HRAM page always take the slow path
+		m_read_pages[0xE] = m_write_pages[0xE] = nullptr;
+		m_read_pages[0xF] = m_write_pages[0xF] = nullptr;
+	}
+
+	u8   GAMEBOY_CLASSIC::read_slow(u32 addr) noexcept {
+		if (addr < 0xE000) { return 0xFF; } // cartridge RAM disabled or absent
+		if (addr < 0xFE00) { return m_memory[addr - 0x2000]; }
+		if (addr < 0xFEA0) { return m_memory[addr]; }
+		if (addr < 0xFF00) { return 0x00; }
+
+		switch (addr) {
+			case IO::P1:
+				return read_joypad();
+
+			case IO::DIV:
+				return u8((m_cycles - m_div_origin) >> 8);
+
+			case IO::TIMA:
+				sync_timer();
+				return m_memory[IO::TIMA];
+
+			case IO::TAC:
+				return m_memory[IO::TAC] | 0xF8;
+
+			case IO::IF:
+				return m_memory[IO::IF] | 0xE0;
+
+			case IO::STAT:
+				return m_memory[IO::STAT] | 0x80;
+
+			default:
+				return m_memory[addr];
+		}
+	}
+
+	void GAMEBOY_CLASSIC::write_slow(u32 addr, u8 value) noexcept {
+		if (addr < 0x8000) { write_mapper(addr, value); return; }
+		if (addr < 0xE000) { return; } // cartridge RAM disabled or absent
+
+		if (addr < 0xFE00) {
+			m_memory[addr - 0x2000] = value;
+			m_memory_writes.mark(addr - 0x2000);
+			return;
+		}
+		if (addr < 0xFEA0) {
+			m_memory[addr] = value;
+			m_memory_writes.mark(addr);
+			return;
+		}
+		if (addr < 0xFF00) { return; }
+
+		switch (addr) {
+			case IO::P1:
+				m_memory[IO::P1] = value & 0x30;
+				break;
+
+			case IO::SC:
+				m_memory[IO::SC] = value;
+				if ((value & 0x81) == 0x81) {
+					// no link partner, the transfer completes at once shifting in ones
+					write_io(IO::SB, 0xFF);
+					m_memory[IO::SC] = value & 0x7F;
+					request_interrupt(IRQ::SERIAL);
+				}
+				break;
+
+			case IO::DIV:
+				sync_timer();
+				m_div_origin = m_cycles;
+				schedule_timer();
+				break;
+
+			case IO::TIMA:
+			case IO::TMA:
+				sync_timer();
+				m_memory[addr] = value;
+				schedule_timer();
+				break;
+
+			case IO::TAC:
+				sync_timer();
+				m_memory[IO::TAC] = value & 0x07;
+				schedule_timer();
+				break;
+
+			case IO::IF:
+				m_memory[IO::IF] = value & 0x1F;
+				break;
+
+			case IO::LCDC:
+				if ((m_memory[IO::LCDC] ^ value) & 0x80) {
+					m_memory[IO::LCDC] = value;
+					if (value & 0x80) { enable_lcd(); }
+					else { disable_lcd(); }
+				} else {
+					m_memory[IO::LCDC] = value;
+				}
+				break;
+
+			case IO::STAT:
+				m_memory[IO::STAT] = (value & 0x78) | (m_memory[IO::STAT] & 0x07);
+				update_stat_line();
+				break;
+
+			case IO::LY:
+				return;
+
+			case IO::LYC:
+				m_memory[IO::LYC] = value;
+				update_stat_line();
+				break;
+
+			case IO::DMA:
+				// the transfer is done in one go rather than over 160 M-cycles
+				m_memory[IO::DMA] = value;
+				for (auto offset = 0u; offset < 0xA0; ++offset) {
+					m_memory[0xFE00 + offset] = read_byte((value << 8) + offset);
+				}
+				m_memory_writes.mark(0xFE00, 0xA0);
+				break;
+
+			default:
+				m_memory[addr] = value;
+				break;
+		}
+		m_memory_writes.mark(addr);
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region Joypad & Timer
+
+	u8   GAMEBOY_CLASSIC::read_joypad() const noexcept {
+		const auto select = m_memory[IO::P1];
+		/***/ auto lines  = 0x0Fu;
+
+		if (!(select & 0x10)) { lines &= ~m_key_states; }
+		if (!(select & 0x20)) { lines &= ~m_key_states >> 4; }
+
+		return u8(0xC0 | select | (lines & 0x0F));
+	}
+
+	void GAMEBOY_CLASSIC::update_joypad(u32 key_states) noexcept {
+		const auto pressed = key_states & ~m_key_states;
+		m_key_states = key_states;
+
+		if (pressed) {
+			request_interrupt(IRQ::JOYPAD);
+			if (m_cpu_mode == CpuMode::STOPPED)
+				{ m_cpu_mode = CpuMode::RUNNING; }
+		}
+	}
+
+	// TIMA counts the falling edges of this DIV counter bit, per TAC clock select
+	static constexpr u32 c_timer_shift[] = { 10, 4, 6, 8 };
+
+	void GAMEBOY_CLASSIC::sync_timer() noexcept {
+		const auto tac = m_memory[IO::TAC];
+
+		if (tac & 0x4) {
+			const auto shift = c_timer_shift[tac & 0x3];
+			const auto ticks = ((m_cycles - m_div_origin) >> shift)
+							 - ((m_timer_sync - m_div_origin) >> shift);
+
+			if (ticks) {
+				auto tima = m_memory[IO::TIMA] + ticks;
+				if (tima > 0xFF) {
+					const auto tma = m_memory[IO::TMA];
+					tima = tma + (tima - 0x100) % (0x100 - tma);
+					request_interrupt(IRQ::TIMER);
+				}
+				write_io(IO::TIMA, u8(tima));
+			}
+		}
+		m_timer_sync = m_cycles;
+	}
+
+	void GAMEBOY_CLASSIC::schedule_timer() noexcept {
+		const auto tac = m_memory[IO::TAC];
+
+		if (tac & 0x4) {
+			const auto shift   = c_timer_shift[tac & 0x3];
+			const auto elapsed = (m_cycles - m_div_origin) >> shift;
+			const auto pending = 0x100u - m_memory[IO::TIMA];
+
+			m_timer_next = m_div_origin + ((elapsed + pending) << shift);
+		} else {
+			m_timer_next = c_never;
+		}
+		refresh_next_event();
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region PPU Timing
+
+	void GAMEBOY_CLASSIC::set_ppu_mode(PpuMode mode, u32 duration) noexcept {
+		m_ppu_mode  = mode;
+		m_ppu_next += duration;
+		write_io(IO::STAT, (m_memory[IO::STAT] & 0xFC) | (u8(mode) & 0x3));
+	}
+
+	void GAMEBOY_CLASSIC::update_stat_line() noexcept {
+		const auto stat = m_memory[IO::STAT];
+		const auto coincident = m_memory[IO::LY] == m_memory[IO::LYC];
+
+		write_io(IO::STAT, u8((stat & ~0x04) | (coincident ? 0x04 : 0x00)));
+
+		const auto stat_line = m_ppu_mode != PpuMode::DISABLED && (
+			((stat & 0x40) && coincident) ||
+			((stat & 0x08) && m_ppu_mode == PpuMode::HBLANK) ||
+			((stat & 0x10) && m_ppu_mode == PpuMode::VBLANK) ||
+			((stat & 0x20) && m_ppu_mode == PpuMode::OAM_SCAN)
+		);
+
+		// the interrupt fires on the rising edge of the combined sources only
+		if (stat_line && !m_stat_line) { request_interrupt(IRQ::LCD_STAT); }
+		m_stat_line = stat_line;
+	}
+
+	void GAMEBOY_CLASSIC::enable_lcd() noexcept {
+		m_ppu_line = 0;
+		m_ppu_next = m_cycles;
+		write_io(IO::LY, 0);
+
+		m_window_line = 0;
+		m_window_triggered = false;
+
+		set_ppu_mode(PpuMode::OAM_SCAN, c_oam_scan_time);
+		update_stat_line();
+		refresh_next_event();
+	}
+
+	void GAMEBOY_CLASSIC::disable_lcd() noexcept {
+		m_ppu_line = 0;
+		m_ppu_next = c_never;
+		write_io(IO::LY, 0);
+
+		set_ppu_mode(PpuMode::DISABLED, 0);
+		update_stat_line();
+		refresh_next_event();
+
+		m_lcd_shades.fill(0);
+	}
+
+	void GAMEBOY_CLASSIC::handle_ppu_event() noexcept {
+		while (m_cycles >= m_ppu_next) {
+			switch (m_ppu_mode) {
+				case PpuMode::OAM_SCAN:
+					scan_line_sprites();
+					m_transfer_time = calc_transfer_time();
+					set_ppu_mode(PpuMode::TRANSFER, m_transfer_time);
+					break;
+
+				case PpuMode::TRANSFER:
+					// the whole line is drawn at once as it leaves mode 3
+					if (m_render_lines) { render_scanline(); }
+					if (is_window_visible()) { ++m_window_line; }
+					set_ppu_mode(PpuMode::HBLANK,
+						c_sys_line_time - c_oam_scan_time - m_transfer_time);
+					break;
+
+				case PpuMode::HBLANK:
+					if (++m_ppu_line == c_sys_screen_H) {
+						set_ppu_mode(PpuMode::VBLANK, c_sys_line_time);
+						request_interrupt(IRQ::VBLANK);
+						m_window_line = 0;
+						m_window_triggered = false;
+						// a frame is one full pass of the LCD, ending as it enters VBlank
+						m_frame_end = m_cycles;
+					} else {
+						set_ppu_mode(PpuMode::OAM_SCAN, c_oam_scan_time);
+					}
+					break;
+
+				case PpuMode::VBLANK:
+					if (++m_ppu_line == 154) {
+						m_ppu_line = 0;
+						set_ppu_mode(PpuMode::OAM_SCAN, c_oam_scan_time);
+					} else {
+						m_ppu_next += c_sys_line_time;
+					}
+					break;
+
+				default:
+					return;
+			}
+			write_io(IO::LY, u8(m_ppu_line));
+			update_stat_line();
+		}
+	}
+
+	bool GAMEBOY_CLASSIC::is_window_visible() const noexcept {
+		// on DMG the window shares the background enable bit
+		return (m_memory[IO::LCDC] & 0x21) == 0x21
+			&& m_window_triggered && m_memory[IO::WX] <= 166;
+	}
+
+	void GAMEBOY_CLASSIC::scan_line_sprites() noexcept {
+		const auto height = m_memory[IO::LCDC] & 0x04 ? 16u : 8u;
+
+		if (m_memory[IO::WY] == m_ppu_line) { m_window_triggered = true; }
+
+		m_sprite_count = 0;
+		for (auto index = 0u; index < 40; ++index) {
+			const auto row = m_ppu_line + 16 - m_memory[0xFE00 + index * 4];
+			if (row < height) {
+				m_line_sprites[m_sprite_count] = u8(index);
+				if (++m_sprite_count == c_max_line_sprites) { break; }
+			}
+		}
+	}
+
+	u32  GAMEBOY_CLASSIC::calc_transfer_time() const noexcept {
+		// approximates the pixel FIFO stalls: fine scroll discards, the window
+		// fetcher restart, and a 6 to 11 dot fetch for every visible sprite
+		const auto scx = m_memory[IO::SCX];
+		/***/ auto duration = c_transfer_time + (scx & 7u);
+
+		if (is_window_visible()) { duration += 6; }
+
+		if (m_memory[IO::LCDC] & 0x02) {
+			for (auto slot = 0u; slot < m_sprite_count; ++slot) {
+				const auto x = m_memory[0xFE01 + m_line_sprites[slot] * 4];
+				if (x < 168) { duration += 11 - std::min((x + scx) & 7u, 5u); }
+			}
+		}
+		return duration;
+	}
+
+	void GAMEBOY_CLASSIC::handle_events() noexcept {
+		if (m_cycles >= m_timer_next) {
+			sync_timer();
+			schedule_timer();
+		}
+		if (m_cycles >= m_ppu_next) {
+			handle_ppu_event();
+		}
+		refresh_next_event();
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region PPU Rendering
+
+	// decodes one plane of a tile row into 8 pixels, leftmost in the lowest byte
+	static constexpr auto c_tile_row_plane = []() noexcept {
+		std::array<std::array<u64, 256>, 2> table{};
+		for (auto bits = 0u; bits < 256; ++bits) {
+			for (auto px = 0u; px < 8; ++px) {
+				table[0][bits] |= u64(bits >> (7 - px) & 1) << (px * 8);
+				table[1][bits] |= u64(bits >> px & 1) << (px * 8);
+			}
+		}
+		return table;
+	}();
+
+	u64  GAMEBOY_CLASSIC::fetch_tile_row(u32 addr, bool flip) const noexcept {
+		const auto& plane = c_tile_row_plane[flip];
+		return plane[m_memory[addr]] | plane[m_memory[addr + 1]] << 1;
+	}
+
+	void GAMEBOY_CLASSIC::render_scanline() noexcept {
+		const auto lcdc = m_memory[IO::LCDC];
+		auto* shade_row = m_lcd_shades.data() + m_ppu_line * c_sys_screen_W;
+
+		// background color indices of the line, with a tile of slack for scrolling
+		alignas(8) std::array<u8, c_sys_screen_W + 8> line{};
+		alignas(8) std::array<u8, c_sys_screen_W + 8> tiles;
+
+		const auto tile_row_addr = [lcdc](u32 tile_id, u32 fine_y) noexcept {
+			return (lcdc & 0x10 ? 0x8000 + tile_id * 16 : 0x9000 + s8(tile_id) * 16) + fine_y * 2;
+		};
+
+		const auto fetch_tiles = [&](u32 map_row, u32 tile_x, u32 fine_y, u32 count) noexcept {
+			for (auto tile = 0u; tile < count; ++tile) {
+				const auto tile_id = m_memory[map_row + ((tile_x + tile) & 31)];
+				const auto pixels  = fetch_tile_row(tile_row_addr(tile_id, fine_y), false);
+				std::memcpy(tiles.data() + tile * 8, &pixels, 8);
+			}
+		};
+
+		if (lcdc & 0x01) {
+			const auto scx = m_memory[IO::SCX];
+			const auto y   = (m_ppu_line + m_memory[IO::SCY]) & 0xFF;
+
+			fetch_tiles((lcdc & 0x08 ? 0x9C00 : 0x9800) + (y >> 3) * 32,
+				scx >> 3, y & 7, c_sys_screen_W / 8 + 1);
+			std::copy_n(tiles.data() + (scx & 7), c_sys_screen_W, line.data());
+
+			if (is_window_visible()) {
+				const auto win_x = m_memory[IO::WX] - 7;
+				const auto skip  = win_x < 0 ? u32(-win_x) : 0u;
+				const auto start = win_x < 0 ? 0u : u32(win_x);
+
+				fetch_tiles((lcdc & 0x40 ? 0x9C00 : 0x9800) + (m_window_line >> 3) * 32,
+					0, m_window_line & 7, (c_sys_screen_W - start + skip + 7) / 8);
+				std::copy_n(tiles.data() + skip, c_sys_screen_W - start, line.data() + start);
+			}
+
+			const auto bgp = m_memory[IO::BGP];
+			const u8 palette[4] = {
+				u8(bgp >> 0 & 3), u8(bgp >> 2 & 3),
+				u8(bgp >> 4 & 3), u8(bgp >> 6 & 3),
+			};
+			for (auto x = 0u; x < c_sys_screen_W; ++x) {
+				shade_row[x] = palette[line[x]];
+			}
+		} else {
+			// with the background off the line is blank, sprites still show
+			std::fill_n(shade_row, c_sys_screen_W, u8(0));
+		}
+
+		if (!(lcdc & 0x02) || !m_sprite_count) { return; }
+
+		// lower X wins between overlapping sprites, OAM order breaks ties
+		auto sprites = m_line_sprites;
+		std::stable_sort(sprites.begin(), sprites.begin() + m_sprite_count,
+			[&](u8 lhs, u8 rhs) noexcept {
+				return m_memory[0xFE01 + lhs * 4] < m_memory[0xFE01 + rhs * 4];
+			});
+
+		const auto height = lcdc & 0x04 ? 16u : 8u;
+		std::array<bool, c_sys_screen_W> claimed{};
+
+		for (auto slot = 0u; slot < m_sprite_count; ++slot) {
+			const auto* sprite = &m_memory[0xFE00 + sprites[slot] * 4];
+			const auto attr = sprite[3];
+
+			/***/ auto row = m_ppu_line + 16 - sprite[0];
+			if (attr & 0x40) { row = height - 1 - row; }
+
+			const auto tile_id = height == 16 ? sprite[2] & 0xFE : sprite[2];
+			const auto pixels  = fetch_tile_row(0x8000 + tile_id * 16 + row * 2, attr & 0x20);
+			const auto palette = m_memory[attr & 0x10 ? IO::OBP1 : IO::OBP0];
+
+			for (auto px = 0u; px < 8; ++px) {
+				const auto x = sprite[1] + px - 8;
+				const auto color = u32(pixels >> (px * 8)) & 3;
+
+				if (x >= c_sys_screen_W || !color || claimed[x]) { continue; }
+				// an opaque pixel hides those of later sprites even when behind the background
+				claimed[x] = true;
+				if ((attr & 0x80) && line[x]) { continue; }
+				shade_row[x] = palette >> (color * 2) & 3;
+			}
+		}
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region CPU Core
+
+	void GAMEBOY_CLASSIC::service_interrupts() noexcept {
+		if (m_cpu_mode == CpuMode::HALTED) {
+			m_cpu_mode = CpuMode::RUNNING;
+			m_cycles += 4;
+		}
+		if (!m_ime) { return; }
+
+		const auto irq_bit = std::countr_zero(pending_interrupts());
+
+		m_ime = false;
+		write_io(IO::IF, u8(m_memory[IO::IF] & ~(1 << irq_bit)));
+
+		push_word(m_pc);
+		m_pc = u16(0x40 + irq_bit * 8);
+		m_cycles += 20;
+	}
+
+	void GAMEBOY_CLASSIC::step_cpu() noexcept {
+		// EI takes effect only once the instruction following it has executed
+		if (m_ime_delay && !--m_ime_delay) [[unlikely]] { m_ime = true; }
+
+		if (pending_interrupts() && m_cpu_mode != CpuMode::STOPPED)
+			[[unlikely]] { service_interrupts(); }
+
+		if (m_cpu_mode != CpuMode::RUNNING) [[unlikely]] {
+			// nothing can wake the CPU before the next scheduled event
+			m_cycles = m_next_event;
+			return;
+		}
+
+		const auto opcode = fetch_byte();
+		if (m_halt_bug) [[unlikely]] {
+			m_halt_bug = false;
+			--m_pc;
+		}
+		s_instruction_table[opcode](*this);
+	}
+
+	template <bool DEBUG>
+	void GAMEBOY_CLASSIC::handle_cycle_loop() noexcept {
+		if (!(DEBUG ? m_debugger.begin_slice() : 0u)) {
+			update_joypad(get_key_states());
+			// frames that will not be shown only need the PPU timing
+			m_render_lines = should_push_video();
+			m_frame_end  = m_cycles + c_sys_frame_time;
+			m_frame_step = 0;
+			refresh_next_event();
+		}
+
+		while (m_cycles < m_frame_end) {
+			// run uninterrupted up to the next timer, PPU or frame event
+			while (m_cycles < m_next_event) {
+				if constexpr (DEBUG) {
+					if (m_debugger.break_before(m_pc, m_frame_step)) { return; }
+				}
+
+				step_cpu();
+
+				if constexpr (DEBUG) {
+					if (m_debugger.break_after(m_pc, ++m_frame_step)) { return; }
+				}
+			}
+			handle_events();
+		}
+	}
+
+	void GAMEBOY_CLASSIC::handle_cycle_loop() noexcept {
+		// the debug loop also finishes a frame that a stop left half-done
+		if (has_cached_system_state(EmuState::DEBUG) || m_debugger.is_mid_frame())
+			[[unlikely]] { handle_cycle_loop<true>(); }
+		else { handle_cycle_loop<false>(); }
+	}
+
+	void GAMEBOY_CLASSIC::push_audio_data() noexcept {
+		// the APU is not emulated yet, there is no audio stream to feed
+	}
+
+	void GAMEBOY_CLASSIC::push_video_data() noexcept {
+		m_display_device.present([&](auto& frame) noexcept {
+			frame.metadata = m_display_device.metadata().copy();
+			frame.copy_from(m_lcd_shades,
+				[](const auto shade) noexcept { return c_shade_colors[shade]; }
+			);
+		});
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region Operand Helpers
+
+	template <u32 R>
+	u8   GAMEBOY_CLASSIC::get_r8() noexcept {
+		if constexpr (R == REG::F) { return read_byte(get_HL()); }
+		else { return m_registers[R]; }
+	}
+
+	template <u32 R>
+	void GAMEBOY_CLASSIC::set_r8(u8 value) noexcept {
+		if constexpr (R == REG::F) { write_byte(get_HL(), value); }
+		else { m_registers[R] = value; }
+	}
+
+	template <u32 P>
+	u16  GAMEBOY_CLASSIC::get_rp() const noexcept {
+		if constexpr (P == 3) { return m_sp; }
+		else { return u16(m_registers[P * 2] << 8 | m_registers[P * 2 + 1]); }
+	}
+
+	template <u32 P>
+	void GAMEBOY_CLASSIC::set_rp(u32 value) noexcept {
+		if constexpr (P == 3) { m_sp = u16(value); }
+		else {
+			m_registers[P * 2 + 0] = u8(value >> 8);
+			m_registers[P * 2 + 1] = u8(value);
+		}
+	}
+
+	template <u32 P>
+	u16  GAMEBOY_CLASSIC::get_rp2() const noexcept {
+		if constexpr (P == 3) { return u16(m_registers[REG::A] << 8 | m_registers[REG::F]); }
+		else { return get_rp<P>(); }
+	}
+
+	template <u32 P>
+	void GAMEBOY_CLASSIC::set_rp2(u32 value) noexcept {
+		if constexpr (P == 3) {
+			m_registers[REG::A] = u8(value >> 8);
+			m_registers[REG::F] = u8(value & 0xF0);
+		}
+		else { set_rp<P>(value); }
+	}
+
+	template <u32 CC>
+	bool GAMEBOY_CLASSIC::test_condition() const noexcept {
+		const auto flags = m_registers[REG::F];
+		if      constexpr (CC == 0) { return !(flags & FLAG::FZ); }
+		else if constexpr (CC == 1) { return   flags & FLAG::FZ;  }
+		else if constexpr (CC == 2) { return !(flags & FLAG::FC); }
+		else                        { return   flags & FLAG::FC;  }
+	}
+
+	template <u32 Y>
+	void GAMEBOY_CLASSIC::alu_operation(u8 value) noexcept {
+		auto& a = m_registers[REG::A];
+		auto& f = m_registers[REG::F];
+
+		if constexpr (Y == 0 || Y == 1) { // ADD, ADC
+			const auto carry  = Y == 1 ? (f >> 4 & 1u) : 0u;
+			const auto result = a + value + carry;
+
+			f = u8((u8(result) ? 0 : FLAG::FZ)
+				| ((a & 0xF) + (value & 0xF) + carry > 0xF ? FLAG::FH : 0)
+				| (result > 0xFF ? FLAG::FC : 0));
+			a = u8(result);
+		}
+		else if constexpr (Y == 2 || Y == 3 || Y == 7) { // SUB, SBC, CP
+			const auto carry  = Y == 3 ? (f >> 4 & 1u) : 0u;
+			const auto result = a - value - carry;
+
+			f = u8((u8(result) ? 0 : FLAG::FZ) | FLAG::FN
+				| ((a & 0xFu) < (value & 0xFu) + carry ? FLAG::FH : 0)
+				| (u32(a) < value + carry ? FLAG::FC : 0));
+			if constexpr (Y != 7) { a = u8(result); }
+		}
+		else if constexpr (Y == 4) { // AND
+			a &= value;
+			f = u8((a ? 0 : FLAG::FZ) | FLAG::FH);
+		}
+		else if constexpr (Y == 5) { // XOR
+			a ^= value;
+			f = u8(a ? 0 : FLAG::FZ);
+		}
+		else if constexpr (Y == 6) { // OR
+			a |= value;
+			f = u8(a ? 0 : FLAG::FZ);
+		}
+	}
+
+	template <u32 Y>
+	u8   GAMEBOY_CLASSIC::rot_operation(u8 value) noexcept {
+		const auto carry_in = m_registers[REG::F] >> 4 & 1u;
+
+		u32 result, carry;
+		if      constexpr (Y == 0) { carry = value >> 7; result = value << 1 | carry; }        // RLC
+		else if constexpr (Y == 1) { carry = value & 1u; result = value >> 1 | carry << 7; }   // RRC
+		else if constexpr (Y == 2) { carry = value >> 7; result = value << 1 | carry_in; }     // RL
+		else if constexpr (Y == 3) { carry = value & 1u; result = value >> 1 | carry_in << 7; } // RR
+		else if constexpr (Y == 4) { carry = value >> 7; result = value << 1; }                // SLA
+		else if constexpr (Y == 5) { carry = value & 1u; result = value >> 1 | (value & 0x80); } // SRA
+		else if constexpr (Y == 6) { carry = 0u; result = value >> 4 | value << 4; }           // SWAP
+		else                       { carry = value & 1u; result = value >> 1; }                // SRL
+
+		m_registers[REG::F] = u8((u8(result) ? 0 : FLAG::FZ) | (carry ? FLAG::FC : 0));
+		return u8(result);
+	}
+
+	u16  GAMEBOY_CLASSIC::add_sp_offset() noexcept {
+		// flags come from the unsigned low byte addition, the result is signed
+		const auto offset = u32(fetch_byte());
+
+		m_registers[REG::F] = u8(
+			((m_sp & 0xF) + (offset & 0xF) > 0xF ? FLAG::FH : 0) |
+			((m_sp & 0xFF) + offset > 0xFF ? FLAG::FC : 0));
+		return u16(m_sp + s8(offset));
+	}
+
+	void GAMEBOY_CLASSIC::decimal_adjust() noexcept {
+		auto& a = m_registers[REG::A];
+		auto& f = m_registers[REG::F];
+
+		if (!(f & FLAG::FN)) {
+			if ((f & FLAG::FC) || a > 0x99) { a += 0x60; f |= FLAG::FC; }
+			if ((f & FLAG::FH) || (a & 0xF) > 0x9) { a += 0x06; }
+		} else {
+			if (f & FLAG::FC) { a -= 0x60; }
+			if (f & FLAG::FH) { a -= 0x06; }
+		}
+		f = u8((f & (FLAG::FN | FLAG::FC)) | (a ? 0 : FLAG::FZ));
+	}
+
+	void GAMEBOY_CLASSIC::illegal_instruction(u32 OP) noexcept {
+		// the real CPU locks up on these, never to fetch again
+		blog.error("Illegal instruction: 0x{:02X} at 0x{:04X}", OP, u16(m_pc - 1));
+		add_system_state(EmuState::FATAL);
+		--m_pc;
+
+		m_frame_end = m_cycles;
+		refresh_next_event();
+	}
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
+
+
+/*==================================================================*/
+	#pragma region Instruction Decoding
+
+	template <u32 OP>
+	void GAMEBOY_CLASSIC::instruction() noexcept {
+		static constexpr u32 X = OP >> 6;
+		static constexpr u32 Y = OP >> 3 & 7;
+		static constexpr u32 Z = OP >> 0 & 7;
+		static constexpr u32 P = Y >> 1;
+		static constexpr u32 Q = Y & 1;
+
+		auto& a = m_registers[REG::A];
+		auto& f = m_registers[REG::F];
+
+		if constexpr (X == 0) {
+			if constexpr (Z == 0) {
+				if constexpr (Y == 0) { // NOP
+					m_cycles += 4;
+				}
+				else if constexpr (Y == 1) { // LD (nn), SP
+					const auto addr = fetch_word();
+					write_byte(addr, u8(m_sp));
+					write_byte(u16(addr + 1), u8(m_sp >> 8));
+					m_cycles += 20;
+				}
+				else if constexpr (Y == 2) { // STOP
+					++m_pc;
+					sync_timer();
+					m_div_origin = m_cycles;
+					schedule_timer();
+					m_cpu_mode = CpuMode::STOPPED;
+					m_cycles += 4;
+				}
+				else { // JR d / JR cc, d
+					const auto offset = s8(fetch_byte());
+					bool taken = true;
+					if constexpr (Y != 3) { taken = test_condition<Y - 4>(); }
+					if (taken) { m_pc = u16(m_pc + offset); }
+					m_cycles += taken ? 12 : 8;
+				}
+			}
+			else if constexpr (Z == 1) {
+				if constexpr (Q == 0) { // LD rr, nn
+					set_rp<P>(fetch_word());
+					m_cycles += 12;
+				}
+				else { // ADD HL, rr
+					const auto hl = u32(get_HL());
+					const auto rr = u32(get_rp<P>());
+
+					f = u8((f & FLAG::FZ)
+						| ((hl & 0xFFF) + (rr & 0xFFF) > 0xFFF ? FLAG::FH : 0)
+						| (hl + rr > 0xFFFF ? FLAG::FC : 0));
+					set_HL(hl + rr);
+					m_cycles += 8;
+				}
+			}
+			else if constexpr (Z == 2) { // LD (rr), A / LD A, (rr) with HL+ and HL-
+				const auto addr = get_rp<P == 3 ? 2 : P>();
+				if constexpr (P == 2) { set_HL(addr + 1u); }
+				if constexpr (P == 3) { set_HL(addr - 1u); }
+
+				if constexpr (Q == 0) { write_byte(addr, a); }
+				else { a = read_byte(addr); }
+				m_cycles += 8;
+			}
+			else if constexpr (Z == 3) { // INC rr / DEC rr
+				set_rp<P>(get_rp<P>() + (Q ? 0xFFFFu : 1u));
+				m_cycles += 8;
+			}
+			else if constexpr (Z == 4) { // INC r
+				const auto value  = get_r8<Y>();
+				const auto result = u8(value + 1);
+
+				f = u8((f & FLAG::FC) | (result ? 0 : FLAG::FZ)
+					| ((value & 0xF) == 0xF ? FLAG::FH : 0));
+				set_r8<Y>(result);
+				m_cycles += Y == 6 ? 12 : 4;
+			}
+			else if constexpr (Z == 5) { // DEC r
+				const auto value  = get_r8<Y>();
+				const auto result = u8(value - 1);
+
+				f = u8((f & FLAG::FC) | (result ? 0 : FLAG::FZ) | FLAG::FN
+					| ((value & 0xF) == 0x0 ? FLAG::FH : 0));
+				set_r8<Y>(result);
+				m_cycles += Y == 6 ? 12 : 4;
+			}
+			else if constexpr (Z == 6) { // LD r, n
+				set_r8<Y>(fetch_byte());
+				m_cycles += Y == 6 ? 12 : 8;
+			}
+			else {
+				if constexpr (Y < 4) { // RLCA, RRCA, RLA, RRA
+					a = rot_operation<Y>(a);
+					f &= ~FLAG::FZ;
+				}
+				else if constexpr (Y == 4) { // DAA
+					decimal_adjust();
+				}
+				else if constexpr (Y == 5) { // CPL
+					a = u8(~a);
+					f |= FLAG::FN | FLAG::FH;
+				}
+				else if constexpr (Y == 6) { // SCF
+					f = u8((f & FLAG::FZ) | FLAG::FC);
+				}
+				else { // CCF
+					f = u8((f & (FLAG::FZ | FLAG::FC)) ^ FLAG::FC);
+				}
+				m_cycles += 4;
+			}
+		}
+		else if constexpr (X == 1) {
+			if constexpr (OP == 0x76) { // HALT
+				// with IME off and an interrupt already pending, the CPU carries
+				// on but fails to advance past the next opcode byte it fetches
+				if (!m_ime && pending_interrupts()) { m_halt_bug = true; }
+				else { m_cpu_mode = CpuMode::HALTED; }
+				m_cycles += 4;
+			}
+			else { // LD r, r
+				set_r8<Y>(get_r8<Z>());
+				m_cycles += Y == 6 || Z == 6 ? 8 : 4;
+			}
+		}
+		else if constexpr (X == 2) { // ALU A, r
+			alu_operation<Y>(get_r8<Z>());
+			m_cycles += Z == 6 ? 8 : 4;
+		}
+		else {
+			if constexpr (Z == 0) {
+				if constexpr (Y < 4) { // RET cc
+					if (test_condition<Y>()) {
+						m_pc = pop_word();
+						m_cycles += 20;
+					} else {
+						m_cycles += 8;
+					}
+				}
+				else if constexpr (Y == 4) { // LDH (n), A
+					write_byte(0xFF00 | fetch_byte(), a);
+					m_cycles += 12;
+				}
+				else if constexpr (Y == 5) { // ADD SP, d
+					m_sp = add_sp_offset();
+					m_cycles += 16;
+				}
+				else if constexpr (Y == 6) { // LDH A, (n)
+					a = read_byte(0xFF00 | fetch_byte());
+					m_cycles += 12;
+				}
+				else { // LD HL, SP + d
+					set_HL(add_sp_offset());
+					m_cycles += 12;
+				}
+			}
+			else if constexpr (Z == 1) {
+				if constexpr (Q == 0) { // POP rr
+					set_rp2<P>(pop_word());
+					m_cycles += 12;
+				}
+				else if constexpr (P == 0 || P == 1) { // RET / RETI
+					m_pc = pop_word();
+					if constexpr (P == 1) { m_ime = true; }
+					m_cycles += 16;
+				}
+				else if constexpr (P == 2) { // JP HL
+					m_pc = get_HL();
+					m_cycles += 4;
+				}
+				else { // LD SP, HL
+					m_sp = get_HL();
+					m_cycles += 8;
+				}
+			}
+			else if constexpr (Z == 2) {
+				if constexpr (Y < 4) { // JP cc, nn
+					const auto addr = fetch_word();
+					if (test_condition<Y>()) {
+						m_pc = addr;
+						m_cycles += 16;
+					} else {
+						m_cycles += 12;
+					}
+				}
+				else if constexpr (Y == 4) { // LD (C), A
+					write_byte(0xFF00 | m_registers[REG::C], a);
+					m_cycles += 8;
+				}
+				else if constexpr (Y == 5) { // LD (nn), A
+					write_byte(fetch_word(), a);
+					m_cycles += 16;
+				}
+				else if constexpr (Y == 6) { // LD A, (C)
+					a = read_byte(0xFF00 | m_registers[REG::C]);
+					m_cycles += 8;
+				}
+				else { // LD A, (nn)
+					a = read_byte(fetch_word());
+					m_cycles += 16;
+				}
+			}
+			else if constexpr (Z == 3) {
+				if constexpr (Y == 0) { // JP nn
+					m_pc = fetch_word();
+					m_cycles += 16;
+				}
+				else if constexpr (Y == 1) { // CB prefix
+					s_cb_instruction_table[fetch_byte()](*this);
+				}
+				else if constexpr (Y == 6) { // DI
+					m_ime = false;
+					m_ime_delay = 0;
+					m_cycles += 4;
+				}
+				else if constexpr (Y == 7) { // EI
+					m_ime_delay = 2;
+					m_cycles += 4;
+				}
+				else { illegal_instruction(OP); }
+			}
+			else if constexpr (Z == 4) {
+				if constexpr (Y < 4) { // CALL cc, nn
+					const auto addr = fetch_word();
+					if (test_condition<Y>()) {
+						push_word(m_pc);
+						m_pc = addr;
+						m_cycles += 24;
+					} else {
+						m_cycles += 12;
+					}
+				}
+				else { illegal_instruction(OP); }
+			}
+			else if constexpr (Z == 5) {
+				if constexpr (Q == 0) { // PUSH rr
+					push_word(get_rp2<P>());
+					m_cycles += 16;
+				}
+				else if constexpr (P == 0) { // CALL nn
+					const auto addr = fetch_word();
+					push_word(m_pc);
+					m_pc = addr;
+					m_cycles += 24;
+				}
+				else { illegal_instruction(OP); }
+			}
+			else if constexpr (Z == 6) { // ALU A, n
+				alu_operation<Y>(fetch_byte());
+				m_cycles += 8;
+			}
+			else { // RST
+				push_word(m_pc);
+				m_pc = u16(Y * 8);
+				m_cycles += 16;
+			}
+		}
+	}
+
+	template <u32 OP>
+	void GAMEBOY_CLASSIC::cb_instruction() noexcept {
+		static constexpr u32 X = OP >> 6;
+		static constexpr u32 Y = OP >> 3 & 7;
+		static constexpr u32 Z = OP >> 0 & 7;
+
+		auto& f = m_registers[REG::F];
+
+		// cycle counts include the prefix byte
+		if constexpr (X == 0) { // RLC, RRC, RL, RR, SLA, SRA, SWAP, SRL
+			set_r8<Z>(rot_operation<Y>(get_r8<Z>()));
+			m_cycles += Z == 6 ? 16 : 8;
+		}
+		else if constexpr (X == 1) { // BIT
+			f = u8((f & FLAG::FC) | FLAG::FH
+				| ((get_r8<Z>() >> Y & 1) ? 0 : FLAG::FZ));
+			m_cycles += Z == 6 ? 12 : 8;
+		}
+		else if constexpr (X == 2) { // RES
+			set_r8<Z>(u8(get_r8<Z>() & ~(1u << Y)));
+			m_cycles += Z == 6 ? 16 : 8;
+		}
+		else { // SET
+			set_r8<Z>(u8(get_r8<Z>() | (1u << Y)));
+			m_cycles += Z == 6 ? 16 : 8;
+		}
+	}
+
+	const std::array<GAMEBOY_CLASSIC::Instruction, 256>
+		GAMEBOY_CLASSIC::s_instruction_table = []<u32... OP>
+		(std::integer_sequence<u32, OP...>) noexcept {
+			return std::array<Instruction, 256>{ +[](GAMEBOY_CLASSIC& self) noexcept
+				{ self.instruction<OP>(); }... };
+		}(std::make_integer_sequence<u32, 256>{});
+
+	const std::array<GAMEBOY_CLASSIC::Instruction, 256>
+		GAMEBOY_CLASSIC::s_cb_instruction_table = []<u32... OP>
+		(std::integer_sequence<u32, OP...>) noexcept {
+			return std::array<Instruction, 256>{ +[](GAMEBOY_CLASSIC& self) noexcept
+				{ self.cb_instruction<OP>(); }... };
+		}(std::make_integer_sequence<u32, 256>{});
+
+	#pragma endregion
+/*VVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVVV*/
 
 #endif
@@ -7,347 +7,310 @@
 #pragma once
 
 #include "../IFamily_GAMEBOY.hpp"
-#include "BasicLogger.hpp"
 
 #define ENABLE_GAMEBOY_CLASSIC
 #if defined(ENABLE_GAMEBOY_SYSTEM) && defined(ENABLE_GAMEBOY_CLASSIC)
 
-#include <initializer_list>
+#include "SystemDescriptor.hpp"
+#include "ArrayOps.hpp"
 
 /*==================================================================*/
 
 class GAMEBOY_CLASSIC final : public IFamily_GAMEBOY {
-	static constexpr u64 c_sys_memory_size = 64_KiB;
+	static constexpr u64 c_sys_memory_size  = 64_KiB;
 	static constexpr f32 c_sys_refresh_rate = 59.7275f;
-	static constexpr u32 cScreenSizeX =     160 };
-	static constexpr u32 cScreenSizeY =     144 };
-	static constexpr u32 cCylesPerSec = 4194304 };
-	static constexpr u32 cScreenSizeT =   23040 };
-
-	static constexpr bool validate_program(const char* file_data, std::size_t file_size) noexcept {
-		if (!file_data || !file_size) { return false; }
-		return true;
+
+	static constexpr u32 c_sys_clock_rate = 4'194'304;
+	static constexpr u32 c_sys_frame_time = 70'224;
+	static constexpr u32 c_sys_line_time  = 456;
+
+	static constexpr u32 c_oam_scan_time = 80;
+	static constexpr u32 c_transfer_time = 172;
+
+	static constexpr u32 c_max_line_sprites = 10;
+
+	static constexpr u32 c_sys_screen_W = 160;
+	static constexpr u32 c_sys_screen_H = 144;
+
+	static constexpr u64 c_max_rom_size = 8_MiB;
+	static constexpr u64 c_max_ram_size = 128_KiB;
+
+	static constexpr std::string_view c_supported_extensions[] = { ".gb" };
+
+	enum class Mapper { NONE, MBC1, MBC3, MBC5, UNSUPPORTED };
+
+	static constexpr Mapper get_mapper(u8 cart_type) noexcept {
+		switch (cart_type) {
+			case 0x00: case 0x08: case 0x09:
+				return Mapper::NONE;
+			case 0x01: case 0x02: case 0x03:
+				return Mapper::MBC1;
+			case 0x0F: case 0x10: case 0x11: case 0x12: case 0x13:
+				return Mapper::MBC3;
+			case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E:
+				return Mapper::MBC5;
+			default:
+				return Mapper::UNSUPPORTED;
+		}
+	}
+
+	static constexpr const char* validate_program(std::span<const char> file) noexcept {
+		if (file.size() < 0x150) { return "file too small"; }
+		if (file.size() > c_max_rom_size) { return "file too large"; }
+		if (u8(file[0x143]) == 0xC0) { return "requires GameBoy Color hardware"; }
+		return (get_mapper(u8(file[0x147])) != Mapper::UNSUPPORTED)
+			? nullptr : "unsupported cartridge mapper";
 	}
 
 public:
-	const SystemDescriptor& get_descriptor() const noexcept override {
-		static constexpr std::string_view extensions[] = { ".gb", ".gb" };
-		static constexpr SystemDescriptor descriptor = {
-			"gamboy_classic", "Gameboy core derived from the original spec.",
-			extensions, validate_program, 0
-		};
+	static constexpr SystemDescriptor descriptor = {
+		0, Family::family_pretty_name, Family::family_name, Family::family_desc,
+		"GameBoy", "gameboy_classic", "Original monochrome GameBoy (DMG).",
+		c_supported_extensions, validate_program
+	};
 
+	const SystemDescriptor& get_descriptor() const noexcept override {
 		return descriptor;
 	}
 
+/*==================================================================*/
+
 private:
-	void instruction_loop() noexcept override;
-	void push_audio_data() override;
-	void push_video_data() override;
-
-	class MMU {
-	public:
-
-
-	MirroredMemory<c_sys_memory_size> m_memory{};
-
-		/* Memory Map */
-		std::span<u8, 0x0100> mBootRomBank{ m_memory.begin() + 0x0000, 0x0100 }; // BOOT ROM
-		std::span<u8, 0x4000> mRomBank00  { m_memory.begin() + 0x0000, 0x4000 }; // ROM BANK 0
-		std::span<u8, 0x4000> mRomBankNN  { m_memory.begin() + 0x4000, 0x4000 }; // ROM BANK N
-		std::span<u8, 0x2000> mVideoBank  { m_memory.begin() + 0x8000, 0x2000 }; // VRAM
-		std::span<u8, 0x2000> mExtBank    { m_memory.begin() + 0xA000, 0x2000 }; // EXT RAM
-		std::span<u8, 0x1000> mWorkBank0  { m_memory.begin() + 0xC000, 0x1000 }; // WRAM 0
-		std::span<u8, 0x1000> mWorkBankN  { m_memory.begin() + 0xD000, 0x1000 }; // WRAM N
-		std::span<u8, 0x1E00> mEchoBank   { m_memory.begin() + 0xE000, 0x1E00 }; // ECHO RAM (C000-DDFF)
-		std::span<u8, 0x00A0> mObjAttrBank{ m_memory.begin() + 0xFE00, 0x00A0 }; // OAM
-		//std::span<u8, 0x0060> mProhibited { m_memory.begin() + 0xFEA0, 0x0060 }; // PROHIBITED
-		std::span<u8, 0x0080> mInOutBank  { m_memory.begin() + 0xFF00, 0x0080 }; // IO REGS
-		std::span<u8, 0x007F> mHighBank   { m_memory.begin() + 0xFF80, 0x007F }; // HRAM
-
-		/* Video Bank 0 Tile Map */
-		std::span<u8, 0x0800> mVideoTileMap0{ mVideoBank.begin() + 0x0000, 0x0800 };
-		std::span<u8, 0x0800> mVideoTileMap1{ mVideoBank.begin() + 0x0800, 0x0800 };
-		std::span<u8, 0x0800> mVideoTileMap2{ mVideoBank.begin() + 0x1000, 0x0800 };
-		std::span<u8, 0x0400> mVideoTileMap3{ mVideoBank.begin() + 0x1800, 0x0400 };
-		std::span<u8, 0x0400> mVideoTileMap4{ mVideoBank.begin() + 0x1C00, 0x0400 };
-
-		/* Video Bank 1 Attr Map */
-		std::span<u8, 0x0400> mVideoAttrMap0{ mVideoBank.begin() + 0x1800, 0x0400 };
-		std::span<u8, 0x0400> mVideoAttrMap1{ mVideoBank.begin() + 0x1C00, 0x0400 };
-
-
-		/* I/O Ranges */
-		u8& mJOYP { mInOutBank[0x00] }; // Joypad
-		u8& mSB   { mInOutBank[0x01] }; // Serial transfer data
-		u8& mSC   { mInOutBank[0x02] }; // Serial transfer control
-
-		u8& mDIV  { mInOutBank[0x04] }; // Divider register
-		u8& mTIMA { mInOutBank[0x05] }; // Timer counter
-		u8& mTMA  { mInOutBank[0x06] }; // Timer modulo
-		u8& mTAC  { mInOutBank[0x07] }; // Timer control
-
-		u8& mIF   { mInOutBank[0x0F] }; // Interrupt flag
-
-		u8& mNR10 { mInOutBank[0x10] }; // Sound channel 1 sweep
-		u8& mNR11 { mInOutBank[0x11] }; // Sound channel 1 length timer & duty cycle
-		u8& mNR12 { mInOutBank[0x12] }; // Sound channel 1 volume & envelope
-		u8& mNR13 { mInOutBank[0x13] }; // Sound channel 1 period low
-		u8& mNR14 { mInOutBank[0x14] }; // Sound channel 1 period high & control
-
-		u8& mNR21 { mInOutBank[0x16] }; // Sound channel 2 length timer & duty cycle
-		u8& mNR22 { mInOutBank[0x17] }; // Sound channel 2 volume & envelope
-		u8& mNR23 { mInOutBank[0x18] }; // Sound channel 2 period low
-		u8& mNR24 { mInOutBank[0x19] }; // Sound channel 2 period high & control
-
-		u8& mNR30 { mInOutBank[0x1A] }; // Sound channel 3 DAC enable
-		u8& mNR31 { mInOutBank[0x1B] }; // Sound channel 3 length timer
-		u8& mNR32 { mInOutBank[0x1C] }; // Sound channel 3 output level
-		u8& mNR33 { mInOutBank[0x1D] }; // Sound channel 3 period low
-		u8& mNR34 { mInOutBank[0x1E] }; // Sound channel 3 period high & control
-
-		u8& mNR40 { mInOutBank[0x20] }; // Sound channel 4 length timer
-		u8& mNR41 { mInOutBank[0x21] }; // Sound channel 4 volume & envelope
-		u8& mNR42 { mInOutBank[0x22] }; // Sound channel 4 frequency & randomness
-		u8& mNR43 { mInOutBank[0x23] }; // Sound channel 4 control
-
-		u8& mNR50 { mInOutBank[0x24] }; // Master volume & VIN panning
-		u8& mNR51 { mInOutBank[0x25] }; // Sound panning
-		u8& mNR52 { mInOutBank[0x26] }; // Sound on/off
-
-		std::span<u8, 0x10> mWAVE /* Storage for waveform */
-			{ mInOutBank.begin() + 0x30, 0x10 };
-
-		u8& mLCDC { mInOutBank[0x40] }; // LCD control
-		u8& mSTAT { mInOutBank[0x41] }; // LCD status
-		u8& mSCY  { mInOutBank[0x42] }; // Viewport Y pos
-		u8& mSCX  { mInOutBank[0x43] }; // Viewport X pos
-		u8& mLY   { mInOutBank[0x44] }; // LCD Y coord
-		u8& mLYC  { mInOutBank[0x45] }; // LY compare
-		u8& mDMA  { mInOutBank[0x46] }; // OAM DMA source addr & start
-		u8& mBGP  { mInOutBank[0x47] }; // BG palette data
-		u8& mOBP0 { mInOutBank[0x48] }; // OBJ palette 0 data
-		u8& mOBP1 { mInOutBank[0x49] }; // OBJ palette 1 data
-		u8& mWY   { mInOutBank[0x4A] }; // Window Y pos
-		u8& mWX   { mInOutBank[0x4B] }; // Window X pos + 7
-		u8& mKEY1 { mInOutBank[0x4D] }; // Prepare speed switch
-
-		u8& mVBK  { mInOutBank[0x4F] }; // VRAM bank
-		u8& mBOOT { mInOutBank[0x50] }; // Boot ROM enable
-		u8& mHDMA1{ mInOutBank[0x51] }; // VRAM DMA src hi
-		u8& mHDMA2{ mInOutBank[0x52] }; // VRAM DMA src lo
-		u8& mHDMA3{ mInOutBank[0x53] }; // VRAM DMA dst hi
-		u8& mHDMA4{ mInOutBank[0x54] }; // VRAM DMA dst lo
-		u8& mHDMA5{ mInOutBank[0x55] }; // VRAM DMA len/mode/start
-
-		u8& mRP   { mInOutBank[0x56] }; // Infrared comms port
-
-		u8& mBCPS { mInOutBank[0x68] }; // BG (color) palette spec / index
-		u8& mBCPD { mInOutBank[0x69] }; // BG (color) palette data
-		u8& mOCPS { mInOutBank[0x6A] }; // OBJ (color) palette spec / index
-		u8& mOCPD { mInOutBank[0x6B] }; // OBJ (color) palette data
-		u8& mOPRI { mInOutBank[0x6C] }; // OBJ priority mode
-		u8& mSVBK { mInOutBank[0x70] }; // WRAM bank
-
-		u8& mPCM12{ mInOutBank[0x76] }; // Audio digital out 1 & 2
-		u8& mPCM34{ mInOutBank[0x77] }; // Audio digital out 3 & 4
-
-		u8& mIE   { m_memory[0xFFFF] }; // Interrupt enable
-	} mMMU;
-
-	u8 mInputControl{};
-	u8 mInputData[2]{};
-
-	void update_key_states() noexcept override {
-		const auto keyState{ static_cast<u8>(getKeyStates()) };
-		const auto keysDPAD{ static_cast<u8>(keyState & 0xF) };
-		const auto keysBTNS{ static_cast<u8>(keyState >>  4) };
-		const auto currJOYP{ static_cast<u8>(~mMMU.mJOYP) };
-
-		if (keysDPAD & ~(currJOYP & 0xF) && currJOYP & 0x10)
-			{ /* trigger CPU interrupt 0x60 */ }
-		if (keysBTNS & ~(currJOYP & 0xF) && currJOYP & 0x20)
-			{ /* trigger CPU interrupt 0x60 */ }
-
-		mInputData[0] = ~keysDPAD & 0xF;
-		mInputData[1] = ~keysBTNS & 0xF;
+	// addresses of the I/O registers handled by the core
+	enum IO : u32 {
+		P1   = 0xFF00, SB   = 0xFF01, SC   = 0xFF02,
+		DIV  = 0xFF04, TIMA = 0xFF05, TMA  = 0xFF06, TAC  = 0xFF07,
+		IF   = 0xFF0F,
+		LCDC = 0xFF40, STAT = 0xFF41, SCY  = 0xFF42, SCX  = 0xFF43,
+		LY   = 0xFF44, LYC  = 0xFF45, DMA  = 0xFF46, BGP  = 0xFF47,
+		OBP0 = 0xFF48, OBP1 = 0xFF49, WY   = 0xFF4A, WX   = 0xFF4B,
+		IE   = 0xFFFF,
+	};
+
+	enum IRQ : u8 {
+		VBLANK = 0x01, LCD_STAT = 0x02, TIMER = 0x04, SERIAL = 0x08, JOYPAD = 0x10,
+	};
+
+	enum FLAG : u8 {
+		FZ = 0x80, FN = 0x40, FH = 0x20, FC = 0x10,
+	};
+
+	// register file laid out in r8 operand order, with F in the (HL) slot
+	enum REG { B, C, D, E, H, L, F, A };
+
+	enum class CpuMode { RUNNING, HALTED, STOPPED };
+	enum class PpuMode { HBLANK, VBLANK, OAM_SCAN, TRANSFER, DISABLED };
+
+	static constexpr u64 c_never = ~0ull;
+
+/*==================================================================*/
+
+private:
+	// VRAM, WRAM, OAM, I/O and HRAM, laid out at their bus addresses
+	MirroredMemory<c_sys_memory_size>
+		m_memory{};
+
+	MirroredMemory<c_max_rom_size>
+		m_cart_rom{};
+	MirroredMemory<c_max_ram_size>
+		m_cart_ram{};
+
+	// 4 KiB pages of the bus, a null page is routed through the slow path
+	std::array<const u8*, 16> m_read_pages{};
+	std::array<u8*, 16>       m_write_pages{};
+
+	Mapper m_mapper{};
+	u32  m_rom_bank_mask{};
+	u32  m_ram_size{};
+	u32  m_rom_bank{ 1 };
+	u32  m_ram_bank{};
+	bool m_ram_enabled{};
+	bool m_mbc1_mode{};
+
+	std::array<u8, 8> m_registers{};
+
+	u16  m_sp{};
+	u16  m_pc{};
+
+	bool m_ime{};
+	bool m_halt_bug{};
+	u8   m_ime_delay{};
+
+	CpuMode m_cpu_mode{};
+
+	// every scheduled time below is an absolute count of T-cycles
+	u64  m_cycles{};
+	u64  m_next_event{};
+	u64  m_frame_end{};
+
+	u64  m_div_origin{};
+	u64  m_timer_sync{};
+	u64  m_timer_next{ c_never };
+
+	u64  m_ppu_next{ c_never };
+	u32  m_ppu_line{};
+	u32  m_transfer_time{};
+	bool m_stat_line{};
+
+	u32  m_window_line{};
+	bool m_window_triggered{};
+	bool m_render_lines{ true };
+
+	// OAM indices of the sprites found on the current line, in OAM order
+	std::array<u8, c_max_line_sprites> m_line_sprites{};
+	u32  m_sprite_count{};
+
+	PpuMode m_ppu_mode{ PpuMode::DISABLED };
+
+	u32  m_key_states{};
+	u32  m_frame_step{};
+
+	// finished rows of shade indices, filled in as each line leaves mode 3
+	std::array<u8, c_sys_screen_W * c_sys_screen_H>
+		m_lcd_shades{};
+
+/*==================================================================*/
+
+private:
+	u8   read_slow(u32 addr) noexcept;
+	void write_slow(u32 addr, u8 value) noexcept;
+
+	u8   read_byte(u32 addr) noexcept {
+		if (const auto* page = m_read_pages[addr >> 12]) [[likely]]
+			{ return page[addr & 0xFFF]; }
+		return read_slow(addr);
 	}
 
-	void setJOYP(u32 addr, u32 value) noexcept {
-		if (addr != 0xFF00) {
-			blog.newEntry<BLOG::WARN>("JoyPad cannot write to 0x{:04X}", addr);
-			return;
-		} else [[likely]] {
-			mInputControl = value & 0x30;
+	void write_byte(u32 addr, u8 value) noexcept {
+		if (auto* page = m_write_pages[addr >> 12]) [[likely]] {
+			page[addr & 0xFFF] = value;
+			m_memory_writes.mark(addr);
+		} else {
+			write_slow(addr, value);
 		}
 	}
 
-	u32 getJOYP(u32 addr) const noexcept {
-		if (addr != 0xFF00) {
-			blog.newEntry<BLOG::WARN>("JoyPad cannot read from 0x{:04X}", addr);
-			return 0;
-		} else [[likely]] {
-			switch (mInputControl) {
-				case 0x10:
-					return mInputData[0] | 0xC0;
-					break;
-				case 0x20:
-					return mInputData[1] | 0xC0;
-					break;
-				default:
-					return 0xCF;
-			}
-		}
+	u8   fetch_byte() noexcept {
+		return read_byte(m_pc++);
 	}
 
-	class PPU {
-		// insert spongebob in box saying "IMAGINATION!"
-	} mPPU;
-
-
-	class CPU {
-		enum RegChar {
-			A, B, C, D, E, F, H, L,
-			AF, BC, DE, HL
-		};
-		class Registers {
-			u8 mA{}, mB{}, mC{}, mD{};
-			u8 mE{}, mF{}, mH{}, mL{};
-
-		public:
-			template <RegChar T>
-			void set(u32 value) noexcept {
-				       if constexpr (T == A) {
-					mA = static_cast<u8>(value);
-				} else if constexpr (T == B) {
-					mB = static_cast<u8>(value);
-				} else if constexpr (T == C) {
-					mC = static_cast<u8>(value);
-				} else if constexpr (T == D) {
-					mD = static_cast<u8>(value);
-				} else if constexpr (T == E) {
-					mE = static_cast<u8>(value);
-				} else if constexpr (T == F) {
-					mF = static_cast<u8>(value);
-				} else if constexpr (T == H) {
-					mH = static_cast<u8>(value);
-				} else if constexpr (T == L) {
-					mL = static_cast<u8>(value);
-				} else if constexpr (T == AF) {
-					mA = static_cast<u8>(value >> 8);
-					mF = static_cast<u8>(value >> 0);
-				} else if constexpr (T == BC) {
-					mB = static_cast<u8>(value >> 8);
-					mC = static_cast<u8>(value >> 0);
-				} else if constexpr (T == DE) {
-					mD = static_cast<u8>(value >> 8);
-					mE = static_cast<u8>(value >> 0);
-				} else if constexpr (T == HL) {
-					mH = static_cast<u8>(value >> 8);
-					mL = static_cast<u8>(value >> 0);
-				}
-			}
-
-			template <RegChar T>
-			u32  get() const noexcept {
-				       if constexpr (T == A) {
-					return mA;
-				} else if constexpr (T == B) {
-					return mB;
-				} else if constexpr (T == C) {
-					return mC;
-				} else if constexpr (T == D) {
-					return mD;
-				} else if constexpr (T == E) {
-					return mE;
-				} else if constexpr (T == F) {
-					return mF;
-				} else if constexpr (T == H) {
-					return mH;
-				} else if constexpr (T == L) {
-					return mL;
-				} else if constexpr (T == AF) {
-					return mA << 8 | mF;
-				} else if constexpr (T == BC) {
-					return mB << 8 | mC;
-				} else if constexpr (T == DE) {
-					return mD << 8 | mE;
-				} else if constexpr (T == HL) {
-					return mH << 8 | mL;
-				}
-			}
-
-			bool getFlagZ() const noexcept { return mF & 0x80; }
-			bool getFlagN() const noexcept { return mF & 0x40; }
-			bool getFlagH() const noexcept { return mF & 0x20; }
-			bool getFlagC() const noexcept { return mF & 0x10; }
-
-			void setFlagZ(const bool state) noexcept { mF = (mF & ~0x8F) | (state << 7); }
-			void setFlagN(const bool state) noexcept { mF = (mF & ~0x4F) | (state << 6); }
-			void setFlagH(const bool state) noexcept { mF = (mF & ~0x2F) | (state << 5); }
-			void setFlagC(const bool state) noexcept { mF = (mF & ~0x1F) | (state << 4); }
-
-			void init_GB() noexcept {
-				mA = 0x01; mB = 0x00; mC = 0x13; mD = 0x00;
-				mE = 0xD8; mF = 0xB0; mH = 0x01; mL = 0x4D;
-			}
-
-			void init_GBC() noexcept {
-				mA = 0x11; mB = 0x00; mC = 0x00; mD = 0xFF;
-				mE = 0x56; mF = 0x80; mH = 0x00; mL = 0x00;
-			}
-		} mReg;
-
-		u32  currentPC{};
-		u32  stackPtr{};
-		bool mIME{};
-		bool mMUL{};
-
-		enum class Mode {
-			NORMAL, HALT, STOP,
-			HALT_BUG, HALT_DI,
-			ENABLE_IME,
-		} mMode;
-
-	} mCPU;
-
-
-	struct Opcode {
-		using InstrStep = void(*)(CPU* const, MMU* const);
-
-		u32 mOpcode{};
-		u32 mLength{};
-		u32 mCyclesT{};
-		u32 mCyclesM{};
-		std::vector<InstrStep>
-			mInstrSteps{};
-
-		Opcode(
-			u32 opcode, u32 length, u32 cyclesT,
-			std::initializer_list<InstrStep> steps
-		) noexcept
-			: mOpcode{ opcode }
-			, mLength{ length }
-			, mCyclesT{ cyclesT }
-			, mCyclesM{ cyclesT / 4 }
-			, mInstrSteps{ steps }
-		{}
-	};
+	u16  fetch_word() noexcept {
+		const auto lo = fetch_byte();
+		return u16(fetch_byte() << 8 | lo);
+	}
 
+	void push_word(u32 value) noexcept {
+		write_byte(--m_sp, u8(value >> 8));
+		write_byte(--m_sp, u8(value));
+	}
 
-public:
-	GAMEBOY_CLASSIC();
-
-	static constexpr bool validate_program(
-		const char* fileData,
-		const size_type   fileSize
-	) noexcept {
-		if (!fileData || !fileSize) { return false; }
-		return false;
+	u16  pop_word() noexcept {
+		const auto lo = read_byte(m_sp++);
+		return u16(read_byte(m_sp++) << 8 | lo);
+	}
+
+	void setup_cartridge() noexcept;
+	void write_mapper(u32 addr, u8 value) noexcept;
+	void update_memory_pages() noexcept;
+
+	u8   read_joypad() const noexcept;
+	void update_joypad(u32 key_states) noexcept;
+
+	// hardware-side register updates, reported to the write tracker like CPU writes
+	void write_io(u32 addr, u8 value) noexcept {
+		m_memory[addr] = value;
+		m_memory_writes.mark(addr);
+	}
+
+	void request_interrupt(u8 irq) noexcept {
+		write_io(IO::IF, m_memory[IO::IF] | irq);
+	}
+	u8   pending_interrupts() const noexcept {
+		return m_memory[IO::IF] & m_memory[IO::IE] & 0x1F;
+	}
+
+	void refresh_next_event() noexcept {
+		m_next_event = std::min({ m_ppu_next, m_timer_next, m_frame_end });
+	}
+
+	void sync_timer() noexcept;
+	void schedule_timer() noexcept;
+
+	void set_ppu_mode(PpuMode mode, u32 duration) noexcept;
+	bool is_window_visible() const noexcept;
+	void scan_line_sprites() noexcept;
+	u32  calc_transfer_time() const noexcept;
+	u64  fetch_tile_row(u32 addr, bool flip) const noexcept;
+	void render_scanline() noexcept;
+	void update_stat_line() noexcept;
+	void enable_lcd() noexcept;
+	void disable_lcd() noexcept;
+	void handle_ppu_event() noexcept;
+	void handle_events() noexcept;
+
+	void service_interrupts() noexcept;
+	void step_cpu() noexcept;
+
+	void power_on() noexcept;
+
+/*==================================================================*/
+
+private:
+	// plain function pointers, sparing each dispatch the member pointer adjustments
+	using Instruction = void (*)(GAMEBOY_CLASSIC&) noexcept;
+
+	static const std::array<Instruction, 256> s_instruction_table;
+	static const std::array<Instruction, 256> s_cb_instruction_table;
+
+	template <u32 OP> void instruction() noexcept;
+	template <u32 OP> void cb_instruction() noexcept;
+
+	u16  get_HL() const noexcept {
+		return u16(m_registers[REG::H] << 8 | m_registers[REG::L]);
+	}
+	void set_HL(u32 value) noexcept {
+		m_registers[REG::H] = u8(value >> 8);
+		m_registers[REG::L] = u8(value);
+	}
+
+	template <u32 R> u8   get_r8() noexcept;
+	template <u32 R> void set_r8(u8 value) noexcept;
+
+	template <u32 P> u16  get_rp() const noexcept;
+	template <u32 P> void set_rp(u32 value) noexcept;
+	template <u32 P> u16  get_rp2() const noexcept;
+	template <u32 P> void set_rp2(u32 value) noexcept;
+
+	template <u32 CC> bool test_condition() const noexcept;
+	template <u32 Y>  void alu_operation(u8 value) noexcept;
+	template <u32 Y>  u8   rot_operation(u8 value) noexcept;
+
+	u16  add_sp_offset() noexcept;
+	void decimal_adjust() noexcept;
+	void illegal_instruction(u32 OP) noexcept;
+
+/*==================================================================*/
+
+private:
+	u32 get_program_counter() const noexcept override {
+		return m_pc;
 	}
 
-	s32 getMaxDisplayW() const noexcept override { return cScreenSizeX; }
-	s32 getMaxDisplayH() const noexcept override { return cScreenSizeY; }
+	template <bool DEBUG>
+	void handle_cycle_loop() noexcept;
+
+	void handle_cycle_loop() noexcept override final;
+	void push_audio_data() noexcept override;
+	void push_video_data() noexcept override;
+
+public:
+	GAMEBOY_CLASSIC() noexcept
+		: IFamily_GAMEBOY(c_sys_screen_W, c_sys_screen_H)
+	{}
+
+private:
+	void initialize_system() noexcept override final;
+	void reset_system_data() noexcept override final;
 };
 
 #endif
@@ -10,10 +10,13 @@
 #include <array>
 #include <numeric>
 #include <cstddef>
+#include <cstdlib>
 #include <algorithm>
 
+#include "Aligned.hpp"
 #include "Concepts.hpp"
 #include "ExecPolicy.hpp"
+#include "VirtualMemory.hpp"
 
 /*==================================================================*/
 
@@ -142,3 +145,115 @@ public:
 	constexpr       auto* data()       noexcept { return mem.data(); }
 	constexpr const auto* data() const noexcept { return mem.data(); }
 };
+
+/*==================================================================*/
+
+/**
+ * @brief MirroredMemory counterpart for large address spaces that programs only
+ *        use a fraction of. The storage is a lazily committed virtual memory region,
+ *        so untouched pages cost no resident memory, and clear() hands the pages
+ *        back to the OS instead of filling them. Indexing mirrors the same way.
+ *
+ * Writes are not observed through operator[], so the owner reports them with
+ * mark_dirty(), which feeds a page-granular map of the pages written since the
+ * last clear(), for savestates and memory diffs to walk instead of everything.
+ *
+ * With AllocPolicy::HUGE_PAGES the region is backed in huge pages instead, which
+ * suits memories that programs use densely and all over, at the cost of sparsity.
+ */
+template <std::size_t N, typename T = std::uint8_t, AllocPolicy P = AllocPolicy::FIRST_TOUCH>
+class SparseMirroredMemory : public SimpleContainerFacade<SparseMirroredMemory<N, T, P>, T> {
+	static_assert(std::has_single_bit(N),
+		"SparseMirroredMemory size must be a power of two!");
+	static_assert(P != AllocPolicy::DEFAULT,
+		"SparseMirroredMemory is always page-mapped!");
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+		"SparseMirroredMemory expects zeroed pages to be valid T objects!");
+
+public:
+	static constexpr std::size_t c_page_size  = 4096;
+	static constexpr std::size_t c_page_count = std::max<std::size_t>(N * sizeof(T) / c_page_size, 1);
+
+private:
+	T*   mem{};
+	bool mapped{};
+
+	std::array<std::uint64_t, (c_page_count + 63) / 64>
+		m_dirty_pages{};
+
+public:
+	SparseMirroredMemory() noexcept
+		: mem(static_cast<T*>(virtual_memory::reserve(N * sizeof(T), P == AllocPolicy::HUGE_PAGES)))
+		, mapped(mem != nullptr)
+	{
+		if (!mapped) { mem = static_cast<T*>(std::calloc(N, sizeof(T))); }
+	}
+	~SparseMirroredMemory() noexcept {
+		if (mapped) { virtual_memory::release(mem, N * sizeof(T)); }
+		else { std::free(mem); }
+	}
+
+	SparseMirroredMemory(const SparseMirroredMemory&) = delete;
+	SparseMirroredMemory& operator=(const SparseMirroredMemory&) = delete;
+
+public:
+	auto& operator[](std::size_t index)       noexcept
+		{ return mem[index & (N - 1)]; }
+	const auto& operator[](std::size_t index) const noexcept
+		{ return mem[index & (N - 1)]; }
+
+	constexpr auto size() const noexcept { return N; }
+
+	// False if neither the reservation nor the fallback allocation succeeded.
+	bool is_valid() const noexcept { return mem != nullptr; }
+
+	// Zeroes the memory by dropping its pages, falling back to a fill if that fails.
+	void clear() noexcept {
+		if (!mem) { return; }
+		if (!mapped || !virtual_memory::discard(mem, N * sizeof(T)))
+			{ std::fill_n(mem, N, T()); }
+		m_dirty_pages.fill(0);
+	}
+
+	      auto* data()       noexcept { return mem; }
+	const auto* data() const noexcept { return mem; }
+
+/*==================================================================*/
+
+	// Notes a write to 'count' elements starting at 'index', mirrored like operator[].
+	void mark_dirty(std::size_t index, std::size_t count = 1) noexcept {
+		if (!count) { return; }
+
+		const auto offset = (index & (N - 1)) * sizeof(T);
+		const auto pages  = std::min(c_page_count, (offset % c_page_size
+			+ std::min(count, N) * sizeof(T) + c_page_size - 1) / c_page_size);
+
+		auto page = offset / c_page_size;
+		for (std::size_t i = 0; i < pages; ++i) {
+			m_dirty_pages[page >> 6] |= std::uint64_t(1) << (page & 63);
+			page = (page + 1) % c_page_count;
+		}
+	}
+
+	bool is_dirty(std::size_t page) const noexcept {
+		return page < c_page_count && (m_dirty_pages[page >> 6] >> (page & 63) & 1);
+	}
+
+	/**
+	 * @brief Visits the written parts of memory as runs of consecutive dirty pages.
+	 * @param[in] fn :: Callable taking (std::size_t byte_offset, std::size_t byte_size).
+	 */
+	template <typename Fn>
+		requires (std::is_invocable_v<Fn, std::size_t, std::size_t>)
+	void for_each_dirty_range(Fn&& fn) const noexcept(std::is_nothrow_invocable_v<Fn, std::size_t, std::size_t>) {
+		for (std::size_t page = 0; page < c_page_count; ) {
+			if (!is_dirty(page)) { ++page; continue; }
+
+			const auto run_start = page;
+			while (page < c_page_count && is_dirty(page)) { ++page; }
+
+			const auto offset = run_start * c_page_size;
+			fn(offset, std::min(page * c_page_size, N * sizeof(T)) - offset);
+		}
+	}
+};
@@ -0,0 +1,531 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "Deflate.hpp"
+
+#include <bit>
+#include <array>
+#include <cstring>
+#include <algorithm>
+
+/*==================================================================*/
+
+namespace {
+	using u8  = std::uint8_t;
+	using u16 = std::uint16_t;
+	using u32 = std::uint32_t;
+	using u64 = std::uint64_t;
+
+	constexpr u32 c_window_size = 32768;
+	constexpr u32 c_window_mask = c_window_size - 1;
+	constexpr u32 c_hash_bits   = 15;
+	constexpr u32 c_max_chain   = 64;
+	constexpr u32 c_min_match   = 3;
+	constexpr u32 c_max_match   = 258;
+
+	constexpr u16 c_length_base[29] = {
+		  3,   4,   5,   6,   7,   8,   9,  10,  11,  13,
+		 15,  17,  19,  23,  27,  31,  35,  43,  51,  59,
+		 67,  83,  99, 115, 131, 163, 195, 227, 258,
+	};
+	constexpr u8 c_length_extra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+		2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+	};
+	constexpr u16 c_dist_base[30] = {
+		    1,     2,     3,     4,     5,     7,     9,    13,    17,    25,
+		   33,    49,    65,    97,   129,   193,   257,   385,   513,   769,
+		 1025,  1537,  2049,  3073,  4097,  6145,  8193, 12289, 16385, 24577,
+	};
+	constexpr u8 c_dist_extra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+		6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+	};
+
+	struct HuffCode { u16 bits; u8 size; };
+
+	// Huffman codes are sent MSB-first while the bit stream is LSB-first.
+	constexpr u16 reverse_bits(u32 code, u32 size) noexcept {
+		u32 result = 0;
+		for (u32 i = 0; i < size; ++i) { result = (result << 1) | ((code >> i) & 1); }
+		return u16(result);
+	}
+
+	constexpr auto c_fixed_litlen = []() noexcept {
+		std::array<HuffCode, 288> table{};
+		for (u32 i = 0; i < 288; ++i) {
+			if      (i < 144) { table[i] = { reverse_bits(0x030 + i - 0,   8), 8 }; }
+			else if (i < 256) { table[i] = { reverse_bits(0x190 + i - 144, 9), 9 }; }
+			else if (i < 280) { table[i] = { reverse_bits(0x000 + i - 256, 7), 7 }; }
+			else              { table[i] = { reverse_bits(0x0C0 + i - 280, 8), 8 }; }
+		}
+		return table;
+	}();
+
+	constexpr auto c_length_symbol = []() noexcept {
+		std::array<u8, c_max_match + 1> table{};
+		for (u32 sym = 0; sym < 28; ++sym) {
+			for (u32 len = c_length_base[sym]; len < c_length_base[sym + 1]; ++len) { table[len] = u8(sym); }
+		}
+		table[c_max_match] = 28;
+		return table;
+	}();
+
+	constexpr auto c_crc32_table = []() noexcept {
+		std::array<u32, 256> table{};
+		for (u32 i = 0; i < 256; ++i) {
+			u32 crc = i;
+			for (auto k = 0; k < 8; ++k) { crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1; }
+			table[i] = crc;
+		}
+		return table;
+	}();
+
+	u32 get_dist_symbol(u32 distance) noexcept {
+		return u32(std::upper_bound(std::begin(c_dist_base), std::end(c_dist_base),
+			distance) - std::begin(c_dist_base)) - 1;
+	}
+
+	class BitWriter {
+		std::vector<u8>& m_output;
+		u64 m_bit_buffer{};
+		u32 m_bit_count{};
+
+	public:
+		explicit BitWriter(std::vector<u8>& output) noexcept : m_output(output) {}
+
+		void put(u32 value, u32 size) {
+			m_bit_buffer |= u64(value) << m_bit_count;
+			m_bit_count  += size;
+			while (m_bit_count >= 8) {
+				m_output.push_back(u8(m_bit_buffer));
+				m_bit_buffer >>= 8; m_bit_count -= 8;
+			}
+		}
+		void put(HuffCode code) { put(code.bits, code.size); }
+
+		void flush() {
+			if (m_bit_count) { m_output.push_back(u8(m_bit_buffer)); }
+			m_bit_buffer = 0; m_bit_count = 0;
+		}
+	};
+
+	u32 hash_at(const u8* data) noexcept {
+		const auto value = u32(data[0]) | (u32(data[1]) << 8) | (u32(data[2]) << 16);
+		return (value * 0x9E3779B1u) >> (32 - c_hash_bits);
+	}
+
+	/*==============================================================*/
+
+	class BitReader {
+		const u8* m_next;
+		const u8* m_end;
+		u64 m_bit_buffer{};
+		u32 m_bit_count{};
+		u32 m_padding{}; // zero bytes fed in past the end of the input
+
+	public:
+		explicit BitReader(std::span<const u8> input) noexcept
+			: m_next(input.data()), m_end(input.data() + input.size())
+		{}
+
+		// Tops the buffer up to at least 56 bits, a whole word at a time while
+		// 8 bytes remain. Bits above the count are re-read on the next refill.
+		void refill() noexcept {
+			if (m_end - m_next >= 8) {
+				u64 word;
+				std::memcpy(&word, m_next, sizeof(word));
+				if constexpr (std::endian::native == std::endian::big) {
+					word = ((word & 0x00000000FFFFFFFFull) << 32) | ((word & 0xFFFFFFFF00000000ull) >> 32);
+					word = ((word & 0x0000FFFF0000FFFFull) << 16) | ((word & 0xFFFF0000FFFF0000ull) >> 16);
+					word = ((word & 0x00FF00FF00FF00FFull) <<  8) | ((word & 0xFF00FF00FF00FF00ull) >>  8);
+				}
+				m_bit_buffer |= word << m_bit_count;
+				m_next       += (63 - m_bit_count) >> 3;
+				m_bit_count  |= 56;
+			} else {
+				for (; m_bit_count <= 56; m_bit_count += 8) {
+					if (m_next < m_end) { m_bit_buffer |= u64(*m_next++) << m_bit_count; }
+					else { ++m_padding; }
+				}
+			}
+		}
+
+		u32  peek(u32 size) const noexcept { return u32(m_bit_buffer & ((1ull << size) - 1)); }
+		void drop(u32 size) noexcept { m_bit_buffer >>= size; m_bit_count -= size; }
+		u32  take(u32 size) noexcept { const auto value = peek(size); drop(size); return value; }
+
+		// true once bits past the end of the input have been consumed
+		bool overrun() const noexcept { return m_padding * 8 > m_bit_count; }
+
+		// Discards the partial byte and hands back the buffered whole bytes,
+		// so that stored blocks can be copied straight out of the input.
+		bool align_to_byte() noexcept {
+			auto bytes = m_bit_count >> 3;
+			const auto padded = std::min(bytes, m_padding);
+			m_padding -= padded; bytes -= padded;
+			m_next    -= bytes;
+
+			m_bit_buffer = 0;
+			m_bit_count  = 0;
+			return m_padding == 0;
+		}
+
+		auto remaining() const noexcept -> std::size_t { return std::size_t(m_end - m_next); }
+		auto position()  const noexcept -> const u8* { return m_next; }
+		void skip(std::size_t bytes) noexcept { m_next += bytes; }
+	};
+
+	/**
+	 * Canonical Huffman decoder. Codes up to 'c_fast_bits' long resolve with a
+	 * single lookup of the next bits, longer ones fall back to a walk over the
+	 * per-length code limits. Fast entries pack (length << 9) | symbol.
+	 */
+	struct HuffDecoder {
+		static constexpr u32 c_fast_bits = 10;
+		static constexpr u32 c_invalid   = 0xFFFF;
+
+		std::array<u16, 1u << c_fast_bits> fast{};
+		std::array<u16, 16> first_code{};
+		std::array<u16, 16> first_symbol{};
+		std::array<u32, 17> max_code{};
+		std::array<u16, 288> symbols{};
+
+		constexpr bool build(const u8* lengths, u32 count) noexcept {
+			fast.fill(0); // may be rebuilt for every dynamic block
+
+			std::array<u16, 16> counts{};
+			for (u32 i = 0; i < count; ++i) { ++counts[lengths[i]]; }
+			counts[0] = 0;
+
+			std::array<u16, 16> next_code{};
+			for (u32 code = 0, index = 0, size = 1; size < 16; ++size) {
+				next_code[size]    = u16(code);
+				first_code[size]   = u16(code);
+				first_symbol[size] = u16(index);
+
+				code  += counts[size];
+				index += counts[size];
+				if (counts[size] && code - 1 >= (1u << size)) { return false; } // oversubscribed
+
+				max_code[size] = code << (16 - size);
+				code <<= 1;
+			}
+			max_code[16] = 0x10000; // sentinel, stops the walk on unused codes
+
+			for (u32 symbol = 0; symbol < count; ++symbol) {
+				const u32 size = lengths[symbol];
+				if (!size) { continue; }
+
+				const u32 code = next_code[size]++;
+				symbols[first_symbol[size] + code - first_code[size]] = u16(symbol);
+
+				if (size <= c_fast_bits) {
+					for (u32 slot = reverse_bits(code, size);
+						slot < fast.size(); slot += 1u << size
+					) { fast[slot] = u16((size << 9) | symbol); }
+				}
+			}
+			return true;
+		}
+
+		// expects at least 15 bits in the reader
+		u32 decode(BitReader& reader) const noexcept {
+			if (const auto entry = fast[reader.peek(c_fast_bits)]) {
+				reader.drop(entry >> 9);
+				return entry & 0x1FF;
+			}
+
+			const u32 code = reverse_bits(reader.peek(16), 16);
+			u32 size = c_fast_bits + 1;
+			while (code >= max_code[size]) { ++size; }
+			if (size >= 16) { return c_invalid; }
+
+			reader.drop(size);
+			return symbols[(code >> (16 - size)) - first_code[size] + first_symbol[size]];
+		}
+	};
+
+	constexpr auto c_fixed_litlen_decoder = []() noexcept {
+		std::array<u8, 288> lengths{};
+		for (u32 i = 0; i < 288; ++i) { lengths[i] = c_fixed_litlen[i].size; }
+		HuffDecoder decoder{};
+		decoder.build(lengths.data(), 288);
+		return decoder;
+	}();
+
+	constexpr auto c_fixed_dist_decoder = []() noexcept {
+		std::array<u8, 30> lengths{};
+		lengths.fill(5);
+		HuffDecoder decoder{};
+		decoder.build(lengths.data(), 30);
+		return decoder;
+	}();
+
+	// order in which the code length code lengths are sent
+	constexpr u8 c_code_length_order[19] = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+	};
+
+	bool read_dynamic_decoders(BitReader& reader, HuffDecoder& litlen, HuffDecoder& dist) noexcept {
+		reader.refill();
+		const auto litlen_count = reader.take(5) + 257;
+		const auto dist_count   = reader.take(5) + 1;
+		const auto code_count   = reader.take(4) + 4;
+		if (litlen_count > 286 || dist_count > 30) { return false; }
+
+		std::array<u8, 19> code_lengths{};
+		for (u32 i = 0; i < code_count; ++i) {
+			reader.refill();
+			code_lengths[c_code_length_order[i]] = u8(reader.take(3));
+		}
+
+		HuffDecoder code_decoder{};
+		if (!code_decoder.build(code_lengths.data(), 19)) { return false; }
+
+		std::array<u8, 286 + 30> lengths{};
+		for (u32 i = 0; i < litlen_count + dist_count;) {
+			reader.refill();
+			if (reader.overrun()) { return false; }
+
+			const auto symbol = code_decoder.decode(reader);
+			if (symbol < 16) { lengths[i++] = u8(symbol); continue; }
+
+			u8  value  = 0;
+			u32 repeat = 0;
+			switch (symbol) {
+				case 16:
+					if (i == 0) { return false; }
+					value  = lengths[i - 1];
+					repeat = 3 + reader.take(2);
+					break;
+				case 17: repeat =  3 + reader.take(3); break;
+				case 18: repeat = 11 + reader.take(7); break;
+				default: return false;
+			}
+			if (i + repeat > litlen_count + dist_count) { return false; }
+			while (repeat--) { lengths[i++] = value; }
+		}
+
+		if (!lengths[256]) { return false; } // no end of block code
+		return litlen.build(lengths.data(), litlen_count)
+			&& dist.build(lengths.data() + litlen_count, dist_count);
+	}
+
+	bool inflate_stream(std::span<const u8> input, std::vector<u8>& output, std::size_t size_limit) {
+		BitReader   reader(input);
+		HuffDecoder dynamic_litlen{}, dynamic_dist{};
+
+		const auto start = output.size();
+		const auto limit = start + std::min(size_limit, SIZE_MAX - start);
+		auto pos = start;
+
+		// grows geometrically, the output was sized up front if the size is known
+		const auto make_room = [&](std::size_t bytes) {
+			if (pos + bytes <= output.size()) { return true; }
+			if (bytes > limit - pos) { return false; }
+			output.resize(std::min(limit, std::max(pos + bytes, start + (output.size() - start) * 2)));
+			return true;
+		};
+
+		// a known size is trusted only as far as the input could possibly expand to
+		output.resize(start + (size_limit != SIZE_MAX
+			? std::min(limit - start, deflate_codec::max_inflated_size(input.size()))
+			: input.size() * 4 + 256));
+
+		for (bool final_block = false; !final_block;) {
+			reader.refill();
+			final_block = reader.take(1);
+
+			const HuffDecoder* litlen{};
+			const HuffDecoder* dist{};
+
+			switch (reader.take(2)) {
+				case 0: {
+					if (!reader.align_to_byte() || reader.remaining() < 4) { return false; }
+					const auto* header = reader.position();
+					const auto length  = u32(header[0] | (header[1] << 8));
+					const auto nlength = u32(header[2] | (header[3] << 8));
+					if ((length ^ 0xFFFF) != nlength) { return false; }
+					if (reader.remaining() - 4 < length || !make_room(length)) { return false; }
+
+					if (length) { std::memcpy(output.data() + pos, header + 4, length); }
+					reader.skip(4 + length);
+					pos += length;
+					continue;
+				}
+				case 1:
+					litlen = &c_fixed_litlen_decoder;
+					dist   = &c_fixed_dist_decoder;
+					break;
+				case 2:
+					if (!read_dynamic_decoders(reader, dynamic_litlen, dynamic_dist)) { return false; }
+					litlen = &dynamic_litlen;
+					dist   = &dynamic_dist;
+					break;
+				default: return false;
+			}
+
+			for (;;) {
+				reader.refill(); // enough for a length/distance pair with their extra bits
+				if (reader.overrun()) { return false; }
+
+				auto symbol = litlen->decode(reader);
+				if (symbol < 256) {
+					if (!make_room(1)) { return false; }
+					output[pos++] = u8(symbol);
+					continue;
+				}
+				if (symbol == 256) { break; }
+
+				symbol -= 257;
+				if (symbol >= 29) { return false; }
+				const auto length = c_length_base[symbol] + reader.take(c_length_extra[symbol]);
+
+				symbol = dist->decode(reader);
+				if (symbol >= 30) { return false; }
+				const auto distance = c_dist_base[symbol] + reader.take(c_dist_extra[symbol]);
+
+				if (distance > pos - start || !make_room(length)) { return false; }
+
+				auto* dst = output.data() + pos;
+				const auto* src = dst - distance;
+				if (distance >= length) { std::memcpy(dst, src, length); }
+				else { for (u32 i = 0; i < length; ++i) { dst[i] = src[i]; } } // overlapping run
+				pos += length;
+			}
+		}
+
+		if (reader.overrun()) { return false; }
+		output.resize(pos);
+		return true;
+	}
+}
+
+/*==================================================================*/
+
+bool deflate_codec::compress_raw(std::span<const u8> input, std::vector<u8>& output) noexcept {
+	try {
+		const auto* data = input.data();
+		const auto  size = u32(input.size());
+
+		std::vector<std::int32_t> head(1u << c_hash_bits, -1);
+		std::vector<std::int32_t> prev(c_window_size, -1);
+
+		output.reserve(output.size() + input.size() / 4 + 64);
+		BitWriter writer(output);
+
+		writer.put(1, 1); // BFINAL
+		writer.put(1, 2); // BTYPE = fixed Huffman
+
+		const auto insert_hash = [&](u32 pos) noexcept {
+			if (pos + c_min_match > size) { return; }
+			const auto hash = hash_at(data + pos);
+			prev[pos & c_window_mask] = head[hash];
+			head[hash] = std::int32_t(pos);
+		};
+
+		for (u32 pos = 0; pos < size;) {
+			u32 best_len = 0, best_dist = 0;
+
+			if (pos + c_min_match <= size) {
+				const auto max_len = std::min(c_max_match, size - pos);
+				auto candidate = head[hash_at(data + pos)];
+
+				for (u32 chain = c_max_chain; candidate >= 0 && chain; --chain) {
+					const auto cand = u32(candidate);
+					if (pos - cand > c_window_size) { break; }
+
+					if (data[cand + best_len] == data[pos + best_len]) {
+						u32 len = 0;
+						while (len < max_len && data[cand + len] == data[pos + len]) { ++len; }
+						if (len > best_len) {
+							best_len = len; best_dist = pos - cand;
+							if (len == max_len) { break; }
+						}
+					}
+
+					const auto next = prev[cand & c_window_mask];
+					if (next >= candidate) { break; } // slot recycled by a newer position
+					candidate = next;
+				}
+			}
+
+			if (best_len >= c_min_match) {
+				const auto len_sym = c_length_symbol[best_len];
+				writer.put(c_fixed_litlen[257 + len_sym]);
+				writer.put(best_len - c_length_base[len_sym], c_length_extra[len_sym]);
+
+				const auto dist_sym = get_dist_symbol(best_dist);
+				writer.put(reverse_bits(dist_sym, 5), 5);
+				writer.put(best_dist - c_dist_base[dist_sym], c_dist_extra[dist_sym]);
+
+				for (u32 i = 0; i < best_len; ++i) { insert_hash(pos + i); }
+				pos += best_len;
+			} else {
+				writer.put(c_fixed_litlen[data[pos]]);
+				insert_hash(pos++);
+			}
+		}
+
+		writer.put(c_fixed_litlen[256]); // end of block
+		writer.flush();
+		return true;
+	}
+	catch (...) { return false; }
+}
+
+bool deflate_codec::compress_zlib(std::span<const u8> input, std::vector<u8>& output) noexcept {
+	try {
+		output.push_back(0x78); // CM = 8, CINFO = 7 (32K window)
+		output.push_back(0x01); // FCHECK, fastest level hint
+
+		if (!compress_raw(input, output)) { return false; }
+
+		const auto adler = adler32(input);
+		for (auto shift = 24; shift >= 0; shift -= 8) {
+			output.push_back(u8(adler >> shift));
+		}
+		return true;
+	}
+	catch (...) { return false; }
+}
+
+bool deflate_codec::decompress_raw(std::span<const u8> input, std::vector<u8>& output, std::size_t size_limit) noexcept {
+	const auto start = output.size();
+
+	try {
+		if (inflate_stream(input, output, size_limit)) { return true; }
+	}
+	catch (...) {}
+
+	output.resize(start);
+	return false;
+}
+
+/*==================================================================*/
+
+u32 deflate_codec::adler32(std::span<const u8> data, u32 adler) noexcept {
+	static constexpr u32 c_modulo  = 65521;
+	static constexpr std::size_t c_chunk = 5552; // max bytes before the sums can overflow
+
+	auto a = adler & 0xFFFF, b = adler >> 16;
+
+	for (std::size_t offset = 0; offset < data.size(); offset += c_chunk) {
+		const auto end = std::min(data.size(), offset + c_chunk);
+		for (auto i = offset; i < end; ++i) { a += data[i]; b += a; }
+		a %= c_modulo; b %= c_modulo;
+	}
+	return (b << 16) | a;
+}
+
+u32 deflate_codec::crc32(std::span<const u8> data, u32 crc) noexcept {
+	crc = ~crc;
+	for (const auto byte : data) {
+		crc = c_crc32_table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
@@ -0,0 +1,68 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+/*==================================================================*/
+
+/**
+ * @brief Self-contained DEFLATE (RFC 1951) encoder/decoder and the checksums
+ *        that the container formats around it need, so that reading/writing
+ *        PNG/ZIP data does not pull in zlib.
+ */
+namespace deflate_codec {
+	/**
+	 * @brief Compresses data as a single fixed-Huffman block, with LZ77 matches
+	 *        found through a hash chain over a 32 KiB window.
+	 * @param[in]  input  :: Bytes to compress.
+	 * @param[out] output :: Compressed stream is appended to this vector.
+	 * @return True on success, false if the output could not be grown.
+	 */
+	bool compress_raw(std::span<const std::uint8_t> input, std::vector<std::uint8_t>& output) noexcept;
+
+	/**
+	 * @brief As 'compress_raw()', but wrapped in a zlib (RFC 1950) header and
+	 *        Adler-32 trailer, as used by PNG IDAT chunks.
+	 */
+	bool compress_zlib(std::span<const std::uint8_t> input, std::vector<std::uint8_t>& output) noexcept;
+
+	/**
+	 * @brief Decompresses a raw DEFLATE stream, as stored in ZIP entries. Codes are
+	 *        resolved through lookup tables off a 64-bit bit buffer, refilled a
+	 *        word at a time.
+	 * @param[in]  input      :: Compressed stream.
+	 * @param[out] output     :: Decompressed stream is appended to this vector.
+	 * @param[in]  size_limit :: Fails rather than output more than this many bytes.
+	 *                           If it's the exact size, the output is sized once.
+	 * @return True on success, false if the stream is malformed, truncated or over
+	 *         the limit, in which case the output is left as it was.
+	 */
+	bool decompress_raw(std::span<const std::uint8_t> input, std::vector<std::uint8_t>& output,
+		std::size_t size_limit = SIZE_MAX) noexcept;
+
+	/**
+	 * @brief Upper bound of what a DEFLATE stream of the given size can expand to,
+	 *        at the format's best ratio of 1032:1, plus some block overhead.
+	 */
+	constexpr std::size_t max_inflated_size(std::size_t input_size) noexcept {
+		return input_size > (SIZE_MAX - 64) / 1032 ? SIZE_MAX : input_size * 1032 + 64;
+	}
+
+	/**
+	 * @brief Computes an Adler-32 checksum, chainable through the 'adler' argument.
+	 */
+	std::uint32_t adler32(std::span<const std::uint8_t> data, std::uint32_t adler = 1) noexcept;
+
+	/**
+	 * @brief Computes a CRC-32 (ISO-HDLC) checksum, chainable through the 'crc' argument.
+	 */
+	std::uint32_t crc32(std::span<const std::uint8_t> data, std::uint32_t crc = 0) noexcept;
+}
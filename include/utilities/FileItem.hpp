@@ -7,6 +7,7 @@
 #pragma once
 
 #include "SimpleFileIO.hpp"
+#include "ZipArchive.hpp"
 
 /*==================================================================*/
 
@@ -21,7 +22,11 @@ public:
 	FileItem(T&& path) noexcept : m_path(std::forward<T>(path)), m_exists(true) {}
 
 	bool exists() noexcept {
-		auto exists = fs::is_regular_file(m_path);
+		// archive entries are named '<archive>.zip/<entry>', check the archive instead
+		const auto path_str = m_path.string();
+		const auto archive  = ZipArchive::split_entry_path(path_str).first;
+
+		auto exists = fs::is_regular_file(archive.empty() ? m_path : fs::Path(archive));
 		return m_exists = !(!exists || !exists.value());
 	}
 
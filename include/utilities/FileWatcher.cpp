@@ -0,0 +1,166 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <new>
+#include <tuple>
+#include <vector>
+#include <filesystem>
+
+#include "FileWatcher.hpp"
+#include "Thread.hpp"
+
+#if defined(__linux__)
+	#include <sys/inotify.h>
+	#include <sys/eventfd.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <climits>
+	#include <cerrno>
+	#include <cstdint>
+#endif
+
+/*==================================================================*/
+
+struct FileWatcher::Context {
+	struct Entry {
+		std::string path{};
+		std::string directory{};
+		std::string file_name{};
+		int watch_id = -1;
+	};
+
+	std::vector<Entry> entries{};
+	Callback callback{};
+	Thread   thread{};
+
+	int notify_fd = -1; // inotify instance
+	int wake_fd   = -1; // eventfd, signalled to unblock the thread on stop()
+
+#if defined(__linux__)
+	~Context() noexcept {
+		if (notify_fd >= 0) { ::close(notify_fd); }
+		if (wake_fd   >= 0) { ::close(wake_fd);   }
+	}
+
+	void dispatch(const inotify_event& event) noexcept {
+		if (!event.len) { return; }
+		const std::string_view file_name(event.name);
+
+		for (const auto& entry : entries) {
+			if (entry.watch_id != event.wd || entry.file_name != file_name) { continue; }
+			try { callback(entry.path); } catch (...) {}
+		}
+	}
+
+	void watch_loop(StopToken token) noexcept {
+		// inotify_event is variable-sized, the buffer must fit at least one with NAME_MAX
+		alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+
+		pollfd fds[2] = {
+			{ notify_fd, POLLIN, 0 },
+			{ wake_fd,   POLLIN, 0 },
+		};
+
+		while (!token.stop_requested()) {
+			if (::poll(fds, 2, -1) < 0) {
+				if (errno == EINTR) { continue; } else { return; }
+			}
+			if (fds[1].revents || token.stop_requested()) { return; }
+			if (!(fds[0].revents & POLLIN)) { continue; }
+
+			for (;;) {
+				const auto length = ::read(notify_fd, buffer, sizeof(buffer));
+				if (length <= 0) { break; } // EAGAIN, queue drained
+
+				for (auto* ptr = buffer; ptr < buffer + length; ) {
+					const auto& event = *reinterpret_cast<const inotify_event*>(ptr);
+					dispatch(event);
+					ptr += sizeof(inotify_event) + event.len;
+				}
+			}
+		}
+	}
+#endif
+};
+
+/*==================================================================*/
+
+FileWatcher::FileWatcher() noexcept
+	: m_context(new (std::nothrow) Context)
+{}
+
+FileWatcher::~FileWatcher() noexcept { stop(); }
+
+bool FileWatcher::watch(std::string_view file_path) noexcept {
+	if (!m_context || is_running()) { return false; }
+
+	try {
+		const std::filesystem::path path(file_path);
+		if (!path.has_filename()) { return false; }
+
+		auto directory = path.parent_path().string();
+		if (directory.empty()) { directory = "."; }
+
+		m_context->entries.push_back({ std::string(file_path),
+			std::move(directory), path.filename().string() });
+		return true;
+	}
+	catch (...) { return false; }
+}
+
+bool FileWatcher::start([[maybe_unused]] Callback callback) noexcept {
+	if (!m_context || is_running() || m_context->entries.empty()) { return false; }
+
+#if defined(__linux__)
+	auto& ctx = *m_context;
+
+	if (ctx.notify_fd < 0) { ctx.notify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC); }
+	if (ctx.wake_fd   < 0) { ctx.wake_fd   = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC); }
+	if (ctx.notify_fd < 0 || ctx.wake_fd < 0) { return false; }
+
+	// a finished write, or a file renamed into place over the original
+	static constexpr std::uint32_t c_watch_mask = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+	bool any_watched = false;
+	for (auto& entry : ctx.entries) {
+		entry.watch_id = ::inotify_add_watch(ctx.notify_fd,
+			entry.directory.c_str(), c_watch_mask);
+		any_watched |= entry.watch_id >= 0;
+	}
+	if (!any_watched) { return false; }
+
+	ctx.callback = std::move(callback);
+
+	try {
+		ctx.thread = Thread([&ctx](StopToken token) noexcept {
+			ctx.watch_loop(token);
+		});
+		return true;
+	}
+	catch (...) { return false; }
+#else
+	return false;
+#endif
+}
+
+void FileWatcher::stop() noexcept {
+	if (!is_running()) { return; }
+
+	m_context->thread.request_stop();
+#if defined(__linux__)
+	static constexpr std::uint64_t wake_value = 1;
+	std::ignore = ::write(m_context->wake_fd, &wake_value, sizeof(wake_value));
+#endif
+	m_context->thread.join();
+#if defined(__linux__)
+	std::uint64_t drained; // re-arm for a later start()
+	std::ignore = ::read(m_context->wake_fd, &drained, sizeof(drained));
+#endif
+}
+
+bool FileWatcher::is_running() const noexcept {
+	return m_context && m_context->thread.joinable();
+}
@@ -0,0 +1,62 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <functional>
+
+/*==================================================================*/
+
+/**
+ * @brief Watches a set of files for being rewritten on disk, and runs a callback on a
+ *        dedicated thread for each one that was. The thread sleeps on the OS' change
+ *        notifications rather than polling: the parent directories are watched, so that
+ *        editors saving through a rename (new inode) are picked up just the same.
+ *
+ * Files are registered with watch() before start(), and stop() (or destruction) joins
+ * the watcher thread. Callbacks may run for a file more than once per save.
+ *
+ * @warning Only implemented on Linux (inotify) for now. Elsewhere start() returns false
+ *          and the files are simply never reported.
+ */
+class FileWatcher final {
+	struct Context;
+	std::unique_ptr<Context> m_context;
+
+public:
+	using Callback = std::function<void(const std::string& file_path)>;
+
+#if defined(__linux__)
+	static constexpr bool is_supported = true;
+#else
+	static constexpr bool is_supported = false;
+#endif
+
+	FileWatcher() noexcept;
+	~FileWatcher() noexcept;
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	/**
+	 * @brief Registers a file to watch, it does not need to exist yet.
+	 * @return False if already started, or the path has no file name.
+	 */
+	bool watch(std::string_view file_path) noexcept;
+
+	/**
+	 * @brief Starts the watcher thread, calling @p callback with the path given to watch().
+	 * @return True if the thread is running and at least one file is being watched.
+	 */
+	bool start(Callback callback) noexcept;
+
+	void stop() noexcept;
+
+	bool is_running() const noexcept;
+};
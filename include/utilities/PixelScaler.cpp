@@ -0,0 +1,687 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "PixelScaler.hpp"
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+/*==================================================================*/
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define PIXEL_SCALER_X86_INTRINSICS
+#endif
+
+#ifdef PIXEL_SCALER_X86_INTRINSICS
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#  include <immintrin.h>
+#  if defined(__GNUC__)
+#    define AVX2_TARGET [[gnu::target("avx2")]]
+#  else
+#    define AVX2_TARGET
+#  endif
+#endif
+
+/*==================================================================*/
+
+#ifdef PIXEL_SCALER_X86_INTRINSICS
+static bool avx2_supported() noexcept {
+	static const bool result = []() noexcept {
+#  ifdef _MSC_VER
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7) { return false; }
+
+		// the OS must also be saving the upper halves of the YMM registers
+		__cpuid(info, 1);
+		if (!((info[2] >> 27) & 1) || (_xgetbv(0) & 0x6) != 0x6) { return false; }
+
+		__cpuidex(info, 7, 0);
+		return bool((info[1] >> 5) & 1);
+#  else
+		return __builtin_cpu_supports("avx2");
+#  endif
+	}();
+	return result;
+}
+#endif
+
+/*==================================================================*/
+
+namespace {
+	using pixel_scaler::Order;
+
+	static constexpr s32 c_max_unrolled = 8;
+
+	/**
+	 * Per byte lane of a pixel, in memory order (A, B, G, R), the tint reduces to
+	 * out = (in * mul + add) >> 8, with mul in [0, 256] and the rounding folded
+	 * into add. Neither term can exceed 16 bits, letting SIMD stay in u16 lanes.
+	 */
+	struct Blend {
+		std::array<u16, 4> mul{ 256, 256, 256, 256 };
+		std::array<u16, 4> add{ 128, 128, 128, 128 };
+
+		bool is_identity() const noexcept {
+			return mul == decltype(mul){ 256, 256, 256, 256 }
+				&& add == decltype(add){ 128, 128, 128, 128 };
+		}
+
+		u64 mul_lanes() const noexcept { return std::bit_cast<u64>(mul); }
+		u64 add_lanes() const noexcept { return std::bit_cast<u64>(add); }
+
+		// image at tint.A opacity over tint's RGB, then darkened by 'darken'
+		static Blend make(RGBA tint, u8 darken = 0) noexcept {
+			const auto opacity = u32(tint.A + (tint.A >> 7));
+			const auto lighten = u32(256 - darken - (darken >> 7));
+			const u8 backdrop[4] = { 0, tint.B, tint.G, tint.R };
+
+			Blend blend;
+			for (auto c = 1; c < 4; ++c) {
+				blend.mul[c] = u16(opacity * lighten >> 8);
+				blend.add[c] = u16((backdrop[c] * (256 - opacity) * lighten >> 8) + 128);
+			}
+			return blend;
+		}
+	};
+
+	/*==================================================================*/
+
+	template <Order O>
+	constexpr u32 order_pixel(u32 pixel) noexcept {
+		if constexpr (O == Order::XRGB) {
+			return std::rotr(pixel, 8);
+		} else if constexpr (O == Order::XBGR) {
+			return (std::rotr(pixel, 8) & 0xFF00FF00) | (std::rotl(pixel, 8) & 0x00FF00FF);
+		} else {
+			return pixel;
+		}
+	}
+
+	u32  blend_pixel(u32 pixel, const Blend& blend) noexcept {
+		u32 result = 0;
+		for (auto c = 0; c < 4; ++c) {
+			const auto channel = (pixel >> (c * 8)) & 0xFF;
+			result |= ((channel * blend.mul[c] + blend.add[c]) >> 8) << (c * 8);
+		}
+		return result;
+	}
+
+	// Lerps two packed pixels two channels at a time, 'weight' in [0, 256] towards b, rounded.
+	constexpr u32 lerp_pixel(u32 a, u32 b, u32 weight) noexcept {
+		const auto inverse = 256 - weight;
+		const auto rb = ((a & 0x00FF00FF) * inverse + (b & 0x00FF00FF) * weight + 0x00800080) >> 8;
+		const auto ag = ((a >> 8 & 0x00FF00FF) * inverse + (b >> 8 & 0x00FF00FF) * weight + 0x00800080);
+		return (rb & 0x00FF00FF) | (ag & 0xFF00FF00);
+	}
+
+	/*==================================================================*/
+
+	/**
+	 * Every kernel set provides the same three row operations:
+	 *  - expand<O, F>: blends and orders 'count' source pixels, writing each F times;
+	 *  - finish<O>:    blends and orders 'count' pixels in place;
+	 *  - lerp:         lerps two rows into a third, 'weight' in [0, 256] towards b.
+	 */
+	using ExpandFn = void (*)(u32* dst, const u32* src, s32 count, const Blend& blend) noexcept;
+	using FinishFn = void (*)(u32* row, s32 count, const Blend& blend) noexcept;
+	using LerpFn   = void (*)(u32* dst, const u32* a, const u32* b, s32 count, u32 weight) noexcept;
+
+	struct ScalarKernels {
+		static constexpr const char* name = "scalar";
+
+		template <Order O, s32 F>
+		static void expand(u32* dst, const u32* src, s32 count, const Blend& blend) noexcept {
+			const auto identity = blend.is_identity();
+			for (auto i = 0; i < count; ++i) {
+				const auto pixel = order_pixel<O>(identity ? src[i] : blend_pixel(src[i], blend));
+				for (auto n = 0; n < F; ++n) { *dst++ = pixel; }
+			}
+		}
+
+		template <Order O>
+		static void finish(u32* row, s32 count, const Blend& blend) noexcept {
+			if (blend.is_identity()) {
+				if constexpr (O == Order::RGBX) { return; }
+				for (auto i = 0; i < count; ++i) { row[i] = order_pixel<O>(row[i]); }
+			} else {
+				for (auto i = 0; i < count; ++i) { row[i] = order_pixel<O>(blend_pixel(row[i], blend)); }
+			}
+		}
+
+		static void lerp(u32* dst, const u32* a, const u32* b, s32 count, u32 weight) noexcept {
+			for (auto i = 0; i < count; ++i) { dst[i] = lerp_pixel(a[i], b[i], weight); }
+		}
+	};
+
+	/*==================================================================*/
+
+#ifdef PIXEL_SCALER_X86_INTRINSICS
+	struct SSE2Kernels {
+		static constexpr const char* name = "SSE2";
+
+		template <Order O>
+		static __m128i order_pixels(__m128i v) noexcept {
+			if constexpr (O == Order::XRGB) {
+				return _mm_or_si128(_mm_srli_epi32(v, 8), _mm_slli_epi32(v, 24));
+			} else if constexpr (O == Order::XBGR) {
+				const auto rotr = _mm_or_si128(_mm_srli_epi32(v, 8), _mm_slli_epi32(v, 24));
+				const auto rotl = _mm_or_si128(_mm_slli_epi32(v, 8), _mm_srli_epi32(v, 24));
+				return _mm_or_si128(
+					_mm_and_si128(rotr, _mm_set1_epi32(s32(0xFF00FF00))),
+					_mm_and_si128(rotl, _mm_set1_epi32(s32(0x00FF00FF))));
+			} else {
+				return v;
+			}
+		}
+
+		static __m128i blend_pixels(__m128i v, __m128i mul, __m128i add) noexcept {
+			const auto zero = _mm_setzero_si128();
+			const auto lo = _mm_unpacklo_epi8(v, zero);
+			const auto hi = _mm_unpackhi_epi8(v, zero);
+			return _mm_packus_epi16(
+				_mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, mul), add), 8),
+				_mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, mul), add), 8));
+		}
+
+		template <s32 F>
+		static void store_run(u32* dst, __m128i pixel) noexcept {
+			auto n = 0;
+			for (; n + 4 <= F; n += 4) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n), pixel); }
+			if constexpr (F % 4 >= 2) { _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + n), pixel); n += 2; }
+			if constexpr (F % 2 == 1) { dst[n] = u32(_mm_cvtsi128_si32(pixel)); }
+		}
+
+		template <Order O, s32 F>
+		static void expand(u32* dst, const u32* src, s32 count, const Blend& blend) noexcept {
+			const auto identity = blend.is_identity();
+			const auto mul = _mm_set1_epi64x(s64(blend.mul_lanes()));
+			const auto add = _mm_set1_epi64x(s64(blend.add_lanes()));
+
+			auto i = 0;
+			for (; i + 4 <= count; i += 4, dst += 4 * F) {
+				auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				v = order_pixels<O>(identity ? v : blend_pixels(v, mul, add));
+
+				if constexpr (F == 1) {
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+				} else if constexpr (F == 2) {
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi32(v, v));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi32(v, v));
+				} else {
+					store_run<F>(dst + 0 * F, _mm_shuffle_epi32(v, 0x00));
+					store_run<F>(dst + 1 * F, _mm_shuffle_epi32(v, 0x55));
+					store_run<F>(dst + 2 * F, _mm_shuffle_epi32(v, 0xAA));
+					store_run<F>(dst + 3 * F, _mm_shuffle_epi32(v, 0xFF));
+				}
+			}
+			ScalarKernels::expand<O, F>(dst, src + i, count - i, blend);
+		}
+
+		template <Order O>
+		static void finish(u32* row, s32 count, const Blend& blend) noexcept {
+			const auto identity = blend.is_identity();
+			if (identity && O == Order::RGBX) { return; }
+
+			const auto mul = _mm_set1_epi64x(s64(blend.mul_lanes()));
+			const auto add = _mm_set1_epi64x(s64(blend.add_lanes()));
+
+			auto i = 0;
+			for (; i + 4 <= count; i += 4) {
+				auto* ptr = reinterpret_cast<__m128i*>(row + i);
+				const auto v = _mm_loadu_si128(ptr);
+				_mm_storeu_si128(ptr, order_pixels<O>(identity ? v : blend_pixels(v, mul, add)));
+			}
+			ScalarKernels::finish<O>(row + i, count - i, blend);
+		}
+
+		static void lerp(u32* dst, const u32* a, const u32* b, s32 count, u32 weight) noexcept {
+			const auto zero = _mm_setzero_si128();
+			const auto wa = _mm_set1_epi16(s16(256 - weight));
+			const auto wb = _mm_set1_epi16(s16(weight));
+			const auto round = _mm_set1_epi16(128);
+
+			const auto lerp_half = [&](__m128i x, __m128i y) noexcept {
+				return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(
+					_mm_mullo_epi16(x, wa), _mm_mullo_epi16(y, wb)), round), 8);
+			};
+
+			auto i = 0;
+			for (; i + 4 <= count; i += 4) {
+				const auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				const auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(
+					lerp_half(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero)),
+					lerp_half(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero))));
+			}
+			ScalarKernels::lerp(dst + i, a + i, b + i, count - i, weight);
+		}
+	};
+
+	/*==================================================================*/
+
+	struct AVX2Kernels {
+		static constexpr const char* name = "AVX2";
+
+		// lane j of the k-th output vector of an F-times expansion holds pixel (8k + j) / F
+		static constexpr auto c_expand_indices = []() noexcept {
+			std::array<std::array<std::array<s32, 8>, c_max_unrolled>, c_max_unrolled + 1> table{};
+			for (auto F = 1; F <= c_max_unrolled; ++F) {
+				for (auto k = 0; k < F; ++k) {
+					for (auto j = 0; j < 8; ++j) { table[F][k][j] = (8 * k + j) / F; }
+				}
+			}
+			return table;
+		}();
+
+		template <Order O> AVX2_TARGET
+		static __m256i order_pixels(__m256i v) noexcept {
+			if constexpr (O == Order::XRGB) {
+				return _mm256_or_si256(_mm256_srli_epi32(v, 8), _mm256_slli_epi32(v, 24));
+			} else if constexpr (O == Order::XBGR) {
+				const auto rotr = _mm256_or_si256(_mm256_srli_epi32(v, 8), _mm256_slli_epi32(v, 24));
+				const auto rotl = _mm256_or_si256(_mm256_slli_epi32(v, 8), _mm256_srli_epi32(v, 24));
+				return _mm256_or_si256(
+					_mm256_and_si256(rotr, _mm256_set1_epi32(s32(0xFF00FF00))),
+					_mm256_and_si256(rotl, _mm256_set1_epi32(s32(0x00FF00FF))));
+			} else {
+				return v;
+			}
+		}
+
+		AVX2_TARGET
+		static __m256i blend_pixels(__m256i v, __m256i mul, __m256i add) noexcept {
+			const auto zero = _mm256_setzero_si256();
+			const auto lo = _mm256_unpacklo_epi8(v, zero);
+			const auto hi = _mm256_unpackhi_epi8(v, zero);
+			return _mm256_packus_epi16(
+				_mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(lo, mul), add), 8),
+				_mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(hi, mul), add), 8));
+		}
+
+		template <Order O, s32 F> AVX2_TARGET
+		static void expand(u32* dst, const u32* src, s32 count, const Blend& blend) noexcept {
+			const auto identity = blend.is_identity();
+			const auto mul = _mm256_set1_epi64x(s64(blend.mul_lanes()));
+			const auto add = _mm256_set1_epi64x(s64(blend.add_lanes()));
+
+			__m256i indices[F];
+			for (auto k = 0; k < F; ++k) {
+				indices[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c_expand_indices[F][k].data()));
+			}
+
+			auto i = 0;
+			for (; i + 8 <= count; i += 8, dst += 8 * F) {
+				auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+				v = order_pixels<O>(identity ? v : blend_pixels(v, mul, add));
+
+				for (auto k = 0; k < F; ++k) {
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 8 * k),
+						F == 1 ? v : _mm256_permutevar8x32_epi32(v, indices[k]));
+				}
+			}
+			ScalarKernels::expand<O, F>(dst, src + i, count - i, blend);
+		}
+
+		template <Order O> AVX2_TARGET
+		static void finish(u32* row, s32 count, const Blend& blend) noexcept {
+			const auto identity = blend.is_identity();
+			if (identity && O == Order::RGBX) { return; }
+
+			const auto mul = _mm256_set1_epi64x(s64(blend.mul_lanes()));
+			const auto add = _mm256_set1_epi64x(s64(blend.add_lanes()));
+
+			auto i = 0;
+			for (; i + 8 <= count; i += 8) {
+				auto* ptr = reinterpret_cast<__m256i*>(row + i);
+				const auto v = _mm256_loadu_si256(ptr);
+				_mm256_storeu_si256(ptr, order_pixels<O>(identity ? v : blend_pixels(v, mul, add)));
+			}
+			ScalarKernels::finish<O>(row + i, count - i, blend);
+		}
+
+		AVX2_TARGET
+		static void lerp(u32* dst, const u32* a, const u32* b, s32 count, u32 weight) noexcept {
+			const auto zero = _mm256_setzero_si256();
+			const auto wa = _mm256_set1_epi16(s16(256 - weight));
+			const auto wb = _mm256_set1_epi16(s16(weight));
+			const auto round = _mm256_set1_epi16(128);
+
+			auto i = 0;
+			for (; i + 8 <= count; i += 8) {
+				const auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				const auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+
+				const auto lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(
+					_mm256_mullo_epi16(_mm256_unpacklo_epi8(va, zero), wa),
+					_mm256_mullo_epi16(_mm256_unpacklo_epi8(vb, zero), wb)), round), 8);
+				const auto hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(
+					_mm256_mullo_epi16(_mm256_unpackhi_epi8(va, zero), wa),
+					_mm256_mullo_epi16(_mm256_unpackhi_epi8(vb, zero), wb)), round), 8);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+			}
+			ScalarKernels::lerp(dst + i, a + i, b + i, count - i, weight);
+		}
+	};
+#endif
+
+	/*==================================================================*/
+
+	struct KernelSet {
+		using ExpandTable = std::array<ExpandFn, c_max_unrolled + 1>;
+
+		const char* name;
+		std::array<ExpandTable, 3> expand;
+		std::array<FinishFn, 3>    finish;
+		LerpFn lerp;
+	};
+
+	template <typename K, Order O>
+	constexpr auto make_expand_table() noexcept {
+		return []<std::size_t... I>(std::index_sequence<I...>) noexcept {
+			return KernelSet::ExpandTable{ nullptr, &K::template expand<O, s32(I + 1)>... };
+		}(std::make_index_sequence<c_max_unrolled>{});
+	}
+
+	template <typename K>
+	constexpr KernelSet make_kernel_set() noexcept {
+		return {
+			K::name,
+			{ make_expand_table<K, Order::RGBX>(),
+			  make_expand_table<K, Order::XRGB>(),
+			  make_expand_table<K, Order::XBGR>() },
+			{ &K::template finish<Order::RGBX>,
+			  &K::template finish<Order::XRGB>,
+			  &K::template finish<Order::XBGR>  },
+			&K::lerp
+		};
+	}
+
+	const KernelSet& get_kernels() noexcept {
+	#ifdef PIXEL_SCALER_X86_INTRINSICS
+		static constexpr auto s_avx2_kernels = make_kernel_set<AVX2Kernels>();
+		static constexpr auto s_sse2_kernels = make_kernel_set<SSE2Kernels>();
+		return avx2_supported() ? s_avx2_kernels : s_sse2_kernels;
+	#else
+		static constexpr auto s_scalar_kernels = make_kernel_set<ScalarKernels>();
+		return s_scalar_kernels;
+	#endif
+	}
+
+	/*==================================================================*/
+
+	struct Job {
+		const KernelSet& kernels;
+		const u32* src; s32 src_pitch, src_w, src_h;
+		/***/ u32* dst; s32 dst_pitch, dst_w, dst_h;
+		const pixel_scaler::Options& options;
+
+		u32* dst_row(s32 y) const noexcept { return dst + std::size_t(y) * dst_pitch; }
+		const u32* src_row(s32 y) const noexcept { return src + std::size_t(y) * src_pitch; }
+
+		FinishFn finish() const noexcept { return kernels.finish[std::size_t(options.order)]; }
+	};
+
+	// Replicates each source pixel F times across, and each row F_y times down,
+	// computing at most two distinct rows per source row and copying the rest.
+	void scale_integer(const Job& job, s32 factor_x, s32 factor_y) noexcept {
+		const auto& options = job.options;
+
+		const auto lit_blend = Blend::make(options.tint);
+		const auto row_blend = Blend::make(options.tint, options.scanlines);
+		const auto col_blend = Blend::make(options.tint, options.grid);
+		const auto dim_blend = Blend::make(options.tint, u8(std::max(options.scanlines, options.grid)));
+
+		const auto scanlines = options.scanlines && factor_y > 1;
+		const auto grid      = options.grid      && factor_x > 1;
+
+		const auto expand = factor_x <= c_max_unrolled
+			? job.kernels.expand[std::size_t(options.order)][factor_x] : nullptr;
+
+		const auto expand_row = [&](u32* dst, const u32* src, const Blend& blend) noexcept {
+			if (expand) {
+				expand(dst, src, job.src_w, blend);
+			} else {
+				for (auto x = 0; x < job.src_w; ++x) {
+					std::fill_n(dst + x * factor_x, factor_x, src[x]);
+				}
+				job.finish()(dst, job.dst_w, blend);
+			}
+		};
+
+		// the grid's dimmed column is patched over the expanded row afterwards
+		const auto patch_grid = [&](u32* dst, const u32* src, const Blend& blend) noexcept {
+			if (!grid) { return; }
+			for (auto x = 0; x < job.src_w; ++x) {
+				auto* pixel = dst + x * factor_x + factor_x - 1;
+				*pixel = src[x];
+				job.finish()(pixel, 1, blend);
+			}
+		};
+
+		for (auto y = 0; y < job.src_h; ++y) {
+			const auto* src = job.src_row(y);
+			auto* first_row = job.dst_row(y * factor_y);
+
+			expand_row(first_row, src, lit_blend);
+			patch_grid(first_row, src, col_blend);
+
+			const auto body_rows = scanlines ? factor_y - 1 : factor_y;
+			for (auto n = 1; n < body_rows; ++n) {
+				std::memcpy(job.dst_row(y * factor_y + n), first_row, job.dst_w * sizeof(u32));
+			}
+
+			if (scanlines) {
+				auto* last_row = job.dst_row(y * factor_y + factor_y - 1);
+				expand_row(last_row, src, row_blend);
+				patch_grid(last_row, src, dim_blend);
+			}
+		}
+	}
+
+	// Nearest-neighbor for arbitrary sizes, sampling at pixel centers same as SDL does.
+	void scale_nearest(const Job& job) noexcept {
+		const auto blend  = Blend::make(job.options.tint);
+		const auto x_step = (u64(job.src_w) << 32) / u64(job.dst_w);
+
+		const u32* last_src_row = nullptr;
+		const u32* last_dst_row = nullptr;
+
+		for (auto y = 0; y < job.dst_h; ++y) {
+			auto* dst_row = job.dst_row(y);
+			const auto* src_row = job.src_row(s32(u64(2 * y + 1) * job.src_h / (2 * u64(job.dst_h))));
+
+			if (src_row == last_src_row) {
+				std::memcpy(dst_row, last_dst_row, job.dst_w * sizeof(u32));
+				continue;
+			}
+
+			auto src_x = x_step / 2;
+			for (auto x = 0; x < job.dst_w; ++x, src_x += x_step) {
+				dst_row[x] = src_row[src_x >> 32];
+			}
+			job.finish()(dst_row, job.dst_w, blend);
+
+			last_src_row = src_row;
+			last_dst_row = dst_row;
+		}
+	}
+
+	/*==================================================================*/
+
+	struct Tap { s32 index; u32 weight; };
+
+	/**
+	 * Sampling positions equivalent to prescaling by the largest integer factor
+	 * that fits, then bilinear filtering to the final size: pixels stay sharp,
+	 * and only the seams between them are blended over about one output pixel.
+	 */
+	void make_sharp_taps(std::vector<Tap>& taps, s32 src_n, s32 dst_n) {
+		const auto scale    = f32(dst_n) / f32(src_n);
+		const auto prescale = std::max(std::floor(scale), 1.0f);
+		const auto region   = 0.5f - 0.5f / prescale;
+
+		taps.resize(dst_n);
+		for (auto i = 0; i < dst_n; ++i) {
+			const auto texel  = (f32(i) + 0.5f) / scale;
+			const auto base   = std::floor(texel);
+			const auto center = texel - base - 0.5f;
+
+			const auto offset = (center - std::clamp(center, -region, region)) * prescale;
+			const auto sample = base + offset;
+			const auto index  = std::floor(sample);
+
+			auto& tap = taps[i];
+			tap.index  = s32(index);
+			tap.weight = u32(std::lround((sample - index) * 256.0f));
+
+			if (tap.index < 0) { tap.index = 0; tap.weight = 0; }
+			if (tap.index >= src_n - 1) { tap.index = src_n - 1; tap.weight = 0; }
+		}
+	}
+
+	void scale_sharp_bilinear(const Job& job) noexcept {
+		thread_local std::vector<Tap> x_taps, y_taps;
+		thread_local std::vector<u32> blended_row;
+
+		try {
+			make_sharp_taps(x_taps, job.src_w, job.dst_w);
+			make_sharp_taps(y_taps, job.src_h, job.dst_h);
+			blended_row.resize(job.src_w + 1);
+		}
+		catch (...) { scale_nearest(job); return; }
+
+		const auto blend = Blend::make(job.options.tint);
+
+		auto last_tap = Tap{ -1, 0 };
+		const u32* last_dst_row = nullptr;
+
+		for (auto y = 0; y < job.dst_h; ++y) {
+			auto* dst_row = job.dst_row(y);
+			const auto tap = y_taps[y];
+
+			if (tap.index == last_tap.index && tap.weight == last_tap.weight) {
+				std::memcpy(dst_row, last_dst_row, job.dst_w * sizeof(u32));
+				continue;
+			}
+
+			const auto* row_a = job.src_row(tap.index);
+			const auto* row_b = tap.weight ? job.src_row(tap.index + 1) : row_a;
+
+			const u32* row = row_a;
+			if (tap.weight) {
+				job.kernels.lerp(blended_row.data(), row_a, row_b, job.src_w, tap.weight);
+				row = blended_row.data();
+			}
+
+			for (auto x = 0; x < job.dst_w; ++x) {
+				const auto [index, weight] = x_taps[x];
+				dst_row[x] = weight ? lerp_pixel(row[index], row[index + 1], weight) : row[index];
+			}
+			job.finish()(dst_row, job.dst_w, blend);
+
+			last_tap = tap;
+			last_dst_row = dst_row;
+		}
+	}
+
+	/*==================================================================*/
+
+	// Scale2x (EPX), copying a neighbor into a corner only where two edges meet.
+	void scale2x(std::vector<u32>& out, const u32* src, s32 pitch, s32 w, s32 h) {
+		out.resize(std::size_t(w) * h * 4);
+
+		for (auto y = 0; y < h; ++y) {
+			const auto* row_up = src + std::size_t(std::max(y - 1, 0)) * pitch;
+			const auto* row    = src + std::size_t(y) * pitch;
+			const auto* row_dn = src + std::size_t(std::min(y + 1, h - 1)) * pitch;
+
+			auto* dst0 = out.data() + std::size_t(y * 2 + 0) * w * 2;
+			auto* dst1 = out.data() + std::size_t(y * 2 + 1) * w * 2;
+
+			for (auto x = 0; x < w; ++x) {
+				const auto B = row_up[x];
+				const auto D = row[std::max(x - 1, 0)];
+				const auto E = row[x];
+				const auto F = row[std::min(x + 1, w - 1)];
+				const auto H = row_dn[x];
+
+				const auto edge = B != H && D != F;
+				dst0[x * 2 + 0] = edge && D == B ? D : E;
+				dst0[x * 2 + 1] = edge && B == F ? F : E;
+				dst1[x * 2 + 0] = edge && D == H ? D : E;
+				dst1[x * 2 + 1] = edge && H == F ? F : E;
+			}
+		}
+	}
+
+	// Smooths edges with up to two Scale2x passes, replicating the rest of the way.
+	void scale_edge_smooth(const Job& job, s32 factor_x, s32 factor_y) noexcept {
+		thread_local std::vector<u32> pass_a, pass_b;
+
+		const u32* src = job.src;
+		auto pitch = job.src_pitch;
+		auto w = job.src_w, h = job.src_h;
+
+		try {
+			for (auto* pass : { &pass_a, &pass_b }) {
+				if (factor_x % 2 || factor_y % 2) { break; }
+				scale2x(*pass, src, pitch, w, h);
+				src = pass->data(); w *= 2; h *= 2; pitch = w;
+				factor_x /= 2; factor_y /= 2;
+			}
+		}
+		catch (...) { src = job.src; pitch = job.src_pitch; w = job.src_w; h = job.src_h; }
+
+		scale_integer(Job{ job.kernels, src, pitch, w, h,
+			job.dst, job.dst_pitch, job.dst_w, job.dst_h, job.options },
+			job.dst_w / w, job.dst_h / h);
+	}
+}
+
+/*==================================================================*/
+
+void pixel_scaler::scale(
+	const u32* src, s32 src_pitch, s32 src_w, s32 src_h,
+	/***/ u32* dst, s32 dst_pitch, s32 dst_w, s32 dst_h,
+	const Options& options
+) noexcept {
+	if (!src || !dst || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) { return; }
+
+	const auto job = Job{ get_kernels(),
+		src, src_pitch, src_w, src_h,
+		dst, dst_pitch, dst_w, dst_h, options };
+
+	const auto integer_x = dst_w % src_w == 0;
+	const auto integer_y = dst_h % src_h == 0;
+
+	if (integer_x && integer_y) {
+		const auto factor_x = dst_w / src_w;
+		const auto factor_y = dst_h / src_h;
+
+		if (options.filter == Filter::EDGE_SMOOTH && factor_x > 1 && factor_y > 1) {
+			scale_edge_smooth(job, factor_x, factor_y);
+		} else {
+			// at whole multiples, sharp bilinear has no seams left to blend
+			scale_integer(job, factor_x, factor_y);
+		}
+	} else if (options.filter == Filter::SHARP_BILINEAR) {
+		scale_sharp_bilinear(job);
+	} else {
+		scale_nearest(job);
+	}
+}
+
+const char* pixel_scaler::get_kernel_name() noexcept {
+	return get_kernels().name;
+}
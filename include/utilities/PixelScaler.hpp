@@ -0,0 +1,67 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "ColorOps.hpp"
+
+/*==================================================================*/
+
+/**
+ * @brief CPU scaling of finished frames for presentation and capture. The
+ *        texture tint, the output channel order and the scanline/grid effects
+ *        are folded into the scaling pass itself, so a frame is read once and
+ *        each distinct output row is produced once, the rest being row copies.
+ *        Kernels are picked at runtime between AVX2, SSE2 and scalar code.
+ */
+namespace pixel_scaler {
+	enum class Filter : u8 {
+		NEAREST,        // pixel replication, integer factors of 1-8x use unrolled kernels
+		SHARP_BILINEAR, // integer prescale followed by bilinear, for fractional sizes
+		EDGE_SMOOTH,    // Scale2x edge interpolation ahead of replication, for low-res art
+		COUNT
+	};
+
+	enum class Order : u8 {
+		RGBX, // as the cores emit it, left untouched
+		XRGB,
+		XBGR,
+	};
+
+	struct Options {
+		Filter filter = Filter::NEAREST;
+		Order  order  = Order::RGBX;
+
+		// Applied the way the renderer path draws it: the image at tint.A opacity over tint's RGB.
+		RGBA   tint = RGBA::White;
+
+		// Darkening of the last row/column of every scaled pixel, 0 disables.
+		// Only the integer factor paths have whole pixels to apply these to.
+		u8     scanlines = 0;
+		u8     grid      = 0;
+
+		friend constexpr bool operator==(const Options& lhs, const Options& rhs) noexcept {
+			return lhs.filter == rhs.filter && lhs.order == rhs.order
+				&& lhs.tint.raw() == rhs.tint.raw()
+				&& lhs.scanlines == rhs.scanlines && lhs.grid == rhs.grid;
+		}
+	};
+
+	/**
+	 * @brief Scales an RGBX image onto a destination of any size.
+	 * @param[in]  src       :: Source pixels, 'src_pitch' pixels apart per row.
+	 * @param[out] dst       :: Destination pixels, 'dst_pitch' pixels apart per row.
+	 * @param[in]  options   :: Filter, channel order, tint and effects, see Options.
+	 * @note Source and destination must not overlap.
+	 */
+	void scale(
+		const u32* src, s32 src_pitch, s32 src_w, s32 src_h,
+		/***/ u32* dst, s32 dst_pitch, s32 dst_w, s32 dst_h,
+		const Options& options = {}) noexcept;
+
+	// Name of the kernel set picked for this CPU, for logging.
+	const char* get_kernel_name() noexcept;
+}
@@ -0,0 +1,168 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "RelaxCPU.hpp"
+
+#include <new>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+/*==================================================================*/
+
+/**
+ * @brief Thread-safe container for a small trivially-copyable object, published
+ *        through a sequence lock instead of a shared_ptr swap.
+ *
+ * Counterpart of AtomicBox for objects mutated every frame: 'edit()' works on a
+ * stack copy and publishes it in place, 'read()' and 'copy()' take a stack copy
+ * and retry if a publish raced with it. Neither side allocates or refcounts.
+ *
+ * @note Concurrent 'edit()' calls are serialized rather than last-write-wins,
+ *       but the callable runs while other writers are held off, keep it short.
+ *       Readers only ever wait for the duration of the copy-in itself.
+ *
+ * @tparam T Must be trivially copy-constructible and trivially destructible.
+ */
+template<typename T> requires (std::is_object_v<T>
+	&& std::is_trivially_copy_constructible_v<T>
+	&& std::is_trivially_destructible_v<T>)
+class SeqLockBox {
+	using word_type = std::uintptr_t;
+
+	static constexpr auto c_word_count = (sizeof(T) + sizeof(word_type) - 1) / sizeof(word_type);
+
+	// raw bytes so that memcpy into them implicitly begins the lifetime of a T
+	struct alignas(std::max(alignof(T), alignof(word_type))) Storage {
+		std::byte bytes[c_word_count * sizeof(word_type)];
+
+		auto get() const noexcept { return std::launder(reinterpret_cast<const T*>(bytes)); }
+	};
+
+	std::atomic<word_type> m_words[c_word_count]{};
+	std::atomic<unsigned>  m_sequence{};
+	std::atomic<bool>      m_writer{};
+
+	// Copy of the stored words, callers must either hold the writer flag or validate the sequence.
+	void load_words(Storage& out) const noexcept {
+		for (std::size_t i = 0; i < c_word_count; ++i) {
+			const auto word = m_words[i].load(std::memory_order::relaxed);
+			std::memcpy(out.bytes + i * sizeof(word_type), &word, sizeof(word_type));
+		}
+	}
+
+	void store_words(const T& value) noexcept {
+		word_type in[c_word_count]{};
+		std::memcpy(in, &value, sizeof(T));
+
+		m_sequence.fetch_add(1, std::memory_order::relaxed);
+		std::atomic_thread_fence(std::memory_order::release);
+
+		for (std::size_t i = 0; i < c_word_count; ++i) {
+			m_words[i].store(in[i], std::memory_order::relaxed);
+		}
+		m_sequence.fetch_add(1, std::memory_order::release);
+	}
+
+	void read_into(Storage& out) const noexcept {
+		for (;;) {
+			const auto seq_before = m_sequence.load(std::memory_order::acquire);
+			if (seq_before & 1) { ::cpu_relax(); continue; }
+
+			load_words(out);
+
+			std::atomic_thread_fence(std::memory_order::acquire);
+			if (m_sequence.load(std::memory_order::relaxed) == seq_before) { return; }
+		}
+	}
+
+	void lock_writer() noexcept {
+		while (m_writer.exchange(true, std::memory_order::acquire)) {
+			while (m_writer.load(std::memory_order::relaxed)) { ::cpu_relax(); }
+		}
+	}
+
+	void unlock_writer() noexcept {
+		m_writer.store(false, std::memory_order::release);
+	}
+
+	struct WriterGuard {
+		SeqLockBox& box;
+		WriterGuard(SeqLockBox& b) noexcept : box(b) { box.lock_writer(); }
+		~WriterGuard() noexcept { box.unlock_writer(); }
+	};
+
+public:
+	explicit SeqLockBox(const T& value) noexcept { store_words(value); }
+
+	template <typename... Args> requires (std::is_constructible_v<T, Args...>)
+	explicit SeqLockBox(std::in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+		: SeqLockBox(T(std::forward<Args>(args)...))
+	{}
+
+	SeqLockBox() noexcept(std::is_nothrow_default_constructible_v<T>)
+		requires (std::is_default_constructible_v<T>)
+		: SeqLockBox(T())
+	{}
+
+	SeqLockBox(const SeqLockBox&) = delete;
+	SeqLockBox& operator=(const SeqLockBox&) = delete;
+
+public:
+	/**
+	 * @brief Copies the current object, mutates the copy via callable, then publishes it.
+	 *        Whatever the callable returns is returned by value, as the copy it could
+	 *        refer to does not outlive the call.
+	 * @warning If the callable throws, the copy is discarded and no publish occurs.
+	 */
+	template <typename Fn> requires (std::is_invocable_v<Fn, T&>)
+	decltype(auto) edit(Fn&& callable) noexcept(std::is_nothrow_invocable_v<Fn, T&>) {
+		WriterGuard guard(*this);
+
+		Storage snapshot;
+		load_words(snapshot);
+		T dup(*snapshot.get());
+
+		if constexpr (std::is_void_v<std::invoke_result_t<Fn, T&>>) {
+			callable(dup);
+			store_words(dup);
+		} else {
+			auto result = callable(dup);
+			store_words(dup);
+			return result;
+		}
+	}
+
+	/**
+	 * @brief Invokes callable with a read-only reference to a snapshot of the current object.
+	 *        Whatever the callable returns is returned by value, as the snapshot it could
+	 *        refer to does not outlive the call.
+	 * @warning If the callable throws, no internal state is modified.
+	 */
+	template <typename Fn> requires (std::is_invocable_v<Fn, const T&>)
+	auto read(Fn&& callable) const noexcept(std::is_nothrow_invocable_v<Fn, const T&>)
+		-> std::remove_cvref_t<std::invoke_result_t<Fn, const T&>>
+	{
+		Storage snapshot;
+		read_into(snapshot);
+		return callable(*snapshot.get());
+	}
+
+public:
+	/**
+	 * @brief Returns an independent copy of the currently stored object.
+	 */
+	T copy() const noexcept {
+		Storage snapshot;
+		read_into(snapshot);
+		return *snapshot.get();
+	}
+};
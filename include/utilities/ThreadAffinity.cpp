@@ -52,6 +52,39 @@ unsigned thread_affinity::get_logical_core_count() noexcept {
 #endif
 }
 
+static auto get_all_cores_mask() noexcept {
+	const auto cpu_count = thread_affinity::get_logical_core_count();
+	return cpu_count >= 64 ? ~0ull : (1ull << cpu_count) - 1;
+}
+
+#if defined(__linux__)
+	// Linux keeps no mask per process, only per thread, and the main thread narrows its
+	// own at startup. Taken during static initialization, this is the mask we inherited.
+	static const auto s_initial_affinity_mask = []() noexcept {
+		cpu_set_t set; CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) != 0) { return ::get_all_cores_mask(); }
+
+		auto mask = 0ull;
+		for (auto i = 0; i < std::min(64, CPU_SETSIZE); ++i) {
+			if (CPU_ISSET(i, &set)) { mask |= 1ull << i; }
+		}
+		return mask ? mask : ::get_all_cores_mask();
+	}();
+#endif
+
+unsigned long long thread_affinity::get_process_affinity_mask() noexcept {
+#if defined(_WIN32)
+	DWORD_PTR process_mask{}, system_mask{};
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) || !process_mask)
+		{ return ::get_all_cores_mask(); }
+	return static_cast<unsigned long long>(process_mask);
+#elif defined(__linux__)
+	return s_initial_affinity_mask;
+#else
+	return ::get_all_cores_mask(); // MacOS, Web or unknown
+#endif
+}
+
 unsigned thread_affinity::get_current_core() noexcept {
 #if defined(_WIN32)
 	return GetCurrentProcessorNumber();
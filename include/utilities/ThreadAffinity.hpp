@@ -23,6 +23,14 @@ namespace thread_affinity {
 	 */
 	unsigned get_logical_core_count() noexcept;
 
+	/**
+	 * @brief Mask of the logical cores the process is allowed to run on. Defaults to all cores.
+	 * @warning Only covers the first 64 logical cores. On Linux, this is the mask the process
+	 *          was started with, before any thread narrowed its own. On MacOS/Web, all cores.
+	 * @return Bitwise mask of eligible logical cores.
+	 */
+	unsigned long long get_process_affinity_mask() noexcept;
+
 	/**
 	 * @brief Guesstimate of which logical processor core the current thread runs on. Defaults to 0.
 	 * @warning On MacOS/Web, this will always return 0 due to platform limitations.
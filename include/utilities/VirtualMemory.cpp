@@ -0,0 +1,115 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <cstdint>
+
+#include "VirtualMemory.hpp"
+
+#if defined(_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+/*==================================================================*/
+
+static constexpr std::size_t c_huge_page_size = 2 * 1024 * 1024;
+
+static std::size_t round_to_pages(std::size_t size) noexcept {
+	const auto page_size = virtual_memory::get_page_size();
+	return (size + page_size - 1) & ~(page_size - 1);
+}
+
+std::size_t virtual_memory::get_page_size() noexcept {
+	static const std::size_t page_size = []() noexcept -> std::size_t {
+	#if defined(_WIN32)
+		SYSTEM_INFO sysinfo;
+		GetSystemInfo(&sysinfo);
+		return sysinfo.dwPageSize;
+	#elif defined(__linux__) || defined(__APPLE__)
+		const auto size = sysconf(_SC_PAGESIZE);
+		return size > 0 ? std::size_t(size) : 4096;
+	#else
+		return 4096; // Web or unknown
+	#endif
+	}();
+	return page_size;
+}
+
+/*==================================================================*/
+
+void* virtual_memory::reserve(std::size_t size, [[maybe_unused]] bool huge_pages) noexcept {
+	if (!size) { return nullptr; }
+	size = round_to_pages(size);
+
+#if defined(_WIN32)
+	// committed pages are zero-filled on first touch, only the commit charge is paid upfront
+	return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__) || defined(__APPLE__)
+	#ifdef MAP_NORESERVE
+		static constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+	#else
+		static constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	#endif
+
+	#ifdef MADV_HUGEPAGE
+	if (huge_pages && size >= c_huge_page_size) {
+		// over-reserve so the region can start on a huge page boundary, then trim the excess
+		auto* ptr = mmap(nullptr, size + c_huge_page_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (ptr == MAP_FAILED) { return nullptr; }
+
+		const auto base = reinterpret_cast<std::uintptr_t>(ptr);
+		const auto head = (c_huge_page_size - (base & (c_huge_page_size - 1))) & (c_huge_page_size - 1);
+
+		if (head) { munmap(ptr, head); }
+		munmap(reinterpret_cast<void*>(base + head + size), c_huge_page_size - head);
+
+		ptr = reinterpret_cast<void*>(base + head);
+		madvise(ptr, size, MADV_HUGEPAGE); // merely a hint, failure is harmless
+		return ptr;
+	}
+	#endif
+
+	auto* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+	return ptr != MAP_FAILED ? ptr : nullptr;
+#else
+	return nullptr; // Web or unknown
+#endif
+}
+
+void virtual_memory::release(void* ptr, std::size_t size) noexcept {
+	if (!ptr || !size) { return; }
+
+#if defined(_WIN32)
+	VirtualFree(ptr, 0, MEM_RELEASE);
+#elif defined(__linux__) || defined(__APPLE__)
+	munmap(ptr, round_to_pages(size));
+#endif
+}
+
+bool virtual_memory::discard(void* ptr, std::size_t size) noexcept {
+	if (!ptr || !size) { return true; }
+	size = round_to_pages(size);
+
+#if defined(_WIN32)
+	// decommitting and committing again is what guarantees the zeroes
+	return VirtualFree(ptr, size, MEM_DECOMMIT)
+		&& VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+	// private anonymous pages read back as zeroes once dropped
+	return madvise(ptr, size, MADV_DONTNEED) == 0;
+#elif defined(__APPLE__)
+	// MADV_DONTNEED may keep the old contents here, map fresh pages over the range instead
+	return mmap(ptr, size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED;
+#else
+	return false; // Web or unknown
+#endif
+}
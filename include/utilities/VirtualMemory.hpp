@@ -0,0 +1,52 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+/*==================================================================*/
+
+namespace virtual_memory {
+#if defined(_WIN32) || defined(__linux__) || defined(__APPLE__)
+	inline constexpr bool is_supported = true;
+#else
+	inline constexpr bool is_supported = false;
+#endif
+
+	/**
+	 * @brief Size of the pages the OS maps memory in. Defaults to 4 KiB.
+	 * @return Page size in bytes.
+	 */
+	std::size_t get_page_size() noexcept;
+
+	/**
+	 * @brief Reserves a zero-filled region of address space, committed lazily: pages
+	 *        only cost resident memory once first written. No swap is reserved upfront.
+	 * @warning On Web or unknown platforms, this is unsupported and returns null.
+	 * @param[in] size       :: Size of the region in bytes, rounded up to whole pages.
+	 * @param[in] huge_pages :: Align the region for and ask for transparent huge pages.
+	 *                          Only honored on Linux, and only for regions of 2 MiB or more.
+	 * @return Page-aligned pointer to the region, or null on failure.
+	 */
+	void* reserve(std::size_t size, bool huge_pages = false) noexcept;
+
+	/**
+	 * @brief Returns a region obtained from reserve() to the OS.
+	 * @param[in] ptr  :: Pointer returned by reserve(), may be null.
+	 * @param[in] size :: Same size as passed to reserve().
+	 */
+	void  release(void* ptr, std::size_t size) noexcept;
+
+	/**
+	 * @brief Drops the backing pages of a reserved region, which reads back as zeroes
+	 *        afterwards and costs no resident memory until written again.
+	 * @param[in] ptr  :: Page-aligned pointer into a region obtained from reserve().
+	 * @param[in] size :: Size in bytes, rounded up to whole pages.
+	 * @return True if successful, false if the caller must zero the memory itself.
+	 */
+	bool  discard(void* ptr, std::size_t size) noexcept;
+}
@@ -0,0 +1,219 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "ZoneProfiler.hpp"
+#include "ThreadAffinity.hpp"
+#include "Millis.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+/*==================================================================*/
+
+namespace {
+	using mo = std::memory_order;
+
+	// ~1.5 MiB per thread, roughly 10s of trace at a few thousand zones per second
+	constexpr std::size_t c_ring_capacity = 1u << 16;
+
+	struct ZoneEvent {
+		std::atomic<const char*> name{};
+		std::atomic<long long>   begin{};
+		std::atomic<long long>   end{};
+	};
+
+	struct ThreadRing {
+		std::atomic<std::size_t> head{};  // total events ever written, single writer
+		std::atomic<bool>        retired{}; // owner thread exited, ring may be reused
+		unsigned                 lane_id{};
+		std::string              lane_name{};
+
+		std::unique_ptr<ZoneEvent[]> events
+			= std::make_unique<ZoneEvent[]>(c_ring_capacity);
+	};
+
+	std::atomic<bool> s_is_enabled{};
+
+	std::mutex s_registry_lock;
+	std::vector<std::shared_ptr<ThreadRing>> s_registry;
+
+	std::shared_ptr<ThreadRing> claim_thread_ring(std::string_view lane_name) noexcept {
+		try {
+			std::lock_guard lock(s_registry_lock);
+
+			for (auto& ring : s_registry) {
+				if (ring->retired.load(mo::acquire)) {
+					ring->head.store(0, mo::release);
+					ring->lane_name = lane_name;
+					ring->retired.store(false, mo::relaxed);
+					return ring;
+				}
+			}
+
+			auto ring = std::make_shared<ThreadRing>();
+			ring->lane_id = unsigned(s_registry.size() + 1);
+			ring->lane_name = lane_name;
+			return s_registry.emplace_back(std::move(ring));
+		} catch (...) { return nullptr; }
+	}
+
+	// The name is kept apart from the ring, so naming a thread that never
+	// records anything doesn't cost it a ring of its own.
+	struct ThreadRingOwner {
+		std::string                 lane_name{};
+		std::shared_ptr<ThreadRing> ring{};
+
+		~ThreadRingOwner() noexcept {
+			if (ring) { ring->retired.store(true, mo::release); }
+		}
+	};
+
+	ThreadRingOwner& get_thread_owner() noexcept {
+		thread_local ThreadRingOwner s_owner;
+		return s_owner;
+	}
+
+	// Claims the calling thread's ring on first use, which only happens while enabled.
+	ThreadRing* get_thread_ring() noexcept {
+		auto& owner = get_thread_owner();
+		if (!owner.ring && s_is_enabled.load(mo::relaxed)) [[unlikely]]
+			{ owner.ring = claim_thread_ring(owner.lane_name); }
+		return owner.ring.get();
+	}
+
+	void append_json_string(std::string& out, std::string_view str) {
+		for (const char c : str) {
+			switch (c) {
+				case '"':  out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20)
+						{ fmt::format_to(std::back_inserter(out), "\\u{:04x}", c); }
+					else { out += c; }
+			}
+		}
+	}
+}
+
+/*==================================================================*/
+
+bool zone_profiler::is_enabled() noexcept {
+	return s_is_enabled.load(mo::relaxed);
+}
+
+bool zone_profiler::set_enabled(bool state) noexcept {
+	return s_is_enabled.exchange(state, mo::acq_rel);
+}
+
+void zone_profiler::set_thread_name(std::string_view name) noexcept {
+	auto& owner = get_thread_owner();
+	try {
+		owner.lane_name = name;
+		if (owner.ring) {
+			std::lock_guard lock(s_registry_lock);
+			owner.ring->lane_name = name;
+		}
+	} catch (...) { /* ignore */ }
+}
+
+void zone_profiler::record_zone(const char* name, long long begin_ns, long long end_ns) noexcept {
+	if (auto* ring = get_thread_ring()) {
+		const auto index = ring->head.load(mo::relaxed);
+		auto& event = ring->events[index & (c_ring_capacity - 1)];
+
+		event.name .store(name,     mo::relaxed);
+		event.begin.store(begin_ns, mo::relaxed);
+		event.end  .store(end_ns,   mo::relaxed);
+
+		ring->head.store(index + 1, mo::release);
+	}
+}
+
+/*==================================================================*/
+
+std::string zone_profiler::export_chrome_trace(double window_secs) noexcept {
+	try {
+		const auto cutoff = Millis::raw() - static_cast<long long>(window_secs * 1e9);
+		const auto pid = thread_affinity::get_process_id();
+
+		std::string output;
+		output.reserve(1024 * 1024);
+		output += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool has_events = false;
+		auto append_separator = [&]() {
+			if (has_events) { output += ",\n"; }
+			has_events = true;
+		};
+
+		std::lock_guard lock(s_registry_lock);
+
+		for (const auto& ring : s_registry) {
+			const auto head_before = ring->head.load(mo::acquire);
+			const auto tail_before = head_before > c_ring_capacity
+				? head_before - c_ring_capacity : 0;
+
+			struct Snapshot { const char* name; long long begin, end; };
+			std::vector<Snapshot> snapshots;
+			snapshots.reserve(head_before - tail_before);
+
+			for (auto i = tail_before; i < head_before; ++i) {
+				const auto& event = ring->events[i & (c_ring_capacity - 1)];
+				snapshots.push_back({ event.name.load(mo::relaxed),
+					event.begin.load(mo::relaxed), event.end.load(mo::relaxed) });
+			}
+
+			// entries the writer lapped while we were copying may be torn, drop them
+			const auto head_after = ring->head.load(mo::acquire);
+			const auto torn_count = std::min<std::size_t>(snapshots.size(),
+				head_after >= c_ring_capacity ? head_after - c_ring_capacity - tail_before + 1 : 0);
+
+			if (snapshots.size() == torn_count) { continue; }
+
+			append_separator();
+			fmt::format_to(std::back_inserter(output),
+				"{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"",
+				pid, ring->lane_id);
+			append_json_string(output, ring->lane_name.empty()
+				? fmt::format("thread {}", ring->lane_id) : ring->lane_name);
+			output += "\"}}";
+
+			for (auto i = torn_count; i < snapshots.size(); ++i) {
+				const auto& snap = snapshots[i];
+				if (!snap.name || snap.begin < cutoff) { continue; }
+
+				append_separator();
+				output += "{\"name\":\"";
+				append_json_string(output, snap.name);
+				fmt::format_to(std::back_inserter(output),
+					"\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+					pid, ring->lane_id, snap.begin / 1e3,
+					std::max(0ll, snap.end - snap.begin) / 1e3);
+			}
+		}
+
+		if (!has_events) { return {}; }
+		output += "]}\n";
+		return output;
+	}
+	catch (...) { return {}; }
+}
+
+/*==================================================================*/
+
+zone_profiler::ScopedZone::ScopedZone(const char* name) noexcept
+	: m_name(is_enabled() ? name : nullptr)
+	, m_begin(m_name ? Millis::raw() : 0)
+{}
+
+zone_profiler::ScopedZone::~ScopedZone() noexcept {
+	if (m_name) { record_zone(m_name, m_begin, Millis::raw()); }
+}
@@ -0,0 +1,74 @@
+/*
+	This Source Code Form is subject to the terms of the Mozilla Public
+	License, v. 2.0. If a copy of the MPL was not distributed with this
+	file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Macros.hpp"
+
+/*==================================================================*/
+
+namespace zone_profiler {
+	/**
+	 * @brief Tests whether zone recording is currently active. Zones opened
+	 *        while recording is disabled cost a single relaxed atomic load.
+	 */
+	[[nodiscard]]
+	bool is_enabled() noexcept;
+
+	/**
+	 * @brief Enables or disables zone recording for all threads.
+	 * @return Previous recording state.
+	 */
+	bool set_enabled(bool state) noexcept;
+
+	/**
+	 * @brief Assigns a display name to the calling thread's trace lane.
+	 * @warning Takes effect on the next export only if the thread records zones.
+	 */
+	void set_thread_name(std::string_view name) noexcept;
+
+	/**
+	 * @brief Pushes a completed zone into the calling thread's ring buffer.
+	 *        Oldest entries are overwritten once the ring is full.
+	 * @param[in] name     :: Static string naming the zone, must outlive the profiler.
+	 * @param[in] begin_ns :: Zone start timestamp, as returned by Millis::raw().
+	 * @param[in] end_ns   :: Zone end timestamp, as returned by Millis::raw().
+	 */
+	void record_zone(const char* name, long long begin_ns, long long end_ns) noexcept;
+
+	/**
+	 * @brief Serializes zones from all threads recorded in the last X seconds
+	 *        into the Chrome Trace Event JSON format (chrome://tracing, Perfetto).
+	 * @param[in] window_secs :: Timespan to export, counting back from now.
+	 * @return JSON document, empty if nothing was recorded.
+	 */
+	[[nodiscard]]
+	std::string export_chrome_trace(double window_secs) noexcept;
+
+/*==================================================================*/
+
+	/**
+	 * @brief RAII zone, timestamps on construction and records on destruction.
+	 *        Use via the PROFILE_ZONE(name) macro rather than directly.
+	 */
+	class ScopedZone final {
+		const char* m_name;
+		long long   m_begin;
+
+	public:
+		ScopedZone(const char* name) noexcept;
+		~ScopedZone() noexcept;
+
+		ScopedZone(const ScopedZone&) = delete;
+		ScopedZone& operator=(const ScopedZone&) = delete;
+	};
+}
+
+#define PROFILE_ZONE(name) \
+	const zone_profiler::ScopedZone CONCAT_TOKENS(_profile_zone_, __LINE__)(name)